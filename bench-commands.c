@@ -0,0 +1,295 @@
+/****************************************************************************
+ * Command benchmark against the simulated device
+ *
+ * Runs -S, -n, -N, -k and -m against devices of increasing size and
+ * reports, per command, the wall time, the number of ioctls, the bytes
+ * they copy and the allocations made through the test wrappers.  The
+ * counts do not depend on the host, so "make bench" compares them with
+ * bench-commands.baseline and fails if any has grown by more than a
+ * tenth; that catches a command whose cost starts growing faster than
+ * the device.  Wall time is only reported.
+ *
+ *	bench-commands [-b BASELINE | -w BASELINE]
+ *
+ * -w writes the current counts as a new baseline.  The measurement time
+ * per case can be set with ETHTOOL_BENCH_SECONDS.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#define TEST_NO_WRAPPERS
+#include "internal.h"
+
+struct bench_case {
+	const char *name;
+	const char *args;
+	unsigned int size;
+	int (*setup)(unsigned int size);
+	void (*reset)(unsigned int size);	/* undo one run */
+};
+
+struct bench_result {
+	double usecs;		/* mean wall time per run */
+	unsigned long ioctls;
+	unsigned long long bytes;
+	unsigned long mallocs;
+	size_t peak;
+};
+
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	return fakenic_ioctl(ctx, cmd);
+}
+
+static int setup_stats(unsigned int size)
+{
+	struct fakenic_config config = {
+		.n_stats = size,
+		.n_queues = 8,
+		.n_rules = 1024,
+		.indir_size = 128,
+	};
+
+	return fakenic_create(&config);
+}
+
+/* A table twice the size, half full from the start */
+static int setup_rules(unsigned int size)
+{
+	struct fakenic_config config = {
+		.n_stats = 64,
+		.n_queues = 8,
+		.n_rules = 2 * size,
+		.indir_size = 128,
+	};
+	struct ethtool_rxnfc nfc;
+	unsigned int i;
+	int err;
+
+	err = fakenic_create(&config);
+	for (i = 0; !err && i < size; i++) {
+		memset(&nfc, 0, sizeof(nfc));
+		nfc.cmd = ETHTOOL_SRXCLSRLINS;
+		nfc.fs.flow_type = TCP_V4_FLOW;
+		nfc.fs.h_u.tcp_ip4_spec.pdst = htons(1024 + i % 64512);
+		nfc.fs.m_u.tcp_ip4_spec.pdst = 0xffff;
+		nfc.fs.ring_cookie = i % 8;
+		nfc.fs.location = i;
+		if (fakenic_ioctl(NULL, &nfc))
+			err = -errno;
+	}
+	return err;
+}
+
+/* The rule manager puts a new rule in the last free location */
+static void reset_insert(unsigned int size)
+{
+	struct ethtool_rxnfc nfc = { .cmd = ETHTOOL_SRXCLSRLDEL };
+
+	nfc.fs.location = 2 * size - 1;
+	fakenic_ioctl(NULL, &nfc);
+}
+
+static int setup_default(unsigned int size)
+{
+	return fakenic_create(NULL);
+}
+
+/* The size is the EEPROM length, which selects the module type */
+static int setup_module(unsigned int size)
+{
+	struct fakenic_config config = {
+		.n_stats = 64,
+		.n_queues = 8,
+		.n_rules = 1024,
+		.indir_size = 128,
+		.module_type = size == ETH_MODULE_SFF_8472_LEN ?
+			ETH_MODULE_SFF_8472 : ETH_MODULE_SFF_8636,
+		.module_len = size,
+	};
+
+	return fakenic_create(&config);
+}
+
+#define BENCH_INSERT	"-N devname flow-type tcp4 dst-port 80 action 1"
+
+static const struct bench_case bench_cases[] = {
+	{ "stats", "-S devname", 100, setup_stats },
+	{ "stats", "-S devname", 1000, setup_stats },
+	{ "stats", "-S devname", 5000, setup_stats },
+	{ "stats", "-S devname", 20000, setup_stats },
+	{ "rules", "-n devname", 1024, setup_rules },
+	{ "rules", "-n devname", 8192, setup_rules },
+	{ "rules", "-n devname", 65536, setup_rules },
+	{ "insert", BENCH_INSERT, 1024, setup_rules, reset_insert },
+	{ "insert", BENCH_INSERT, 8192, setup_rules, reset_insert },
+	{ "insert", BENCH_INSERT, 65536, setup_rules, reset_insert },
+	{ "features", "-k devname", 0, setup_default },
+	{ "module", "-m devname", ETH_MODULE_SFF_8472_LEN, setup_module },
+	{ "module", "-m devname", ETH_MODULE_SFF_8636_MAX_LEN, setup_module },
+};
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Run one case until @seconds have passed; the counts are from the first */
+static int bench_run(const struct bench_case *bc, double seconds,
+		     struct bench_result *res)
+{
+	double start, elapsed;
+	unsigned long runs = 0;
+	int rc;
+
+	if (bc->setup(bc->size)) {
+		fprintf(stderr, "Cannot create device for %s %u\n",
+			bc->name, bc->size);
+		return -1;
+	}
+
+	start = now();
+	do {
+		fakenic_io.requests = 0;
+		fakenic_io.bytes = 0;
+		test_alloc_stats.count = 0;
+		test_alloc_stats.peak = 0;
+		rc = test_cmdline(bc->args);
+		if (rc) {
+			fprintf(stderr, "ethtool %s returns %d\n",
+				bc->args, rc);
+			return -1;
+		}
+		if (!runs++) {
+			res->ioctls = fakenic_io.requests;
+			res->bytes = fakenic_io.bytes;
+			res->mallocs = test_alloc_stats.count;
+			res->peak = test_alloc_stats.peak;
+		}
+		if (bc->reset)
+			bc->reset(bc->size);
+		elapsed = now() - start;
+	} while (elapsed < seconds);
+
+	res->usecs = elapsed * 1e6 / runs;
+	return 0;
+}
+
+/* Look up a case in the baseline; 1 if found */
+static int baseline_find(FILE *baseline, const struct bench_case *bc,
+			 struct bench_result *base)
+{
+	char line[256], name[32];
+	unsigned int size;
+
+	rewind(baseline);
+	while (fgets(line, sizeof(line), baseline)) {
+		if (line[0] == '#')
+			continue;
+		if (sscanf(line, "%31s %u %lu %llu %lu %zu", name, &size,
+			   &base->ioctls, &base->bytes, &base->mallocs,
+			   &base->peak) == 6 &&
+		    !strcmp(name, bc->name) && size == bc->size)
+			return 1;
+	}
+	return 0;
+}
+
+/* Allow a tenth more than the baseline */
+static int bench_grew(unsigned long long value, unsigned long long base)
+{
+	return value > base + base / 10;
+}
+
+static const char *bench_compare(const struct bench_result *res,
+				 const struct bench_result *base)
+{
+	if (bench_grew(res->ioctls, base->ioctls) ||
+	    bench_grew(res->bytes, base->bytes) ||
+	    bench_grew(res->mallocs, base->mallocs) ||
+	    bench_grew(res->peak, base->peak))
+		return "REGRESSED";
+	if (res->ioctls < base->ioctls || res->bytes < base->bytes ||
+	    res->mallocs < base->mallocs || res->peak < base->peak)
+		return "improved";
+	return "ok";
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: bench-commands [-b BASELINE | -w BASELINE]\n");
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	struct bench_result res, base;
+	const struct bench_case *bc;
+	FILE *baseline = NULL, *out = NULL;
+	double seconds = 0.2;
+	const char *status;
+	int rc = 0;
+
+	if (argc == 3 && !strcmp(argv[1], "-b")) {
+		baseline = fopen(argv[2], "r");
+		if (!baseline) {
+			perror(argv[2]);
+			return 1;
+		}
+	} else if (argc == 3 && !strcmp(argv[1], "-w")) {
+		out = fopen(argv[2], "w");
+		if (!out) {
+			perror(argv[2]);
+			return 1;
+		}
+		fprintf(out, "# case size ioctls bytes mallocs peak\n");
+	} else if (argc != 1) {
+		usage();
+	}
+	if (getenv("ETHTOOL_BENCH_SECONDS"))
+		seconds = atof(getenv("ETHTOOL_BENCH_SECONDS"));
+
+	printf("%-9s %6s %12s %7s %10s %8s %9s\n", "Case", "Size",
+	       "usecs/run", "Ioctls", "Bytes", "Mallocs", "Peak");
+	for (bc = bench_cases; bc < bench_cases + ARRAY_SIZE(bench_cases);
+	     bc++) {
+		if (bench_run(bc, seconds, &res)) {
+			rc = 1;
+			continue;
+		}
+		status = "";
+		if (baseline) {
+			status = baseline_find(baseline, bc, &base) ?
+				bench_compare(&res, &base) : "no baseline";
+			if (!strcmp(status, "REGRESSED"))
+				rc = 1;
+		}
+		printf("%-9s %6u %12.1f %7lu %10llu %8lu %9zu %s\n",
+		       bc->name, bc->size, res.usecs, res.ioctls, res.bytes,
+		       res.mallocs, res.peak, status);
+		if (out)
+			fprintf(out, "%s %u %lu %llu %lu %zu\n", bc->name,
+				bc->size, res.ioctls, res.bytes, res.mallocs,
+				res.peak);
+	}
+
+	fakenic_destroy();
+	if (baseline)
+		fclose(baseline);
+	if (out && fclose(out)) {
+		perror(argv[2]);
+		rc = 1;
+	}
+	return rc;
+}
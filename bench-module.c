@@ -0,0 +1,127 @@
+/****************************************************************************
+ * Throughput benchmark for the module EEPROM decoders
+ *
+ * Decodes synthetic images of each supported module type in a loop with
+ * stdout sent to /dev/null, and reports decodes per second.  This is not
+ * run by "make check"; run ./bench-module by hand.  The measurement time
+ * per module type can be set with ETHTOOL_BENCH_SECONDS.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "internal.h"
+#include "sff-common.h"
+
+struct bench_module {
+	const char *name;
+	__u32 type;
+	__u32 len;
+	__u8 id;
+};
+
+static const struct bench_module bench_modules[] = {
+	{ "SFF-8079", ETH_MODULE_SFF_8079, ETH_MODULE_SFF_8079_LEN,
+	  SFF8024_ID_SFP },
+	{ "SFF-8472", ETH_MODULE_SFF_8472, ETH_MODULE_SFF_8472_LEN,
+	  SFF8024_ID_SFP },
+	{ "SFF-8636", ETH_MODULE_SFF_8636, ETH_MODULE_SFF_8636_LEN,
+	  SFF8024_ID_QSFP28 },
+	{ "SFF-8636 paged", ETH_MODULE_SFF_8636,
+	  ETH_MODULE_SFF_8636_MAX_LEN, SFF8024_ID_QSFP28 },
+};
+
+static void fill_image(const struct bench_module *bm, __u8 *image)
+{
+	unsigned int i;
+
+	srandom(bm->type);
+	for (i = 0; i < bm->len; i++)
+		image[i] = random();
+	image[0] = bm->id;
+	if (bm->type == ETH_MODULE_SFF_8079 ||
+	    bm->type == ETH_MODULE_SFF_8472) {
+		image[1] = 0x04;
+		image[92] |= 1 << 6;
+	} else {
+		/* page 03h present, valid temperature */
+		image[2] &= ~0x04;
+		image[22] = 0x20;
+	}
+}
+
+static void decode(const struct bench_module *bm, const __u8 *image)
+{
+	switch (bm->type) {
+	case ETH_MODULE_SFF_8079:
+		sff8079_show_all(image);
+		break;
+	case ETH_MODULE_SFF_8472:
+		sff8079_show_all(image);
+		sff8472_show_all(image);
+		break;
+	default:
+		sff8636_show_all(image, bm->len);
+		break;
+	}
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+	__u8 image[ETH_MODULE_SFF_8636_MAX_LEN];
+	double seconds = 1.0, start, elapsed;
+	const struct bench_module *bm;
+	unsigned long count, batch;
+	FILE *report;
+	int dev_null;
+
+	if (getenv("ETHTOOL_BENCH_SECONDS"))
+		seconds = atof(getenv("ETHTOOL_BENCH_SECONDS"));
+
+	fflush(stdout);
+	report = fdopen(dup(STDOUT_FILENO), "w");
+	dev_null = open("/dev/null", O_WRONLY);
+	if (!report || dev_null < 0) {
+		perror("Cannot redirect output");
+		return 1;
+	}
+	dup2(dev_null, STDOUT_FILENO);
+	close(dev_null);
+
+	sff_dbm_table_init();
+
+	fprintf(report, "%-16s %12s %14s\n", "Module", "Decodes", "Decodes/sec");
+	for (bm = bench_modules;
+	     bm < bench_modules + ARRAY_SIZE(bench_modules); bm++) {
+		fill_image(bm, image);
+		count = 0;
+		start = now();
+		do {
+			for (batch = 0; batch < 256; batch++)
+				decode(bm, image);
+			count += batch;
+			fflush(stdout);
+			elapsed = now() - start;
+		} while (elapsed < seconds);
+		fprintf(report, "%-16s %12lu %14.0f\n",
+			bm->name, count, count / elapsed);
+	}
+
+	fclose(report);
+	return 0;
+}
@@ -1,15 +1,84 @@
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "internal.h"
+#include "regs-desc.h"
+
+/*
+ * The decoded registers of a port are normally printed as they are
+ * decoded.  To lay several ports out side by side, each line is
+ * instead captured as a label and a value.
+ */
+#define DSA_LABEL_LEN	48
+#define DSA_VALUE_LEN	48
+#define DSA_MAX_LINES	256
+
+struct dsa_line {
+	char label[DSA_LABEL_LEN];
+	char value[DSA_VALUE_LEN];
+};
+
+struct dsa_port_lines {
+	struct dsa_line *lines;
+	unsigned int n_lines;
+};
+
+static struct dsa_port_lines *dsa_capture;
+
+static struct dsa_line *dsa_capture_line(void)
+{
+	if (dsa_capture->n_lines == DSA_MAX_LINES)
+		return NULL;
+	return &dsa_capture->lines[dsa_capture->n_lines++];
+}
+
+static void dsa_reg(int reg, const char *name, u16 val)
+{
+	struct dsa_line *line;
+
+	if (!dsa_capture) {
+		printf("%.02u: %-38.38s 0x%.4x\n", reg, name, val);
+		return;
+	}
+	line = dsa_capture_line();
+	if (!line)
+		return;
+	snprintf(line->label, sizeof(line->label), "%.02u: %s", reg, name);
+	snprintf(line->value, sizeof(line->value), "0x%.4x", val);
+}
+
+static void dsa_field(const char *name, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static void dsa_field(const char *name, const char *fmt, ...)
+{
+	struct dsa_line *line;
+	va_list ap;
+	size_t len;
+
+	va_start(ap, fmt);
+	if (!dsa_capture) {
+		printf("      %-36.36s ", name);
+		vprintf(fmt, ap);
+		putchar('\n');
+	} else if ((line = dsa_capture_line())) {
+		snprintf(line->label, sizeof(line->label), "      %s", name);
+		vsnprintf(line->value, sizeof(line->value), fmt, ap);
+		/* Bitmaps end in a space */
+		len = strlen(line->value);
+		while (len && line->value[len - 1] == ' ')
+			line->value[--len] = 0;
+	}
+	va_end(ap);
+}
 
 /* Macros and dump functions for the 16-bit mv88e6xxx per-port registers */
 
-#define REG(_reg, _name, _val) \
-	printf("%.02u: %-38.38s 0x%.4x\n", _reg, _name, _val)
+#define REG(_reg, _name, _val) dsa_reg(_reg, _name, _val)
 
-#define FIELD(_name, _fmt, ...) \
-	printf("      %-36.36s " _fmt "\n", _name, ##__VA_ARGS__)
+#define FIELD(_name, _fmt, ...) dsa_field(_name, _fmt, ##__VA_ARGS__)
 
 #define FIELD_BITMAP(_name, _val) \
 	FIELD(_name, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s", \
@@ -635,37 +704,49 @@ static const struct dsa_mv88e6xxx_switch dsa_mv88e6xxx_switches[] = {
 	{ .id = 0x3900, .name = "88E6390 ", .dump = dsa_mv88e6390 },
 };
 
-static int dsa_mv88e6xxx_dump_regs(struct ethtool_regs *regs)
+static const struct dsa_mv88e6xxx_switch *
+dsa_mv88e6xxx_switch(const struct ethtool_regs *regs)
 {
-	const struct dsa_mv88e6xxx_switch *sw = NULL;
-	const u16 *data = (u16 *)regs->data;
 	u16 id;
 	int i;
 
 	/* Marvell chips have 32 per-port 16-bit registers */
 	if (regs->len < 32 * 2)
-		return 1;
+		return NULL;
 
 	id = regs->version & 0xfff0;
 
-	for (i = 0; i < ARRAY_SIZE(dsa_mv88e6xxx_switches); i++) {
-		if (id == dsa_mv88e6xxx_switches[i].id) {
-			sw = &dsa_mv88e6xxx_switches[i];
-			break;
-		}
-	}
+	for (i = 0; i < ARRAY_SIZE(dsa_mv88e6xxx_switches); i++)
+		if (id == dsa_mv88e6xxx_switches[i].id)
+			return &dsa_mv88e6xxx_switches[i];
 
-	if (!sw)
-		return 1;
+	return NULL;
+}
 
-	printf("%s Switch Port Registers\n", sw->name);
-	printf("------------------------------\n");
+static void dsa_mv88e6xxx_decode(const struct dsa_mv88e6xxx_switch *sw,
+				 const struct ethtool_regs *regs)
+{
+	const u16 *data = (u16 *)regs->data;
+	int i;
 
 	for (i = 0; i < 32; i++)
 		if (sw->dump)
 			sw->dump(i, data[i]);
 		else
 			REG(i, "", data[i]);
+}
+
+static int dsa_mv88e6xxx_dump_regs(struct ethtool_regs *regs)
+{
+	const struct dsa_mv88e6xxx_switch *sw = dsa_mv88e6xxx_switch(regs);
+
+	if (!sw)
+		return 1;
+
+	printf("%s Switch Port Registers\n", sw->name);
+	printf("------------------------------\n");
+
+	dsa_mv88e6xxx_decode(sw, regs);
 
 	return 0;
 }
@@ -684,3 +765,112 @@ int dsa_dump_regs(struct ethtool_drvinfo *info maybe_unused,
 	/* Fallback to hexdump */
 	return 1;
 }
+
+/*
+ * Of the values on one line, is port @i's different from the value
+ * most ports have?
+ */
+static int dsa_port_differs(const struct dsa_port_lines *ports,
+			    unsigned int n, unsigned int line, unsigned int i)
+{
+	unsigned int best = 0, best_count = 0, count, j, k;
+
+	for (j = 0; j < n; j++) {
+		for (k = 0, count = 0; k < n; k++)
+			count += !strcmp(ports[j].lines[line].value,
+					 ports[k].lines[line].value);
+		if (count > best_count) {
+			best = j;
+			best_count = count;
+		}
+	}
+	return strcmp(ports[i].lines[line].value,
+		      ports[best].lines[line].value) != 0;
+}
+
+/*
+ * Decode the dumps of @n ports of one switch and print them as a
+ * matrix, one column per port.  Lines on which the ports disagree are
+ * marked with a '*', and with @colour the odd values out are
+ * highlighted.
+ */
+int dsa_dump_regs_ports(struct ethtool_drvinfo *info maybe_unused,
+			struct ethtool_regs **regs, const char *const *names,
+			unsigned int n, int colour)
+{
+	const struct dsa_mv88e6xxx_switch *sw;
+	struct dsa_port_lines *ports;
+	unsigned int i, line;
+	int *widths, label_width = 0;
+	int mismatch, err = -1;
+
+	sw = dsa_mv88e6xxx_switch(regs[0]);
+	if (!sw) {
+		fprintf(stderr, "Cannot compare ports: unknown switch\n");
+		return -1;
+	}
+	for (i = 1; i < n; i++) {
+		if (dsa_mv88e6xxx_switch(regs[i]) != sw) {
+			fprintf(stderr, "Cannot compare ports: %s and %s are "
+				"on different switches\n", names[0], names[i]);
+			return -1;
+		}
+	}
+
+	ports = calloc(n, sizeof(*ports));
+	widths = calloc(n, sizeof(*widths));
+	if (!ports || !widths)
+		goto out;
+	for (i = 0; i < n; i++) {
+		ports[i].lines = calloc(DSA_MAX_LINES,
+					sizeof(ports[i].lines[0]));
+		if (!ports[i].lines)
+			goto out;
+		dsa_capture = &ports[i];
+		dsa_mv88e6xxx_decode(sw, regs[i]);
+		dsa_capture = NULL;
+		widths[i] = strlen(names[i]);
+		for (line = 0; line < ports[i].n_lines; line++)
+			if ((int)strlen(ports[i].lines[line].value) > widths[i])
+				widths[i] = strlen(ports[i].lines[line].value);
+	}
+	/* Don't pad the last column */
+	widths[n - 1] = 0;
+	for (line = 0; line < ports[0].n_lines; line++)
+		if ((int)strlen(ports[0].lines[line].label) > label_width)
+			label_width = strlen(ports[0].lines[line].label);
+
+	printf("%s Switch Port Registers\n", sw->name);
+	printf("  %-*s", label_width, "");
+	for (i = 0; i < n; i++)
+		printf("  %-*s", widths[i], names[i]);
+	putchar('\n');
+
+	for (line = 0; line < ports[0].n_lines; line++) {
+		for (i = 1, mismatch = 0; i < n && !mismatch; i++)
+			mismatch = strcmp(ports[i].lines[line].value,
+					  ports[0].lines[line].value);
+		printf("%c %-*s", mismatch ? '*' : ' ', label_width,
+		       ports[0].lines[line].label);
+		for (i = 0; i < n; i++) {
+			if (colour && mismatch &&
+			    dsa_port_differs(ports, n, line, i))
+				printf("  %s%-*s%s", REGS_DIFF_NEW_COLOUR,
+				       widths[i], ports[i].lines[line].value,
+				       REGS_DIFF_END_COLOUR);
+			else
+				printf("  %-*s", widths[i],
+				       ports[i].lines[line].value);
+		}
+		putchar('\n');
+	}
+	err = 0;
+out:
+	if (err)
+		perror("Cannot allocate memory for register dumps");
+	for (i = 0; ports && i < n; i++)
+		free(ports[i].lines);
+	free(ports);
+	free(widths);
+	return err;
+}
@@ -1,6 +1,7 @@
 /* Copyright (c) 2002 Intel Corporation */
 #include <stdio.h>
 #include "internal.h"
+#include "regs-desc.h"
 
 /* Register Bit Masks */
 /* Device Control */
@@ -363,15 +364,259 @@ static enum e1000_mac_type e1000_get_mac_type(u16 device_id)
 	return mac_type;
 }
 
-int e1000_dump_regs(struct ethtool_drvinfo *info maybe_unused,
-		    struct ethtool_regs *regs)
+static const struct regs_desc_value e1000_speed_values[] = {
+	{ 0, E1000_CTRL_SPD_10, "10Mb/s" },
+	{ 0, E1000_CTRL_SPD_100, "100Mb/s" },
+	{ 0, E1000_CTRL_SPD_1000, "1000Mb/s" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field e1000_ctrl_fields[] = {
+	REGS_BOOL("Endian mode (buffers)", E1000_CTRL_BEM, "little", "big"),
+	REGS_BOOL("Link reset", E1000_CTRL_LRST, "normal", "reset"),
+	REGS_BOOL("Set link up", E1000_CTRL_SLU, "0", "1"),
+	REGS_BOOL("Invert Loss-Of-Signal", E1000_CTRL_ILOS, "no", "yes"),
+	REGS_BOOL("Receive flow control", E1000_CTRL_RFCE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Transmit flow control", E1000_CTRL_TFCE,
+		  "disabled", "enabled"),
+	REGS_BOOL("VLAN mode", E1000_CTRL_VME, "disabled", "enabled"),
+	REGS_BOOL_MAC("Auto speed detect", E1000_CTRL_ASDE,
+		      "disabled", "enabled", e1000_82543, 0),
+	REGS_ENUM_MAC("Speed select", E1000_CTRL_SPD_SEL, e1000_speed_values,
+		      "not used", e1000_82543, 0),
+	REGS_BOOL_MAC("Force speed", E1000_CTRL_FRCSPD, "no", "yes",
+		      e1000_82543, 0),
+	REGS_BOOL_MAC("Force duplex", E1000_CTRL_FRCDPX, "no", "yes",
+		      e1000_82543, 0),
+	{ NULL }
+};
+
+static const struct regs_desc_value e1000_link_speed_values[] = {
+	{ 0, E1000_STATUS_SPEED_10, "10Mb/s" },
+	{ 0, E1000_STATUS_SPEED_100, "100Mb/s" },
+	{ 0, E1000_STATUS_SPEED_1000, "1000Mb/s" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value e1000_port_values[] = {
+	{ 0, 0, "0" },
+	{ 0, 0, NULL }
+};
+
+/* The PCI-X speed bits are only meaningful in PCI-X mode */
+static const struct regs_desc_value e1000_bus_speed_values[] = {
+	{ E1000_STATUS_PCIX_MODE | E1000_STATUS_PCIX_SPEED_133,
+	  E1000_STATUS_PCIX_MODE | E1000_STATUS_PCIX_SPEED_133, "133MHz" },
+	{ E1000_STATUS_PCIX_MODE | E1000_STATUS_PCIX_SPEED_100,
+	  E1000_STATUS_PCIX_MODE | E1000_STATUS_PCIX_SPEED_100, "100MHz" },
+	{ E1000_STATUS_PCIX_MODE, E1000_STATUS_PCIX_MODE, "66MHz" },
+	{ E1000_STATUS_PCI66, E1000_STATUS_PCI66, "66MHz" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field e1000_status_fields[] = {
+	REGS_BOOL("Duplex", E1000_STATUS_FD, "half", "full"),
+	REGS_BOOL("Link up", E1000_STATUS_LU, "no link config", "link config"),
+	REGS_BOOL_MAC("TBI mode", E1000_STATUS_TBIMODE, "disabled", "enabled",
+		      e1000_82543, 0),
+	REGS_ENUM_MAC("Link speed", E1000_STATUS_SPEED_MASK,
+		      e1000_link_speed_values, "not used", e1000_82543, 0),
+	REGS_ENUM_MAC("Bus type", 0, NULL, "PCI Express", e1000_82571, 0),
+	REGS_ENUM_MAC("Port number", E1000_STATUS_FUNC_MASK,
+		      e1000_port_values, "1", e1000_82571, 0),
+	REGS_BOOL_MAC("Bus type", E1000_STATUS_PCIX_MODE, "PCI", "PCI-X",
+		      e1000_82543, e1000_82547_rev_2),
+	REGS_ENUM_MAC("Bus speed",
+		      E1000_STATUS_PCIX_MODE | E1000_STATUS_PCIX_SPEED |
+		      E1000_STATUS_PCI66,
+		      e1000_bus_speed_values, "33MHz",
+		      e1000_82543, e1000_82547_rev_2),
+	REGS_BOOL_MAC("Bus width", E1000_STATUS_BUS64, "32-bit", "64-bit",
+		      e1000_82543, e1000_82547_rev_2),
+	{ NULL }
+};
+
+static const struct regs_desc_value e1000_rdmts_values[] = {
+	{ 0, E1000_RCTL_RDMTS_HALF, "1/2" },
+	{ 0, E1000_RCTL_RDMTS_QUAT, "1/4" },
+	{ 0, E1000_RCTL_RDMTS_EIGTH, "1/8" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value e1000_buffer_size_values[] = {
+	{ 0, E1000_RCTL_BSEX | E1000_RCTL_SZ_16384, "16384" },
+	{ 0, E1000_RCTL_BSEX | E1000_RCTL_SZ_8192, "8192" },
+	{ 0, E1000_RCTL_BSEX | E1000_RCTL_SZ_4096, "4096" },
+	{ 0, E1000_RCTL_SZ_2048, "2048" },
+	{ 0, E1000_RCTL_SZ_1024, "1024" },
+	{ 0, E1000_RCTL_SZ_512, "512" },
+	{ 0, E1000_RCTL_SZ_256, "256" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field e1000_rctl_fields[] = {
+	REGS_BOOL("Receiver", E1000_RCTL_EN, "disabled", "enabled"),
+	REGS_BOOL("Store bad packets", E1000_RCTL_SBP, "disabled", "enabled"),
+	REGS_BOOL("Unicast promiscuous", E1000_RCTL_UPE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Multicast promiscuous", E1000_RCTL_MPE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Long packet", E1000_RCTL_LPE, "disabled", "enabled"),
+	REGS_ENUM("Descriptor minimum threshold size", E1000_RCTL_RDMTS,
+		  e1000_rdmts_values, "reserved"),
+	REGS_BOOL("Broadcast accept mode", E1000_RCTL_BAM, "ignore", "accept"),
+	REGS_BOOL("VLAN filter", E1000_RCTL_VFE, "disabled", "enabled"),
+	REGS_BOOL("Canonical form indicator", E1000_RCTL_CFIEN,
+		  "disabled", "enabled"),
+	REGS_BOOL("Discard pause frames", E1000_RCTL_DPF,
+		  "filtered", "ignored"),
+	REGS_BOOL("Pass MAC control frames", E1000_RCTL_PMCF,
+		  "don't pass", "pass"),
+	/* Only later MACs have the buffer size extension */
+	REGS_ENUM_MAC("Receive buffer size", E1000_RCTL_BSEX | E1000_RCTL_SZ,
+		      e1000_buffer_size_values, "reserved", e1000_82543, 0),
+	REGS_ENUM_MAC("Receive buffer size", E1000_RCTL_SZ,
+		      e1000_buffer_size_values + 3, "256", 0, e1000_82542),
+	{ NULL }
+};
+
+static const struct regs_desc_field e1000_tctl_fields[] = {
+	REGS_BOOL("Transmitter", E1000_TCTL_EN, "disabled", "enabled"),
+	REGS_BOOL("Pad short packets", E1000_TCTL_PSP, "disabled", "enabled"),
+	REGS_BOOL("Software XOFF Transmission", E1000_TCTL_SWXOFF,
+		  "disabled", "enabled"),
+	REGS_BOOL_MAC("Re-transmit on late collision", E1000_TCTL_RTLC,
+		      "disabled", "enabled", e1000_82543, 0),
+	{ NULL }
+};
+
+static const struct regs_desc_value e1000_phy_type_values[] = {
+	{ 0, 0, "M88" },
+	{ 0, 1, "IGP" },
+	{ 0, 2, "IGP2" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value m88_cable_length_values[] = {
+	{ 0, M88_PSSR_CL_0_50, "0-50" },
+	{ 0, M88_PSSR_CL_50_80, "50-80" },
+	{ 0, M88_PSSR_CL_80_110, "80-110" },
+	{ 0, M88_PSSR_CL_110_140, "110-140" },
+	{ 0, M88_PSSR_CL_140_PLUS, "140+" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value m88_speed_values[] = {
+	{ 0, M88_PSSR_10MBS, "10" },
+	{ 0, M88_PSSR_100MBS, "100" },
+	{ 0, M88_PSSR_1000MBS, "1000" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field m88_pssr_fields[] = {
+	REGS_BOOL("Jabber", M88_PSSR_JABBER, "no", "yes"),
+	REGS_BOOL("Polarity", M88_PSSR_REV_POLARITY, "normal", "reverse"),
+	REGS_BOOL("Downshifted", M88_PSSR_DOWNSHIFT, "no", "yes"),
+	REGS_BOOL("MDI/MDIX", M88_PSSR_MDIX, "MDI", "MDIX"),
+	{ .label = "Cable Length Estimate", .mask = M88_PSSR_CABLE_LENGTH,
+	  .format = REGS_FIELD_ENUM, .values = m88_cable_length_values,
+	  .text = { "unknown" }, .unit = " meters" },
+	REGS_BOOL("Link State", M88_PSSR_LINK, "Down", "Up"),
+	REGS_BOOL("Speed & Duplex Resolved", M88_PSSR_SPD_DPLX_RESOLVED,
+		  "No", "Yes"),
+	REGS_BOOL("Page Received", M88_PSSR_PAGE_RCVD, "No", "Yes"),
+	REGS_BOOL("Duplex", M88_PSSR_DPLX, "Half", "Full"),
+	{ .label = "Speed", .mask = M88_PSSR_SPEED,
+	  .format = REGS_FIELD_ENUM, .values = m88_speed_values,
+	  .text = { "unknown" }, .unit = " mbps" },
+	{ NULL }
+};
+
+static const struct regs_desc_value m88_mdi_values[] = {
+	{ 0, M88_PSCR_MDI_MANUAL_MODE, "force MDI" },
+	{ 0, M88_PSCR_MDIX_MANUAL_MODE, "force MDIX" },
+	{ 0, M88_PSCR_AUTO_X_1000T, "1000 auto, 10/100 MDI" },
+	{ 0, M88_PSCR_AUTO_X_MODE, "auto" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field m88_pscr_fields[] = {
+	REGS_BOOL("Jabber function", M88_PSCR_JABBER_DISABLE,
+		  "enabled", "disabled"),
+	REGS_BOOL("Auto-polarity", M88_PSCR_POLARITY_REVERSAL,
+		  "disabled", "enabled"),
+	REGS_BOOL("SQE Test", M88_PSCR_SQE_TEST, "disabled", "enabled"),
+	REGS_BOOL("CLK125", M88_PSCR_CLK125_DISABLE, "enabled", "disabled"),
+	REGS_ENUM("Auto-MDIX", M88_PSCR_MDI_MASK, m88_mdi_values, "wtf"),
+	REGS_BOOL("Extended 10Base-T Distance", M88_PSCR_10BT_EXT_DIST_ENABLE,
+		  "disabled", "enabled"),
+	REGS_BOOL("100Base-TX Interface", M88_PSCR_MII_5BIT_ENABLE,
+		  "MII", "5-bit"),
+	REGS_BOOL("Scrambler", M88_PSCR_SCRAMBLER_DISABLE,
+		  "enabled", "disabled"),
+	REGS_BOOL("Force Link Good", M88_PSCR_FORCE_LINK_GOOD,
+		  "disabled", "forced"),
+	REGS_BOOL("Assert CRS on Transmit", M88_PSCR_ASSERT_CRS_ON_TX,
+		  "disabled", "enabled"),
+	{ NULL }
+};
+
+/* Word 12 of the dump is the PHY type, followed by PHY registers */
+#define E1000_PHY_TYPE_WORD	12
+
+static const struct regs_desc_reg e1000_regs[] = {
+	REGS_DECODE("CTRL", "Device control register", 0x00000, 0,
+		    e1000_ctrl_fields),
+	REGS_DECODE("STATUS", "Device status register", 0x00008, 1,
+		    e1000_status_fields),
+	REGS_DECODE("RCTL", "Receive control register", 0x00100, 2,
+		    e1000_rctl_fields),
+
+	/* Receive descriptor registers */
+	REGS_REG("RDLEN", "Receive desc length", 0x02808, 3),
+	REGS_REG("RDH", "Receive desc head", 0x02810, 4),
+	REGS_REG("RDT", "Receive desc tail", 0x02818, 5),
+	REGS_REG("RDTR", "Receive delay timer", 0x02820, 6),
+
+	REGS_DECODE("TCTL", "Transmit ctrl register", 0x00400, 7,
+		    e1000_tctl_fields),
+
+	/* Transmit descriptor registers */
+	REGS_REG("TDLEN", "Transmit desc length", 0x03808, 8),
+	REGS_REG("TDH", "Transmit desc head", 0x03810, 9),
+	REGS_REG("TDT", "Transmit desc tail", 0x03818, 10),
+	REGS_REG("TIDV", "Transmit delay timer", 0x03820, 11),
+
+	{ .name = "PHY_TYPE", .desc = "PHY type", .addr = REGS_DESC_NO_ADDR,
+	  .word = E1000_PHY_TYPE_WORD, .values = e1000_phy_type_values,
+	  .fallback = "unknown" },
+	{ .name = "M88_PSSR", .desc = "M88 PHY STATUS REGISTER",
+	  .addr = REGS_DESC_NO_ADDR, .word = 13, .fields = m88_pssr_fields,
+	  .dep_word = E1000_PHY_TYPE_WORD, .dep_mask = 0xffffffff,
+	  .dep_value = 0 },
+	{ .name = "M88_PSCR", .desc = "M88 PHY CONTROL REGISTER",
+	  .addr = REGS_DESC_NO_ADDR, .word = 17, .fields = m88_pscr_fields,
+	  .dep_word = E1000_PHY_TYPE_WORD, .dep_mask = 0xffffffff,
+	  .dep_value = 0 },
+};
+
+static const struct regs_desc_table e1000_regs_table = {
+	.title = "MAC Registers",
+	.regs = e1000_regs,
+	.n_regs = ARRAY_SIZE(e1000_regs),
+	.name_width = 5,
+	.value_col = 41,
+	.field_indent = 6,
+};
+
+int e1000_describe_regs(struct ethtool_drvinfo *info maybe_unused,
+			struct ethtool_regs *regs, struct regs_desc *desc)
 {
-	u32 *regs_buff = (u32 *)regs->data;
 	u16 hw_device_id = (u16)regs->version;
 	/* u8 hw_revision_id = (u8)(regs->version >> 16); */
 	u8 version = (u8)(regs->version >> 24);
 	enum e1000_mac_type mac_type;
-	u32 reg;
 
 	if (version != 1)
 		return -1;
@@ -381,260 +626,7 @@ int e1000_dump_regs(struct ethtool_drvinfo *info maybe_unused,
 	if(mac_type == e1000_undefined)
 		return -1;
 
-	fprintf(stdout, "MAC Registers\n");
-	fprintf(stdout, "-------------\n");
-
-	/* Device control register */
-	reg = regs_buff[0];
-	fprintf(stdout,
-		"0x00000: CTRL (Device control register)  0x%08X\n"
-		"      Endian mode (buffers):             %s\n"
-		"      Link reset:                        %s\n"
-		"      Set link up:                       %s\n"
-		"      Invert Loss-Of-Signal:             %s\n"
-		"      Receive flow control:              %s\n"
-		"      Transmit flow control:             %s\n"
-		"      VLAN mode:                         %s\n",
-		reg,
-		reg & E1000_CTRL_BEM    ? "big"      : "little",
-		reg & E1000_CTRL_LRST   ? "reset"    : "normal",
-		reg & E1000_CTRL_SLU    ? "1"        : "0",
-		reg & E1000_CTRL_ILOS   ? "yes"      : "no",
-		reg & E1000_CTRL_RFCE   ? "enabled"  : "disabled",
-		reg & E1000_CTRL_TFCE   ? "enabled"  : "disabled",
-		reg & E1000_CTRL_VME    ? "enabled"  : "disabled");
-	if(mac_type >= e1000_82543) {
-	fprintf(stdout,
-		"      Auto speed detect:                 %s\n"
-		"      Speed select:                      %s\n"
-		"      Force speed:                       %s\n"
-		"      Force duplex:                      %s\n",
-		reg & E1000_CTRL_ASDE   ? "enabled"  : "disabled",
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_10   ? "10Mb/s"   :
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_100  ? "100Mb/s"  :
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_1000 ? "1000Mb/s" :
-		"not used",
-		reg & E1000_CTRL_FRCSPD ? "yes"      : "no",
-		reg & E1000_CTRL_FRCDPX ? "yes"      : "no");
-	}
-
-	/* Device status register */
-	reg = regs_buff[1];
-	fprintf(stdout,
-		"0x00008: STATUS (Device status register) 0x%08X\n"
-		"      Duplex:                            %s\n"
-		"      Link up:                           %s\n",
-		reg,
-		reg & E1000_STATUS_FD      ? "full"        : "half",
-		reg & E1000_STATUS_LU      ? "link config" : "no link config");
-	if (mac_type >= e1000_82571) {
-	fprintf(stdout,
-		"      TBI mode:                          %s\n"
-		"      Link speed:                        %s\n"
-		"      Bus type:                          %s\n"
-		"      Port number:                       %s\n",
-		reg & E1000_STATUS_TBIMODE ? "enabled"     : "disabled",
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_10   ?
-		"10Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_100  ?
-		"100Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_1000 ?
-		"1000Mb/s" : "not used",
-		"PCI Express",
-		(reg & E1000_STATUS_FUNC_MASK) == 0 ? "0" : "1");
-	}
-	else if (mac_type >= e1000_82543) {
-	fprintf(stdout,
-		"      TBI mode:                          %s\n"
-		"      Link speed:                        %s\n"
-		"      Bus type:                          %s\n"
-		"      Bus speed:                         %s\n"
-		"      Bus width:                         %s\n",
-		reg & E1000_STATUS_TBIMODE ? "enabled"     : "disabled",
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_10   ?
-		"10Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_100  ?
-		"100Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_1000 ?
-		"1000Mb/s" : "not used",
-		(reg & E1000_STATUS_PCIX_MODE) ? "PCI-X" : "PCI",
-		(reg & E1000_STATUS_PCIX_MODE) ?
-			((reg & E1000_STATUS_PCIX_SPEED_133) ? "133MHz" :
-			(reg & E1000_STATUS_PCIX_SPEED_100) ? "100MHz" :
-			"66MHz")	       :
-			((reg & E1000_STATUS_PCI66) ? "66MHz" : "33MHz"),
-		(reg & E1000_STATUS_BUS64) ? "64-bit" : "32-bit");
-	}
-
-	/* Receive control register */
-	reg = regs_buff[2];
-	fprintf(stdout,
-		"0x00100: RCTL (Receive control register) 0x%08X\n"
-		"      Receiver:                          %s\n"
-		"      Store bad packets:                 %s\n"
-		"      Unicast promiscuous:               %s\n"
-		"      Multicast promiscuous:             %s\n"
-		"      Long packet:                       %s\n"
-		"      Descriptor minimum threshold size: %s\n"
-		"      Broadcast accept mode:             %s\n"
-		"      VLAN filter:                       %s\n"
-		"      Canonical form indicator:          %s\n"
-		"      Discard pause frames:              %s\n"
-		"      Pass MAC control frames:           %s\n",
-		reg,
-		reg & E1000_RCTL_EN      ? "enabled"  : "disabled",
-		reg & E1000_RCTL_SBP     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_UPE     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_MPE     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_LPE     ? "enabled"  : "disabled",
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_HALF  ? "1/2" :
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_QUAT  ? "1/4" :
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_EIGTH ? "1/8" :
-		"reserved",
-		reg & E1000_RCTL_BAM     ? "accept"   : "ignore",
-		reg & E1000_RCTL_VFE     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_CFIEN   ? "enabled"  : "disabled",
-		reg & E1000_RCTL_DPF     ? "ignored"  : "filtered",
-		reg & E1000_RCTL_PMCF    ? "pass"     : "don't pass");
-	if(mac_type >= e1000_82543) {
-	fprintf(stdout,
-		"      Receive buffer size:               %s\n",
-		reg & E1000_RCTL_BSEX    ?
-			((reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_16384 ? "16384" :
-			 (reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_8192  ? "8192"  :
-			 (reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_4096  ? "4096"  :
-			 "reserved")     :
-			((reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_2048  ? "2048"  :
-			 (reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_1024  ? "1024"  :
-			 (reg & E1000_RCTL_SZ)==E1000_RCTL_SZ_512   ? "512"   :
-			 "256"));
-	} else {
-	fprintf(stdout,
-		"      Receive buffer size:               %s\n",
-		(reg & E1000_RCTL_SZ) == E1000_RCTL_SZ_2048  ? "2048"  :
-		(reg & E1000_RCTL_SZ) == E1000_RCTL_SZ_1024  ? "1024"  :
-		(reg & E1000_RCTL_SZ) == E1000_RCTL_SZ_512   ? "512"   :
-		"256");
-	}
-
-	/* Receive descriptor registers */
-	fprintf(stdout,
-		"0x02808: RDLEN (Receive desc length)     0x%08X\n",
-		regs_buff[3]);
-	fprintf(stdout,
-		"0x02810: RDH   (Receive desc head)       0x%08X\n",
-		regs_buff[4]);
-	fprintf(stdout,
-		"0x02818: RDT   (Receive desc tail)       0x%08X\n",
-		regs_buff[5]);
-	fprintf(stdout,
-		"0x02820: RDTR  (Receive delay timer)     0x%08X\n",
-		regs_buff[6]);
-
-	/* Transmit control register */
-	reg = regs_buff[7];
-	fprintf(stdout,
-		"0x00400: TCTL (Transmit ctrl register)   0x%08X\n"
-		"      Transmitter:                       %s\n"
-		"      Pad short packets:                 %s\n"
-		"      Software XOFF Transmission:        %s\n",
-		reg,
-		reg & E1000_TCTL_EN      ? "enabled"  : "disabled",
-		reg & E1000_TCTL_PSP     ? "enabled"  : "disabled",
-		reg & E1000_TCTL_SWXOFF  ? "enabled"  : "disabled");
-	if(mac_type >= e1000_82543) {
-	fprintf(stdout,
-		"      Re-transmit on late collision:     %s\n",
-		reg & E1000_TCTL_RTLC    ? "enabled"  : "disabled");
-	}
-
-	/* Transmit descriptor registers */
-	fprintf(stdout,
-		"0x03808: TDLEN (Transmit desc length)    0x%08X\n",
-		regs_buff[8]);
-	fprintf(stdout,
-		"0x03810: TDH   (Transmit desc head)      0x%08X\n",
-		regs_buff[9]);
-	fprintf(stdout,
-		"0x03818: TDT   (Transmit desc tail)      0x%08X\n",
-		regs_buff[10]);
-	fprintf(stdout,
-		"0x03820: TIDV  (Transmit delay timer)    0x%08X\n",
-		regs_buff[11]);
-
-	/* PHY type */
-	fprintf(stdout,
-		"PHY type:                                %s\n",
-		regs_buff[12] == 0 ? "M88" :
-		regs_buff[12] == 1 ? "IGP" :
-		regs_buff[12] == 2 ? "IGP2" : "unknown" );
-
-	if (0 == regs_buff[12]) {
-		reg = regs_buff[13];
-		fprintf(stdout,
-			"M88 PHY STATUS REGISTER:                 0x%08X\n"
-			"      Jabber:                            %s\n"
-			"      Polarity:                          %s\n"
-			"      Downshifted:                       %s\n"
-			"      MDI/MDIX:                          %s\n"
-			"      Cable Length Estimate:             %s meters\n"
-			"      Link State:                        %s\n"
-			"      Speed & Duplex Resolved:           %s\n"
-			"      Page Received:                     %s\n"
-			"      Duplex:                            %s\n"
-			"      Speed:                             %s mbps\n",
-			reg,
-			reg & M88_PSSR_JABBER       ? "yes"     : "no",
-			reg & M88_PSSR_REV_POLARITY ? "reverse" : "normal",
-			reg & M88_PSSR_DOWNSHIFT    ? "yes"     : "no",
-			reg & M88_PSSR_MDIX         ? "MDIX"    : "MDI",
-			((reg & M88_PSSR_CABLE_LENGTH)==M88_PSSR_CL_0_50 ? "0-50"
-				: (reg & M88_PSSR_CABLE_LENGTH)==M88_PSSR_CL_50_80 ? "50-80"
-				: (reg & M88_PSSR_CABLE_LENGTH)==M88_PSSR_CL_80_110 ? "80-110"
-				: (reg & M88_PSSR_CABLE_LENGTH)==M88_PSSR_CL_110_140? "110-140"
-				: (reg & M88_PSSR_CABLE_LENGTH)==M88_PSSR_CL_140_PLUS ? "140+"
-				: "unknown"),
-			reg & M88_PSSR_LINK              ? "Up"      : "Down",
-			reg & M88_PSSR_SPD_DPLX_RESOLVED ? "Yes"     : "No",
-			reg & M88_PSSR_PAGE_RCVD         ? "Yes"     : "No",
-			reg & M88_PSSR_DPLX              ? "Full"    : "Half",
-			((reg & M88_PSSR_SPEED)==M88_PSSR_10MBS        ? "10"
-				: (reg & M88_PSSR_SPEED)==M88_PSSR_100MBS  ? "100"
-				: (reg & M88_PSSR_SPEED)==M88_PSSR_1000MBS ? "1000"
-				: "unknown")
-		);
-
-		reg = regs_buff[17];
-		fprintf(stdout,
-			"M88 PHY CONTROL REGISTER:                0x%08X\n"
-			"      Jabber function:                   %s\n"
-			"      Auto-polarity:                     %s\n"
-			"      SQE Test:                          %s\n"
-			"      CLK125:                            %s\n"
-			"      Auto-MDIX:                         %s\n"
-			"      Extended 10Base-T Distance:        %s\n"
-			"      100Base-TX Interface:              %s\n"
-			"      Scrambler:                         %s\n"
-			"      Force Link Good:                   %s\n"
-			"      Assert CRS on Transmit:            %s\n",
-			reg,
-			reg & M88_PSCR_JABBER_DISABLE    ? "disabled" : "enabled",
-			reg & M88_PSCR_POLARITY_REVERSAL ? "enabled"  : "disabled",
-			reg & M88_PSCR_SQE_TEST          ? "enabled"  : "disabled",
-			reg & M88_PSCR_CLK125_DISABLE    ? "disabled" : "enabled",
-			((reg & M88_PSCR_MDI_MASK)==M88_PSCR_MDI_MANUAL_MODE ? "force MDI"
-				: (reg & M88_PSCR_MDI_MASK)==M88_PSCR_MDIX_MANUAL_MODE ? "force MDIX"
-				: (reg & M88_PSCR_MDI_MASK)==M88_PSCR_AUTO_X_1000T ? "1000 auto, 10/100 MDI"
-				: (reg & M88_PSCR_MDI_MASK)==M88_PSCR_AUTO_X_MODE ? "auto"
-				: "wtf"),
-			reg & M88_PSCR_10BT_EXT_DIST_ENABLE ? "enabled" : "disabled",
-			reg & M88_PSCR_MII_5BIT_ENABLE ? "5-bit" : "MII",
-			reg & M88_PSCR_SCRAMBLER_DISABLE ? "disabled" : "enabled",
-			reg & M88_PSCR_FORCE_LINK_GOOD ? "forced" : "disabled",
-			reg & M88_PSCR_ASSERT_CRS_ON_TX ? "enabled" : "disabled"
-		);
-	}
-
+	desc->table = &e1000_regs_table;
+	desc->mac = mac_type;
 	return 0;
 }
-
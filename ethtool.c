@@ -30,6 +30,12 @@
  */
 
 #include "internal.h"
+#include "libethtool.h"
+#include "regs-desc.h"
+#include "netlink.h"
+#ifdef ETHTOOL_ENABLE_PRETTY_DUMP
+#include "sff-common.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -40,13 +46,26 @@
 #include <sys/utsname.h>
 #include <limits.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <dirent.h>
+#include <poll.h>
+#include <stdarg.h>
 
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
 #include <linux/sockios.h>
 #include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 #ifndef MAX_ADDR_LEN
 #define MAX_ADDR_LEN	32
@@ -196,7 +215,9 @@ struct feature_defs {
 	size_t n_features;
 	/* Number of features each offload flag is associated with */
 	unsigned int off_flag_matched[ARRAY_SIZE(off_flag_def)];
-	/* Name and offload flag index for each feature */
+	/* Name and offload flag index for each feature, followed by
+	 * the name index (see feature_name_index())
+	 */
 	struct feature_def def[0];
 };
 
@@ -1186,18 +1207,26 @@ static int parse_hkey(char **rss_hkey, u32 key_size,
 static const struct {
 	const char *name;
 	int (*func)(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
-
+	/* Drivers described by a table instead of a dump function */
+	int (*describe)(struct ethtool_drvinfo *info,
+			struct ethtool_regs *regs, struct regs_desc *desc);
+	/* Drivers whose dump functions can print selected tables */
+	int (*tables)(struct ethtool_drvinfo *info, struct ethtool_regs *regs,
+		      const struct regs_table_filter *filter);
+	/* Drivers that can lay the dumps of several ports side by side */
+	int (*ports)(struct ethtool_drvinfo *info, struct ethtool_regs **regs,
+		     const char *const *names, unsigned int n, int colour);
 } driver_list[] = {
 #ifdef ETHTOOL_ENABLE_PRETTY_DUMP
 	{ "8139cp", realtek_dump_regs },
 	{ "8139too", realtek_dump_regs },
 	{ "r8169", realtek_dump_regs },
 	{ "de2104x", de2104x_dump_regs },
-	{ "e1000", e1000_dump_regs },
-	{ "e1000e", e1000_dump_regs },
-	{ "igb", igb_dump_regs },
+	{ "e1000", NULL, e1000_describe_regs },
+	{ "e1000e", NULL, e1000_describe_regs },
+	{ "igb", NULL, igb_describe_regs },
 	{ "ixgb", ixgb_dump_regs },
-	{ "ixgbe", ixgbe_dump_regs },
+	{ "ixgbe", NULL, ixgbe_describe_regs },
 	{ "ixgbevf", ixgbevf_dump_regs },
 	{ "natsemi", natsemi_dump_regs },
 	{ "e100", e100_dump_regs },
@@ -1211,7 +1240,7 @@ static const struct {
 	{ "vioc", vioc_dump_regs },
 	{ "smsc911x", smsc911x_dump_regs },
 	{ "at76c50x-usb", at76c50x_usb_dump_regs },
-	{ "sfc", sfc_dump_regs },
+	{ "sfc", sfc_dump_regs, NULL, sfc_dump_regs_tables },
 	{ "st_mac100", st_mac100_dump_regs },
 	{ "st_gmac", st_gmac_dump_regs },
 	{ "et131x", et131x_dump_regs },
@@ -1219,41 +1248,177 @@ static const struct {
 	{ "vmxnet3", vmxnet3_dump_regs },
 	{ "fjes", fjes_dump_regs },
 	{ "lan78xx", lan78xx_dump_regs },
-	{ "dsa", dsa_dump_regs },
+	{ "dsa", dsa_dump_regs, NULL, NULL, dsa_dump_regs_ports },
 	{ "fec", fec_dump_regs },
 #endif
 };
 
-void dump_hex(FILE *file, const u8 *data, int len, int offset)
+#define DUMP_HEX_BUF_LEN	16384
+#define DUMP_HEX_ROW_MAX	128
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Format one row of up to 16 bytes and return its length */
+static size_t dump_hex_row(char *out, const u8 *data, int n,
+			   unsigned int addr, unsigned int flags)
 {
+	char *p = out;
+	int digits = 4;
 	int i;
 
-	fprintf(file, "Offset\t\tValues\n");
-	fprintf(file, "------\t\t------");
-	for (i = 0; i < len; i++) {
-		if (i % 16 == 0)
-			fprintf(file, "\n0x%04x:\t\t", i + offset);
-		fprintf(file, "%02x ", data[i]);
+	while (digits < 8 && addr >> (4 * digits))
+		digits++;
+	*p++ = '\n';
+	*p++ = '0';
+	*p++ = 'x';
+	while (digits--)
+		*p++ = hex_digits[(addr >> (4 * digits)) & 0xf];
+	*p++ = ':';
+	*p++ = '\t';
+	*p++ = '\t';
+	for (i = 0; i < n; i++) {
+		*p++ = hex_digits[data[i] >> 4];
+		*p++ = hex_digits[data[i] & 0xf];
+		*p++ = ' ';
+	}
+
+	if (flags & DUMP_HEX_ASCII) {
+		for (; i < 16; i++) {
+			*p++ = ' ';
+			*p++ = ' ';
+			*p++ = ' ';
+		}
+		*p++ = ' ';
+		*p++ = '|';
+		for (i = 0; i < n; i++)
+			*p++ = data[i] >= 0x20 && data[i] < 0x7f ?
+				data[i] : '.';
+		*p++ = '|';
+	}
+	return p - out;
+}
+
+/*
+ * Rows are formatted into a local buffer that is written out in large
+ * chunks, so that dumping a big EEPROM or register space costs a few
+ * writes rather than a stdio call per byte.
+ */
+void dump_hex_fmt(FILE *file, const u8 *data, int len, int offset,
+		  unsigned int flags)
+{
+	char buf[DUMP_HEX_BUF_LEN];
+	size_t pos = 0;
+	int squeezed = 0;
+	int i, n;
+
+	fputs("Offset\t\tValues\n", file);
+	fputs("------\t\t------", file);
+	for (i = 0; i < len; i += 16) {
+		n = len - i < 16 ? len - i : 16;
+		/* Like hexdump, but always show the last row */
+		if ((flags & DUMP_HEX_SQUEEZE) && i && n == 16 &&
+		    len - i > 16 && !memcmp(data + i, data + i - 16, 16)) {
+			if (!squeezed) {
+				buf[pos++] = '\n';
+				buf[pos++] = '*';
+			}
+			squeezed = 1;
+		} else {
+			squeezed = 0;
+			pos += dump_hex_row(buf + pos, data + i, n,
+					    i + offset, flags);
+		}
+		if (pos > sizeof(buf) - DUMP_HEX_ROW_MAX) {
+			fwrite(buf, 1, pos, file);
+			pos = 0;
+		}
 	}
-	fprintf(file, "\n");
+	buf[pos++] = '\n';
+	fwrite(buf, 1, pos, file);
+}
+
+void dump_hex(FILE *file, const u8 *data, int len, int offset)
+{
+	dump_hex_fmt(file, data, len, offset, 0);
+}
+
+/* Look up the register description of a driver with a table */
+static int regs_describe(struct ethtool_drvinfo *info,
+			 struct ethtool_regs *regs, struct regs_desc *desc)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(driver_list); i++)
+		if (!strncmp(driver_list[i].name, info->driver,
+			     ETHTOOL_BUSINFO_LEN))
+			return driver_list[i].describe ?
+				driver_list[i].describe(info, regs, desc) : -1;
+	return -1;
+}
+
+static void dump_regs_json(struct ethtool_drvinfo *info,
+			   struct ethtool_regs *regs)
+{
+	const u32 *words = (const u32 *)regs->data;
+	u32 i;
+
+	fprintf(stdout, "{\"driver\": ");
+	regs_json_string(stdout, info->driver);
+	fprintf(stdout, ", \"registers\": [");
+	for (i = 0; i < regs->len / 4; i++)
+		fprintf(stdout, "%s\n    {\"offset\": %u, \"value\": %u}",
+			i ? "," : "", i * 4, words[i]);
+	fprintf(stdout, "\n]}\n");
 }
 
-static int dump_regs(int gregs_dump_raw, int gregs_dump_hex,
-		     struct ethtool_drvinfo *info, struct ethtool_regs *regs)
+struct regs_dump_opts {
+	int raw;
+	int hex;
+	unsigned int hex_flags;
+	const char *split;	/* per-segment output file name prefix */
+	const struct regs_desc_opts *desc;
+	const struct regs_table_filter *filter;	/* or NULL */
+};
+
+/* Decode one register dump, leaving out any nested dumps */
+static int dump_regs_one(const struct regs_dump_opts *dopts,
+			 struct ethtool_drvinfo *info,
+			 struct ethtool_regs *regs)
 {
+	const struct regs_desc_opts *opts = dopts->desc;
+	struct regs_desc desc;
 	int i;
 
-	if (gregs_dump_raw) {
-		fwrite(regs->data, regs->len, 1, stdout);
-		goto nested;
+	if (dopts->filter) {
+		for (i = 0; i < ARRAY_SIZE(driver_list); i++)
+			if (!strncmp(driver_list[i].name, info->driver,
+				     ETHTOOL_BUSINFO_LEN) &&
+			    driver_list[i].tables)
+				return driver_list[i].tables(info, regs,
+							     dopts->filter);
+		fprintf(stderr, "Cannot select register tables: driver %s "
+			"has none\n", info->driver);
+		return -1;
+	}
+	if (!dopts->hex && !regs_describe(info, regs, &desc))
+		return regs_desc_dump(&desc, info, regs, opts);
+	if (opts->n_select) {
+		fprintf(stderr, "Cannot select registers: no register "
+			"description for driver %s\n", info->driver);
+		return -1;
+	}
+	if (opts->json) {
+		dump_regs_json(info, regs);
+		return 0;
 	}
 
-	if (!gregs_dump_hex)
+	if (!dopts->hex)
 		for (i = 0; i < ARRAY_SIZE(driver_list); i++)
 			if (!strncmp(driver_list[i].name, info->driver,
 				     ETHTOOL_BUSINFO_LEN)) {
-				if (driver_list[i].func(info, regs) == 0)
-					goto nested;
+				if (driver_list[i].func &&
+				    driver_list[i].func(info, regs) == 0)
+					return 0;
 				/* This version (or some other
 				 * variation in the dump format) is
 				 * not handled; fall back to hex
@@ -1261,21 +1426,431 @@ static int dump_regs(int gregs_dump_raw, int gregs_dump_hex,
 				break;
 			}
 
-	dump_hex(stdout, regs->data, regs->len, 0);
+	dump_hex_fmt(stdout, regs->data, regs->len, 0, dopts->hex_flags);
+	return 0;
+}
+
+struct regs_segment {
+	struct ethtool_drvinfo *info;
+	struct ethtool_regs *regs;
+};
+
+/*
+ * Some drivers append the dumps of other functions to their own (a DSA
+ * switch port behind its master, say), each behind its own drvinfo
+ * and regs structures.  List the segments of a dump whose data area is
+ * @size bytes, stopping at a header or dump that would not fit.  With
+ * a NULL @segs, just count them.
+ */
+static unsigned int regs_segments(struct ethtool_drvinfo *info,
+				  struct ethtool_regs *regs, u32 size,
+				  struct regs_segment *segs)
+{
+	const size_t hdr_len = sizeof(*info) + sizeof(*regs);
+	u8 *end = regs->data + size;
+	unsigned int n = 0;
+
+	for (;;) {
+		if (segs) {
+			segs[n].info = info;
+			segs[n].regs = regs;
+		}
+		n++;
+		if (info->regdump_len <= regs->len + hdr_len ||
+		    (size_t)(end - regs->data) < regs->len + hdr_len)
+			break;
+		info = (struct ethtool_drvinfo *)(regs->data + regs->len);
+		regs = (struct ethtool_regs *)(regs->data + regs->len +
+					       sizeof(*info));
+		if ((size_t)(end - regs->data) < regs->len)
+			break;
+	}
+	return n;
+}
+
+static int regs_copy_out(FILE *from)
+{
+	char buf[65536];
+	size_t len;
+
+	rewind(from);
+	while ((len = fread(buf, 1, sizeof(buf), from)) > 0)
+		if (fwrite(buf, 1, len, stdout) != len)
+			return -1;
+	return ferror(from) ? -1 : 0;
+}
+
+/*
+ * Decode each segment in a child process with stdout sent to its own
+ * file, as many at once as there are CPUs, then copy the results out
+ * in order unless they are to be kept in separate files.  Decoders
+ * print straight to stdout, so it takes processes rather than threads
+ * to keep their output apart.
+ */
+static int dump_regs_parallel(const struct regs_dump_opts *dopts,
+			      const struct regs_segment *segs,
+			      unsigned int n)
+{
+	long max_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int next = 0, running = 0, i;
+	char name[PATH_MAX];
+	FILE **out;
+	pid_t *pids, pid;
+	int status, err = 0;
+
+	/* sysconf() fails with -1 where the CPUs cannot be counted */
+	if (max_jobs < 1)
+		max_jobs = 1;
+	out = calloc(n, sizeof(*out));
+	pids = calloc(n, sizeof(*pids));
+	if (!out || !pids) {
+		perror("Cannot allocate memory for register dump");
+		err = -1;
+		goto out;
+	}
+	for (i = 0; i < n; i++) {
+		if (dopts->split) {
+			snprintf(name, sizeof(name), "%s.%u", dopts->split, i);
+			out[i] = fopen(name, "w+");
+		} else {
+			out[i] = tmpfile();
+		}
+		if (!out[i]) {
+			fprintf(stderr, "Cannot create output for register "
+				"dump %u: %s\n", i, strerror(errno));
+			err = -1;
+			goto out;
+		}
+	}
+
+	fflush(stdout);
+	while (next < n || running) {
+		if (next < n && running < max_jobs && !err) {
+			pid = fork();
+			if (pid == 0) {
+				dup2(fileno(out[next]), STDOUT_FILENO);
+				err = dump_regs_one(dopts, segs[next].info,
+						    segs[next].regs);
+				fflush(stdout);
+				_exit(err ? 1 : 0);
+			}
+			if (pid < 0) {
+				perror("Cannot start register decoder");
+				err = -1;
+				next = n;
+				continue;
+			}
+			pids[next++] = pid;
+			running++;
+			continue;
+		}
+		if (!running)
+			break;
+		pid = wait(&status);
+		if (pid < 0)
+			break;
+		running--;
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			err = -1;
+	}
+
+	for (i = 0; !dopts->split && i < n && !err; i++)
+		if (regs_copy_out(out[i]) < 0) {
+			perror("Cannot copy register dump");
+			err = -1;
+		}
+out:
+	for (i = 0; out && i < n; i++)
+		if (out[i])
+			fclose(out[i]);
+	free(out);
+	free(pids);
+	return err;
+}
+
+/* Below this, forking costs more than decoding the segments in turn */
+#define REGS_PARALLEL_MIN	(1 << 20)
+
+/* Decode a dump of @size bytes, which may have others nested in it */
+static int dump_regs(const struct regs_dump_opts *dopts,
+		     struct ethtool_drvinfo *info, struct ethtool_regs *regs,
+		     u32 size)
+{
+	struct regs_segment *segs;
+	unsigned int n, i;
+	int err;
+
+	n = regs_segments(info, regs, size, NULL);
+	segs = calloc(n, sizeof(*segs));
+	if (!segs) {
+		perror("Cannot allocate memory for register dump");
+		return -1;
+	}
+	regs_segments(info, regs, size, segs);
+	if (dopts->raw) {
+		for (i = 0; i < n; i++)
+			fwrite(segs[i].regs->data, segs[i].regs->len, 1,
+			       stdout);
+		err = 0;
+	} else if (dopts->split || (size >= REGS_PARALLEL_MIN &&
+				    sysconf(_SC_NPROCESSORS_ONLN) > 1)) {
+		err = dump_regs_parallel(dopts, segs, n);
+	} else {
+		for (i = 0, err = 0; i < n && !err; i++)
+			err = dump_regs_one(dopts, segs[i].info,
+					    segs[i].regs);
+	}
+	free(segs);
+	return err;
+}
+
+/* Register dump comparison */
+
+#define REGS_DIFF_BLOCK		64
+
+static u32 regs_word(const u8 *data, u32 len, u32 offset)
+{
+	u32 word = 0;
+
+	if (offset < len)
+		memcpy(&word, data + offset,
+		       len - offset < 4 ? len - offset : 4);
+	return word;
+}
+
+enum regs_diff_print {
+	REGS_DIFF_COUNT,
+	REGS_DIFF_TEXT,
+	REGS_DIFF_JSON,
+};
+
+/*
+ * Print the words that differ between two register dumps and return
+ * how many there are.  Identical blocks are skipped with memcmp(),
+ * which libc vectorises, so only the blocks containing a change are
+ * walked word by word.
+ */
+static unsigned int regs_diff_words(const u8 *old, const u8 *new, u32 len,
+				    enum regs_diff_print print)
+{
+	unsigned int changed = 0;
+	u32 block, offset, end;
+	u32 old_word, new_word;
+
+	if (print == REGS_DIFF_TEXT) {
+		fprintf(stdout, "Offset\t\tOld\t\tNew\t\tChanged bits\n");
+		fprintf(stdout, "------\t\t---\t\t---\t\t------------\n");
+	}
+	for (block = 0; block < len; block += REGS_DIFF_BLOCK) {
+		end = len - block < REGS_DIFF_BLOCK ?
+			len : block + REGS_DIFF_BLOCK;
+		if (!memcmp(old + block, new + block, end - block))
+			continue;
+		for (offset = block; offset < end; offset += 4) {
+			old_word = regs_word(old, end, offset);
+			new_word = regs_word(new, end, offset);
+			if (old_word == new_word)
+				continue;
+			if (print == REGS_DIFF_TEXT)
+				fprintf(stdout,
+					"0x%04x:\t\t0x%08x\t0x%08x\t0x%08x\n",
+					offset, old_word, new_word,
+					old_word ^ new_word);
+			else if (print == REGS_DIFF_JSON)
+				fprintf(stdout, "%s\n    {\"offset\": %u, "
+					"\"old\": %u, \"new\": %u}",
+					changed ? "," : "", offset,
+					old_word, new_word);
+			changed++;
+		}
+	}
+
+	return changed;
+}
+
+struct regs_text {
+	char *buf;
+	char **lines;
+	unsigned int n_lines;
+};
+
+/* Run the pretty-printer with stdout sent to a temporary file */
+static int regs_capture(int gregs_dump_hex, struct ethtool_drvinfo *info,
+			struct ethtool_regs *regs, struct regs_text *text)
+{
+	static const struct regs_desc_opts no_opts;
+	const struct regs_dump_opts dopts = {
+		.hex = gregs_dump_hex,
+		.desc = &no_opts,
+	};
+	FILE *tmp;
+	int saved_stdout;
+	long size;
+	unsigned int i;
+	char *p;
+	int err;
+
+	memset(text, 0, sizeof(*text));
+	tmp = tmpfile();
+	if (!tmp) {
+		perror("Cannot create temporary file");
+		return -1;
+	}
+	fflush(stdout);
+	saved_stdout = dup(STDOUT_FILENO);
+	if (saved_stdout < 0) {
+		perror("Cannot redirect register dump");
+		fclose(tmp);
+		return -1;
+	}
+	dup2(fileno(tmp), STDOUT_FILENO);
+	err = dump_regs(&dopts, info, regs, regs->len);
+	fflush(stdout);
+	dup2(saved_stdout, STDOUT_FILENO);
+	close(saved_stdout);
+	if (err < 0)
+		goto out;
+
+	size = lseek(fileno(tmp), 0, SEEK_END);
+	err = -1;
+	if (size < 0 || lseek(fileno(tmp), 0, SEEK_SET) < 0)
+		goto out;
+	text->buf = malloc(size + 1);
+	if (!text->buf)
+		goto out;
+	if (size && fread(text->buf, size, 1, tmp) != 1)
+		goto out;
+	text->buf[size] = 0;
+
+	for (p = text->buf; *p; p++)
+		if (*p == '\n')
+			text->n_lines++;
+	text->lines = calloc(text->n_lines + 1, sizeof(text->lines[0]));
+	if (!text->lines)
+		goto out;
+	for (i = 0, p = text->buf; i < text->n_lines; i++) {
+		text->lines[i] = p;
+		p = strchr(p, '\n');
+		*p++ = 0;
+	}
+	err = 0;
+out:
+	if (err < 0)
+		perror("Cannot capture register dump");
+	fclose(tmp);
+	return err;
+}
+
+static void regs_text_free(struct regs_text *text)
+{
+	free(text->lines);
+	free(text->buf);
+}
+
+static int regs_diff(int gregs_dump_hex, const struct regs_desc_opts *opts,
+		     struct ethtool_drvinfo *info,
+		     struct ethtool_regs *old, struct ethtool_regs *new)
+{
+	struct regs_desc_opts desc_opts = *opts;
+	struct regs_text old_text, new_text;
+	int colour = isatty(STDOUT_FILENO);
+	struct regs_desc desc;
+	unsigned int changed, i, header, shown = -1;
+	const char *line;
+	u32 len;
+	int pretty = 0;
+
+	len = old->len < new->len ? old->len : new->len;
+	if (old->len != new->len)
+		fprintf(stderr, "Register dumps differ in length "
+			"(%u and %u bytes), comparing the first %u\n",
+			old->len, new->len, len);
+
+	if (!gregs_dump_hex && !regs_describe(info, new, &desc)) {
+		/* Compare decoded fields straight from the tables */
+		changed = regs_diff_words(old->data, new->data, len,
+					  REGS_DIFF_COUNT);
+		desc_opts.colour = colour;
+		regs_desc_diff(&desc, info, old, new, &desc_opts);
+		goto out;
+	}
+	if (opts->n_select) {
+		fprintf(stderr, "Cannot select registers: no register "
+			"description for driver %s\n", info->driver);
+		return -1;
+	}
+	if (opts->json) {
+		fprintf(stdout, "{\"driver\": ");
+		regs_json_string(stdout, info->driver);
+		fprintf(stdout, ", \"changes\": [");
+		changed = regs_diff_words(old->data, new->data, len,
+					  REGS_DIFF_JSON);
+		fprintf(stdout, "\n]}\n");
+		goto out;
+	}
+
+	if (!gregs_dump_hex) {
+		for (i = 0; i < ARRAY_SIZE(driver_list); i++)
+			if (!strncmp(driver_list[i].name, info->driver,
+				     ETHTOOL_BUSINFO_LEN))
+				pretty = 1;
+	}
+	if (!pretty) {
+		changed = regs_diff_words(old->data, new->data, len,
+					  REGS_DIFF_TEXT);
+		goto out;
+	}
+
+	changed = regs_diff_words(old->data, new->data, len,
+				  REGS_DIFF_COUNT);
+	if (!changed)
+		goto out;
+
+	if (regs_capture(0, info, old, &old_text) < 0)
+		return -1;
+	if (regs_capture(0, info, new, &new_text) < 0) {
+		regs_text_free(&old_text);
+		return -1;
+	}
 
-nested:
-	/* Recurse dump if some drvinfo and regs structures are nested */
-	if (info->regdump_len > regs->len + sizeof(*info) + sizeof(*regs)) {
-		info = (struct ethtool_drvinfo *)(&regs->data[0] + regs->len);
-		regs = (struct ethtool_regs *)(&regs->data[0] + regs->len + sizeof(*info));
+	if (old_text.n_lines != new_text.n_lines) {
+		/* The decoded layouts do not line up; show raw words */
+		regs_diff_words(old->data, new->data, len, REGS_DIFF_TEXT);
+	} else {
+		for (i = 0; i < new_text.n_lines; i++) {
+			if (!strcmp(old_text.lines[i], new_text.lines[i]))
+				continue;
 
-		return dump_regs(gregs_dump_raw, gregs_dump_hex, info, regs);
+			/* Show the register a changed field belongs to */
+			for (header = i; header > 0; header--) {
+				line = new_text.lines[header];
+				if (!isspace((unsigned char)line[0]))
+					break;
+			}
+			if (header != i && header != shown)
+				fprintf(stdout, " %s\n",
+					new_text.lines[header]);
+			shown = header;
+
+			regs_diff_line('-', old_text.lines[i],
+				       new_text.lines[i],
+				       colour ? REGS_DIFF_OLD_COLOUR : NULL);
+			regs_diff_line('+', new_text.lines[i],
+				       old_text.lines[i],
+				       colour ? REGS_DIFF_NEW_COLOUR : NULL);
+		}
 	}
 
+	regs_text_free(&old_text);
+	regs_text_free(&new_text);
+out:
+	if (!opts->json)
+		fprintf(stdout, "%u of %u register words changed\n",
+			changed, (len + 3) / 4);
 	return 0;
 }
 
-static int dump_eeprom(int geeprom_dump_raw,
+static int dump_eeprom(int geeprom_dump_raw, unsigned int hex_flags,
 		       struct ethtool_drvinfo *info maybe_unused,
 		       struct ethtool_eeprom *ee)
 {
@@ -1290,7 +1865,7 @@ static int dump_eeprom(int geeprom_dump_raw,
 		return tg3_dump_eeprom(info, ee);
 	}
 #endif
-	dump_hex(stdout, ee->data, ee->len, ee->offset);
+	dump_hex_fmt(stdout, ee->data, ee->len, ee->offset, hex_flags);
 
 	return 0;
 }
@@ -1784,52 +2359,131 @@ static int dump_tsinfo(const struct ethtool_ts_info *info)
 	return 0;
 }
 
-static struct ethtool_gstrings *
-get_stringset(struct cmd_context *ctx, enum ethtool_stringset set_id,
-	      ptrdiff_t drvinfo_offset, int null_terminate)
+static int get_stringset_len(struct cmd_context *ctx,
+			     enum ethtool_stringset set_id,
+			     ptrdiff_t drvinfo_offset, u32 *len)
 {
-	struct {
-		struct ethtool_sset_info hdr;
-		u32 buf[1];
-	} sset_info;
 	struct ethtool_drvinfo drvinfo;
-	u32 len, i;
-	struct ethtool_gstrings *strings;
+	struct ethtool_dev dev;
+	int err;
 
-	sset_info.hdr.cmd = ETHTOOL_GSSET_INFO;
-	sset_info.hdr.reserved = 0;
-	sset_info.hdr.sset_mask = 1ULL << set_id;
-	if (send_ioctl(ctx, &sset_info) == 0) {
-		len = sset_info.hdr.sset_mask ? sset_info.hdr.data[0] : 0;
-	} else if (errno == EOPNOTSUPP && drvinfo_offset != 0) {
+	ctx_ethtool_dev(ctx, &dev);
+	err = ethtool_get_string_count(&dev, set_id, len);
+	if (err == -EOPNOTSUPP && drvinfo_offset != 0) {
 		/* Fallback for old kernel versions */
 		drvinfo.cmd = ETHTOOL_GDRVINFO;
 		if (send_ioctl(ctx, &drvinfo))
-			return NULL;
-		len = *(u32 *)((char *)&drvinfo + drvinfo_offset);
-	} else {
-		return NULL;
+			return -1;
+		*len = *(u32 *)((char *)&drvinfo + drvinfo_offset);
+	} else if (err) {
+		errno = -err;
+		return -1;
 	}
 
-	strings = calloc(1, sizeof(*strings) + len * ETH_GSTRING_LEN);
-	if (!strings)
+	return 0;
+}
+
+static struct ethtool_gstrings *
+get_stringset(struct cmd_context *ctx, enum ethtool_stringset set_id,
+	      ptrdiff_t drvinfo_offset, int null_terminate)
+{
+	struct ethtool_gstrings *strings;
+	struct ethtool_dev dev;
+	u32 len;
+	int err;
+
+	if (get_stringset_len(ctx, set_id, drvinfo_offset, &len))
 		return NULL;
 
-	strings->cmd = ETHTOOL_GSTRINGS;
-	strings->string_set = set_id;
-	strings->len = len;
-	if (len != 0 && send_ioctl(ctx, strings)) {
-		free(strings);
+	ctx_ethtool_dev(ctx, &dev);
+	err = ethtool_fetch_strings(&dev, set_id, len, null_terminate,
+				    &strings);
+	if (err) {
+		errno = -err;
 		return NULL;
 	}
 
-	if (null_terminate)
-		for (i = 0; i < len; i++)
-			strings->data[(i + 1) * ETH_GSTRING_LEN - 1] = 0;
-
 	return strings;
 }
 
+/* The name index is an open-addressed hash table following the
+ * feature definitions.  Each slot holds a feature index plus one,
+ * or 0 if it is empty.
+ */
+static unsigned int feature_name_index_size(size_t n_features)
+{
+	unsigned int size = 2;
+
+	while (size < 2 * n_features)
+		size <<= 1;
+	return size;
+}
+
+static unsigned int *feature_name_index(const struct feature_defs *defs)
+{
+	return (unsigned int *)&defs->def[defs->n_features];
+}
+
+static size_t feature_defs_size(size_t n_features)
+{
+	return sizeof(struct feature_defs) +
+		sizeof(struct feature_def) * n_features +
+		sizeof(unsigned int) * feature_name_index_size(n_features);
+}
+
+static unsigned int feature_name_hash(const char *name)
+{
+	unsigned int hash = 2166136261u;	/* FNV-1a */
+
+	while (*name)
+		hash = (hash ^ (unsigned char)*name++) * 16777619u;
+	return hash;
+}
+
+/* Find the first feature with the given name; return its index or -1 */
+static int find_feature(const struct feature_defs *defs, const char *name)
+{
+	const unsigned int *index = feature_name_index(defs);
+	unsigned int mask = feature_name_index_size(defs->n_features) - 1;
+	unsigned int slot;
+
+	for (slot = feature_name_hash(name) & mask; index[slot];
+	     slot = (slot + 1) & mask)
+		if (!strcmp(defs->def[index[slot] - 1].name, name))
+			return index[slot] - 1;
+	return -1;
+}
+
+static void index_feature_names(struct feature_defs *defs)
+{
+	unsigned int *index = feature_name_index(defs);
+	unsigned int mask = feature_name_index_size(defs->n_features) - 1;
+	unsigned int slot;
+	int i;
+
+	memset(index, 0, sizeof(*index) * (mask + 1));
+	for (i = 0; i < defs->n_features; i++) {
+		for (slot = feature_name_hash(defs->def[i].name) & mask;
+		     index[slot]; slot = (slot + 1) & mask)
+			if (!strcmp(defs->def[index[slot] - 1].name,
+				    defs->def[i].name))
+				break;
+		/* Duplicate names resolve to the first, as before */
+		if (!index[slot])
+			index[slot] = i + 1;
+	}
+}
+
+static struct feature_defs *copy_feature_defs(const struct feature_defs *defs)
+{
+	struct feature_defs *copy;
+
+	copy = malloc(feature_defs_size(defs->n_features));
+	if (copy)
+		memcpy(copy, defs, feature_defs_size(defs->n_features));
+	return copy;
+}
+
 static struct feature_defs *get_feature_defs(struct cmd_context *ctx)
 {
 	struct ethtool_gstrings *names;
@@ -1837,6 +2491,14 @@ static struct feature_defs *get_feature_defs(struct cmd_context *ctx)
 	u32 n_features;
 	int i, j;
 
+	/* Feature names are the same for every device, so during a
+	 * batch only their number needs to be checked again.
+	 */
+	if (ctx->batch_defs && *ctx->batch_defs &&
+	    !get_stringset_len(ctx, ETH_SS_FEATURES, 0, &n_features) &&
+	    n_features == (*ctx->batch_defs)->n_features)
+		return copy_feature_defs(*ctx->batch_defs);
+
 	names = get_stringset(ctx, ETH_SS_FEATURES, 0, 1);
 	if (names) {
 		n_features = names->len;
@@ -1851,7 +2513,7 @@ static struct feature_defs *get_feature_defs(struct cmd_context *ctx)
 		return NULL;
 	}
 
-	defs = malloc(sizeof(*defs) + sizeof(defs->def[0]) * n_features);
+	defs = malloc(feature_defs_size(n_features));
 	if (!defs) {
 		free(names);
 		return NULL;
@@ -1899,6 +2561,12 @@ static struct feature_defs *get_feature_defs(struct cmd_context *ctx)
 	}
 
 	free(names);
+	index_feature_names(defs);
+
+	if (ctx->batch_defs) {
+		free(*ctx->batch_defs);
+		*ctx->batch_defs = copy_feature_defs(defs);
+	}
 	return defs;
 }
 
@@ -1981,19 +2649,25 @@ static void do_generic_set(struct cmdline_info *info,
 		do_generic_set1(&info[i], changed_out);
 }
 
+#define DECLARE_PAUSE_OPTION_VARS()		\
+	int pause_autoneg_wanted = -1;		\
+	int pause_rx_wanted = -1;		\
+	int pause_tx_wanted = -1
+
+#define PAUSE_CMDLINE_INFO(__epause)					\
+{									\
+	{ "autoneg", CMDL_BOOL, &pause_autoneg_wanted,			\
+	  &__epause.autoneg },						\
+	{ "rx", CMDL_BOOL, &pause_rx_wanted, &__epause.rx_pause },	\
+	{ "tx", CMDL_BOOL, &pause_tx_wanted, &__epause.tx_pause },	\
+}
+
 static int do_spause(struct cmd_context *ctx)
 {
 	struct ethtool_pauseparam epause;
 	int gpause_changed = 0;
-	int pause_autoneg_wanted = -1;
-	int pause_rx_wanted = -1;
-	int pause_tx_wanted = -1;
-	struct cmdline_info cmdline_pause[] = {
-		{ "autoneg", CMDL_BOOL, &pause_autoneg_wanted,
-		  &epause.autoneg },
-		{ "rx", CMDL_BOOL, &pause_rx_wanted, &epause.rx_pause },
-		{ "tx", CMDL_BOOL, &pause_tx_wanted, &epause.tx_pause },
-	};
+	DECLARE_PAUSE_OPTION_VARS();
+	struct cmdline_info cmdline_pause[] = PAUSE_CMDLINE_INFO(epause);
 	int err, changed = 0;
 
 	parse_generic_cmdline(ctx, &gpause_changed,
@@ -2023,22 +2697,28 @@ static int do_spause(struct cmd_context *ctx)
 	return 0;
 }
 
+#define DECLARE_RING_OPTION_VARS()		\
+	s32 ring_rx_wanted = -1;		\
+	s32 ring_rx_mini_wanted = -1;		\
+	s32 ring_rx_jumbo_wanted = -1;		\
+	s32 ring_tx_wanted = -1
+
+#define RING_CMDLINE_INFO(__ering)					\
+{									\
+	{ "rx", CMDL_S32, &ring_rx_wanted, &__ering.rx_pending },	\
+	{ "rx-mini", CMDL_S32, &ring_rx_mini_wanted,			\
+	  &__ering.rx_mini_pending },					\
+	{ "rx-jumbo", CMDL_S32, &ring_rx_jumbo_wanted,			\
+	  &__ering.rx_jumbo_pending },					\
+	{ "tx", CMDL_S32, &ring_tx_wanted, &__ering.tx_pending },	\
+}
+
 static int do_sring(struct cmd_context *ctx)
 {
 	struct ethtool_ringparam ering;
 	int gring_changed = 0;
-	s32 ring_rx_wanted = -1;
-	s32 ring_rx_mini_wanted = -1;
-	s32 ring_rx_jumbo_wanted = -1;
-	s32 ring_tx_wanted = -1;
-	struct cmdline_info cmdline_ring[] = {
-		{ "rx", CMDL_S32, &ring_rx_wanted, &ering.rx_pending },
-		{ "rx-mini", CMDL_S32, &ring_rx_mini_wanted,
-		  &ering.rx_mini_pending },
-		{ "rx-jumbo", CMDL_S32, &ring_rx_jumbo_wanted,
-		  &ering.rx_jumbo_pending },
-		{ "tx", CMDL_S32, &ring_tx_wanted, &ering.tx_pending },
-	};
+	DECLARE_RING_OPTION_VARS();
+	struct cmdline_info cmdline_ring[] = RING_CMDLINE_INFO(ering);
 	int err, changed = 0;
 
 	parse_generic_cmdline(ctx, &gring_changed,
@@ -2092,22 +2772,29 @@ static int do_gring(struct cmd_context *ctx)
 	return 0;
 }
 
+#define DECLARE_CHANNELS_OPTION_VARS()		\
+	s32 channels_rx_wanted = -1;		\
+	s32 channels_tx_wanted = -1;		\
+	s32 channels_other_wanted = -1;		\
+	s32 channels_combined_wanted = -1
+
+#define CHANNELS_CMDLINE_INFO(__echannels)				\
+{									\
+	{ "rx", CMDL_S32, &channels_rx_wanted, &__echannels.rx_count },	\
+	{ "tx", CMDL_S32, &channels_tx_wanted, &__echannels.tx_count },	\
+	{ "other", CMDL_S32, &channels_other_wanted,			\
+	  &__echannels.other_count },					\
+	{ "combined", CMDL_S32, &channels_combined_wanted,		\
+	  &__echannels.combined_count },				\
+}
+
 static int do_schannels(struct cmd_context *ctx)
 {
 	struct ethtool_channels echannels;
 	int gchannels_changed;
-	s32 channels_rx_wanted = -1;
-	s32 channels_tx_wanted = -1;
-	s32 channels_other_wanted = -1;
-	s32 channels_combined_wanted = -1;
-	struct cmdline_info cmdline_channels[] = {
-		{ "rx", CMDL_S32, &channels_rx_wanted, &echannels.rx_count },
-		{ "tx", CMDL_S32, &channels_tx_wanted, &echannels.tx_count },
-		{ "other", CMDL_S32, &channels_other_wanted,
-		  &echannels.other_count },
-		{ "combined", CMDL_S32, &channels_combined_wanted,
-		  &echannels.combined_count },
-	};
+	DECLARE_CHANNELS_OPTION_VARS();
+	struct cmdline_info cmdline_channels[] =
+		CHANNELS_CMDLINE_INFO(echannels);
 	int err, changed = 0;
 
 	parse_generic_cmdline(ctx, &gchannels_changed,
@@ -2315,14 +3002,37 @@ get_features(struct cmd_context *ctx, const struct feature_defs *defs)
 
 	state->off_flags = 0;
 
-	for (i = 0; i < ARRAY_SIZE(off_flag_def); i++) {
-		value = off_flag_def[i].value;
-		if (!off_flag_def[i].get_cmd)
-			continue;
-		eval.cmd = off_flag_def[i].get_cmd;
-		err = send_ioctl(ctx, &eval);
-		if (err) {
-			if (errno == EOPNOTSUPP &&
+	if (defs->n_features) {
+		state->features.cmd = ETHTOOL_GFEATURES;
+		state->features.size = FEATURE_BITS_TO_BLOCKS(defs->n_features);
+		err = send_ioctl(ctx, &state->features);
+		if (!err) {
+			/* The kernel derives the legacy offload flags from
+			 * the same features that get_feature_defs() matched
+			 * them to, so there is no need to ask for them.
+			 */
+			for (i = 0; i < defs->n_features; i++)
+				if (defs->def[i].off_flag_index >= 0 &&
+				    FEATURE_BIT_IS_SET(state->features.features,
+						       i, active))
+					state->off_flags |= off_flag_def[
+						defs->def[i].off_flag_index].value;
+			return state;
+		}
+		perror("Cannot get device generic features");
+		memset(state->features.features, 0,
+		       state->features.size *
+		       sizeof(state->features.features[0]));
+	}
+
+	for (i = 0; i < ARRAY_SIZE(off_flag_def); i++) {
+		value = off_flag_def[i].value;
+		if (!off_flag_def[i].get_cmd)
+			continue;
+		eval.cmd = off_flag_def[i].get_cmd;
+		err = send_ioctl(ctx, &eval);
+		if (err) {
+			if (errno == EOPNOTSUPP &&
 			    off_flag_def[i].get_cmd == ETHTOOL_GUFO)
 				continue;
 
@@ -2345,16 +3055,6 @@ get_features(struct cmd_context *ctx, const struct feature_defs *defs)
 		allfail = 0;
 	}
 
-	if (defs->n_features) {
-		state->features.cmd = ETHTOOL_GFEATURES;
-		state->features.size = FEATURE_BITS_TO_BLOCKS(defs->n_features);
-		err = send_ioctl(ctx, &state->features);
-		if (err)
-			perror("Cannot get device generic features");
-		else
-			allfail = 0;
-	}
-
 	if (allfail) {
 		free(state);
 		return NULL;
@@ -2399,7 +3099,7 @@ static int do_sfeatures(struct cmd_context *ctx)
 	u32 off_flags_wanted = 0;
 	u32 off_flags_mask = 0;
 	struct ethtool_sfeatures *efeatures;
-	struct cmdline_info *cmdline_features;
+	struct cmdline_info cmdline_feature;
 	struct feature_state *old_state, *new_state;
 	struct ethtool_value eval;
 	int err, rc;
@@ -2428,30 +3128,37 @@ static int do_sfeatures(struct cmd_context *ctx)
 		efeatures = NULL;
 	}
 
-	/* Generate cmdline_info for legacy flags and kernel-named
-	 * features, and parse our arguments.
+	/* Parse our arguments a pair at a time, looking each name up
+	 * among the legacy flags and then in the kernel-named features.
 	 */
-	cmdline_features = calloc(ARRAY_SIZE(off_flag_def) + defs->n_features,
-				  sizeof(cmdline_features[0]));
-	if (!cmdline_features) {
-		perror("Cannot parse arguments");
-		rc = 1;
-		goto err;
+	for (i = 0; i < ctx->argc; i += 2) {
+		struct cmd_context pair_ctx = *ctx;
+
+		for (j = 0; j < ARRAY_SIZE(off_flag_def); j++)
+			if (!strcmp(off_flag_def[j].short_name, ctx->argp[i]))
+				break;
+		if (j < ARRAY_SIZE(off_flag_def)) {
+			flag_to_cmdline_info(off_flag_def[j].short_name,
+					     off_flag_def[j].value,
+					     &off_flags_wanted,
+					     &off_flags_mask,
+					     &cmdline_feature);
+		} else {
+			j = find_feature(defs, ctx->argp[i]);
+			if (j < 0)
+				exit_bad_args();
+			flag_to_cmdline_info(
+				defs->def[j].name, FEATURE_FIELD_FLAG(j),
+				&FEATURE_WORD(efeatures->features, j,
+					      requested),
+				&FEATURE_WORD(efeatures->features, j, valid),
+				&cmdline_feature);
+		}
+		pair_ctx.argc = ctx->argc - i < 2 ? 1 : 2;
+		pair_ctx.argp = ctx->argp + i;
+		parse_generic_cmdline(&pair_ctx, &any_changed,
+				      &cmdline_feature, 1);
 	}
-	for (i = 0; i < ARRAY_SIZE(off_flag_def); i++)
-		flag_to_cmdline_info(off_flag_def[i].short_name,
-				     off_flag_def[i].value,
-				     &off_flags_wanted, &off_flags_mask,
-				     &cmdline_features[i]);
-	for (i = 0; i < defs->n_features; i++)
-		flag_to_cmdline_info(
-			defs->def[i].name, FEATURE_FIELD_FLAG(i),
-			&FEATURE_WORD(efeatures->features, i, requested),
-			&FEATURE_WORD(efeatures->features, i, valid),
-			&cmdline_features[ARRAY_SIZE(off_flag_def) + i]);
-	parse_generic_cmdline(ctx, &any_changed, cmdline_features,
-			      ARRAY_SIZE(off_flag_def) + defs->n_features);
-	free(cmdline_features);
 
 	if (!any_changed) {
 		fprintf(stdout, "no features changed\n");
@@ -2587,43 +3294,19 @@ err:
 static struct ethtool_link_usettings *
 do_ioctl_glinksettings(struct cmd_context *ctx)
 {
-	int err;
-	struct {
-		struct ethtool_link_settings req;
-		__u32 link_mode_data[3 * ETHTOOL_LINK_MODE_MASK_MAX_KERNEL_NU32];
-	} ecmd;
 	struct ethtool_link_usettings *link_usettings;
-	unsigned int u32_offs;
+	struct ethtool_link_info link;
+	struct ethtool_dev dev;
+	int nwords;
 
-	/* Handshake with kernel to determine number of words for link
-	 * mode bitmaps. When requested number of bitmap words is not
-	 * the one expected by kernel, the latter returns the integer
-	 * opposite of what it is expecting. We request length 0 below
-	 * (aka. invalid bitmap length) to get this info.
-	 */
-	memset(&ecmd, 0, sizeof(ecmd));
-	ecmd.req.cmd = ETHTOOL_GLINKSETTINGS;
-	err = send_ioctl(ctx, &ecmd);
-	if (err < 0)
-		return NULL;
-
-	/* see above: we expect a strictly negative value from kernel.
-	 */
-	if (ecmd.req.link_mode_masks_nwords >= 0
-	    || ecmd.req.cmd != ETHTOOL_GLINKSETTINGS)
-		return NULL;
+	BUILD_BUG_ON(LIBETHTOOL_LINK_MODE_WORDS !=
+		     ETHTOOL_LINK_MODE_MASK_MAX_KERNEL_NU32);
 
-	/* got the real ecmd.req.link_mode_masks_nwords,
-	 * now send the real request
+	/* The library does the handshake for the number of words in
+	 * the link mode bitmaps
 	 */
-	ecmd.req.cmd = ETHTOOL_GLINKSETTINGS;
-	ecmd.req.link_mode_masks_nwords = -ecmd.req.link_mode_masks_nwords;
-	err = send_ioctl(ctx, &ecmd);
-	if (err < 0)
-		return NULL;
-
-	if (ecmd.req.link_mode_masks_nwords <= 0
-	    || ecmd.req.cmd != ETHTOOL_GLINKSETTINGS)
+	ctx_ethtool_dev(ctx, &dev);
+	if (ethtool_get_link_info(&dev, &link))
 		return NULL;
 
 	/* Convert to usettings struct */
@@ -2632,23 +3315,16 @@ do_ioctl_glinksettings(struct cmd_context *ctx)
 		return NULL;
 
 	/* keep transceiver 0 */
-	memcpy(&link_usettings->base, &ecmd.req, sizeof(link_usettings->base));
+	memcpy(&link_usettings->base, &link.base, sizeof(link_usettings->base));
 
 	/* copy link mode bitmaps */
-	u32_offs = 0;
-	memcpy(link_usettings->link_modes.supported,
-	       &ecmd.link_mode_data[u32_offs],
-	       4 * ecmd.req.link_mode_masks_nwords);
-
-	u32_offs += ecmd.req.link_mode_masks_nwords;
-	memcpy(link_usettings->link_modes.advertising,
-	       &ecmd.link_mode_data[u32_offs],
-	       4 * ecmd.req.link_mode_masks_nwords);
-
-	u32_offs += ecmd.req.link_mode_masks_nwords;
-	memcpy(link_usettings->link_modes.lp_advertising,
-	       &ecmd.link_mode_data[u32_offs],
-	       4 * ecmd.req.link_mode_masks_nwords);
+	nwords = link.base.link_mode_masks_nwords;
+	memcpy(link_usettings->link_modes.supported, link.supported,
+	       4 * nwords);
+	memcpy(link_usettings->link_modes.advertising, link.advertising,
+	       4 * nwords);
+	memcpy(link_usettings->link_modes.lp_advertising, link.lp_advertising,
+	       4 * nwords);
 
 	return link_usettings;
 }
@@ -3240,34 +3916,640 @@ static int do_sset(struct cmd_context *ctx)
 	return 0;
 }
 
+/* A file mapped behind room for an ioctl command header */
+struct file_map {
+	char *base;
+	size_t size;
+	u32 len;		/* of the data in view */
+	u64 file_size;
+	int fd;
+};
+
+/*
+ * Map @len bytes of the file open at map->fd, from @offset, and return
+ * a command header of @hdr_size placed just in front of them, so that
+ * the data can be handed to code taking the ioctl structure without a
+ * copy.  The file mapping starts after an anonymous page that holds the
+ * header, and is followed by a zero page, so a decoder that overruns
+ * the view reads zeroes rather than faulting.
+ */
+static void *file_map_view(struct file_map *map, u64 offset, u32 len,
+			   size_t hdr_size, int flags)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t skew = offset & (page - 1);
+	char *base;
+
+	map->size = page + skew + len + page;
+	base = mmap(NULL, map->size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+		return NULL;
+	/* A header beyond the first page lands in a private copy */
+	if (len && mmap(base + page, skew + len, PROT_READ | PROT_WRITE,
+			flags | MAP_FIXED, map->fd,
+			offset - skew) == MAP_FAILED) {
+		munmap(base, map->size);
+		return NULL;
+	}
+	map->base = base;
+	map->len = len;
+	return base + page + skew - hdr_size;
+}
+
+static void file_unmap(struct file_map *map)
+{
+	if (map->base)
+		munmap(map->base, map->size);
+	map->base = NULL;
+}
+
+/*
+ * Map a saved dump for decoding in place, from @offset and at most
+ * *@len bytes (which is updated to what the file holds).  Changes to
+ * the data or header stay private.
+ */
+static void *dump_file_map(struct file_map *map, const char *name,
+			   u32 offset, u32 *len, size_t hdr_size)
+{
+	struct stat st;
+	void *hdr = NULL;
+
+	map->base = NULL;
+	map->fd = open(name, O_RDONLY);
+	if (map->fd < 0 || fstat(map->fd, &st) < 0) {
+		fprintf(stderr, "Can't open '%s': %s\n",
+			name, strerror(errno));
+		goto out;
+	}
+	if (!S_ISREG(st.st_mode) || st.st_size > UINT32_MAX) {
+		fprintf(stderr, "'%s' is not a dump file\n", name);
+		goto out;
+	}
+	map->file_size = st.st_size;
+	if (offset > map->file_size) {
+		fprintf(stderr, "Offset %u is beyond the end of '%s'\n",
+			offset, name);
+		goto out;
+	}
+	if (*len > map->file_size - offset)
+		*len = map->file_size - offset;
+
+	hdr = file_map_view(map, offset, *len, hdr_size, MAP_PRIVATE);
+	if (!hdr)
+		fprintf(stderr, "Can't map '%s': %s\n",
+			name, strerror(errno));
+out:
+	if (map->fd >= 0)
+		close(map->fd);
+	map->fd = -1;
+	return hdr;
+}
+
+static int load_regs_file(const char *name, struct ethtool_regs **regsp,
+			  struct file_map *map)
+{
+	struct ethtool_regs *regs;
+	u32 len = -1;
+
+	regs = dump_file_map(map, name, 0, &len,
+			     offsetof(struct ethtool_regs, data));
+	if (!regs)
+		return 75;
+	regs->cmd = ETHTOOL_GREGS;
+	regs->version = 0;
+	regs->len = len;
+
+	*regsp = regs;
+	return 0;
+}
+
+static void regs_free(struct ethtool_regs *regs, struct file_map *map)
+{
+	if (map->base)
+		file_unmap(map);
+	else
+		free(regs);
+}
+
+struct regs_range {
+	u32 start;
+	u32 end;		/* inclusive */
+};
+
+/* Parse a comma-separated list of register offsets and ranges */
+static struct regs_range *parse_regs_ranges(const char *list,
+					    unsigned int *n_ranges)
+{
+	struct regs_range *ranges;
+	const char *p;
+	char *endp;
+	unsigned int n = 1;
+
+	for (p = list; *p; p++)
+		if (*p == ',')
+			n++;
+	ranges = calloc(n, sizeof(*ranges));
+	if (!ranges)
+		return NULL;
+
+	for (p = list, n = 0; ; n++) {
+		errno = 0;
+		ranges[n].start = strtoul(p, &endp, 0);
+		ranges[n].end = ranges[n].start;
+		if (*endp == '-')
+			ranges[n].end = strtoul(endp + 1, &endp, 0);
+		if (errno || endp == p || (*endp && *endp != ',') ||
+		    ranges[n].end < ranges[n].start) {
+			free(ranges);
+			exit_bad_args();
+		}
+		/* Registers are sampled as aligned 32-bit words */
+		ranges[n].start &= ~3;
+		ranges[n].end &= ~3;
+		if (!*endp)
+			break;
+		p = endp + 1;
+	}
+
+	*n_ranges = n + 1;
+	return ranges;
+}
+
+/* Split a comma-separated REGISTER[.FIELD] list in place */
+static char **parse_regs_select(char *list, unsigned int *n_select)
+{
+	char **select;
+	char *p;
+	unsigned int n = 1;
+
+	for (p = list; *p; p++)
+		if (*p == ',')
+			n++;
+	select = calloc(n, sizeof(*select));
+	if (!select) {
+		perror("Cannot allocate memory for register selection");
+		return NULL;
+	}
+
+	for (p = list, n = 0; ; n++) {
+		select[n] = p;
+		p = strchr(p, ',');
+		if (p)
+			*p++ = 0;
+		if (!*select[n] || *select[n] == '.') {
+			free(select);
+			exit_bad_args();
+		}
+		if (!p)
+			break;
+	}
+
+	*n_select = n + 1;
+	return select;
+}
+
+#define SYSFS_NET_DIR	"/sys/class/net"
+
+static int read_switch_id(const char *devname, char *id, size_t size)
+{
+	char path[sizeof(SYSFS_NET_DIR) + IFNAMSIZ + 16];
+	FILE *file;
+	int err = -1;
+
+	snprintf(path, sizeof(path), SYSFS_NET_DIR "/%s/phys_switch_id",
+		 devname);
+	file = fopen(path, "r");
+	if (!file)
+		return -1;
+	if (fgets(id, size, file) && *id != '\n')
+		err = 0;
+	fclose(file);
+	return err;
+}
+
+/* List the interfaces that are ports of the same switch as @devname */
+static char **regs_switch_ports(const char *devname, unsigned int *n_ports)
+{
+	char id[64], port_id[64];
+	struct dirent **entries;
+	char **names = NULL;
+	unsigned int n = 0;
+	int i, count;
+
+	if (read_switch_id(devname, id, sizeof(id))) {
+		fprintf(stderr, "Cannot find switch ports: %s is not a "
+			"switch port\n", devname);
+		return NULL;
+	}
+	count = scandir(SYSFS_NET_DIR, &entries, NULL, alphasort);
+	if (count < 0) {
+		perror("Cannot list network interfaces");
+		return NULL;
+	}
+	names = calloc(count, sizeof(*names));
+	for (i = 0; i < count; i++) {
+		if (names && entries[i]->d_name[0] != '.' &&
+		    !read_switch_id(entries[i]->d_name, port_id,
+				    sizeof(port_id)) &&
+		    !strcmp(id, port_id)) {
+			names[n] = strdup(entries[i]->d_name);
+			if (names[n])
+				n++;
+		}
+		free(entries[i]);
+	}
+	free(entries);
+	if (!names)
+		perror("Cannot allocate memory for switch ports");
+	*n_ports = n;
+	return names;
+}
+
+static struct ethtool_regs *regs_fetch_port(struct cmd_context *ctx,
+					    const char *devname,
+					    struct ethtool_drvinfo *info)
+{
+	struct cmd_context port_ctx = *ctx;
+	struct ethtool_regs *regs;
+
+	if (strlen(devname) >= IFNAMSIZ) {
+		fprintf(stderr, "Device name %s is too long\n", devname);
+		return NULL;
+	}
+	port_ctx.devname = devname;
+	strcpy(port_ctx.ifr.ifr_name, devname);
+
+	info->cmd = ETHTOOL_GDRVINFO;
+	if (send_ioctl(&port_ctx, info) < 0) {
+		fprintf(stderr, "Cannot get driver information for %s: %s\n",
+			devname, strerror(errno));
+		return NULL;
+	}
+	regs = calloc(1, sizeof(*regs) + info->regdump_len);
+	if (!regs) {
+		perror("Cannot allocate memory for register dump");
+		return NULL;
+	}
+	regs->cmd = ETHTOOL_GREGS;
+	regs->len = info->regdump_len;
+	if (send_ioctl(&port_ctx, regs) < 0) {
+		fprintf(stderr, "Cannot get register dump for %s: %s\n",
+			devname, strerror(errno));
+		free(regs);
+		return NULL;
+	}
+	return regs;
+}
+
+/* Fetch the dumps of several ports and print them side by side */
+static int regs_ports(struct cmd_context *ctx,
+		      const char *const *names, unsigned int n)
+{
+	struct ethtool_drvinfo info, port_info;
+	struct ethtool_regs **regs;
+	unsigned int i;
+	int err = -1;
+	int d;
+
+	regs = calloc(n, sizeof(*regs));
+	if (!regs) {
+		perror("Cannot allocate memory for register dumps");
+		return -1;
+	}
+	for (i = 0; i < n; i++) {
+		regs[i] = regs_fetch_port(ctx, names[i],
+					  i ? &port_info : &info);
+		if (!regs[i])
+			goto out;
+		if (i && strncmp(port_info.driver, info.driver,
+				 sizeof(info.driver))) {
+			fprintf(stderr, "Cannot compare ports: %s and %s have "
+				"different drivers\n", names[0], names[i]);
+			goto out;
+		}
+	}
+
+	for (d = 0; d < ARRAY_SIZE(driver_list); d++)
+		if (!strncmp(driver_list[d].name, info.driver,
+			     ETHTOOL_BUSINFO_LEN))
+			break;
+	if (d == ARRAY_SIZE(driver_list) || !driver_list[d].ports) {
+		fprintf(stderr, "Cannot compare ports: not supported by "
+			"driver %s\n", info.driver);
+		goto out;
+	}
+	err = driver_list[d].ports(&info, regs, names, n,
+				   isatty(STDOUT_FILENO));
+out:
+	for (i = 0; i < n; i++)
+		free(regs[i]);
+	free(regs);
+	return err;
+}
+
+static volatile sig_atomic_t regs_watch_stop;
+
+static void regs_watch_sigint(int sig maybe_unused)
+{
+	regs_watch_stop = 1;
+}
+
+static double elapsed_since(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec - start->tv_sec +
+		(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void regs_watch_print(double t, double dt, u32 offset,
+			     const struct ethtool_regs *prev,
+			     const struct ethtool_regs *cur)
+{
+	u32 old = regs_word(prev->data, prev->len, offset);
+	u32 new = regs_word(cur->data, cur->len, offset);
+	s32 delta = new - old;
+
+	fprintf(stdout, "%.6f\t0x%04x\t0x%08x\t%+11d\t%.0f\n",
+		t, offset, new, delta, dt > 0 ? delta / dt : 0.);
+}
+
+/*
+ * Sample the register dump every @interval seconds, reusing the
+ * buffers and issuing only ETHTOOL_GREGS.  Listed registers are printed
+ * on every sample; without a list, only the words that changed are.
+ */
+static int regs_watch(struct cmd_context *ctx, struct ethtool_regs *regs,
+		      double interval, u32 count,
+		      const struct regs_range *ranges, unsigned int n_ranges)
+{
+	struct ethtool_regs *prev = regs, *cur, *tmp;
+	struct timespec start, next;
+	double t, prev_t = 0;
+	u32 len = regs->len;
+	u32 sample, offset, end;
+	unsigned int i;
+	int err = 0;
+
+	cur = calloc(1, sizeof(*cur) + len);
+	if (!cur) {
+		perror("Cannot allocate memory for register dump");
+		return 73;
+	}
+
+	regs_watch_stop = 0;
+	signal(SIGINT, regs_watch_sigint);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	next = start;
+	fprintf(stdout, "Time\t\tOffset\tValue\t\t      Delta\tRate/s\n");
+	for (sample = 0; !count || sample < count; sample++) {
+		/* Sleep to an absolute deadline so that the period does
+		 * not drift with the time spent in the ioctl
+		 */
+		next.tv_sec += (time_t)interval;
+		next.tv_nsec += (interval - (time_t)interval) * 1e9;
+		if (next.tv_nsec >= 1000000000) {
+			next.tv_sec++;
+			next.tv_nsec -= 1000000000;
+		}
+		while (!regs_watch_stop &&
+		       clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+				       &next, NULL) == EINTR)
+			;
+		if (regs_watch_stop)
+			break;
+
+		cur->cmd = ETHTOOL_GREGS;
+		cur->len = len;
+		if (send_ioctl(ctx, cur) < 0) {
+			perror("Cannot get register dump");
+			err = 74;
+			break;
+		}
+		/* Offsets no longer mean the same registers */
+		if (cur->len != prev->len) {
+			fprintf(stderr, "Register dump length changed "
+				"from %u to %u bytes\n", prev->len, cur->len);
+			err = 74;
+			break;
+		}
+		t = elapsed_since(&start);
+
+		if (ranges) {
+			for (i = 0; i < n_ranges; i++) {
+				if (ranges[i].start >= len)
+					continue;
+				end = ranges[i].end < len ? ranges[i].end :
+					len - 1;
+				for (offset = ranges[i].start; offset <= end;
+				     offset += 4)
+					regs_watch_print(t, t - prev_t, offset,
+							 prev, cur);
+			}
+		} else {
+			for (offset = 0; offset < len; offset += 4) {
+				if (!memcmp(prev->data + offset,
+					    cur->data + offset,
+					    len - offset < 4 ? len - offset : 4))
+					continue;
+				regs_watch_print(t, t - prev_t, offset,
+						 prev, cur);
+			}
+		}
+		fflush(stdout);
+
+		prev_t = t;
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+
+	signal(SIGINT, SIG_DFL);
+	/* Free whichever buffer was not passed in */
+	free(cur == regs ? prev : cur);
+	return err;
+}
+
 static int do_gregs(struct cmd_context *ctx)
 {
 	int gregs_changed = 0;
 	int gregs_dump_raw = 0;
 	int gregs_dump_hex = 0;
 	char *gregs_dump_file = NULL;
+	char *gregs_diff_file = NULL;
+	char *gregs_watch = NULL;
+	char *gregs_watch_regs = NULL;
+	u32 gregs_watch_count = 0;
+	int gregs_json = 0;
+	int gregs_ascii = 0;
+	int gregs_squeeze = 0;
+	char *gregs_split = NULL;
+	char *gregs_select = NULL;
+	char *gregs_table = NULL;
+	char *gregs_rows = NULL;
+	char *gregs_ports = NULL;
 	struct cmdline_info cmdline_gregs[] = {
 		{ "raw", CMDL_BOOL, &gregs_dump_raw, NULL },
 		{ "hex", CMDL_BOOL, &gregs_dump_hex, NULL },
 		{ "file", CMDL_STR, &gregs_dump_file, NULL },
+		{ "diff", CMDL_STR, &gregs_diff_file, NULL },
+		{ "watch", CMDL_STR, &gregs_watch, NULL },
+		{ "regs", CMDL_STR, &gregs_watch_regs, NULL },
+		{ "count", CMDL_U32, &gregs_watch_count, NULL },
+		{ "json", CMDL_BOOL, &gregs_json, NULL },
+		{ "select", CMDL_STR, &gregs_select, NULL },
+		{ "ascii", CMDL_BOOL, &gregs_ascii, NULL },
+		{ "squeeze", CMDL_BOOL, &gregs_squeeze, NULL },
+		{ "split", CMDL_STR, &gregs_split, NULL },
+		{ "table", CMDL_STR, &gregs_table, NULL },
+		{ "rows", CMDL_STR, &gregs_rows, NULL },
+		{ "ports", CMDL_STR, &gregs_ports, NULL },
 	};
+	struct regs_desc_opts opts = { 0 };
+	struct regs_table_filter filter = { .last_row = 0xffffffff };
+	char **ports = NULL;
+	unsigned int n_ports = 0;
 	int err;
 	struct ethtool_drvinfo drvinfo;
 	struct ethtool_regs *regs;
+	struct file_map file_map = { .fd = -1 };
+	struct regs_range *watch_ranges = NULL;
+	unsigned int n_watch_ranges = 0;
+	double watch_interval = 0;
+	char *endp;
 
 	parse_generic_cmdline(ctx, &gregs_changed,
 			      cmdline_gregs, ARRAY_SIZE(cmdline_gregs));
 
+	if (gregs_dump_raw && gregs_diff_file) {
+		fprintf(stderr, "Raw dump and diff cannot be specified together\n");
+		return 1;
+	}
+	if (gregs_watch) {
+		if (gregs_dump_raw || gregs_diff_file || gregs_dump_file) {
+			fprintf(stderr, "watch cannot be combined with raw, "
+				"file or diff\n");
+			return 1;
+		}
+		errno = 0;
+		watch_interval = strtod(gregs_watch, &endp);
+		if (errno || *endp || endp == gregs_watch ||
+		    !(watch_interval > 0) || watch_interval > INT_MAX)
+			exit_bad_args();
+		if (gregs_watch_regs)
+			watch_ranges = parse_regs_ranges(gregs_watch_regs,
+							 &n_watch_ranges);
+	} else if (gregs_watch_regs || gregs_watch_count) {
+		exit_bad_args();
+	}
+	if ((gregs_json || gregs_select) && (gregs_dump_raw || gregs_watch)) {
+		fprintf(stderr, "json and select cannot be combined with raw "
+			"or watch\n");
+		free(watch_ranges);
+		return 1;
+	}
+	if (gregs_split && (gregs_dump_raw || gregs_diff_file || gregs_watch)) {
+		fprintf(stderr, "split cannot be combined with raw, diff or "
+			"watch\n");
+		free(watch_ranges);
+		return 1;
+	}
+	if (gregs_select && gregs_dump_hex) {
+		fprintf(stderr, "select cannot be combined with hex\n");
+		return 1;
+	}
+	if ((gregs_table || gregs_rows) &&
+	    (gregs_dump_raw || gregs_dump_hex || gregs_json || gregs_select ||
+	     gregs_diff_file || gregs_watch)) {
+		fprintf(stderr, "table and rows cannot be combined with raw, "
+			"hex, json, select, diff or watch\n");
+		free(watch_ranges);
+		return 1;
+	}
+	if (gregs_table) {
+		filter.table = gregs_table;
+		endp = strchr(gregs_table, '.');
+		if (endp) {
+			*endp = 0;
+			filter.field = endp + 1;
+		}
+		if (!*filter.table || (filter.field && !*filter.field))
+			exit_bad_args();
+	}
+	if (gregs_rows) {
+		errno = 0;
+		filter.first_row = strtoul(gregs_rows, &endp, 0);
+		filter.last_row = filter.first_row;
+		if (*endp == '-')
+			filter.last_row = strtoul(endp + 1, &endp, 0);
+		if (errno || endp == gregs_rows || *endp ||
+		    filter.last_row < filter.first_row)
+			exit_bad_args();
+	}
+	if (gregs_ports) {
+		if (gregs_dump_raw || gregs_dump_hex || gregs_dump_file ||
+		    gregs_diff_file || gregs_watch || gregs_json ||
+		    gregs_select || gregs_split || gregs_table || gregs_rows) {
+			fprintf(stderr, "ports cannot be combined with other "
+				"options\n");
+			free(watch_ranges);
+			return 1;
+		}
+		if (strcmp(gregs_ports, "all")) {
+			/* This device, then the listed ones */
+			char **list = parse_regs_select(gregs_ports, &n_ports);
+
+			if (list)
+				ports = calloc(n_ports + 1, sizeof(*ports));
+			if (!ports) {
+				free(list);
+				return 73;
+			}
+			ports[0] = (char *)ctx->devname;
+			memcpy(ports + 1, list, n_ports * sizeof(*ports));
+			free(list);
+			n_ports++;
+		}
+	}
+	opts.json = gregs_json;
+	if (gregs_select) {
+		opts.select = parse_regs_select(gregs_select, &opts.n_select);
+		if (!opts.select)
+			return 73;
+	}
+
 	drvinfo.cmd = ETHTOOL_GDRVINFO;
 	err = send_ioctl(ctx, &drvinfo);
 	if (err < 0) {
 		perror("Cannot get driver information");
+		free(watch_ranges);
+		free(opts.select);
+		free(ports);
 		return 72;
 	}
 
+	if (gregs_ports) {
+		int all = !ports;
+		unsigned int i;
+
+		if (all)
+			ports = regs_switch_ports(ctx->devname, &n_ports);
+		err = ports ? regs_ports(ctx, (const char *const *)ports,
+					 n_ports) : -1;
+		for (i = 0; all && ports && i < n_ports; i++)
+			free(ports[i]);
+		free(ports);
+		return err ? 75 : 0;
+	}
+
 	regs = calloc(1, sizeof(*regs)+drvinfo.regdump_len);
 	if (!regs) {
 		perror("Cannot allocate memory for register dump");
+		free(watch_ranges);
+		free(opts.select);
 		return 73;
 	}
 	regs->cmd = ETHTOOL_GREGS;
@@ -3275,49 +4557,148 @@ static int do_gregs(struct cmd_context *ctx)
 	err = send_ioctl(ctx, regs);
 	if (err < 0) {
 		perror("Cannot get register dump");
+		free(watch_ranges);
+		free(opts.select);
 		free(regs);
 		return 74;
 	}
 
 	if (!gregs_dump_raw && gregs_dump_file != NULL) {
 		/* overwrite reg values from file dump */
-		FILE *f = fopen(gregs_dump_file, "r");
 		struct ethtool_regs *nregs;
-		struct stat st;
-		size_t nread;
 
-		if (!f || fstat(fileno(f), &st) < 0) {
-			fprintf(stderr, "Can't open '%s': %s\n",
-				gregs_dump_file, strerror(errno));
-			if (f)
-				fclose(f);
+		err = load_regs_file(gregs_dump_file, &nregs, &file_map);
+		if (err) {
+			free(opts.select);
 			free(regs);
-			return 75;
-		}
-
-		nregs = realloc(regs, sizeof(*regs) + st.st_size);
-		if (!nregs) {
-			perror("Cannot allocate memory for register dump");
-			free(regs); /* was not freed by realloc */
-			return 73;
+			return err;
 		}
+		nregs->version = regs->version;
+		free(regs);
 		regs = nregs;
-		regs->len = st.st_size;
-		nread = fread(regs->data, regs->len, 1, f);
-		fclose(f);
-		if (nread != 1) {
-			free(regs);
-			return 75;
+	}
+
+	if (gregs_watch) {
+		err = regs_watch(ctx, regs, watch_interval, gregs_watch_count,
+				 watch_ranges, n_watch_ranges);
+		free(watch_ranges);
+		free(regs);
+		return err;
+	}
+
+	if (gregs_diff_file != NULL) {
+		/* compare the saved dump against the current one */
+		struct file_map diff_map;
+		struct ethtool_regs *oregs;
+
+		err = load_regs_file(gregs_diff_file, &oregs, &diff_map);
+		if (err) {
+			free(opts.select);
+			regs_free(regs, &file_map);
+			return err;
 		}
+		oregs->version = regs->version;
+		err = regs_diff(gregs_dump_hex, &opts, &drvinfo, oregs, regs);
+		file_unmap(&diff_map);
+	} else {
+		const struct regs_dump_opts dopts = {
+			.raw = gregs_dump_raw,
+			.hex = gregs_dump_hex,
+			.hex_flags = (gregs_ascii ? DUMP_HEX_ASCII : 0) |
+				(gregs_squeeze ? DUMP_HEX_SQUEEZE : 0),
+			.split = gregs_split,
+			.desc = &opts,
+			.filter = gregs_table || gregs_rows ? &filter : NULL,
+		};
+
+		/* A dump read from a file is only as long as the file */
+		err = dump_regs(&dopts, &drvinfo, regs,
+				file_map.base ? regs->len :
+				drvinfo.regdump_len);
+	}
+	free(opts.select);
+	if (err < 0) {
+		fprintf(stderr, "Cannot dump registers\n");
+		regs_free(regs, &file_map);
+		return 75;
+	}
+	regs_free(regs, &file_map);
+
+	return 0;
+}
+
+static int do_diff_regs(struct cmd_context *ctx)
+{
+	int diff_changed = 0;
+	int diff_dump_hex = 0;
+	char *diff_driver = NULL;
+	u32 diff_version = 0;
+	int diff_json = 0;
+	char *diff_select = NULL;
+	struct cmdline_info cmdline_diff[] = {
+		{ "driver", CMDL_STR, &diff_driver, NULL },
+		{ "version", CMDL_U32, &diff_version, NULL },
+		{ "hex", CMDL_BOOL, &diff_dump_hex, NULL },
+		{ "json", CMDL_BOOL, &diff_json, NULL },
+		{ "select", CMDL_STR, &diff_select, NULL },
+	};
+	struct regs_desc_opts opts = { 0 };
+	struct ethtool_drvinfo drvinfo;
+	struct ethtool_regs *old, *new;
+	struct file_map old_map, new_map;
+	const char *old_file, *new_file;
+	int err;
+
+	if (ctx->argc < 2)
+		exit_bad_args();
+	old_file = ctx->argp[0];
+	new_file = ctx->argp[1];
+	ctx->argc -= 2;
+	ctx->argp += 2;
+	parse_generic_cmdline(ctx, &diff_changed,
+			      cmdline_diff, ARRAY_SIZE(cmdline_diff));
+	if (diff_select && (diff_dump_hex || !diff_driver)) {
+		fprintf(stderr, "select needs a driver and cannot be "
+			"combined with hex\n");
+		return 1;
 	}
+	opts.json = diff_json;
+	if (diff_select) {
+		opts.select = parse_regs_select(diff_select, &opts.n_select);
+		if (!opts.select)
+			return 73;
+	}
+
+	err = load_regs_file(old_file, &old, &old_map);
+	if (err) {
+		free(opts.select);
+		return err;
+	}
+	err = load_regs_file(new_file, &new, &new_map);
+	if (err) {
+		free(opts.select);
+		file_unmap(&old_map);
+		return err;
+	}
+	old->version = new->version = diff_version;
 
-	if (dump_regs(gregs_dump_raw, gregs_dump_hex,
-		      &drvinfo, regs) < 0) {
+	/* Without a driver name the dumps are compared word by word */
+	memset(&drvinfo, 0, sizeof(drvinfo));
+	drvinfo.cmd = ETHTOOL_GDRVINFO;
+	if (diff_driver)
+		strncpy(drvinfo.driver, diff_driver,
+			sizeof(drvinfo.driver) - 1);
+	drvinfo.regdump_len = new->len;
+
+	err = regs_diff(diff_dump_hex || !diff_driver, &opts, &drvinfo,
+			old, new);
+	free(opts.select);
+	file_unmap(&old_map);
+	file_unmap(&new_map);
+	if (err < 0) {
 		fprintf(stderr, "Cannot dump registers\n");
-		free(regs);
 		return 75;
 	}
-	free(regs);
 
 	return 0;
 }
@@ -3338,23 +4719,123 @@ static int do_nway_rst(struct cmd_context *ctx)
 	return err;
 }
 
+static int eeprom_read(struct cmd_context *ctx, struct ethtool_eeprom *eeprom,
+		       u32 offset, u32 len)
+{
+	eeprom->cmd = ETHTOOL_GEEPROM;
+	eeprom->offset = offset;
+	eeprom->len = len;
+	if (send_ioctl(ctx, eeprom) < 0) {
+		perror("Cannot get EEPROM data");
+		return 74;
+	}
+	return 0;
+}
+
+#define EEPROM_READ_CHUNK	65536
+
+/*
+ * Read @len bytes of EEPROM from @offset a chunk at a time, into @dest
+ * and to @out where they are not NULL, optionally reporting progress.
+ */
+static int eeprom_read_chunked(struct cmd_context *ctx, u32 offset, u32 len,
+			       u32 chunk_size, u8 *dest, FILE *out,
+			       int progress)
+{
+	struct ethtool_eeprom *chunk;
+	struct timespec start;
+	double elapsed = 0;
+	u32 done, n;
+	int err = 0;
+
+	if (chunk_size > len)
+		chunk_size = len ? len : 1;
+	chunk = calloc(1, sizeof(*chunk) + chunk_size);
+	if (!chunk) {
+		perror("Cannot allocate memory for EEPROM data");
+		return 75;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (done = 0; done < len; done += n) {
+		n = len - done < chunk_size ? len - done : chunk_size;
+		err = eeprom_read(ctx, chunk, offset + done, n);
+		if (err)
+			break;
+		if (dest)
+			memcpy(dest + done, chunk->data, n);
+		if (out && fwrite(chunk->data, 1, n, out) != n) {
+			perror("Cannot write EEPROM data");
+			err = 75;
+			break;
+		}
+		if (progress) {
+			elapsed = elapsed_since(&start);
+			fprintf(stderr, "\r%u of %u bytes read, %.1f KiB/s",
+				done + n, len,
+				elapsed > 0 ? (done + n) / 1024. / elapsed : 0);
+		}
+	}
+	if (progress) {
+		if (done)
+			fputc('\n', stderr);
+		if (!err)
+			fprintf(stderr, "Read %u bytes at offset %u in %.3f s\n",
+				len, offset, elapsed);
+	}
+
+	free(chunk);
+	return err;
+}
+
 static int do_geeprom(struct cmd_context *ctx)
 {
 	int geeprom_changed = 0;
 	int geeprom_dump_raw = 0;
 	u32 geeprom_offset = 0;
 	u32 geeprom_length = -1;
+	char *geeprom_file = NULL;
+	int geeprom_ascii = 0;
+	int geeprom_squeeze = 0;
+	u32 geeprom_chunk = EEPROM_READ_CHUNK;
+	char *geeprom_output = NULL;
+	int geeprom_resume = 0;
+	int geeprom_progress = 0;
 	struct cmdline_info cmdline_geeprom[] = {
 		{ "offset", CMDL_U32, &geeprom_offset, NULL },
 		{ "length", CMDL_U32, &geeprom_length, NULL },
 		{ "raw", CMDL_BOOL, &geeprom_dump_raw, NULL },
+		{ "file", CMDL_STR, &geeprom_file, NULL },
+		{ "ascii", CMDL_BOOL, &geeprom_ascii, NULL },
+		{ "squeeze", CMDL_BOOL, &geeprom_squeeze, NULL },
+		{ "chunk", CMDL_U32, &geeprom_chunk, NULL },
+		{ "output", CMDL_STR, &geeprom_output, NULL },
+		{ "resume", CMDL_BOOL, &geeprom_resume, NULL },
+		{ "progress", CMDL_BOOL, &geeprom_progress, NULL },
 	};
 	int err;
 	struct ethtool_drvinfo drvinfo;
 	struct ethtool_eeprom *eeprom;
+	struct file_map map;
+	unsigned int hex_flags;
+	struct stat st;
+	FILE *out;
 
 	parse_generic_cmdline(ctx, &geeprom_changed,
 			      cmdline_geeprom, ARRAY_SIZE(cmdline_geeprom));
+	hex_flags = (geeprom_ascii ? DUMP_HEX_ASCII : 0) |
+		(geeprom_squeeze ? DUMP_HEX_SQUEEZE : 0);
+	if (!geeprom_chunk)
+		exit_bad_args();
+	if (geeprom_file && geeprom_output) {
+		fprintf(stderr, "file and output cannot be specified "
+			"together\n");
+		return 1;
+	}
+	if (geeprom_resume && !geeprom_output) {
+		fprintf(stderr, "resume requires output\n");
+		return 1;
+	}
 
 	drvinfo.cmd = ETHTOOL_GDRVINFO;
 	err = send_ioctl(ctx, &drvinfo);
@@ -3363,32 +4844,177 @@ static int do_geeprom(struct cmd_context *ctx)
 		return 74;
 	}
 
+	if (geeprom_file) {
+		/* Decode a saved raw dump, which starts at offset 0 */
+		eeprom = dump_file_map(&map, geeprom_file, geeprom_offset,
+				       &geeprom_length,
+				       offsetof(struct ethtool_eeprom, data));
+		if (!eeprom)
+			return 75;
+		eeprom->cmd = ETHTOOL_GEEPROM;
+		eeprom->len = geeprom_length;
+		eeprom->offset = geeprom_offset;
+		err = dump_eeprom(geeprom_dump_raw, hex_flags, &drvinfo,
+				  eeprom);
+		file_unmap(&map);
+		return err;
+	}
+
 	if (geeprom_length == -1)
 		geeprom_length = drvinfo.eedump_len;
 
 	if (drvinfo.eedump_len < geeprom_offset + geeprom_length)
 		geeprom_length = drvinfo.eedump_len - geeprom_offset;
 
+	if (geeprom_output) {
+		/* The file holds the EEPROM contents from the offset on */
+		out = fopen(geeprom_output, geeprom_resume ? "a" : "w");
+		if (!out || fstat(fileno(out), &st) < 0) {
+			fprintf(stderr, "Can't open '%s': %s\n",
+				geeprom_output, strerror(errno));
+			if (out)
+				fclose(out);
+			return 75;
+		}
+		if (st.st_size > geeprom_length) {
+			fprintf(stderr, "'%s' is longer than the EEPROM data "
+				"to read\n", geeprom_output);
+			fclose(out);
+			return 75;
+		}
+		geeprom_offset += st.st_size;
+		geeprom_length -= st.st_size;
+		err = eeprom_read_chunked(ctx, geeprom_offset, geeprom_length,
+					  geeprom_chunk, NULL, out,
+					  geeprom_progress);
+		if (fclose(out) && !err) {
+			perror("Cannot write EEPROM data");
+			err = 75;
+		}
+		return err;
+	}
+	if (geeprom_dump_raw)
+		return eeprom_read_chunked(ctx, geeprom_offset, geeprom_length,
+					   geeprom_chunk, NULL, stdout,
+					   geeprom_progress);
+
 	eeprom = calloc(1, sizeof(*eeprom)+geeprom_length);
 	if (!eeprom) {
 		perror("Cannot allocate memory for EEPROM data");
 		return 75;
 	}
+	err = eeprom_read_chunked(ctx, geeprom_offset, geeprom_length,
+				  geeprom_chunk, eeprom->data, NULL,
+				  geeprom_progress);
+	if (err) {
+		free(eeprom);
+		return err;
+	}
 	eeprom->cmd = ETHTOOL_GEEPROM;
 	eeprom->len = geeprom_length;
 	eeprom->offset = geeprom_offset;
-	err = send_ioctl(ctx, eeprom);
-	if (err < 0) {
-		perror("Cannot get EEPROM data");
-		free(eeprom);
-		return 74;
-	}
-	err = dump_eeprom(geeprom_dump_raw, &drvinfo, eeprom);
+	err = dump_eeprom(geeprom_dump_raw, hex_flags, &drvinfo, eeprom);
 	free(eeprom);
 
 	return err;
 }
 
+/*
+ * Unchanged runs shorter than this are rewritten rather than splitting
+ * an extent, as many parts are written a word at a time anyway.
+ */
+#define EEPROM_DELTA_GAP	4
+/* The kernel bounces EEPROM writes through a page-sized buffer */
+#define EEPROM_WRITE_CHUNK	4096
+
+/*
+ * Write only the extents of @eeprom that differ from what the device
+ * holds, then read the range back to check it.
+ */
+static int eeprom_write_delta(struct cmd_context *ctx,
+			      const struct ethtool_eeprom *eeprom)
+{
+	const u8 *data = eeprom->data;
+	struct ethtool_eeprom *cur, *chunk;
+	u32 start, end, last, pos, n;
+	u32 written = 0, extents = 0;
+	struct timespec t0;
+	double elapsed;
+	const u8 *old;
+	int err;
+
+	cur = calloc(1, sizeof(*cur) + eeprom->len);
+	chunk = calloc(1, sizeof(*chunk) + EEPROM_WRITE_CHUNK);
+	if (!cur || !chunk) {
+		perror("Cannot allocate memory for EEPROM data");
+		err = 75;
+		goto out;
+	}
+	err = eeprom_read(ctx, cur, eeprom->offset, eeprom->len);
+	if (err)
+		goto out;
+	old = cur->data;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (start = 0; start < eeprom->len; start = end) {
+		if (data[start] == old[start]) {
+			end = start + 1;
+			continue;
+		}
+		for (end = last = start + 1;
+		     end < eeprom->len && end - last < EEPROM_DELTA_GAP; end++)
+			if (data[end] != old[end])
+				last = end + 1;
+		end = last;
+
+		for (pos = start; pos < end; pos += n) {
+			n = end - pos;
+			if (n > EEPROM_WRITE_CHUNK)
+				n = EEPROM_WRITE_CHUNK;
+			chunk->cmd = ETHTOOL_SEEPROM;
+			chunk->magic = eeprom->magic;
+			chunk->offset = eeprom->offset + pos;
+			chunk->len = n;
+			memcpy(chunk->data, data + pos, n);
+			if (send_ioctl(ctx, chunk) < 0) {
+				perror("Cannot set EEPROM data");
+				err = 87;
+				goto out;
+			}
+		}
+		written += end - start;
+		extents++;
+	}
+	elapsed = elapsed_since(&t0);
+
+	err = eeprom_read(ctx, cur, eeprom->offset, eeprom->len);
+	if (err)
+		goto out;
+	for (pos = 0; pos < eeprom->len; pos++) {
+		if (old[pos] != data[pos]) {
+			fprintf(stderr, "EEPROM verify failed at offset %u: "
+				"wrote 0x%02x, read 0x%02x\n",
+				eeprom->offset + pos, data[pos], old[pos]);
+			err = 87;
+			goto out;
+		}
+	}
+
+	if (!written) {
+		printf("EEPROM already up to date, %u bytes verified\n",
+		       eeprom->len);
+	} else {
+		printf("Wrote %u of %u bytes in %u extents, verified\n",
+		       written, eeprom->len, extents);
+		printf("Write took %.3f s, about %.3f s saved\n", elapsed,
+		       elapsed * (eeprom->len - written) / written);
+	}
+out:
+	free(chunk);
+	free(cur);
+	return err;
+}
+
 static int do_seeprom(struct cmd_context *ctx)
 {
 	int seeprom_changed = 0;
@@ -3397,20 +5023,32 @@ static int do_seeprom(struct cmd_context *ctx)
 	u32 seeprom_offset = 0;
 	u8 seeprom_value = 0;
 	int seeprom_value_seen = 0;
+	char *seeprom_file = NULL;
+	int seeprom_verify = 0;
 	struct cmdline_info cmdline_seeprom[] = {
 		{ "magic", CMDL_U32, &seeprom_magic, NULL },
 		{ "offset", CMDL_U32, &seeprom_offset, NULL },
 		{ "length", CMDL_U32, &seeprom_length, NULL },
 		{ "value", CMDL_U8, &seeprom_value, NULL,
 		  0, &seeprom_value_seen },
+		{ "file", CMDL_STR, &seeprom_file, NULL },
+		{ "verify", CMDL_BOOL, &seeprom_verify, NULL },
 	};
 	int err;
 	struct ethtool_drvinfo drvinfo;
 	struct ethtool_eeprom *eeprom;
+	struct file_map map = { .base = NULL };
+	u32 file_length;
 
 	parse_generic_cmdline(ctx, &seeprom_changed,
 			      cmdline_seeprom, ARRAY_SIZE(cmdline_seeprom));
 
+	if (seeprom_file && seeprom_value_seen) {
+		fprintf(stderr, "file and value cannot be specified "
+			"together\n");
+		return 1;
+	}
+
 	drvinfo.cmd = ETHTOOL_GDRVINFO;
 	err = send_ioctl(ctx, &drvinfo);
 	if (err < 0) {
@@ -3421,28 +5059,49 @@ static int do_seeprom(struct cmd_context *ctx)
 	if (seeprom_value_seen)
 		seeprom_length = 1;
 
-	if (seeprom_length == -1)
+	if (seeprom_file) {
+		/* The image holds the whole EEPROM, from offset 0 */
+		file_length = seeprom_length;
+		eeprom = dump_file_map(&map, seeprom_file, seeprom_offset,
+				       &file_length,
+				       offsetof(struct ethtool_eeprom, data));
+		if (!eeprom)
+			return 75;
+		if (seeprom_length != -1 && file_length < seeprom_length) {
+			fprintf(stderr, "not enough data in '%s'\n",
+				seeprom_file);
+			file_unmap(&map);
+			return 75;
+		}
+		seeprom_length = file_length;
+	} else if (seeprom_length == -1) {
 		seeprom_length = drvinfo.eedump_len;
+	}
 
 	if (drvinfo.eedump_len < seeprom_offset + seeprom_length) {
 		fprintf(stderr, "offset & length out of bounds\n");
+		if (map.base)
+			file_unmap(&map);
 		return 1;
 	}
 
-	eeprom = calloc(1, sizeof(*eeprom)+seeprom_length);
-	if (!eeprom) {
-		perror("Cannot allocate memory for EEPROM data");
-		return 75;
+	if (!map.base) {
+		eeprom = calloc(1, sizeof(*eeprom)+seeprom_length);
+		if (!eeprom) {
+			perror("Cannot allocate memory for EEPROM data");
+			return 75;
+		}
 	}
 
 	eeprom->cmd = ETHTOOL_SEEPROM;
 	eeprom->len = seeprom_length;
 	eeprom->offset = seeprom_offset;
 	eeprom->magic = seeprom_magic;
-	eeprom->data[0] = seeprom_value;
+	if (seeprom_value_seen)
+		eeprom->data[0] = seeprom_value;
 
 	/* Multi-byte write: read input from stdin */
-	if (!seeprom_value_seen) {
+	if (!seeprom_value_seen && !map.base) {
 		if (fread(eeprom->data, eeprom->len, 1, stdin) != 1) {
 			fprintf(stderr, "not enough data from stdin\n");
 			free(eeprom);
@@ -3455,12 +5114,19 @@ static int do_seeprom(struct cmd_context *ctx)
 		}
 	}
 
-	err = send_ioctl(ctx, eeprom);
-	if (err < 0) {
-		perror("Cannot set EEPROM data");
-		err = 87;
+	if (seeprom_verify) {
+		err = eeprom_write_delta(ctx, eeprom);
+	} else {
+		err = send_ioctl(ctx, eeprom);
+		if (err < 0) {
+			perror("Cannot set EEPROM data");
+			err = 87;
+		}
 	}
-	free(eeprom);
+	if (map.base)
+		file_unmap(&map);
+	else
+		free(eeprom);
 
 	return err;
 }
@@ -3821,8 +5487,8 @@ static int do_grxfhindir(struct cmd_context *ctx,
 static int do_grxfh(struct cmd_context *ctx)
 {
 	struct ethtool_gstrings *hfuncs = NULL;
-	struct ethtool_rxfh rss_head = {0};
 	struct ethtool_rxnfc ring_count;
+	struct ethtool_dev dev;
 	struct ethtool_rxfh *rss;
 	u32 rss_context = 0;
 	u32 i, indir_bytes;
@@ -3848,32 +5514,13 @@ static int do_grxfh(struct cmd_context *ctx)
 		return 1;
 	}
 
-	rss_head.cmd = ETHTOOL_GRSSH;
-	rss_head.rss_context = rss_context;
-	err = send_ioctl(ctx, &rss_head);
-	if (err < 0 && errno == EOPNOTSUPP && !rss_context) {
+	ctx_ethtool_dev(ctx, &dev);
+	err = ethtool_fetch_rxfh(&dev, rss_context, &rss);
+	if (err == -EOPNOTSUPP && !rss_context) {
 		return do_grxfhindir(ctx, &ring_count);
-	} else if (err < 0) {
-		perror("Cannot get RX flow hash indir size and/or key size");
-		return 1;
-	}
-
-	rss = calloc(1, sizeof(*rss) +
-			rss_head.indir_size * sizeof(rss_head.rss_config[0]) +
-			rss_head.key_size);
-	if (!rss) {
-		perror("Cannot allocate memory for RX flow hash config");
-		return 1;
-	}
-
-	rss->cmd = ETHTOOL_GRSSH;
-	rss->rss_context = rss_context;
-	rss->indir_size = rss_head.indir_size;
-	rss->key_size = rss_head.key_size;
-	err = send_ioctl(ctx, rss);
-	if (err < 0) {
+	} else if (err) {
+		errno = -err;
 		perror("Cannot get RX flow hash configuration");
-		free(rss);
 		return 1;
 	}
 
@@ -4458,25 +6105,77 @@ static int do_srxntuple(struct cmd_context *ctx,
 	return 0;
 }
 
-static int do_writefwdump(struct ethtool_dump *dump, const char *dump_file)
+#ifdef HAVE_ZLIB
+#define FWDUMP_ZCHUNK	65536
+
+static int fwdump_write_gzip(FILE *f, const u8 *data, u32 len)
+{
+	static unsigned char out[FWDUMP_ZCHUNK];
+	z_stream zs;
+	size_t bytes;
+	int ret;
+
+	memset(&zs, 0, sizeof(zs));
+	/* 16 + window bits selects the gzip wrapper.  Favour speed: the
+	 * dump is usually taken while the host is in trouble.
+	 */
+	if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, 16 + 15, 8,
+			 Z_DEFAULT_STRATEGY) != Z_OK)
+		return -1;
+
+	zs.next_in = (Bytef *)data;
+	zs.avail_in = len;
+	do {
+		zs.next_out = out;
+		zs.avail_out = sizeof(out);
+		ret = deflate(&zs, Z_FINISH);
+		if (ret == Z_STREAM_ERROR)
+			break;
+		bytes = sizeof(out) - zs.avail_out;
+		if (fwrite(out, 1, bytes, f) != bytes) {
+			ret = Z_ERRNO;
+			break;
+		}
+	} while (ret != Z_STREAM_END);
+
+	deflateEnd(&zs);
+	return ret == Z_STREAM_END ? 0 : -1;
+}
+#endif
+
+static int do_writefwdump(struct ethtool_dump *dump, const char *dump_file,
+			  int compress)
 {
 	int err = 0;
 	FILE *f;
-	size_t bytes;
+	int ret;
 
-	f = fopen(dump_file, "wb+");
+	if (!strcmp(dump_file, "-"))
+		f = stdout;
+	else
+		f = fopen(dump_file, "wb+");
 
 	if (!f) {
 		fprintf(stderr, "Can't open file %s: %s\n",
 			dump_file, strerror(errno));
 		return 1;
 	}
-	bytes = fwrite(dump->data, 1, dump->len, f);
-	if (bytes != dump->len) {
+#ifdef HAVE_ZLIB
+	if (compress)
+		ret = fwdump_write_gzip(f, dump->data, dump->len);
+	else
+#endif
+		ret = fwrite(dump->data, 1, dump->len, f) == dump->len ? 0 : -1;
+	if (ret) {
 		fprintf(stderr, "Can not write all of dump data\n");
 		err = 1;
 	}
-	if (fclose(f)) {
+	if (f == stdout) {
+		if (fflush(f)) {
+			perror("Can't flush dump data");
+			err = 1;
+		}
+	} else if (fclose(f)) {
 		fprintf(stderr, "Can't close file %s: %s\n",
 			dump_file, strerror(errno));
 		err = 1;
@@ -4484,17 +6183,90 @@ static int do_writefwdump(struct ethtool_dump *dump, const char *dump_file)
 	return err;
 }
 
+/*
+ * Map a preallocated output file so that the kernel copies the dump
+ * straight into the page cache.
+ */
+static struct ethtool_dump *
+fwdump_map_file(struct file_map *map, const char *path, u32 len)
+{
+	struct ethtool_dump *dump;
+	int err;
+
+	map->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (map->fd < 0) {
+		fprintf(stderr, "Can't open file %s: %s\n",
+			path, strerror(errno));
+		return NULL;
+	}
+	if (len) {
+		err = posix_fallocate(map->fd, 0, len);
+		if (err) {
+			fprintf(stderr, "Can't preallocate %u bytes in %s: %s\n",
+				len, path, strerror(err));
+			goto err_close;
+		}
+	}
+
+	dump = file_map_view(map, 0, len, offsetof(struct ethtool_dump, data),
+			     MAP_SHARED);
+	if (dump)
+		return dump;
+
+	fprintf(stderr, "Can't map file %s: %s\n", path, strerror(errno));
+err_close:
+	close(map->fd);
+	unlink(path);
+	return NULL;
+}
+
+static int fwdump_unmap_file(struct file_map *map, const char *path,
+			     const struct ethtool_dump *dump, int failed)
+{
+	int err = 0;
+
+	/* The kernel may return less than it advertised */
+	if (!failed && dump->len < map->len &&
+	    ftruncate(map->fd, dump->len)) {
+		fprintf(stderr, "Can't truncate file %s: %s\n",
+			path, strerror(errno));
+		err = 1;
+	}
+	file_unmap(map);
+	if (close(map->fd)) {
+		fprintf(stderr, "Can't close file %s: %s\n",
+			path, strerror(errno));
+		err = 1;
+	}
+	if (failed)
+		unlink(path);
+	return err;
+}
+
 static int do_getfwdump(struct cmd_context *ctx)
 {
 	u32 dump_flag;
 	char *dump_file;
+	int dump_changed = 0;
+	int dump_compress = 0;
+	int dump_mmap = 0;
 	int err;
 	struct ethtool_dump edata;
 	struct ethtool_dump *data;
+	struct file_map map = { .fd = -1 };
+
+	struct cmdline_info cmdline_dump[] = {
+		{ "compress", CMDL_BOOL, &dump_compress, NULL },
+		{ "mmap", CMDL_BOOL, &dump_mmap, NULL },
+	};
 
-	if (ctx->argc == 2 && !strcmp(ctx->argp[0], "data")) {
+	if (ctx->argc >= 2 && !strcmp(ctx->argp[0], "data")) {
 		dump_flag = ETHTOOL_GET_DUMP_DATA;
 		dump_file = ctx->argp[1];
+		ctx->argc -= 2;
+		ctx->argp += 2;
+		parse_generic_cmdline(ctx, &dump_changed,
+				      cmdline_dump, ARRAY_SIZE(cmdline_dump));
 	} else if (ctx->argc == 0) {
 		dump_flag = 0;
 		dump_file = NULL;
@@ -4502,6 +6274,18 @@ static int do_getfwdump(struct cmd_context *ctx)
 		exit_bad_args();
 	}
 
+#ifndef HAVE_ZLIB
+	if (dump_compress) {
+		fprintf(stderr, "Dump compression is not supported by this "
+			"build of ethtool\n");
+		return 1;
+	}
+#endif
+	if (dump_mmap && (dump_compress || !strcmp(dump_file, "-"))) {
+		fprintf(stderr, "mmap capture needs an uncompressed dump file\n");
+		return 1;
+	}
+
 	edata.cmd = ETHTOOL_GET_DUMP_FLAG;
 
 	err = send_ioctl(ctx, &edata);
@@ -4514,10 +6298,17 @@ static int do_getfwdump(struct cmd_context *ctx)
 			edata.flag, edata.version, edata.len);
 		return 0;
 	}
-	data = calloc(1, offsetof(struct ethtool_dump, data) + edata.len);
-	if (!data) {
-		perror("Can not allocate enough memory\n");
-		return 1;
+	if (dump_mmap) {
+		data = fwdump_map_file(&map, dump_file, edata.len);
+		if (!data)
+			return 1;
+	} else {
+		data = calloc(1, offsetof(struct ethtool_dump, data) +
+			      edata.len);
+		if (!data) {
+			perror("Can not allocate enough memory\n");
+			return 1;
+		}
 	}
 	data->cmd = ETHTOOL_GET_DUMP_DATA;
 	data->len = edata.len;
@@ -4525,11 +6316,13 @@ static int do_getfwdump(struct cmd_context *ctx)
 	if (err < 0) {
 		perror("Can not get dump data\n");
 		err = 1;
-		goto free;
+	} else if (!dump_mmap) {
+		err = do_writefwdump(data, dump_file, dump_compress);
 	}
-	err = do_writefwdump(data, dump_file);
-free:
-	free(data);
+	if (dump_mmap)
+		err |= fwdump_unmap_file(&map, dump_file, data, err);
+	else
+		free(data);
 	return err;
 }
 
@@ -4675,618 +6468,2664 @@ err:
 	return rc;
 }
 
-static int do_tsinfo(struct cmd_context *ctx)
-{
-	struct ethtool_ts_info info;
+/*
+ * Settings saved by --save, in the order that --restore applies them.
+ * Channels go first because drivers may reset the RSS table when they
+ * change, and features go last.
+ */
+enum settings_group {
+	SETTINGS_CHANNELS,
+	SETTINGS_RXFH,
+	SETTINGS_RING,
+	SETTINGS_COALESCE,
+	SETTINGS_PAUSE,
+	SETTINGS_PRIV_FLAGS,
+	SETTINGS_FEATURES,
+	SETTINGS_N_GROUPS
+};
 
-	if (ctx->argc != 0)
-		exit_bad_args();
+static const char *const settings_group_name[SETTINGS_N_GROUPS] = {
+	[SETTINGS_CHANNELS]	= "channels",
+	[SETTINGS_RXFH]		= "rxfh",
+	[SETTINGS_RING]		= "ring",
+	[SETTINGS_COALESCE]	= "coalesce",
+	[SETTINGS_PAUSE]	= "pause",
+	[SETTINGS_PRIV_FLAGS]	= "priv-flags",
+	[SETTINGS_FEATURES]	= "features",
+};
 
-	fprintf(stdout, "Time stamping parameters for %s:\n", ctx->devname);
-	info.cmd = ETHTOOL_GET_TS_INFO;
-	if (send_ioctl(ctx, &info)) {
-		perror("Cannot get device time stamping settings");
-		return -1;
-	}
-	dump_tsinfo(&info);
-	return 0;
-}
+/* The most fields of any group, which is coalesce */
+#define SETTINGS_MAX_FIELDS	22
 
-static int do_getmodule(struct cmd_context *ctx)
-{
-	struct ethtool_modinfo modinfo;
-	struct ethtool_eeprom *eeprom;
-	u32 geeprom_offset = 0;
-	u32 geeprom_length = -1;
-	int geeprom_changed = 0;
-	int geeprom_dump_raw = 0;
-	int geeprom_dump_hex = 0;
-	int err;
+/* A group of settings read and written as one ioctl structure */
+struct settings_simple {
+	u32 get_cmd, set_cmd;
+	union {
+		u32 cmd;
+		struct ethtool_channels channels;
+		struct ethtool_ringparam ring;
+		struct ethtool_coalesce coalesce;
+		struct ethtool_pauseparam pause;
+	} data;
+	struct cmdline_info info[SETTINGS_MAX_FIELDS];
+	s32 wanted[SETTINGS_MAX_FIELDS];
+	unsigned int n_info;
+};
 
-	struct cmdline_info cmdline_geeprom[] = {
-		{ "offset", CMDL_U32, &geeprom_offset, NULL },
-		{ "length", CMDL_U32, &geeprom_length, NULL },
-		{ "raw", CMDL_BOOL, &geeprom_dump_raw, NULL },
-		{ "hex", CMDL_BOOL, &geeprom_dump_hex, NULL },
-	};
+struct settings {
+	struct settings_simple simple[SETTINGS_N_GROUPS];
+	/* Arguments of each group read from a file, or NULL */
+	struct cmd_context args[SETTINGS_N_GROUPS];
+	/* RSS indirection table and hash key */
+	u32 *indir;
+	u32 indir_size;
+	const char *hkey;
+	/* Private flags */
+	u32 priv_flags_wanted, priv_flags_seen;
+	/* Named features */
+	struct feature_defs *defs;
+	struct ethtool_set_features_block *features_wanted;
+	/* An ioctl buffer undoing each group that has been restored */
+	void *undo[SETTINGS_N_GROUPS];
+};
 
-	parse_generic_cmdline(ctx, &geeprom_changed,
-			      cmdline_geeprom, ARRAY_SIZE(cmdline_geeprom));
+/* Copy a table of cmdline_info pointing into @base, so that it points
+ * into the group's own ioctl structure and wanted values instead.
+ */
+static void settings_simple_init(struct settings_simple *simple,
+				 u32 get_cmd, u32 set_cmd,
+				 const struct cmdline_info *info,
+				 unsigned int n_info, const void *base)
+{
+	unsigned int i;
 
-	if (geeprom_dump_raw && geeprom_dump_hex) {
-		printf("Hex and raw dump cannot be specified together\n");
-		return 1;
+	simple->get_cmd = get_cmd;
+	simple->set_cmd = set_cmd;
+	simple->n_info = n_info;
+	for (i = 0; i < n_info; i++) {
+		simple->info[i] = info[i];
+		simple->wanted[i] = -1;
+		simple->info[i].wanted_val = &simple->wanted[i];
+		simple->info[i].ioctl_val = (char *)&simple->data +
+			((const char *)info[i].ioctl_val - (const char *)base);
 	}
+}
 
-	modinfo.cmd = ETHTOOL_GMODULEINFO;
-	err = send_ioctl(ctx, &modinfo);
-	if (err < 0) {
-		perror("Cannot get module EEPROM information");
-		return 1;
-	}
+static void settings_init(struct settings *settings)
+{
+	struct ethtool_channels echannels;
+	struct ethtool_ringparam ering;
+	struct ethtool_coalesce ecoal;
+	struct ethtool_pauseparam epause;
+	DECLARE_CHANNELS_OPTION_VARS();
+	DECLARE_RING_OPTION_VARS();
+	DECLARE_COALESCE_OPTION_VARS();
+	DECLARE_PAUSE_OPTION_VARS();
+	const struct cmdline_info cmdline_channels[] =
+		CHANNELS_CMDLINE_INFO(echannels);
+	const struct cmdline_info cmdline_ring[] = RING_CMDLINE_INFO(ering);
+	const struct cmdline_info cmdline_coalesce[] =
+		COALESCE_CMDLINE_INFO(ecoal);
+	const struct cmdline_info cmdline_pause[] = PAUSE_CMDLINE_INFO(epause);
+
+	BUILD_BUG_ON(ARRAY_SIZE(cmdline_channels) > SETTINGS_MAX_FIELDS);
+	BUILD_BUG_ON(ARRAY_SIZE(cmdline_ring) > SETTINGS_MAX_FIELDS);
+	BUILD_BUG_ON(ARRAY_SIZE(cmdline_coalesce) > SETTINGS_MAX_FIELDS);
+	BUILD_BUG_ON(ARRAY_SIZE(cmdline_pause) > SETTINGS_MAX_FIELDS);
+
+	memset(settings, 0, sizeof(*settings));
+	settings_simple_init(&settings->simple[SETTINGS_CHANNELS],
+			     ETHTOOL_GCHANNELS, ETHTOOL_SCHANNELS,
+			     cmdline_channels, ARRAY_SIZE(cmdline_channels),
+			     &echannels);
+	settings_simple_init(&settings->simple[SETTINGS_RING],
+			     ETHTOOL_GRINGPARAM, ETHTOOL_SRINGPARAM,
+			     cmdline_ring, ARRAY_SIZE(cmdline_ring), &ering);
+	settings_simple_init(&settings->simple[SETTINGS_COALESCE],
+			     ETHTOOL_GCOALESCE, ETHTOOL_SCOALESCE,
+			     cmdline_coalesce, ARRAY_SIZE(cmdline_coalesce),
+			     &ecoal);
+	settings_simple_init(&settings->simple[SETTINGS_PAUSE],
+			     ETHTOOL_GPAUSEPARAM, ETHTOOL_SPAUSEPARAM,
+			     cmdline_pause, ARRAY_SIZE(cmdline_pause), &epause);
+}
 
-	if (geeprom_length == -1)
-		geeprom_length = modinfo.eeprom_len;
+static void settings_free(struct settings *settings)
+{
+	unsigned int i;
 
-	if (modinfo.eeprom_len < geeprom_offset + geeprom_length)
-		geeprom_length = modinfo.eeprom_len - geeprom_offset;
+	for (i = 0; i < SETTINGS_N_GROUPS; i++)
+		free(settings->undo[i]);
+	free(settings->indir);
+	free(settings->defs);
+	free(settings->features_wanted);
+}
 
-	eeprom = calloc(1, sizeof(*eeprom)+geeprom_length);
-	if (!eeprom) {
-		perror("Cannot allocate memory for Module EEPROM data");
-		return 1;
-	}
+static void *settings_undo_copy(const void *data, size_t size, u32 cmd)
+{
+	void *undo = malloc(size);
 
-	eeprom->cmd = ETHTOOL_GMODULEEEPROM;
-	eeprom->len = geeprom_length;
-	eeprom->offset = geeprom_offset;
-	err = send_ioctl(ctx, eeprom);
-	if (err < 0) {
-		perror("Cannot get Module EEPROM data");
-		free(eeprom);
-		return 1;
+	if (undo) {
+		memcpy(undo, data, size);
+		*(u32 *)undo = cmd;
 	}
+	return undo;
+}
 
-	/*
-	 * SFF-8079 EEPROM layout contains the memory available at A0 address on
-	 * the PHY EEPROM.
-	 * SFF-8472 defines a virtual extension of the EEPROM, where the
-	 * microcontroller on the SFP/SFP+ generates a page at the A2 address,
-	 * which contains data relative to optical diagnostics.
-	 * The current kernel implementation returns a blob, which contains:
-	 *  - ETH_MODULE_SFF_8079 => The A0 page only.
-	 *  - ETH_MODULE_SFF_8472 => The A0 and A2 page concatenated.
-	 */
-	if (geeprom_dump_raw) {
-		fwrite(eeprom->data, 1, eeprom->len, stdout);
-	} else {
-		if (eeprom->offset != 0  ||
-		    (eeprom->len != modinfo.eeprom_len)) {
-			geeprom_dump_hex = 1;
-		} else if (!geeprom_dump_hex) {
-			switch (modinfo.type) {
-#ifdef ETHTOOL_ENABLE_PRETTY_DUMP
-			case ETH_MODULE_SFF_8079:
-				sff8079_show_all(eeprom->data);
-				break;
-			case ETH_MODULE_SFF_8472:
-				sff8079_show_all(eeprom->data);
-				sff8472_show_all(eeprom->data);
-				break;
-			case ETH_MODULE_SFF_8436:
-			case ETH_MODULE_SFF_8636:
-				sff8636_show_all(eeprom->data,
-						 modinfo.eeprom_len);
-				break;
-#endif
-			default:
-				geeprom_dump_hex = 1;
-				break;
-			}
+static struct ethtool_rxfh *get_rxfh(struct cmd_context *ctx)
+{
+	struct ethtool_rxfh *rss;
+	struct ethtool_dev dev;
+
+	ctx_ethtool_dev(ctx, &dev);
+	if (ethtool_fetch_rxfh(&dev, 0, &rss))
+		return NULL;
+	return rss;
+}
+
+/* Write one group; a group the device does not support is left out */
+static int save_settings_group(struct cmd_context *ctx,
+			       struct settings *settings,
+			       enum settings_group group, FILE *file)
+{
+	struct settings_simple *simple = &settings->simple[group];
+	const char *name = settings_group_name[group];
+	struct ethtool_gstrings *strings;
+	struct feature_state *state;
+	struct ethtool_value flags;
+	struct ethtool_rxfh *rss;
+	const u8 *hkey;
+	int any = 0;
+	u32 i;
+
+	switch (group) {
+	case SETTINGS_RXFH:
+		rss = get_rxfh(ctx);
+		if (!rss)
+			break;
+		if (rss->indir_size || rss->key_size)
+			fputs(name, file);
+		if (rss->indir_size)
+			fputs(" indir", file);
+		for (i = 0; i < rss->indir_size; i++)
+			fprintf(file, " %u", rss->rss_config[i]);
+		hkey = (const u8 *)&rss->rss_config[rss->indir_size];
+		for (i = 0; i < rss->key_size; i++)
+			fprintf(file, "%s%02x", i ? ":" : " hkey ", hkey[i]);
+		if (rss->indir_size || rss->key_size)
+			fputc('\n', file);
+		free(rss);
+		return 0;
+
+	case SETTINGS_PRIV_FLAGS:
+		strings = get_stringset(ctx, ETH_SS_PRIV_FLAGS,
+					offsetof(struct ethtool_drvinfo,
+						 n_priv_flags), 1);
+		if (!strings)
+			break;
+		flags.cmd = ETHTOOL_GPFLAGS;
+		if (strings->len && send_ioctl(ctx, &flags)) {
+			free(strings);
+			break;
 		}
-		if (geeprom_dump_hex)
-			dump_hex(stdout, eeprom->data,
-				 eeprom->len, eeprom->offset);
-	}
+		for (i = 0; i < strings->len && i < 32; i++)
+			fprintf(file, "%s %s %s", i ? "" : name,
+				(const char *)strings->data +
+				i * ETH_GSTRING_LEN,
+				flags.data & (1U << i) ? "on" : "off");
+		if (strings->len)
+			fputc('\n', file);
+		free(strings);
+		return 0;
 
-	free(eeprom);
+	case SETTINGS_FEATURES:
+		settings->defs = get_feature_defs(ctx);
+		if (!settings->defs) {
+			perror("Cannot get device feature names");
+			return 1;
+		}
+		if (!settings->defs->n_features)
+			return 0;
+		state = get_features(ctx, settings->defs);
+		if (!state)
+			return 1;
+		/* Only the features that can be changed are of interest */
+		for (i = 0; i < settings->defs->n_features; i++) {
+			if (!settings->defs->def[i].name[0] ||
+			    !FEATURE_BIT_IS_SET(state->features.features,
+						i, available) ||
+			    FEATURE_BIT_IS_SET(state->features.features,
+					       i, never_changed))
+				continue;
+			fprintf(file, "%s %s %s", any ? "" : name,
+				settings->defs->def[i].name,
+				FEATURE_BIT_IS_SET(state->features.features,
+						   i, active) ? "on" : "off");
+			any = 1;
+		}
+		if (any)
+			fputc('\n', file);
+		free(state);
+		return 0;
 
-	return 0;
+	default:
+		memset(&simple->data, 0, sizeof(simple->data));
+		simple->data.cmd = simple->get_cmd;
+		if (send_ioctl(ctx, &simple->data))
+			break;
+		fputs(name, file);
+		for (i = 0; i < simple->n_info; i++) {
+			s32 value = *(s32 *)simple->info[i].ioctl_val;
+
+			if (simple->info[i].type == CMDL_BOOL)
+				fprintf(file, " %s %s", simple->info[i].name,
+					value ? "on" : "off");
+			else
+				fprintf(file, " %s %d", simple->info[i].name,
+					value);
+		}
+		fputc('\n', file);
+		return 0;
+	}
+
+	if (errno == EOPNOTSUPP)
+		return 0;
+	fprintf(stderr, "Cannot get device %s settings: %m\n", name);
+	return 1;
 }
 
-static int do_geee(struct cmd_context *ctx)
+static int do_save(struct cmd_context *ctx)
 {
-	struct ethtool_eee eeecmd;
+	struct settings settings;
+	char tmp_name[PATH_MAX];
+	unsigned int group;
+	int rc = 0;
+	FILE *file;
 
-	if (ctx->argc != 0)
+	if (ctx->argc != 1)
 		exit_bad_args();
 
-	eeecmd.cmd = ETHTOOL_GEEE;
-	if (send_ioctl(ctx, &eeecmd)) {
-		perror("Cannot get EEE settings");
+	/* Write a new file alongside, so that a failure leaves any
+	 * earlier profile of the same name in place
+	 */
+	if (snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", ctx->argp[0]) >=
+	    sizeof(tmp_name)) {
+		fprintf(stderr, "File name too long\n");
+		return 1;
+	}
+	file = fopen(tmp_name, "w");
+	if (!file) {
+		fprintf(stderr, "Can't open '%s': %m\n", tmp_name);
 		return 1;
 	}
 
-	fprintf(stdout, "EEE Settings for %s:\n", ctx->devname);
-	dump_eeecmd(&eeecmd);
+	settings_init(&settings);
+	fprintf(file, "# ethtool --restore %s settings\n", ctx->devname);
+	for (group = 0; group < SETTINGS_N_GROUPS && !rc; group++)
+		rc = save_settings_group(ctx, &settings, group, file);
+	settings_free(&settings);
 
-	return 0;
+	if ((ferror(file) | fclose(file)) && !rc) {
+		fprintf(stderr, "Can't write '%s': %m\n", tmp_name);
+		rc = 1;
+	}
+	if (!rc && rename(tmp_name, ctx->argp[0])) {
+		fprintf(stderr, "Can't rename '%s': %m\n", tmp_name);
+		rc = 1;
+	}
+	if (rc)
+		unlink(tmp_name);
+	return rc;
 }
 
-static int do_seee(struct cmd_context *ctx)
+/* Parse a number read from a settings file; 0 if it is valid */
+static int settings_get_u32(const char *str, u32 *val)
 {
-	int adv_c = -1, lpi_c = -1, lpi_time_c = -1, eee_c = -1;
-	int change = -1, change2 = 0;
-	struct ethtool_eee eeecmd;
-	struct cmdline_info cmdline_eee[] = {
-		{ "advertise",    CMDL_U32,  &adv_c,       &eeecmd.advertised },
-		{ "tx-lpi",       CMDL_BOOL, &lpi_c,   &eeecmd.tx_lpi_enabled },
-		{ "tx-timer",	  CMDL_U32,  &lpi_time_c, &eeecmd.tx_lpi_timer},
-		{ "eee",	  CMDL_BOOL, &eee_c,	   &eeecmd.eee_enabled},
-	};
+	unsigned long long v;
+	char *endp;
 
-	if (ctx->argc == 0)
-		exit_bad_args();
+	errno = 0;
+	v = strtoull(str, &endp, 0);
+	if (errno || *endp || v > 0xffffffff)
+		return -1;
+	*val = v;
+	return 0;
+}
 
-	parse_generic_cmdline(ctx, &change, cmdline_eee,
-			      ARRAY_SIZE(cmdline_eee));
+/* Check the arguments of a group read from a file before passing them
+ * to parse_generic_cmdline(), which would exit with the usage message.
+ * Only the types that --save writes are accepted.
+ */
+static int settings_args_valid(const struct cmd_context *args,
+			       const struct cmdline_info *info,
+			       unsigned int n_info)
+{
+	unsigned int idx;
+	long long val;
+	char *endp;
+	int i;
 
-	eeecmd.cmd = ETHTOOL_GEEE;
-	if (send_ioctl(ctx, &eeecmd)) {
-		perror("Cannot get EEE settings");
-		return 1;
+	for (i = 0; i < args->argc; i += 2) {
+		for (idx = 0; idx < n_info; idx++)
+			if (!strcmp(info[idx].name, args->argp[i]))
+				break;
+		if (idx == n_info || i + 1 >= args->argc)
+			return 0;
+		switch (info[idx].type) {
+		case CMDL_BOOL:
+		case CMDL_FLAG:
+			if (strcmp(args->argp[i + 1], "on") &&
+			    strcmp(args->argp[i + 1], "off"))
+				return 0;
+			break;
+		case CMDL_S32:
+			errno = 0;
+			val = strtoll(args->argp[i + 1], &endp, 0);
+			if (errno || *endp || val < -0x80000000LL ||
+			    val > 0x7fffffff)
+				return 0;
+			break;
+		default:
+			return 0;
+		}
 	}
+	return 1;
+}
 
-	do_generic_set(cmdline_eee, ARRAY_SIZE(cmdline_eee), &change2);
+/* Check the arguments of each group read from a file and look up any
+ * names they use, before anything is changed
+ */
+static int parse_settings(struct cmd_context *ctx, struct settings *settings)
+{
+	struct cmd_context *args;
+	struct ethtool_gstrings *strings;
+	struct cmdline_info *cmdline;
+	struct cmdline_info cmdline_feature;
+	int seen, valid, i, j;
 
-	if (change2) {
-		eeecmd.cmd = ETHTOOL_SEEE;
-		if (send_ioctl(ctx, &eeecmd)) {
-			perror("Cannot set EEE settings");
-			return 1;
+	for (i = 0; i < SETTINGS_N_GROUPS; i++) {
+		args = &settings->args[i];
+		if (!args->argp)
+			continue;
+
+		switch (i) {
+		case SETTINGS_RXFH:
+			for (j = 0; j < args->argc; j++) {
+				if (!strcmp(args->argp[j], "hkey") &&
+				    j + 1 < args->argc) {
+					settings->hkey = args->argp[++j];
+				} else if (!strcmp(args->argp[j], "indir") &&
+					   !settings->indir) {
+					settings->indir = calloc(args->argc,
+								 sizeof(u32));
+					if (!settings->indir) {
+						perror("Cannot allocate memory for RSS table");
+						return 1;
+					}
+					while (j + 1 < args->argc &&
+					       isdigit((unsigned char)
+						       args->argp[j + 1][0])) {
+						if (settings_get_u32(
+							    args->argp[++j],
+							    &settings->indir[
+							    settings->indir_size++]))
+							goto bad;
+					}
+				} else {
+					goto bad;
+				}
+			}
+			break;
+
+		case SETTINGS_PRIV_FLAGS:
+			strings = get_stringset(ctx, ETH_SS_PRIV_FLAGS,
+						offsetof(struct ethtool_drvinfo,
+							 n_priv_flags), 1);
+			if (!strings) {
+				perror("Cannot get private flag names");
+				return 1;
+			}
+			if (strings->len > 32)
+				strings->len = 32;
+			cmdline = calloc(strings->len + 1, sizeof(*cmdline));
+			if (!cmdline) {
+				perror("Cannot parse arguments");
+				free(strings);
+				return 1;
+			}
+			for (j = 0; j < strings->len; j++) {
+				cmdline[j].name = ((const char *)strings->data +
+						   j * ETH_GSTRING_LEN);
+				cmdline[j].type = CMDL_FLAG;
+				cmdline[j].wanted_val =
+					&settings->priv_flags_wanted;
+				cmdline[j].flag_val = 1U << j;
+				cmdline[j].seen_val =
+					&settings->priv_flags_seen;
+			}
+			valid = settings_args_valid(args, cmdline,
+						    strings->len);
+			if (valid)
+				parse_generic_cmdline(args, &seen, cmdline,
+						      strings->len);
+			free(cmdline);
+			free(strings);
+			if (!valid)
+				goto bad;
+			break;
+
+		case SETTINGS_FEATURES:
+			settings->defs = get_feature_defs(ctx);
+			if (!settings->defs) {
+				perror("Cannot get device feature names");
+				return 1;
+			}
+			settings->features_wanted =
+				calloc(FEATURE_BITS_TO_BLOCKS(
+					       settings->defs->n_features) + 1,
+				       sizeof(settings->features_wanted[0]));
+			if (!settings->features_wanted) {
+				perror("Cannot parse arguments");
+				return 1;
+			}
+			for (j = 0; j < args->argc; j += 2) {
+				struct cmd_context pair_ctx = *args;
+				int k = find_feature(settings->defs,
+						     args->argp[j]);
+
+				if (k < 0)
+					goto bad;
+				flag_to_cmdline_info(
+					settings->defs->def[k].name,
+					FEATURE_FIELD_FLAG(k),
+					&FEATURE_WORD(settings->features_wanted,
+						      k, requested),
+					&FEATURE_WORD(settings->features_wanted,
+						      k, valid),
+					&cmdline_feature);
+				pair_ctx.argc = args->argc - j < 2 ? 1 : 2;
+				pair_ctx.argp = args->argp + j;
+				if (!settings_args_valid(&pair_ctx,
+							 &cmdline_feature, 1))
+					goto bad;
+				parse_generic_cmdline(&pair_ctx, &seen,
+						      &cmdline_feature, 1);
+			}
+			break;
+
+		default:
+			if (!settings_args_valid(args, settings->simple[i].info,
+						 settings->simple[i].n_info))
+				goto bad;
+			parse_generic_cmdline(args, &seen,
+					      settings->simple[i].info,
+					      settings->simple[i].n_info);
+			break;
 		}
 	}
 
 	return 0;
+
+bad:
+	fprintf(stderr, "Invalid %s settings in '%s'\n",
+		settings_group_name[i], ctx->argp[0]);
+	return 1;
 }
 
-static int do_get_phy_tunable(struct cmd_context *ctx)
+static int restore_rxfh(struct cmd_context *ctx, struct settings *settings,
+			int *changed)
 {
-	int argc = ctx->argc;
-	char **argp = ctx->argp;
-
-	if (argc < 1)
-		exit_bad_args();
+	struct ethtool_rxfh *rss, *set = NULL, *undo = NULL;
+	u32 indir_bytes, set_bytes = 0;
+	int indir_changed = 0;
+	char *hkey = NULL;
+	const char *key;
+	int rc = 1;
 
-	if (!strcmp(argp[0], "downshift")) {
-		struct {
-			struct ethtool_tunable ds;
-			u8 count;
-		} cont;
+	rss = get_rxfh(ctx);
+	if (!rss) {
+		perror("Cannot get RX flow hash configuration");
+		return 1;
+	}
+	indir_bytes = rss->indir_size * sizeof(rss->rss_config[0]);
+	key = (const char *)rss->rss_config + indir_bytes;
 
-		cont.ds.cmd = ETHTOOL_PHY_GTUNABLE;
-		cont.ds.id = ETHTOOL_PHY_DOWNSHIFT;
-		cont.ds.type_id = ETHTOOL_TUNABLE_U8;
-		cont.ds.len = 1;
-		if (send_ioctl(ctx, &cont.ds) < 0) {
-			perror("Cannot Get PHY downshift count");
-			return 87;
+	if (settings->indir) {
+		if (settings->indir_size != rss->indir_size) {
+			fprintf(stderr,
+				"RSS indirection table has %u entries, not %u\n",
+				rss->indir_size, settings->indir_size);
+			goto out;
 		}
-		if (cont.count)
-			fprintf(stdout, "Downshift count: %d\n", cont.count);
-		else
-			fprintf(stdout, "Downshift disabled\n");
-	} else if (!strcmp(argp[0], "fast-link-down")) {
-		struct {
-			struct ethtool_tunable fld;
-			u8 msecs;
-		} cont;
+		indir_changed = memcmp(settings->indir, rss->rss_config,
+				       indir_bytes) != 0;
+		if (indir_changed)
+			set_bytes += indir_bytes;
+	}
+	if (settings->hkey) {
+		if (parse_hkey(&hkey, rss->key_size, settings->hkey))
+			goto out;
+		if (!memcmp(hkey, key, rss->key_size)) {
+			free(hkey);
+			hkey = NULL;
+		} else {
+			set_bytes += rss->key_size;
+		}
+	}
+	if (!indir_changed && !hkey) {
+		rc = 0;
+		goto out;
+	}
+
+	/* The undo buffer holds the old values of whatever changes */
+	set = calloc(1, sizeof(*set) + set_bytes);
+	undo = calloc(1, sizeof(*undo) + set_bytes);
+	if (!set || !undo) {
+		perror("Cannot allocate memory for RX flow hash config");
+		goto out;
+	}
+	set->cmd = undo->cmd = ETHTOOL_SRSSH;
+	set->indir_size = undo->indir_size = ETH_RXFH_INDIR_NO_CHANGE;
+	if (indir_changed) {
+		set->indir_size = undo->indir_size = rss->indir_size;
+		memcpy(set->rss_config, settings->indir, indir_bytes);
+		memcpy(undo->rss_config, rss->rss_config, indir_bytes);
+	}
+	if (hkey) {
+		set->key_size = undo->key_size = rss->key_size;
+		memcpy((char *)set->rss_config + set_bytes - rss->key_size,
+		       hkey, rss->key_size);
+		memcpy((char *)undo->rss_config + set_bytes - rss->key_size,
+		       key, rss->key_size);
+	}
+
+	if (send_ioctl(ctx, set)) {
+		perror("Cannot set RX flow hash configuration");
+		goto out;
+	}
+	settings->undo[SETTINGS_RXFH] = undo;
+	undo = NULL;
+	*changed = 1;
+	rc = 0;
+out:
+	free(undo);
+	free(set);
+	free(hkey);
+	free(rss);
+	return rc;
+}
+
+static int restore_features(struct cmd_context *ctx,
+			    struct settings *settings, int *changed)
+{
+	const struct feature_defs *defs = settings->defs;
+	struct ethtool_sfeatures *set, *undo;
+	struct feature_state *state, *new_state = NULL;
+	int any_changed = 0, any_mismatch = 0;
+	size_t size;
+	int err, rc = 1;
+	u32 i;
+
+	state = get_features(ctx, defs);
+	if (!state)
+		return 1;
+
+	size = sizeof(*set) + FEATURE_BITS_TO_BLOCKS(defs->n_features) *
+		sizeof(set->features[0]);
+	set = calloc(1, size);
+	undo = calloc(1, size);
+	if (!set || !undo) {
+		perror("Cannot allocate memory for features");
+		goto out;
+	}
+	set->cmd = undo->cmd = ETHTOOL_SFEATURES;
+	set->size = undo->size = FEATURE_BITS_TO_BLOCKS(defs->n_features);
+
+	/* Change only those that differ and can be changed */
+	for (i = 0; i < defs->n_features; i++) {
+		int wanted = FEATURE_BIT_IS_SET(settings->features_wanted,
+						i, requested);
+
+		if (!FEATURE_BIT_IS_SET(settings->features_wanted, i, valid) ||
+		    !FEATURE_BIT_IS_SET(state->features.features,
+					i, available) ||
+		    FEATURE_BIT_IS_SET(state->features.features,
+				       i, never_changed) ||
+		    !FEATURE_BIT_IS_SET(state->features.features,
+					i, active) == !wanted)
+			continue;
+		FEATURE_BIT_SET(set->features, i, valid);
+		FEATURE_BIT_SET(undo->features, i, valid);
+		if (wanted)
+			FEATURE_BIT_SET(set->features, i, requested);
+		else
+			FEATURE_BIT_SET(undo->features, i, requested);
+		*changed = 1;
+	}
+
+	if (!*changed) {
+		rc = 0;
+		goto out;
+	}
+	err = send_ioctl(ctx, set);
+	if (err < 0) {
+		perror("Cannot set device feature settings");
+		*changed = 0;
+		goto out;
+	}
+	settings->undo[SETTINGS_FEATURES] = undo;
+	undo = NULL;
+	if (!err) {
+		rc = 0;
+		goto out;
+	}
+
+	/* The device did not take every request; see what it did take */
+	new_state = get_features(ctx, defs);
+	if (!new_state)
+		goto out;
+	for (i = 0; i < FEATURE_BITS_TO_BLOCKS(defs->n_features); i++) {
+		if (new_state->features.features[i].active !=
+		    state->features.features[i].active)
+			any_changed = 1;
+		if ((new_state->features.features[i].active ^
+		     set->features[i].requested) & set->features[i].valid)
+			any_mismatch = 1;
+	}
+	if (!any_mismatch) {
+		rc = 0;
+		goto out;
+	}
+	if (!any_changed) {
+		fprintf(stderr, "Could not change any device features\n");
+		free(settings->undo[SETTINGS_FEATURES]);
+		settings->undo[SETTINGS_FEATURES] = NULL;
+		*changed = 0;
+	} else {
+		fprintf(stderr, "Could not change all device features\n");
+		printf("Actual changes:\n");
+		dump_features(defs, new_state, state);
+	}
+out:
+	free(undo);
+	free(set);
+	free(new_state);
+	free(state);
+	return rc;
+}
+
+static int restore_settings_group(struct cmd_context *ctx,
+				  struct settings *settings,
+				  enum settings_group group, int *changed)
+{
+	struct settings_simple *simple = &settings->simple[group];
+	const char *name = settings_group_name[group];
+	struct ethtool_value flags;
+	u32 old_flags;
+	unsigned int i;
+
+	switch (group) {
+	case SETTINGS_RXFH:
+		return restore_rxfh(ctx, settings, changed);
+
+	case SETTINGS_FEATURES:
+		return restore_features(ctx, settings, changed);
+
+	case SETTINGS_PRIV_FLAGS:
+		flags.cmd = ETHTOOL_GPFLAGS;
+		if (send_ioctl(ctx, &flags))
+			break;
+		old_flags = flags.data;
+		flags.data = (flags.data & ~settings->priv_flags_seen) |
+			settings->priv_flags_wanted;
+		if (flags.data == old_flags)
+			return 0;
+		flags.cmd = ETHTOOL_SPFLAGS;
+		if (send_ioctl(ctx, &flags)) {
+			perror("Cannot set private flags");
+			return 1;
+		}
+		flags.data = old_flags;
+		settings->undo[group] = settings_undo_copy(&flags,
+							   sizeof(flags),
+							   ETHTOOL_SPFLAGS);
+		*changed = 1;
+		return 0;
+
+	default:
+		memset(&simple->data, 0, sizeof(simple->data));
+		simple->data.cmd = simple->get_cmd;
+		if (send_ioctl(ctx, &simple->data))
+			break;
+		settings->undo[group] = settings_undo_copy(&simple->data,
+							   sizeof(simple->data),
+							   simple->set_cmd);
+		for (i = 0; i < simple->n_info; i++) {
+			s32 *value = simple->info[i].ioctl_val;
+
+			if (simple->wanted[i] >= 0 &&
+			    simple->wanted[i] != *value) {
+				*value = simple->wanted[i];
+				*changed = 1;
+			}
+		}
+		if (!*changed) {
+			free(settings->undo[group]);
+			settings->undo[group] = NULL;
+			return 0;
+		}
+		simple->data.cmd = simple->set_cmd;
+		if (send_ioctl(ctx, &simple->data)) {
+			fprintf(stderr, "Cannot set device %s settings: %m\n",
+				name);
+			free(settings->undo[group]);
+			settings->undo[group] = NULL;
+			*changed = 0;
+			return 1;
+		}
+		return 0;
+	}
+
+	fprintf(stderr, "Cannot get device %s settings: %m\n", name);
+	return 1;
+}
+
+static int do_restore(struct cmd_context *ctx)
+{
+	struct settings settings;
+	struct file_map map;
+	u32 len = -1;
+	char *text, *line, *next, *tok;
+	char **words = NULL;
+	unsigned int n_words = 0, n_changed = 0;
+	int group, changed, rc = 1;
+
+	if (ctx->argc != 1)
+		exit_bad_args();
+
+	settings_init(&settings);
+	text = dump_file_map(&map, ctx->argp[0], 0, &len, 0);
+	if (!text)
+		return 1;
+
+	/* The mapping is private and followed by zeroes, so it can be
+	 * split into words in place.  A word is at most every other
+	 * byte of the file.
+	 */
+	words = calloc(len / 2 + 2, sizeof(words[0]));
+	if (!words) {
+		perror("Cannot allocate memory for settings");
+		goto out;
+	}
+	for (line = text; line && *line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = 0;
+		tok = strtok(line, " \t");
+		if (!tok || tok[0] == '#')
+			continue;
+		for (group = 0; group < SETTINGS_N_GROUPS; group++)
+			if (!strcmp(tok, settings_group_name[group]))
+				break;
+		if (group == SETTINGS_N_GROUPS) {
+			fprintf(stderr, "Unknown settings '%s' in '%s'\n",
+				tok, ctx->argp[0]);
+			goto out;
+		}
+		if (settings.args[group].argp) {
+			fprintf(stderr, "Settings '%s' repeated in '%s'\n",
+				tok, ctx->argp[0]);
+			goto out;
+		}
+		settings.args[group].argp = words + n_words;
+		while ((tok = strtok(NULL, " \t")) != NULL) {
+			words[n_words++] = tok;
+			settings.args[group].argc++;
+		}
+		n_words++;
+	}
+
+	if (parse_settings(ctx, &settings))
+		goto out;
+
+	for (group = 0; group < SETTINGS_N_GROUPS; group++) {
+		if (!settings.args[group].argp)
+			continue;
+		changed = 0;
+		if (restore_settings_group(ctx, &settings, group, &changed))
+			break;
+		if (changed) {
+			printf("Restored %s settings\n",
+			       settings_group_name[group]);
+			n_changed++;
+		}
+	}
+
+	if (group < SETTINGS_N_GROUPS) {
+		/* Put back what was already changed, newest first.  The
+		 * group that failed may have been changed in part.
+		 */
+		for (; group >= 0; group--) {
+			if (!settings.undo[group])
+				continue;
+			if (send_ioctl(ctx, settings.undo[group]))
+				fprintf(stderr,
+					"Cannot put back device %s settings: %m\n",
+					settings_group_name[group]);
+			else
+				printf("Put back %s settings\n",
+				       settings_group_name[group]);
+		}
+		goto out;
+	}
+
+	if (!n_changed)
+		printf("Settings already match '%s'\n", ctx->argp[0]);
+	rc = 0;
+out:
+	free(words);
+	file_unmap(&map);
+	settings_free(&settings);
+	return rc;
+}
+
+static int do_tsinfo(struct cmd_context *ctx)
+{
+	struct ethtool_ts_info info;
+
+	if (ctx->argc != 0)
+		exit_bad_args();
+
+	fprintf(stdout, "Time stamping parameters for %s:\n", ctx->devname);
+	info.cmd = ETHTOOL_GET_TS_INFO;
+	if (send_ioctl(ctx, &info)) {
+		perror("Cannot get device time stamping settings");
+		return -1;
+	}
+	dump_tsinfo(&info);
+	return 0;
+}
+
+/*
+ * Module EEPROM cache.  Static module data (serial ID fields,
+ * thresholds, calibration constants) is kept in a file named after a
+ * hash of the module's identifying bytes: vendor OUI, PN, revision,
+ * SN, date code and the ID checksums.  A cached query re-reads only
+ * those bytes and the dynamic monitoring area from the module.
+ */
+#ifndef MODULE_CACHE_DIR
+#define MODULE_CACHE_DIR	"/run/ethtool"
+#endif
+#define MODULE_CACHE_MAGIC	0x4d435445	/* "ETCM" */
+
+struct module_cache_hdr {
+	u32 magic;
+	u32 type;
+	u32 eeprom_len;
+};
+
+struct module_cache_layout {
+	u32 type;
+	/* Identifying bytes, compared on every cached read */
+	u32 id_offset;
+	u32 id_len;
+	/* Monitoring and status bytes, always read from the module */
+	u32 dyn_offset;
+	u32 dyn_len;
+};
+
+static const struct module_cache_layout module_cache_layouts[] = {
+	/* A0h bytes 37-95: OUI, PN, rev, ..., CC_BASE, SN, date, CC_EXT */
+	{ ETH_MODULE_SFF_8079,	37,  59, 0,	    0 },
+	/* A2h bytes 96-127: diagnostics, status and alarm/warning flags */
+	{ ETH_MODULE_SFF_8472,	37,  59, 0x100 + 96, 32 },
+	/* Upper page 00h bytes 165-223 as above; lower page 00h is
+	 * entirely status, flags, monitors and controls
+	 */
+	{ ETH_MODULE_SFF_8436,	165, 59, 0,	    128 },
+	{ ETH_MODULE_SFF_8636,	165, 59, 0,	    128 },
+};
+
+static const struct module_cache_layout *
+module_cache_find_layout(const struct ethtool_modinfo *modinfo)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(module_cache_layouts); i++)
+		if (module_cache_layouts[i].type == modinfo->type &&
+		    module_cache_layouts[i].id_offset +
+		    module_cache_layouts[i].id_len <= modinfo->eeprom_len &&
+		    module_cache_layouts[i].dyn_offset +
+		    module_cache_layouts[i].dyn_len <= modinfo->eeprom_len)
+			return &module_cache_layouts[i];
+	return NULL;
+}
+
+static int module_read(struct cmd_context *ctx, u8 *buf, u32 offset, u32 len)
+{
+	struct {
+		struct ethtool_eeprom hdr;
+		u8 data[128];
+	} eeprom;
+
+	if (len > sizeof(eeprom.data))
+		return -1;
+	eeprom.hdr.cmd = ETHTOOL_GMODULEEEPROM;
+	eeprom.hdr.offset = offset;
+	eeprom.hdr.len = len;
+	if (send_ioctl(ctx, &eeprom) < 0)
+		return -1;
+	memcpy(buf, eeprom.data, len);
+	return 0;
+}
+
+static void module_cache_path(char *path, size_t size,
+			      const struct ethtool_modinfo *modinfo,
+			      const u8 *id, u32 len)
+{
+	u64 hash = 0xcbf29ce484222325ULL;	/* FNV-1a */
+	u32 i;
+
+	hash = (hash ^ modinfo->type) * 0x100000001b3ULL;
+	hash = (hash ^ modinfo->eeprom_len) * 0x100000001b3ULL;
+	for (i = 0; i < len; i++)
+		hash = (hash ^ id[i]) * 0x100000001b3ULL;
+	snprintf(path, size, "%s/module-%016llx", MODULE_CACHE_DIR, hash);
+}
+
+/* Fill eeprom from the cache; returns 0 on a cache hit */
+static int module_cache_fetch(struct cmd_context *ctx,
+			      const struct ethtool_modinfo *modinfo,
+			      const struct module_cache_layout *layout,
+			      struct ethtool_eeprom *eeprom)
+{
+	struct module_cache_hdr hdr;
+	char path[PATH_MAX];
+	u8 id[128];
+	size_t nread;
+	FILE *f;
+
+	if (module_read(ctx, id, layout->id_offset, layout->id_len))
+		return -1;
+	module_cache_path(path, sizeof(path), modinfo, id, layout->id_len);
+
+	f = fopen(path, "rb");
+	if (!f)
+		return -1;
+	nread = fread(&hdr, sizeof(hdr), 1, f);
+	if (nread == 1 && hdr.magic == MODULE_CACHE_MAGIC &&
+	    hdr.type == modinfo->type &&
+	    hdr.eeprom_len == modinfo->eeprom_len)
+		nread = fread(eeprom->data, eeprom->len, 1, f);
+	else
+		nread = 0;
+	fclose(f);
+
+	/* Module changed, or hash collision */
+	if (nread != 1 ||
+	    memcmp(eeprom->data + layout->id_offset, id, layout->id_len))
+		return -1;
+
+	if (layout->dyn_len &&
+	    module_read(ctx, eeprom->data + layout->dyn_offset,
+			layout->dyn_offset, layout->dyn_len))
+		return -1;
+	return 0;
+}
+
+static void module_cache_store(const struct ethtool_modinfo *modinfo,
+			       const struct module_cache_layout *layout,
+			       const struct ethtool_eeprom *eeprom)
+{
+	struct module_cache_hdr hdr = {
+		.magic = MODULE_CACHE_MAGIC,
+		.type = modinfo->type,
+		.eeprom_len = modinfo->eeprom_len,
+	};
+	char path[PATH_MAX], tmp_path[PATH_MAX + 16];
+	int ok;
+	FILE *f;
+
+	module_cache_path(path, sizeof(path), modinfo,
+			  eeprom->data + layout->id_offset, layout->id_len);
+	snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+	if (mkdir(MODULE_CACHE_DIR, 0755) && errno != EEXIST)
+		goto err;
+	f = fopen(tmp_path, "wb");
+	if (!f)
+		goto err;
+	ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+		fwrite(eeprom->data, eeprom->len, 1, f) == 1;
+	if (fclose(f) || !ok || rename(tmp_path, path)) {
+		unlink(tmp_path);
+		goto err;
+	}
+	return;
+
+err:
+	fprintf(stderr, "Cannot update module EEPROM cache %s: %s\n",
+		path, strerror(errno));
+}
+
+/* Work out what the kernel would report for a saved module EEPROM image */
+static void module_file_info(struct ethtool_modinfo *modinfo,
+			     const struct ethtool_eeprom *eeprom,
+			     u32 file_size)
+{
+	modinfo->type = 0;
+	modinfo->eeprom_len = file_size;
+	if (eeprom->offset || !eeprom->len)
+		return;
+
+	switch (eeprom->data[0]) {
+#ifdef ETHTOOL_ENABLE_PRETTY_DUMP
+	case SFF8024_ID_SOLDERED_MODULE:
+	case SFF8024_ID_SFP:
+		/* The A2h page follows A0h if the module has diagnostics */
+		modinfo->type = file_size >= ETH_MODULE_SFF_8472_LEN ?
+			ETH_MODULE_SFF_8472 : ETH_MODULE_SFF_8079;
+		break;
+	case SFF8024_ID_QSFP:
+		modinfo->type = ETH_MODULE_SFF_8436;
+		break;
+	case SFF8024_ID_QSFP_PLUS:
+	case SFF8024_ID_QSFP28:
+		modinfo->type = ETH_MODULE_SFF_8636;
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+static int do_getmodule(struct cmd_context *ctx)
+{
+	struct ethtool_modinfo modinfo;
+	struct ethtool_eeprom *eeprom;
+	const struct module_cache_layout *cache_layout = NULL;
+	u32 geeprom_offset = 0;
+	u32 geeprom_length = -1;
+	int geeprom_changed = 0;
+	int geeprom_dump_raw = 0;
+	int geeprom_dump_hex = 0;
+	int geeprom_cache = 0;
+	char *geeprom_file = NULL;
+	int geeprom_ascii = 0;
+	int geeprom_squeeze = 0;
+	struct file_map map;
+	int err;
+
+	struct cmdline_info cmdline_geeprom[] = {
+		{ "offset", CMDL_U32, &geeprom_offset, NULL },
+		{ "length", CMDL_U32, &geeprom_length, NULL },
+		{ "raw", CMDL_BOOL, &geeprom_dump_raw, NULL },
+		{ "hex", CMDL_BOOL, &geeprom_dump_hex, NULL },
+		{ "cache", CMDL_BOOL, &geeprom_cache, NULL },
+		{ "file", CMDL_STR, &geeprom_file, NULL },
+		{ "ascii", CMDL_BOOL, &geeprom_ascii, NULL },
+		{ "squeeze", CMDL_BOOL, &geeprom_squeeze, NULL },
+	};
+
+	parse_generic_cmdline(ctx, &geeprom_changed,
+			      cmdline_geeprom, ARRAY_SIZE(cmdline_geeprom));
+
+	if (geeprom_dump_raw && geeprom_dump_hex) {
+		printf("Hex and raw dump cannot be specified together\n");
+		return 1;
+	}
+
+	if (geeprom_file) {
+		if (geeprom_cache) {
+			fprintf(stderr, "cache cannot be combined with file\n");
+			return 1;
+		}
+		/* Decode a saved raw image without asking the device */
+		eeprom = dump_file_map(&map, geeprom_file, geeprom_offset,
+				       &geeprom_length,
+				       offsetof(struct ethtool_eeprom, data));
+		if (!eeprom)
+			return 1;
+		eeprom->cmd = ETHTOOL_GMODULEEEPROM;
+		eeprom->len = geeprom_length;
+		eeprom->offset = geeprom_offset;
+		module_file_info(&modinfo, eeprom, map.file_size);
+		goto show;
+	}
+
+	modinfo.cmd = ETHTOOL_GMODULEINFO;
+	err = send_ioctl(ctx, &modinfo);
+	if (err < 0) {
+		perror("Cannot get module EEPROM information");
+		return 1;
+	}
+
+	if (geeprom_length == -1)
+		geeprom_length = modinfo.eeprom_len;
+
+	if (modinfo.eeprom_len < geeprom_offset + geeprom_length)
+		geeprom_length = modinfo.eeprom_len - geeprom_offset;
+
+	eeprom = calloc(1, sizeof(*eeprom)+geeprom_length);
+	if (!eeprom) {
+		perror("Cannot allocate memory for Module EEPROM data");
+		return 1;
+	}
+
+	eeprom->cmd = ETHTOOL_GMODULEEEPROM;
+	eeprom->len = geeprom_length;
+	eeprom->offset = geeprom_offset;
+
+	/* The cache only holds complete images */
+	if (geeprom_cache && geeprom_offset == 0 &&
+	    geeprom_length == modinfo.eeprom_len)
+		cache_layout = module_cache_find_layout(&modinfo);
+
+	if (!cache_layout ||
+	    module_cache_fetch(ctx, &modinfo, cache_layout, eeprom)) {
+		err = send_ioctl(ctx, eeprom);
+		if (err < 0) {
+			perror("Cannot get Module EEPROM data");
+			free(eeprom);
+			return 1;
+		}
+		if (cache_layout)
+			module_cache_store(&modinfo, cache_layout, eeprom);
+	}
+
+show:
+	/*
+	 * SFF-8079 EEPROM layout contains the memory available at A0 address on
+	 * the PHY EEPROM.
+	 * SFF-8472 defines a virtual extension of the EEPROM, where the
+	 * microcontroller on the SFP/SFP+ generates a page at the A2 address,
+	 * which contains data relative to optical diagnostics.
+	 * The current kernel implementation returns a blob, which contains:
+	 *  - ETH_MODULE_SFF_8079 => The A0 page only.
+	 *  - ETH_MODULE_SFF_8472 => The A0 and A2 page concatenated.
+	 */
+	if (geeprom_dump_raw) {
+		fwrite(eeprom->data, 1, eeprom->len, stdout);
+	} else {
+		if (eeprom->offset != 0  ||
+		    (eeprom->len != modinfo.eeprom_len)) {
+			geeprom_dump_hex = 1;
+		} else if (!geeprom_dump_hex) {
+			/*
+			 * The decoders index the image at fixed offsets, so
+			 * do not trust a driver reporting a short image for
+			 * its module type.
+			 */
+			switch (modinfo.type) {
+#ifdef ETHTOOL_ENABLE_PRETTY_DUMP
+			case ETH_MODULE_SFF_8079:
+				if (eeprom->len < ETH_MODULE_SFF_8079_LEN) {
+					geeprom_dump_hex = 1;
+					break;
+				}
+				sff8079_show_all(eeprom->data);
+				break;
+			case ETH_MODULE_SFF_8472:
+				if (eeprom->len < ETH_MODULE_SFF_8472_LEN) {
+					geeprom_dump_hex = 1;
+					break;
+				}
+				sff8079_show_all(eeprom->data);
+				sff8472_show_all(eeprom->data);
+				break;
+			case ETH_MODULE_SFF_8436:
+			case ETH_MODULE_SFF_8636:
+				if (eeprom->len < ETH_MODULE_SFF_8636_LEN) {
+					geeprom_dump_hex = 1;
+					break;
+				}
+				sff8636_show_all(eeprom->data,
+						 modinfo.eeprom_len);
+				break;
+#endif
+			default:
+				geeprom_dump_hex = 1;
+				break;
+			}
+		}
+		if (geeprom_dump_hex)
+			dump_hex_fmt(stdout, eeprom->data,
+				     eeprom->len, eeprom->offset,
+				     (geeprom_ascii ? DUMP_HEX_ASCII : 0) |
+				     (geeprom_squeeze ? DUMP_HEX_SQUEEZE : 0));
+	}
+
+	if (geeprom_file)
+		file_unmap(&map);
+	else
+		free(eeprom);
+
+	return 0;
+}
+
+static int do_geee(struct cmd_context *ctx)
+{
+	struct ethtool_eee eeecmd;
+
+	if (ctx->argc != 0)
+		exit_bad_args();
+
+	eeecmd.cmd = ETHTOOL_GEEE;
+	if (send_ioctl(ctx, &eeecmd)) {
+		perror("Cannot get EEE settings");
+		return 1;
+	}
+
+	fprintf(stdout, "EEE Settings for %s:\n", ctx->devname);
+	dump_eeecmd(&eeecmd);
+
+	return 0;
+}
+
+static int do_seee(struct cmd_context *ctx)
+{
+	int adv_c = -1, lpi_c = -1, lpi_time_c = -1, eee_c = -1;
+	int change = -1, change2 = 0;
+	struct ethtool_eee eeecmd;
+	struct cmdline_info cmdline_eee[] = {
+		{ "advertise",    CMDL_U32,  &adv_c,       &eeecmd.advertised },
+		{ "tx-lpi",       CMDL_BOOL, &lpi_c,   &eeecmd.tx_lpi_enabled },
+		{ "tx-timer",	  CMDL_U32,  &lpi_time_c, &eeecmd.tx_lpi_timer},
+		{ "eee",	  CMDL_BOOL, &eee_c,	   &eeecmd.eee_enabled},
+	};
+
+	if (ctx->argc == 0)
+		exit_bad_args();
+
+	parse_generic_cmdline(ctx, &change, cmdline_eee,
+			      ARRAY_SIZE(cmdline_eee));
+
+	eeecmd.cmd = ETHTOOL_GEEE;
+	if (send_ioctl(ctx, &eeecmd)) {
+		perror("Cannot get EEE settings");
+		return 1;
+	}
+
+	do_generic_set(cmdline_eee, ARRAY_SIZE(cmdline_eee), &change2);
+
+	if (change2) {
+		eeecmd.cmd = ETHTOOL_SEEE;
+		if (send_ioctl(ctx, &eeecmd)) {
+			perror("Cannot set EEE settings");
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int do_get_phy_tunable(struct cmd_context *ctx)
+{
+	int argc = ctx->argc;
+	char **argp = ctx->argp;
+
+	if (argc < 1)
+		exit_bad_args();
+
+	if (!strcmp(argp[0], "downshift")) {
+		struct {
+			struct ethtool_tunable ds;
+			u8 count;
+		} cont;
+
+		cont.ds.cmd = ETHTOOL_PHY_GTUNABLE;
+		cont.ds.id = ETHTOOL_PHY_DOWNSHIFT;
+		cont.ds.type_id = ETHTOOL_TUNABLE_U8;
+		cont.ds.len = 1;
+		if (send_ioctl(ctx, &cont.ds) < 0) {
+			perror("Cannot Get PHY downshift count");
+			return 87;
+		}
+		if (cont.count)
+			fprintf(stdout, "Downshift count: %d\n", cont.count);
+		else
+			fprintf(stdout, "Downshift disabled\n");
+	} else if (!strcmp(argp[0], "fast-link-down")) {
+		struct {
+			struct ethtool_tunable fld;
+			u8 msecs;
+		} cont;
+
+		cont.fld.cmd = ETHTOOL_PHY_GTUNABLE;
+		cont.fld.id = ETHTOOL_PHY_FAST_LINK_DOWN;
+		cont.fld.type_id = ETHTOOL_TUNABLE_U8;
+		cont.fld.len = 1;
+		if (send_ioctl(ctx, &cont.fld) < 0) {
+			perror("Cannot Get PHY Fast Link Down value");
+			return 87;
+		}
+
+		if (cont.msecs == ETHTOOL_PHY_FAST_LINK_DOWN_ON)
+			fprintf(stdout, "Fast Link Down enabled\n");
+		else if (cont.msecs == ETHTOOL_PHY_FAST_LINK_DOWN_OFF)
+			fprintf(stdout, "Fast Link Down disabled\n");
+		else
+			fprintf(stdout, "Fast Link Down enabled, %d msecs\n",
+				cont.msecs);
+	} else if (!strcmp(argp[0], "energy-detect-power-down")) {
+		struct {
+			struct ethtool_tunable ds;
+			u16 msecs;
+		} cont;
+
+		cont.ds.cmd = ETHTOOL_PHY_GTUNABLE;
+		cont.ds.id = ETHTOOL_PHY_EDPD;
+		cont.ds.type_id = ETHTOOL_TUNABLE_U16;
+		cont.ds.len = 2;
+		if (send_ioctl(ctx, &cont.ds) < 0) {
+			perror("Cannot Get PHY Energy Detect Power Down value");
+			return 87;
+		}
+
+		if (cont.msecs == ETHTOOL_PHY_EDPD_DISABLE)
+			fprintf(stdout, "Energy Detect Power Down: disabled\n");
+		else if (cont.msecs == ETHTOOL_PHY_EDPD_NO_TX)
+			fprintf(stdout,
+				"Energy Detect Power Down: enabled, TX disabled\n");
+		else
+			fprintf(stdout,
+				"Energy Detect Power Down: enabled, TX %u msecs\n",
+				cont.msecs);
+	} else {
+		exit_bad_args();
+	}
+
+	return 0;
+}
+
+static __u32 parse_reset(char *val, __u32 bitset, char *arg, __u32 *data)
+{
+	__u32 bitval = 0;
+	int i;
+
+	/* Check for component match */
+	for (i = 0; val[i] != '\0'; i++)
+		if (arg[i] != val[i])
+			return 0;
+
+	/* Check if component has -shared specified or not */
+	if (arg[i] == '\0')
+		bitval = bitset;
+	else if (!strcmp(arg+i, "-shared"))
+		bitval = bitset << ETH_RESET_SHARED_SHIFT;
+
+	if (bitval) {
+		*data |= bitval;
+		return 1;
+	}
+	return 0;
+}
+
+static int do_reset(struct cmd_context *ctx)
+{
+	struct ethtool_value resetinfo;
+	__u32 data;
+	int argc = ctx->argc;
+	char **argp = ctx->argp;
+	int i;
+
+	if (argc == 0)
+		exit_bad_args();
+
+	data = 0;
+
+	for (i = 0; i < argc; i++) {
+		if (!strcmp(argp[i], "flags")) {
+			__u32 flags;
+
+			i++;
+			if (i >= argc)
+				exit_bad_args();
+			flags = strtoul(argp[i], NULL, 0);
+			if (flags == 0)
+				exit_bad_args();
+			else
+				data |= flags;
+		} else if (parse_reset("mgmt", ETH_RESET_MGMT,
+				      argp[i], &data)) {
+		} else if (parse_reset("irq",  ETH_RESET_IRQ,
+				    argp[i], &data)) {
+		} else if (parse_reset("dma", ETH_RESET_DMA,
+				    argp[i], &data)) {
+		} else if (parse_reset("filter", ETH_RESET_FILTER,
+				    argp[i], &data)) {
+		} else if (parse_reset("offload", ETH_RESET_OFFLOAD,
+				    argp[i], &data)) {
+		} else if (parse_reset("mac", ETH_RESET_MAC,
+				    argp[i], &data)) {
+		} else if (parse_reset("phy", ETH_RESET_PHY,
+				    argp[i], &data)) {
+		} else if (parse_reset("ram", ETH_RESET_RAM,
+				    argp[i], &data)) {
+		} else if (parse_reset("ap", ETH_RESET_AP,
+				    argp[i], &data)) {
+		} else if (!strcmp(argp[i], "dedicated")) {
+			data |= ETH_RESET_DEDICATED;
+		} else if (!strcmp(argp[i], "all")) {
+			data |= ETH_RESET_ALL;
+		} else {
+			exit_bad_args();
+		}
+	}
+
+	resetinfo.cmd = ETHTOOL_RESET;
+	resetinfo.data = data;
+	fprintf(stdout, "ETHTOOL_RESET 0x%x\n", resetinfo.data);
+
+	if (send_ioctl(ctx, &resetinfo)) {
+		perror("Cannot issue ETHTOOL_RESET");
+		return 1;
+	}
+
+	fprintf(stdout, "Components reset:     0x%x\n", data & ~resetinfo.data);
+	if (resetinfo.data)
+		fprintf(stdout, "Components not reset: 0x%x\n", resetinfo.data);
+
+	return 0;
+}
+
+static int parse_named_bool(struct cmd_context *ctx, const char *name, u8 *on)
+{
+	if (ctx->argc < 2)
+		return 0;
+
+	if (strcmp(*ctx->argp, name))
+		return 0;
+
+	if (!strcmp(*(ctx->argp + 1), "on")) {
+		*on = 1;
+	} else if (!strcmp(*(ctx->argp + 1), "off")) {
+		*on = 0;
+	} else {
+		fprintf(stderr, "Invalid boolean\n");
+		exit_bad_args();
+	}
+
+	ctx->argc -= 2;
+	ctx->argp += 2;
+
+	return 1;
+}
+
+static int parse_named_uint(struct cmd_context *ctx,
+			    const char *name,
+			    unsigned long long *val,
+			    unsigned long long max)
+{
+	if (ctx->argc < 2)
+		return 0;
 
-		cont.fld.cmd = ETHTOOL_PHY_GTUNABLE;
+	if (strcmp(*ctx->argp, name))
+		return 0;
+
+	*val = get_uint_range(*(ctx->argp + 1), 0, max);
+
+	ctx->argc -= 2;
+	ctx->argp += 2;
+
+	return 1;
+}
+
+static int parse_named_u8(struct cmd_context *ctx, const char *name, u8 *val)
+{
+	unsigned long long val1;
+	int ret;
+
+	ret = parse_named_uint(ctx, name, &val1, 0xff);
+	if (ret)
+		*val = val1;
+
+	return ret;
+}
+
+static int parse_named_u16(struct cmd_context *ctx, const char *name, u16 *val)
+{
+	unsigned long long val1;
+	int ret;
+
+	ret = parse_named_uint(ctx, name, &val1, 0xffff);
+	if (ret)
+		*val = val1;
+
+	return ret;
+}
+
+static int do_set_phy_tunable(struct cmd_context *ctx)
+{
+	int err = 0;
+	u8 ds_cnt = DOWNSHIFT_DEV_DEFAULT_COUNT;
+	u8 ds_changed = 0, ds_has_cnt = 0, ds_enable = 0;
+	u8 fld_changed = 0, fld_enable = 0;
+	u8 fld_msecs = ETHTOOL_PHY_FAST_LINK_DOWN_ON;
+	u8 edpd_changed = 0, edpd_enable = 0;
+	u16 edpd_tx_interval = ETHTOOL_PHY_EDPD_DFLT_TX_MSECS;
+
+	/* Parse arguments */
+	if (parse_named_bool(ctx, "downshift", &ds_enable)) {
+		ds_changed = 1;
+		ds_has_cnt = parse_named_u8(ctx, "count", &ds_cnt);
+	} else if (parse_named_bool(ctx, "fast-link-down", &fld_enable)) {
+		fld_changed = 1;
+		if (fld_enable)
+			parse_named_u8(ctx, "msecs", &fld_msecs);
+	} else if (parse_named_bool(ctx, "energy-detect-power-down",
+				    &edpd_enable)) {
+		edpd_changed = 1;
+		if (edpd_enable)
+			parse_named_u16(ctx, "msecs", &edpd_tx_interval);
+	} else {
+		exit_bad_args();
+	}
+
+	/* Validate parameters */
+	if (ds_changed) {
+		if (!ds_enable && ds_has_cnt) {
+			fprintf(stderr, "'count' may not be set when downshift "
+				        "is off.\n");
+			exit_bad_args();
+		}
+
+		if (ds_enable && ds_has_cnt && ds_cnt == 0) {
+			fprintf(stderr, "'count' may not be zero.\n");
+			exit_bad_args();
+		}
+
+		if (!ds_enable)
+			ds_cnt = DOWNSHIFT_DEV_DISABLE;
+	} else if (fld_changed) {
+		if (!fld_enable)
+			fld_msecs = ETHTOOL_PHY_FAST_LINK_DOWN_OFF;
+		else if (fld_msecs == ETHTOOL_PHY_FAST_LINK_DOWN_OFF)
+			exit_bad_args();
+	} else if (edpd_changed) {
+		if (!edpd_enable)
+			edpd_tx_interval = ETHTOOL_PHY_EDPD_DISABLE;
+		else if (edpd_tx_interval == 0)
+			edpd_tx_interval = ETHTOOL_PHY_EDPD_NO_TX;
+		else if (edpd_tx_interval > ETHTOOL_PHY_EDPD_NO_TX) {
+			fprintf(stderr, "'msecs' max value is %d.\n",
+				(ETHTOOL_PHY_EDPD_NO_TX - 1));
+			exit_bad_args();
+		}
+	}
+
+	/* Do it */
+	if (ds_changed) {
+		struct {
+			struct ethtool_tunable ds;
+			u8 count;
+		} cont;
+
+		cont.ds.cmd = ETHTOOL_PHY_STUNABLE;
+		cont.ds.id = ETHTOOL_PHY_DOWNSHIFT;
+		cont.ds.type_id = ETHTOOL_TUNABLE_U8;
+		cont.ds.len = 1;
+		cont.count = ds_cnt;
+		err = send_ioctl(ctx, &cont.ds);
+		if (err < 0) {
+			perror("Cannot Set PHY downshift count");
+			err = 87;
+		}
+	} else if (fld_changed) {
+		struct {
+			struct ethtool_tunable fld;
+			u8 msecs;
+		} cont;
+
+		cont.fld.cmd = ETHTOOL_PHY_STUNABLE;
 		cont.fld.id = ETHTOOL_PHY_FAST_LINK_DOWN;
 		cont.fld.type_id = ETHTOOL_TUNABLE_U8;
 		cont.fld.len = 1;
-		if (send_ioctl(ctx, &cont.fld) < 0) {
-			perror("Cannot Get PHY Fast Link Down value");
-			return 87;
+		cont.msecs = fld_msecs;
+		err = send_ioctl(ctx, &cont.fld);
+		if (err < 0) {
+			perror("Cannot Set PHY Fast Link Down value");
+			err = 87;
 		}
-
-		if (cont.msecs == ETHTOOL_PHY_FAST_LINK_DOWN_ON)
-			fprintf(stdout, "Fast Link Down enabled\n");
-		else if (cont.msecs == ETHTOOL_PHY_FAST_LINK_DOWN_OFF)
-			fprintf(stdout, "Fast Link Down disabled\n");
-		else
-			fprintf(stdout, "Fast Link Down enabled, %d msecs\n",
-				cont.msecs);
-	} else if (!strcmp(argp[0], "energy-detect-power-down")) {
+	} else if (edpd_changed) {
 		struct {
-			struct ethtool_tunable ds;
+			struct ethtool_tunable fld;
 			u16 msecs;
 		} cont;
 
-		cont.ds.cmd = ETHTOOL_PHY_GTUNABLE;
-		cont.ds.id = ETHTOOL_PHY_EDPD;
-		cont.ds.type_id = ETHTOOL_TUNABLE_U16;
-		cont.ds.len = 2;
-		if (send_ioctl(ctx, &cont.ds) < 0) {
-			perror("Cannot Get PHY Energy Detect Power Down value");
-			return 87;
-		}
+		cont.fld.cmd = ETHTOOL_PHY_STUNABLE;
+		cont.fld.id = ETHTOOL_PHY_EDPD;
+		cont.fld.type_id = ETHTOOL_TUNABLE_U16;
+		cont.fld.len = 2;
+		cont.msecs = edpd_tx_interval;
+		err = send_ioctl(ctx, &cont.fld);
+		if (err < 0) {
+			perror("Cannot Set PHY Energy Detect Power Down");
+			err = 87;
+		}
+	}
+
+	return err;
+}
+
+static int fecmode_str_to_type(const char *str)
+{
+	if (!strcasecmp(str, "auto"))
+		return ETHTOOL_FEC_AUTO;
+	if (!strcasecmp(str, "off"))
+		return ETHTOOL_FEC_OFF;
+	if (!strcasecmp(str, "rs"))
+		return ETHTOOL_FEC_RS;
+	if (!strcasecmp(str, "baser"))
+		return ETHTOOL_FEC_BASER;
+
+	return 0;
+}
+
+static int do_gfec(struct cmd_context *ctx)
+{
+	struct ethtool_fecparam feccmd = { 0 };
+	int rv;
+
+	if (ctx->argc != 0)
+		exit_bad_args();
+
+	feccmd.cmd = ETHTOOL_GFECPARAM;
+	rv = send_ioctl(ctx, &feccmd);
+	if (rv != 0) {
+		perror("Cannot get FEC settings");
+		return rv;
+	}
+
+	fprintf(stdout, "FEC parameters for %s:\n", ctx->devname);
+	fprintf(stdout, "Configured FEC encodings:");
+	dump_fec(feccmd.fec);
+	fprintf(stdout, "\n");
+
+	fprintf(stdout, "Active FEC encoding:");
+	dump_fec(feccmd.active_fec);
+	fprintf(stdout, "\n");
+
+	return 0;
+}
+
+static int do_sfec(struct cmd_context *ctx)
+{
+	enum { ARG_NONE, ARG_ENCODING } state = ARG_NONE;
+	struct ethtool_fecparam feccmd;
+	int fecmode = 0, newmode;
+	int rv, i;
+
+	for (i = 0; i < ctx->argc; i++) {
+		if (!strcmp(ctx->argp[i], "encoding")) {
+			state = ARG_ENCODING;
+			continue;
+		}
+		if (state == ARG_ENCODING) {
+			newmode = fecmode_str_to_type(ctx->argp[i]);
+			if (!newmode)
+				exit_bad_args();
+			fecmode |= newmode;
+			continue;
+		}
+		exit_bad_args();
+	}
+
+	if (!fecmode)
+		exit_bad_args();
+
+	feccmd.cmd = ETHTOOL_SFECPARAM;
+	feccmd.fec = fecmode;
+	rv = send_ioctl(ctx, &feccmd);
+	if (rv != 0) {
+		perror("Cannot set FEC settings");
+		return rv;
+	}
+
+	return 0;
+}
+
+static int do_perqueue(struct cmd_context *ctx);
+
+#ifndef TEST_ETHTOOL
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	ctx->ifr.ifr_data = cmd;
+	return ioctl(ctx->fd, SIOCETHTOOL, &ctx->ifr);
+}
+#endif
+
+/* Request tracing for --trace and --trace-file */
+
+struct trace_cmd_info {
+	u32 cmd;
+	const char *name;
+	size_t size;		/* command structure, without trailing data */
+};
+
+#define TRACE_CMD(name, type)						\
+	{ ETHTOOL_##name, #name, sizeof(struct ethtool_##type) }
+
+static const struct trace_cmd_info trace_cmd_info[] = {
+	TRACE_CMD(GSET, cmd),
+	TRACE_CMD(SSET, cmd),
+	TRACE_CMD(GDRVINFO, drvinfo),
+	TRACE_CMD(GREGS, regs),
+	TRACE_CMD(GWOL, wolinfo),
+	TRACE_CMD(SWOL, wolinfo),
+	TRACE_CMD(GMSGLVL, value),
+	TRACE_CMD(SMSGLVL, value),
+	TRACE_CMD(NWAY_RST, value),
+	TRACE_CMD(GLINK, value),
+	TRACE_CMD(GEEPROM, eeprom),
+	TRACE_CMD(SEEPROM, eeprom),
+	TRACE_CMD(GCOALESCE, coalesce),
+	TRACE_CMD(SCOALESCE, coalesce),
+	TRACE_CMD(GRINGPARAM, ringparam),
+	TRACE_CMD(SRINGPARAM, ringparam),
+	TRACE_CMD(GPAUSEPARAM, pauseparam),
+	TRACE_CMD(SPAUSEPARAM, pauseparam),
+	TRACE_CMD(GRXCSUM, value),
+	TRACE_CMD(SRXCSUM, value),
+	TRACE_CMD(GTXCSUM, value),
+	TRACE_CMD(STXCSUM, value),
+	TRACE_CMD(GSG, value),
+	TRACE_CMD(SSG, value),
+	TRACE_CMD(TEST, test),
+	TRACE_CMD(GSTRINGS, gstrings),
+	TRACE_CMD(PHYS_ID, value),
+	TRACE_CMD(GSTATS, stats),
+	TRACE_CMD(GTSO, value),
+	TRACE_CMD(STSO, value),
+	TRACE_CMD(GPERMADDR, perm_addr),
+	TRACE_CMD(GUFO, value),
+	TRACE_CMD(SUFO, value),
+	TRACE_CMD(GGSO, value),
+	TRACE_CMD(SGSO, value),
+	TRACE_CMD(GFLAGS, value),
+	TRACE_CMD(SFLAGS, value),
+	TRACE_CMD(GPFLAGS, value),
+	TRACE_CMD(SPFLAGS, value),
+	TRACE_CMD(GRXFH, rxnfc),
+	TRACE_CMD(SRXFH, rxnfc),
+	TRACE_CMD(GGRO, value),
+	TRACE_CMD(SGRO, value),
+	TRACE_CMD(GRXRINGS, rxnfc),
+	TRACE_CMD(GRXCLSRLCNT, rxnfc),
+	TRACE_CMD(GRXCLSRULE, rxnfc),
+	TRACE_CMD(GRXCLSRLALL, rxnfc),
+	TRACE_CMD(SRXCLSRLDEL, rxnfc),
+	TRACE_CMD(SRXCLSRLINS, rxnfc),
+	TRACE_CMD(FLASHDEV, flash),
+	TRACE_CMD(RESET, value),
+	TRACE_CMD(SRXNTUPLE, rx_ntuple),
+	TRACE_CMD(GRXNTUPLE, value),
+	TRACE_CMD(GSSET_INFO, sset_info),
+	TRACE_CMD(GRXFHINDIR, rxfh_indir),
+	TRACE_CMD(SRXFHINDIR, rxfh_indir),
+	TRACE_CMD(GFEATURES, gfeatures),
+	TRACE_CMD(SFEATURES, sfeatures),
+	TRACE_CMD(GCHANNELS, channels),
+	TRACE_CMD(SCHANNELS, channels),
+	TRACE_CMD(SET_DUMP, dump),
+	TRACE_CMD(GET_DUMP_FLAG, dump),
+	TRACE_CMD(GET_DUMP_DATA, dump),
+	TRACE_CMD(GET_TS_INFO, ts_info),
+	TRACE_CMD(GMODULEINFO, modinfo),
+	TRACE_CMD(GMODULEEEPROM, eeprom),
+	TRACE_CMD(GEEE, eee),
+	TRACE_CMD(SEEE, eee),
+	TRACE_CMD(GRSSH, rxfh),
+	TRACE_CMD(SRSSH, rxfh),
+	TRACE_CMD(GTUNABLE, tunable),
+	TRACE_CMD(STUNABLE, tunable),
+	TRACE_CMD(GPHYSTATS, stats),
+	TRACE_CMD(PERQUEUE, per_queue_op),
+	TRACE_CMD(GLINKSETTINGS, link_settings),
+	TRACE_CMD(SLINKSETTINGS, link_settings),
+	TRACE_CMD(PHY_GTUNABLE, tunable),
+	TRACE_CMD(PHY_STUNABLE, tunable),
+	TRACE_CMD(GFECPARAM, fecparam),
+	TRACE_CMD(SFECPARAM, fecparam),
+};
+
+/* The calls made with one command */
+struct trace_cmd {
+	u32 cmd;
+	unsigned long calls, errors;
+	unsigned long long bytes;
+	u64 total_ns;
+	u64 *ns;		/* latency of each call */
+	unsigned long n_ns, max_ns;
+};
+
+static struct {
+	int enabled;
+	FILE *file;		/* one line per call, or NULL */
+	struct trace_cmd *cmds;
+	unsigned int n_cmds;
+} trace;
+
+static const struct trace_cmd_info *trace_find_info(u32 cmd)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(trace_cmd_info); i++)
+		if (trace_cmd_info[i].cmd == cmd)
+			return &trace_cmd_info[i];
+	return NULL;
+}
 
-		if (cont.msecs == ETHTOOL_PHY_EDPD_DISABLE)
-			fprintf(stdout, "Energy Detect Power Down: disabled\n");
-		else if (cont.msecs == ETHTOOL_PHY_EDPD_NO_TX)
-			fprintf(stdout,
-				"Energy Detect Power Down: enabled, TX disabled\n");
-		else
-			fprintf(stdout,
-				"Energy Detect Power Down: enabled, TX %u msecs\n",
-				cont.msecs);
-	} else {
-		exit_bad_args();
-	}
+static const char *trace_cmd_name(u32 cmd, char *buf, size_t len)
+{
+	const struct trace_cmd_info *info = trace_find_info(cmd);
 
-	return 0;
+	if (info)
+		return info->name;
+	snprintf(buf, len, "%#x", cmd);
+	return buf;
 }
 
-static __u32 parse_reset(char *val, __u32 bitset, char *arg, __u32 *data)
+/* Whether a request only reads from the device: the kernel names those
+ * ETHTOOL_G*.  Requests we do not know may change anything.
+ */
+bool request_is_read(u32 cmd)
 {
-	__u32 bitval = 0;
-	int i;
+	const struct trace_cmd_info *info = trace_find_info(cmd);
 
-	/* Check for component match */
-	for (i = 0; val[i] != '\0'; i++)
-		if (arg[i] != val[i])
-			return 0;
+	return info && info->name[0] == 'G';
+}
 
-	/* Check if component has -shared specified or not */
-	if (arg[i] == '\0')
-		bitval = bitset;
-	else if (!strcmp(arg+i, "-shared"))
-		bitval = bitset << ETH_RESET_SHARED_SHIFT;
+/* Bytes passed with a request: the command structure and the data after
+ * it, as its length fields give it.  @header_only leaves out the data,
+ * which the kernel does not copy back when a request fails.
+ */
+size_t request_size(const void *cmd, int header_only)
+{
+	const struct trace_cmd_info *info = trace_find_info(*(const u32 *)cmd);
+	const struct ethtool_link_settings *link = cmd;
+	const struct ethtool_per_queue_op *op = cmd;
+	const struct ethtool_rxfh *rxfh = cmd;
+	size_t size;
+	unsigned int i, n;
+
+	if (!info)
+		return sizeof(u32);
+	size = info->size;
+	if (header_only)
+		return size;
+
+	switch (info->cmd) {
+	case ETHTOOL_GREGS:
+		return size + ((const struct ethtool_regs *)cmd)->len;
+	case ETHTOOL_GEEPROM:
+	case ETHTOOL_SEEPROM:
+	case ETHTOOL_GMODULEEEPROM:
+		return size + ((const struct ethtool_eeprom *)cmd)->len;
+	case ETHTOOL_TEST:
+		return size + ((const struct ethtool_test *)cmd)->len *
+			sizeof(u64);
+	case ETHTOOL_GSTRINGS:
+		return size + ((const struct ethtool_gstrings *)cmd)->len *
+			ETH_GSTRING_LEN;
+	case ETHTOOL_GSTATS:
+	case ETHTOOL_GPHYSTATS:
+		return size + ((const struct ethtool_stats *)cmd)->n_stats *
+			sizeof(u64);
+	case ETHTOOL_GPERMADDR:
+		return size + ((const struct ethtool_perm_addr *)cmd)->size;
+	case ETHTOOL_GRXCLSRLALL:
+		return size + ((const struct ethtool_rxnfc *)cmd)->rule_cnt *
+			sizeof(u32);
+	case ETHTOOL_GSSET_INFO:
+		return size + __builtin_popcountll(
+			((const struct ethtool_sset_info *)cmd)->sset_mask) *
+			sizeof(u32);
+	case ETHTOOL_GRXFHINDIR:
+	case ETHTOOL_SRXFHINDIR:
+		return size + ((const struct ethtool_rxfh_indir *)cmd)->size *
+			sizeof(u32);
+	case ETHTOOL_GFEATURES:
+		return size + ((const struct ethtool_gfeatures *)cmd)->size *
+			sizeof(struct ethtool_get_features_block);
+	case ETHTOOL_SFEATURES:
+		return size + ((const struct ethtool_sfeatures *)cmd)->size *
+			sizeof(struct ethtool_set_features_block);
+	case ETHTOOL_GET_DUMP_DATA:
+		return size + ((const struct ethtool_dump *)cmd)->len;
+	case ETHTOOL_GRSSH:
+	case ETHTOOL_SRSSH:
+		if (rxfh->indir_size != ETH_RXFH_INDIR_NO_CHANGE)
+			size += rxfh->indir_size * sizeof(u32);
+		return size + rxfh->key_size;
+	case ETHTOOL_GTUNABLE:
+	case ETHTOOL_STUNABLE:
+	case ETHTOOL_PHY_GTUNABLE:
+	case ETHTOOL_PHY_STUNABLE:
+		return size + ((const struct ethtool_tunable *)cmd)->len;
+	case ETHTOOL_PERQUEUE:
+		for (i = 0, n = 0; i < ARRAY_SIZE(op->queue_mask); i++)
+			n += __builtin_popcount(op->queue_mask[i]);
+		return size + n * sizeof(struct ethtool_coalesce);
+	case ETHTOOL_GLINKSETTINGS:
+	case ETHTOOL_SLINKSETTINGS:
+		if (link->link_mode_masks_nwords > 0)
+			size += 3 * link->link_mode_masks_nwords * sizeof(u32);
+		return size;
+	default:
+		return size;
+	}
+}
 
-	if (bitval) {
-		*data |= bitval;
-		return 1;
+static struct trace_cmd *trace_find_cmd(u32 cmd)
+{
+	struct trace_cmd *cmds;
+	unsigned int i;
+
+	for (i = 0; i < trace.n_cmds; i++)
+		if (trace.cmds[i].cmd == cmd)
+			return &trace.cmds[i];
+
+	cmds = realloc(trace.cmds, (trace.n_cmds + 1) * sizeof(cmds[0]));
+	if (!cmds)
+		return NULL;
+	trace.cmds = cmds;
+	memset(&cmds[trace.n_cmds], 0, sizeof(cmds[0]));
+	cmds[trace.n_cmds].cmd = cmd;
+	return &cmds[trace.n_cmds++];
+}
+
+static void trace_record(const struct cmd_context *ctx, u32 cmd, size_t size,
+			 u64 ns, int err)
+{
+	struct trace_cmd *tc = trace_find_cmd(cmd);
+	struct timespec now;
+	char date[32], buf[16];
+	struct tm tm;
+	u64 *samples;
+
+	if (tc) {
+		tc->calls++;
+		tc->errors += !!err;
+		tc->bytes += size;
+		tc->total_ns += ns;
+		/* Without memory for the sample, percentiles omit it */
+		if (tc->n_ns == tc->max_ns) {
+			samples = realloc(tc->ns, (tc->max_ns * 2 + 16) *
+					  sizeof(tc->ns[0]));
+			if (samples) {
+				tc->ns = samples;
+				tc->max_ns = tc->max_ns * 2 + 16;
+			}
+		}
+		if (tc->n_ns < tc->max_ns)
+			tc->ns[tc->n_ns++] = ns;
+	}
+
+	if (trace.file) {
+		clock_gettime(CLOCK_REALTIME, &now);
+		localtime_r(&now.tv_sec, &tm);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+		fprintf(trace.file, "%s.%06ld %s %s %zu %llu.%03llu %d\n",
+			date, now.tv_nsec / 1000,
+			ctx->devname ? ctx->devname : "-",
+			trace_cmd_name(cmd, buf, sizeof(buf)), size,
+			(unsigned long long)ns / 1000,
+			(unsigned long long)ns % 1000, err);
 	}
-	return 0;
 }
 
-static int do_reset(struct cmd_context *ctx)
+static int trace_compare_ns(const void *a, const void *b)
 {
-	struct ethtool_value resetinfo;
-	__u32 data;
-	int argc = ctx->argc;
-	char **argp = ctx->argp;
-	int i;
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
 
-	if (argc == 0)
-		exit_bad_args();
+	return x < y ? -1 : x > y;
+}
 
-	data = 0;
+/* Most time first */
+static int trace_compare_cmd(const void *a, const void *b)
+{
+	u64 x = ((const struct trace_cmd *)a)->total_ns;
+	u64 y = ((const struct trace_cmd *)b)->total_ns;
 
-	for (i = 0; i < argc; i++) {
-		if (!strcmp(argp[i], "flags")) {
-			__u32 flags;
+	return x > y ? -1 : x < y;
+}
 
-			i++;
-			if (i >= argc)
-				exit_bad_args();
-			flags = strtoul(argp[i], NULL, 0);
-			if (flags == 0)
-				exit_bad_args();
-			else
-				data |= flags;
-		} else if (parse_reset("mgmt", ETH_RESET_MGMT,
-				      argp[i], &data)) {
-		} else if (parse_reset("irq",  ETH_RESET_IRQ,
-				    argp[i], &data)) {
-		} else if (parse_reset("dma", ETH_RESET_DMA,
-				    argp[i], &data)) {
-		} else if (parse_reset("filter", ETH_RESET_FILTER,
-				    argp[i], &data)) {
-		} else if (parse_reset("offload", ETH_RESET_OFFLOAD,
-				    argp[i], &data)) {
-		} else if (parse_reset("mac", ETH_RESET_MAC,
-				    argp[i], &data)) {
-		} else if (parse_reset("phy", ETH_RESET_PHY,
-				    argp[i], &data)) {
-		} else if (parse_reset("ram", ETH_RESET_RAM,
-				    argp[i], &data)) {
-		} else if (parse_reset("ap", ETH_RESET_AP,
-				    argp[i], &data)) {
-		} else if (!strcmp(argp[i], "dedicated")) {
-			data |= ETH_RESET_DEDICATED;
-		} else if (!strcmp(argp[i], "all")) {
-			data |= ETH_RESET_ALL;
-		} else {
-			exit_bad_args();
+/* Nearest-rank percentile of sorted samples, in microseconds */
+static double trace_percentile(const struct trace_cmd *tc, unsigned int p)
+{
+	unsigned long rank = (tc->n_ns * p + 99) / 100;
+
+	return tc->ns[rank ? rank - 1 : 0] / 1000.0;
+}
+
+static void trace_report(void)
+{
+	struct trace_cmd *tc;
+	char buf[16];
+
+	fflush(stdout);
+	qsort(trace.cmds, trace.n_cmds, sizeof(trace.cmds[0]),
+	      trace_compare_cmd);
+	fprintf(stderr, "%-16s %7s %6s %12s %10s %9s %9s %9s %9s\n",
+		"Request", "Calls", "Errors", "Bytes", "Total ms",
+		"p50 us", "p90 us", "p99 us", "Max us");
+	for (tc = trace.cmds; tc < trace.cmds + trace.n_cmds; tc++) {
+		fprintf(stderr, "%-16s %7lu %6lu %12llu %10.3f",
+			trace_cmd_name(tc->cmd, buf, sizeof(buf)), tc->calls,
+			tc->errors, tc->bytes, tc->total_ns / 1e6);
+		if (tc->n_ns) {
+			qsort(tc->ns, tc->n_ns, sizeof(tc->ns[0]),
+			      trace_compare_ns);
+			fprintf(stderr, " %9.1f %9.1f %9.1f %9.1f",
+				trace_percentile(tc, 50),
+				trace_percentile(tc, 90),
+				trace_percentile(tc, 99),
+				trace_percentile(tc, 100));
 		}
+		fputc('\n', stderr);
 	}
+}
 
-	resetinfo.cmd = ETHTOOL_RESET;
-	resetinfo.data = data;
-	fprintf(stdout, "ETHTOOL_RESET 0x%x\n", resetinfo.data);
+/* Print the summary and stop tracing; safe to call more than once */
+static void trace_finish(void)
+{
+	unsigned int i;
 
-	if (send_ioctl(ctx, &resetinfo)) {
-		perror("Cannot issue ETHTOOL_RESET");
-		return 1;
-	}
+	if (!trace.enabled)
+		return;
+	trace_report();
+	for (i = 0; i < trace.n_cmds; i++)
+		free(trace.cmds[i].ns);
+	free(trace.cmds);
+	if (trace.file)
+		fclose(trace.file);
+	memset(&trace, 0, sizeof(trace));
+}
 
-	fprintf(stdout, "Components reset:     0x%x\n", data & ~resetinfo.data);
-	if (resetinfo.data)
-		fprintf(stdout, "Components not reset: 0x%x\n", resetinfo.data);
+/* Use netlink where the kernel has an equivalent, else the ioctl */
+static int send_request(struct cmd_context *ctx, void *cmd)
+{
+	int ret;
 
-	return 0;
+	if (netlink_send(ctx, cmd, &ret))
+		return ret;
+	return ioctl_send(ctx, cmd);
 }
 
-static int parse_named_bool(struct cmd_context *ctx, const char *name, u8 *on)
+int send_ioctl(struct cmd_context *ctx, void *cmd)
 {
-	if (ctx->argc < 2)
-		return 0;
+	struct timespec start, end;
+	u32 cmd_id;
+	size_t size;
+	int ret, err;
+
+	if (!trace.enabled)
+		return send_request(ctx, cmd);
+
+	cmd_id = *(u32 *)cmd;
+	size = request_size(cmd, 0);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ret = send_request(ctx, cmd);
+	err = ret < 0 ? errno : 0;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	trace_record(ctx, cmd_id, size,
+		     (end.tv_sec - start.tv_sec) * 1000000000ULL +
+		     end.tv_nsec - start.tv_nsec, err);
+	if (ret < 0)
+		errno = err;
+	return ret;
+}
 
-	if (strcmp(*ctx->argp, name))
-		return 0;
+static int ctx_ethtool_send(struct ethtool_dev *dev, void *cmd)
+{
+	return send_ioctl(dev->priv, cmd) ? -errno : 0;
+}
 
-	if (!strcmp(*(ctx->argp + 1), "on")) {
-		*on = 1;
-	} else if (!strcmp(*(ctx->argp + 1), "off")) {
-		*on = 0;
-	} else {
-		fprintf(stderr, "Invalid boolean\n");
-		exit_bad_args();
-	}
+void ctx_ethtool_dev(struct cmd_context *ctx, struct ethtool_dev *dev)
+{
+	memset(dev, 0, sizeof(*dev));
+	dev->fd = -1;
+	dev->send = ctx_ethtool_send;
+	dev->priv = ctx;
+}
 
-	ctx->argc -= 2;
-	ctx->argp += 2;
+/* Link and feature change monitor */
 
-	return 1;
+#ifndef IFF_LOWER_UP
+#define IFF_LOWER_UP	0x10000
+#endif
+
+#define MONITOR_BUF_SIZE	65536
+
+enum monitor_mode {
+	MONITOR_START,		/* reading the initial state */
+	MONITOR_EVENT,		/* handling a notification */
+	MONITOR_RESYNC,		/* reading every device after lost events */
+};
+
+struct monitor_link {
+	int known;
+	u32 speed;
+	u8 duplex;
+	u8 autoneg;
+};
+
+struct monitor_dev {
+	struct monitor_dev *next;
+	int ifindex;
+	char name[IFNAMSIZ];
+	u32 seen;			/* last scan listing the device */
+	u32 flags;			/* IFF_* */
+	u8 operstate;			/* IF_OPER_* */
+	int carrier;
+	struct monitor_link link;	/* while the carrier is up */
+	struct feature_defs *defs;
+	struct feature_state *features;
+};
+
+struct monitor {
+	int argc;			/* devices to watch, or all if none */
+	char **argp;
+	struct cmd_context ctx;		/* requests for one device */
+	struct feature_defs *defs;	/* feature names, shared by devices */
+	struct monitor_dev *devs;
+	int rtnl_fd;
+	int ntf_fd;			/* ethtool notifications, or -1 */
+	u32 seq;
+	struct timespec stamp;		/* when the event was received */
+	char *buf;
+};
+
+static void monitor_record(const struct monitor *mon,
+			   const struct monitor_dev *dev, const char *fmt, ...)
+{
+	char date[32];
+	struct tm tm;
+	va_list ap;
+
+	localtime_r(&mon->stamp.tv_sec, &tm);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+	printf("%s.%06ld %s: ", date, mon->stamp.tv_nsec / 1000, dev->name);
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	putchar('\n');
 }
 
-static int parse_named_uint(struct cmd_context *ctx,
-			    const char *name,
-			    unsigned long long *val,
-			    unsigned long long max)
+/* Point the request context at @dev */
+static struct cmd_context *monitor_ctx(struct monitor *mon,
+				       struct monitor_dev *dev)
 {
-	if (ctx->argc < 2)
-		return 0;
+	mon->ctx.devname = dev->name;
+	memset(&mon->ctx.ifr, 0, sizeof(mon->ctx.ifr));
+	strcpy(mon->ctx.ifr.ifr_name, dev->name);
+	return &mon->ctx;
+}
 
-	if (strcmp(*ctx->argp, name))
-		return 0;
+static void monitor_read_link(struct monitor *mon, struct monitor_dev *dev,
+			      struct monitor_link *link)
+{
+	struct cmd_context *ctx = monitor_ctx(mon, dev);
+	struct ethtool_link_usettings *link_usettings;
 
-	*val = get_uint_range(*(ctx->argp + 1), 0, max);
+	memset(link, 0, sizeof(*link));
+	link_usettings = do_ioctl_glinksettings(ctx);
+	if (!link_usettings)
+		link_usettings = do_ioctl_gset(ctx);
+	if (!link_usettings)
+		return;
+	link->known = 1;
+	link->speed = link_usettings->base.speed;
+	link->duplex = link_usettings->base.duplex;
+	link->autoneg = link_usettings->base.autoneg;
+	free(link_usettings);
+}
 
-	ctx->argc -= 2;
-	ctx->argp += 2;
+static void monitor_print_link(const struct monitor *mon,
+			       const struct monitor_dev *dev, const char *what)
+{
+	const struct monitor_link *link = &dev->link;
+	char speed[16];
 
-	return 1;
+	if (!link->known) {
+		monitor_record(mon, dev, "%s", what);
+		return;
+	}
+	if (link->speed == 0 || link->speed == (u16)(-1) ||
+	    link->speed == (u32)(-1))
+		strcpy(speed, "unknown");
+	else
+		snprintf(speed, sizeof(speed), "%uMb/s", link->speed);
+	monitor_record(mon, dev, "%s, speed %s, duplex %s, autoneg %s",
+		       what, speed,
+		       link->duplex == DUPLEX_HALF ? "half" :
+		       link->duplex == DUPLEX_FULL ? "full" : "unknown",
+		       link->autoneg == AUTONEG_ENABLE ? "on" : "off");
 }
 
-static int parse_named_u8(struct cmd_context *ctx, const char *name, u8 *val)
+/* The carrier changed; the link settings only matter while it is up */
+static void monitor_carrier(struct monitor *mon, struct monitor_dev *dev,
+			    int carrier)
 {
-	unsigned long long val1;
-	int ret;
+	dev->carrier = carrier;
+	if (!carrier) {
+		monitor_record(mon, dev, "link down");
+		return;
+	}
+	monitor_read_link(mon, dev, &dev->link);
+	monitor_print_link(mon, dev, "link up");
+}
 
-	ret = parse_named_uint(ctx, name, &val1, 0xff);
-	if (ret)
-		*val = val1;
+static void monitor_link_settings(struct monitor *mon,
+				  struct monitor_dev *dev)
+{
+	struct monitor_link link;
 
-	return ret;
+	if (!dev->carrier)
+		return;
+	monitor_read_link(mon, dev, &link);
+	if (link.known == dev->link.known && link.speed == dev->link.speed &&
+	    link.duplex == dev->link.duplex &&
+	    link.autoneg == dev->link.autoneg)
+		return;
+	dev->link = link;
+	monitor_print_link(mon, dev, "link settings");
 }
 
-static int parse_named_u16(struct cmd_context *ctx, const char *name, u16 *val)
+static void monitor_features(struct monitor *mon, struct monitor_dev *dev)
 {
-	unsigned long long val1;
-	int ret;
+	struct feature_state *state;
+	bool changed;
+	int i;
 
-	ret = parse_named_uint(ctx, name, &val1, 0xffff);
-	if (ret)
-		*val = val1;
+	if (!dev->features)
+		return;
+	state = get_features(monitor_ctx(mon, dev), dev->defs);
+	if (!state)
+		return;
 
-	return ret;
+	changed = state->off_flags != dev->features->off_flags;
+	for (i = 0; i < dev->defs->n_features && !changed; i++)
+		changed = !FEATURE_BIT_IS_SET(state->features.features, i,
+					      active) !=
+			  !FEATURE_BIT_IS_SET(dev->features->features.features,
+					      i, active);
+	if (changed) {
+		monitor_record(mon, dev, "features changed");
+		dump_features(dev->defs, state, dev->features);
+	}
+	free(dev->features);
+	dev->features = state;
 }
 
-static int do_set_phy_tunable(struct cmd_context *ctx)
+static bool monitor_wanted(const struct monitor *mon, const char *name)
 {
-	int err = 0;
-	u8 ds_cnt = DOWNSHIFT_DEV_DEFAULT_COUNT;
-	u8 ds_changed = 0, ds_has_cnt = 0, ds_enable = 0;
-	u8 fld_changed = 0, fld_enable = 0;
-	u8 fld_msecs = ETHTOOL_PHY_FAST_LINK_DOWN_ON;
-	u8 edpd_changed = 0, edpd_enable = 0;
-	u16 edpd_tx_interval = ETHTOOL_PHY_EDPD_DFLT_TX_MSECS;
+	int i;
 
-	/* Parse arguments */
-	if (parse_named_bool(ctx, "downshift", &ds_enable)) {
-		ds_changed = 1;
-		ds_has_cnt = parse_named_u8(ctx, "count", &ds_cnt);
-	} else if (parse_named_bool(ctx, "fast-link-down", &fld_enable)) {
-		fld_changed = 1;
-		if (fld_enable)
-			parse_named_u8(ctx, "msecs", &fld_msecs);
-	} else if (parse_named_bool(ctx, "energy-detect-power-down",
-				    &edpd_enable)) {
-		edpd_changed = 1;
-		if (edpd_enable)
-			parse_named_u16(ctx, "msecs", &edpd_tx_interval);
-	} else {
-		exit_bad_args();
-	}
+	if (!mon->argc)
+		return true;
+	for (i = 0; i < mon->argc; i++)
+		if (!strcmp(mon->argp[i], name))
+			return true;
+	return false;
+}
 
-	/* Validate parameters */
-	if (ds_changed) {
-		if (!ds_enable && ds_has_cnt) {
-			fprintf(stderr, "'count' may not be set when downshift "
-				        "is off.\n");
-			exit_bad_args();
-		}
+static struct monitor_dev *monitor_find(struct monitor *mon, int ifindex)
+{
+	struct monitor_dev *dev;
 
-		if (ds_enable && ds_has_cnt && ds_cnt == 0) {
-			fprintf(stderr, "'count' may not be zero.\n");
-			exit_bad_args();
-		}
+	for (dev = mon->devs; dev; dev = dev->next)
+		if (dev->ifindex == ifindex)
+			return dev;
+	return NULL;
+}
 
-		if (!ds_enable)
-			ds_cnt = DOWNSHIFT_DEV_DISABLE;
-	} else if (fld_changed) {
-		if (!fld_enable)
-			fld_msecs = ETHTOOL_PHY_FAST_LINK_DOWN_OFF;
-		else if (fld_msecs == ETHTOOL_PHY_FAST_LINK_DOWN_OFF)
-			exit_bad_args();
-	} else if (edpd_changed) {
-		if (!edpd_enable)
-			edpd_tx_interval = ETHTOOL_PHY_EDPD_DISABLE;
-		else if (edpd_tx_interval == 0)
-			edpd_tx_interval = ETHTOOL_PHY_EDPD_NO_TX;
-		else if (edpd_tx_interval > ETHTOOL_PHY_EDPD_NO_TX) {
-			fprintf(stderr, "'msecs' max value is %d.\n",
-				(ETHTOOL_PHY_EDPD_NO_TX - 1));
-			exit_bad_args();
-		}
+static struct monitor_dev *monitor_add(struct monitor *mon, int ifindex,
+				       const char *name)
+{
+	struct monitor_dev *dev = calloc(1, sizeof(*dev));
+	struct cmd_context *ctx;
+
+	if (!dev) {
+		perror("Cannot allocate memory for monitor");
+		return NULL;
 	}
+	dev->ifindex = ifindex;
+	strcpy(dev->name, name);
+	dev->seen = mon->seq;
+	ctx = monitor_ctx(mon, dev);
+	dev->defs = get_feature_defs(ctx);
+	if (dev->defs)
+		dev->features = get_features(ctx, dev->defs);
+	dev->next = mon->devs;
+	mon->devs = dev;
+	return dev;
+}
 
-	/* Do it */
-	if (ds_changed) {
-		struct {
-			struct ethtool_tunable ds;
-			u8 count;
-		} cont;
+static void monitor_free_dev(struct monitor_dev *dev)
+{
+	free(dev->defs);
+	free(dev->features);
+	free(dev);
+}
 
-		cont.ds.cmd = ETHTOOL_PHY_STUNABLE;
-		cont.ds.id = ETHTOOL_PHY_DOWNSHIFT;
-		cont.ds.type_id = ETHTOOL_TUNABLE_U8;
-		cont.ds.len = 1;
-		cont.count = ds_cnt;
-		err = send_ioctl(ctx, &cont.ds);
-		if (err < 0) {
-			perror("Cannot Set PHY downshift count");
-			err = 87;
-		}
-	} else if (fld_changed) {
-		struct {
-			struct ethtool_tunable fld;
-			u8 msecs;
-		} cont;
+static void monitor_remove(struct monitor *mon, struct monitor_dev *dev)
+{
+	struct monitor_dev **pdev;
 
-		cont.fld.cmd = ETHTOOL_PHY_STUNABLE;
-		cont.fld.id = ETHTOOL_PHY_FAST_LINK_DOWN;
-		cont.fld.type_id = ETHTOOL_TUNABLE_U8;
-		cont.fld.len = 1;
-		cont.msecs = fld_msecs;
-		err = send_ioctl(ctx, &cont.fld);
-		if (err < 0) {
-			perror("Cannot Set PHY Fast Link Down value");
-			err = 87;
-		}
-	} else if (edpd_changed) {
-		struct {
-			struct ethtool_tunable fld;
-			u16 msecs;
-		} cont;
+	for (pdev = &mon->devs; *pdev != dev; pdev = &(*pdev)->next)
+		;
+	*pdev = dev->next;
+	monitor_free_dev(dev);
+}
 
-		cont.fld.cmd = ETHTOOL_PHY_STUNABLE;
-		cont.fld.id = ETHTOOL_PHY_EDPD;
-		cont.fld.type_id = ETHTOOL_TUNABLE_U16;
-		cont.fld.len = 2;
-		cont.msecs = edpd_tx_interval;
-		err = send_ioctl(ctx, &cont.fld);
-		if (err < 0) {
-			perror("Cannot Set PHY Energy Detect Power Down");
-			err = 87;
+/* Handle a link message, from a notification or a dump */
+static void monitor_rtnl(struct monitor *mon, const struct nlmsghdr *nlh,
+			 enum monitor_mode mode)
+{
+	const struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+	const struct nlattr *tb[IFLA_OPERSTATE + 1];
+	char name[IFNAMSIZ] = "";
+	struct monitor_dev *dev;
+	bool state_changed;
+	u8 operstate;
+	int carrier;
+
+	/* Bridge ports are also reported, with AF_BRIDGE */
+	if ((nlh->nlmsg_type != RTM_NEWLINK &&
+	     nlh->nlmsg_type != RTM_DELLINK) ||
+	    nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*ifi)) ||
+	    ifi->ifi_family != AF_UNSPEC)
+		return;
+	nl_parse(IFLA_RTA(ifi), IFLA_PAYLOAD(nlh), tb, IFLA_OPERSTATE);
+	if (tb[IFLA_IFNAME])
+		snprintf(name, sizeof(name), "%.*s",
+			 nl_attr_len(tb[IFLA_IFNAME]),
+			 (const char *)nl_attr_data(tb[IFLA_IFNAME]));
+	/* IF_OPER_UNKNOWN if not given */
+	operstate = tb[IFLA_OPERSTATE] ? nl_get_u8(tb[IFLA_OPERSTATE]) : 0;
+	carrier = !!(ifi->ifi_flags & IFF_LOWER_UP);
+
+	dev = monitor_find(mon, ifi->ifi_index);
+	if (nlh->nlmsg_type == RTM_DELLINK) {
+		if (dev) {
+			monitor_record(mon, dev, "removed");
+			monitor_remove(mon, dev);
 		}
+		return;
+	}
+	if (!dev) {
+		if (!name[0] || !monitor_wanted(mon, name))
+			return;
+		dev = monitor_add(mon, ifi->ifi_index, name);
+		if (!dev)
+			return;
+		dev->flags = ifi->ifi_flags;
+		dev->operstate = operstate;
+		if (mode != MONITOR_START)
+			monitor_record(mon, dev, "added");
+		monitor_carrier(mon, dev, carrier);
+		return;
 	}
 
-	return err;
+	dev->seen = mon->seq;
+	state_changed = ifi->ifi_flags != dev->flags ||
+		operstate != dev->operstate;
+	dev->flags = ifi->ifi_flags;
+	dev->operstate = operstate;
+	if (name[0] && strcmp(name, dev->name)) {
+		monitor_record(mon, dev, "renamed to %s", name);
+		strcpy(dev->name, name);
+	}
+	if (carrier != dev->carrier) {
+		monitor_carrier(mon, dev, carrier);
+	} else if (mode == MONITOR_RESYNC) {
+		monitor_link_settings(mon, dev);
+		monitor_features(mon, dev);
+	} else if (mon->ntf_fd < 0 && state_changed) {
+		/* Without ethtool notifications, a change of state may
+		 * have come with one to the device's features.  Reading
+		 * them on every link message would cost a request per
+		 * MTU or address change; a change of features alone
+		 * shows at the next change of state.
+		 */
+		monitor_features(mon, dev);
+	}
 }
 
-static int fecmode_str_to_type(const char *str)
+static void monitor_ntf(struct monitor *mon, const struct nlmsghdr *nlh)
 {
-	if (!strcasecmp(str, "auto"))
-		return ETHTOOL_FEC_AUTO;
-	if (!strcasecmp(str, "off"))
-		return ETHTOOL_FEC_OFF;
-	if (!strcasecmp(str, "rs"))
-		return ETHTOOL_FEC_RS;
-	if (!strcasecmp(str, "baser"))
-		return ETHTOOL_FEC_BASER;
+	struct monitor_dev *dev;
+	int ifindex;
+	u8 type;
 
-	return 0;
+	type = netlink_ntf_parse(nlh, &ifindex);
+	if (!type)
+		return;
+	dev = monitor_find(mon, ifindex);
+	if (!dev)
+		return;
+
+	switch (type) {
+	case ETHTOOL_MSG_LINKINFO_NTF:
+	case ETHTOOL_MSG_LINKMODES_NTF:
+		monitor_link_settings(mon, dev);
+		break;
+	case ETHTOOL_MSG_FEATURES_NTF:
+		monitor_features(mon, dev);
+		break;
+	}
 }
 
-static int do_gfec(struct cmd_context *ctx)
+/* Receive into the buffer, noting the time.  Returns the length or a
+ * negative errno.
+ */
+static int monitor_recv(struct monitor *mon, int fd, int flags)
 {
-	struct ethtool_fecparam feccmd = { 0 };
-	int rv;
+	ssize_t n;
 
-	if (ctx->argc != 0)
-		exit_bad_args();
+	do {
+		n = recv(fd, mon->buf, MONITOR_BUF_SIZE, flags);
+	} while (n < 0 && errno == EINTR);
+	if (n < 0)
+		return -errno;
+	clock_gettime(CLOCK_REALTIME, &mon->stamp);
+	return n;
+}
 
-	feccmd.cmd = ETHTOOL_GFECPARAM;
-	rv = send_ioctl(ctx, &feccmd);
-	if (rv != 0) {
-		perror("Cannot get FEC settings");
-		return rv;
+/* Read every device's link state, at start or after losing events */
+static int monitor_scan(struct monitor *mon, enum monitor_mode mode)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct ifinfomsg ifi;
+	} req;
+	struct monitor_dev *dev, *next;
+	struct nlmsghdr *nlh;
+	int len;
+
+	memset(&req, 0, sizeof(req));
+	req.nlh.nlmsg_len = sizeof(req);
+	req.nlh.nlmsg_type = RTM_GETLINK;
+	req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	req.nlh.nlmsg_seq = ++mon->seq;
+	req.ifi.ifi_family = AF_UNSPEC;
+	if (send(mon->rtnl_fd, &req, sizeof(req), 0) < 0)
+		return -errno;
+
+	for (;;) {
+		len = monitor_recv(mon, mon->rtnl_fd, 0);
+		if (len < 0)
+			return len;
+		for (nlh = (struct nlmsghdr *)mon->buf; NLMSG_OK(nlh, len);
+		     nlh = NLMSG_NEXT(nlh, len)) {
+			/* Notifications may arrive during the dump */
+			if (nlh->nlmsg_seq != mon->seq) {
+				monitor_rtnl(mon, nlh, MONITOR_EVENT);
+				continue;
+			}
+			if (nlh->nlmsg_type == NLMSG_DONE)
+				goto done;
+			if (nlh->nlmsg_type == NLMSG_ERROR)
+				return -EPROTO;
+			monitor_rtnl(mon, nlh, mode);
+		}
 	}
 
-	fprintf(stdout, "FEC parameters for %s:\n", ctx->devname);
-	fprintf(stdout, "Configured FEC encodings:");
-	dump_fec(feccmd.fec);
-	fprintf(stdout, "\n");
-
-	fprintf(stdout, "Active FEC encoding:");
-	dump_fec(feccmd.active_fec);
-	fprintf(stdout, "\n");
-
+done:
+	/* Devices missing from the dump have gone */
+	for (dev = mon->devs; dev; dev = next) {
+		next = dev->next;
+		if (dev->seen == mon->seq)
+			continue;
+		monitor_record(mon, dev, "removed");
+		monitor_remove(mon, dev);
+	}
 	return 0;
 }
 
-static int do_sfec(struct cmd_context *ctx)
+static int monitor_run(struct monitor *mon)
 {
-	enum { ARG_NONE, ARG_ENCODING } state = ARG_NONE;
-	struct ethtool_fecparam feccmd;
-	int fecmode = 0, newmode;
-	int rv, i;
-
-	for (i = 0; i < ctx->argc; i++) {
-		if (!strcmp(ctx->argp[i], "encoding")) {
-			state = ARG_ENCODING;
-			continue;
+	struct pollfd pfd[2];
+	struct nlmsghdr *nlh;
+	int i, len;
+
+	pfd[0].fd = mon->rtnl_fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = mon->ntf_fd;
+	pfd[1].events = POLLIN;
+
+	for (;;) {
+		fflush(stdout);
+		if (poll(pfd, ARRAY_SIZE(pfd), -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("Cannot wait for events");
+			return 1;
 		}
-		if (state == ARG_ENCODING) {
-			newmode = fecmode_str_to_type(ctx->argp[i]);
-			if (!newmode)
-				exit_bad_args();
-			fecmode |= newmode;
-			continue;
+
+		for (i = 0; i < ARRAY_SIZE(pfd); i++) {
+			if (!pfd[i].revents)
+				continue;
+			/* Handle everything queued before waiting again */
+			while ((len = monitor_recv(mon, pfd[i].fd,
+						   MSG_DONTWAIT)) != -EAGAIN) {
+				if (len == -ENOBUFS) {
+					fprintf(stderr, "Events were lost, "
+						"reading every device\n");
+					do {
+						len = monitor_scan(mon,
+								   MONITOR_RESYNC);
+					} while (len == -ENOBUFS);
+					if (!len)
+						continue;
+				}
+				if (len < 0) {
+					errno = -len;
+					perror("Cannot receive events");
+					return 1;
+				}
+				/* Nothing more comes once it is shut down */
+				if (!len)
+					return 0;
+				for (nlh = (struct nlmsghdr *)mon->buf;
+				     NLMSG_OK(nlh, len);
+				     nlh = NLMSG_NEXT(nlh, len)) {
+					if (pfd[i].fd == mon->rtnl_fd)
+						monitor_rtnl(mon, nlh,
+							     MONITOR_EVENT);
+					else
+						monitor_ntf(mon, nlh);
+				}
+			}
 		}
-		exit_bad_args();
 	}
+}
 
-	if (!fecmode)
+static int do_monitor(struct cmd_context *ctx)
+{
+	struct sockaddr_nl addr;
+	struct monitor_dev *dev;
+	struct monitor mon;
+	int i, err, rc = 1;
+
+	for (i = 0; i < ctx->argc; i++)
+		if (strlen(ctx->argp[i]) >= IFNAMSIZ)
+			exit_bad_args();
+	/* A batch would never get past it */
+	if (ctx->batch_defs)
 		exit_bad_args();
 
-	feccmd.cmd = ETHTOOL_SFECPARAM;
-	feccmd.fec = fecmode;
-	rv = send_ioctl(ctx, &feccmd);
-	if (rv != 0) {
-		perror("Cannot set FEC settings");
-		return rv;
+	memset(&mon, 0, sizeof(mon));
+	mon.argc = ctx->argc;
+	mon.argp = ctx->argp;
+	mon.ctx.batch_defs = &mon.defs;
+	mon.ctx.fd = -1;
+	mon.rtnl_fd = -1;
+	mon.ntf_fd = -1;
+
+	mon.buf = malloc(MONITOR_BUF_SIZE);
+	if (!mon.buf) {
+		perror("Cannot allocate memory for monitor");
+		goto out;
 	}
+	mon.ctx.nl = netlink_new();
 
-	return 0;
-}
+	mon.ctx.fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (mon.ctx.fd < 0)
+		mon.ctx.fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+	if (mon.ctx.fd < 0) {
+		perror("Cannot get control socket");
+		rc = 70;
+		goto out;
+	}
 
-static int do_perqueue(struct cmd_context *ctx);
+	mon.rtnl_fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = RTMGRP_LINK;
+	if (mon.rtnl_fd < 0 ||
+	    bind(mon.rtnl_fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		perror("Cannot listen for link events");
+		goto out;
+	}
+	/* Kernels before 5.6 only send link events */
+	err = netlink_monitor_open();
+	if (err >= 0)
+		mon.ntf_fd = err;
 
-#ifndef TEST_ETHTOOL
-int send_ioctl(struct cmd_context *ctx, void *cmd)
-{
-	ctx->ifr.ifr_data = cmd;
-	return ioctl(ctx->fd, SIOCETHTOOL, &ctx->ifr);
+	clock_gettime(CLOCK_REALTIME, &mon.stamp);
+	do {
+		err = monitor_scan(&mon, MONITOR_START);
+	} while (err == -ENOBUFS);
+	if (err) {
+		errno = -err;
+		perror("Cannot read link states");
+		goto out;
+	}
+
+	rc = monitor_run(&mon);
+
+out:
+	while ((dev = mon.devs)) {
+		mon.devs = dev->next;
+		monitor_free_dev(dev);
+	}
+	free(mon.defs);
+	free(mon.buf);
+	netlink_free(mon.ctx.nl);
+	if (mon.ntf_fd >= 0)
+		close(mon.ntf_fd);
+	if (mon.rtnl_fd >= 0)
+		close(mon.rtnl_fd);
+	if (mon.ctx.fd >= 0)
+		close(mon.ctx.fd);
+	return rc;
 }
-#endif
 
 static int show_usage(struct cmd_context *ctx);
+static int do_batch(struct cmd_context *ctx);
 
 static const struct option {
 	const char *opts;
@@ -5350,17 +9189,35 @@ static const struct option {
 	{ "-i|--driver", 1, do_gdrv, "Show driver information" },
 	{ "-d|--register-dump", 1, do_gregs, "Do a register dump",
 	  "		[ raw on|off ]\n"
-	  "		[ file FILENAME ]\n" },
+	  "		[ file FILENAME ]\n"
+	  "		[ diff FILENAME ]\n"
+	  "		[ watch SECONDS [ regs OFFSET[-OFFSET][,...] ] [ count N ] ]\n"
+	  "		[ json on|off ]\n"
+	  "		[ select REGISTER[.FIELD][,...] ]\n"
+	  "		[ ascii on|off ]\n"
+	  "		[ squeeze on|off ]\n"
+	  "		[ split PREFIX ]\n"
+	  "		[ table NAME[.FIELD] ]\n"
+	  "		[ rows N[-N] ]\n"
+	  "		[ ports all|DEVNAME[,...] ]\n" },
 	{ "-e|--eeprom-dump", 1, do_geeprom, "Do a EEPROM dump",
 	  "		[ raw on|off ]\n"
 	  "		[ offset N ]\n"
-	  "		[ length N ]\n" },
+	  "		[ length N ]\n"
+	  "		[ file FILENAME ]\n"
+	  "		[ ascii on|off ]\n"
+	  "		[ squeeze on|off ]\n"
+	  "		[ chunk N ]\n"
+	  "		[ output FILENAME [ resume on|off ] ]\n"
+	  "		[ progress on|off ]\n" },
 	{ "-E|--change-eeprom", 1, do_seeprom,
 	  "Change bytes in device EEPROM",
 	  "		[ magic N ]\n"
 	  "		[ offset N ]\n"
 	  "		[ length N ]\n"
-	  "		[ value N ]\n" },
+	  "		[ value N ]\n"
+	  "		[ file FILENAME ]\n"
+	  "		[ verify on|off ]\n" },
 	{ "-r|--negotiate", 1, do_nway_rst, "Restart N-WAY negotiation" },
 	{ "-p|--identify", 1, do_phys_id,
 	  "Show visible port identification (e.g. blinking)",
@@ -5419,7 +9276,7 @@ static const struct option {
 	  "Show permanent hardware address" },
 	{ "-w|--get-dump", 1, do_getfwdump,
 	  "Get dump flag, data",
-	  "		[ data FILENAME ]\n" },
+	  "		[ data FILENAME|- [ compress on|off ] [ mmap on|off ] ]\n" },
 	{ "-W|--set-dump", 1, do_setfwdump,
 	  "Set dump flag of the device",
 	  "		N\n"},
@@ -5437,7 +9294,11 @@ static const struct option {
 	  "		[ raw on|off ]\n"
 	  "		[ hex on|off ]\n"
 	  "		[ offset N ]\n"
-	  "		[ length N ]\n" },
+	  "		[ length N ]\n"
+	  "		[ cache on|off ]\n"
+	  "		[ file FILENAME ]\n"
+	  "		[ ascii on|off ]\n"
+	  "		[ squeeze on|off ]\n" },
 	{ "--show-eee", 1, do_geee, "Show EEE settings"},
 	{ "--set-eee", 1, do_seee, "Set EEE settings",
 	  "		[ eee on|off ]\n"
@@ -5477,9 +9338,26 @@ static const struct option {
 	{ "--show-fec", 1, do_gfec, "Show FEC settings"},
 	{ "--set-fec", 1, do_sfec, "Set FEC settings",
 	  "		[ encoding auto|off|rs|baser [...]]\n"},
+	{ "--save", 1, do_save, "Save features, rings, channels, coalescing, "
+	  "pause, RSS and private flags to a file",
+	  "		FILE\n" },
+	{ "--restore", 1, do_restore, "Apply the settings saved in a file "
+	  "that differ from the device's",
+	  "		FILE\n" },
 	{ "-Q|--per-queue", 1, do_perqueue, "Apply per-queue command."
 	  "The supported sub commands include --show-coalesce, --coalesce",
 	  "             [queue_mask %x] SUB_COMMAND\n"},
+	{ "--diff", 0, do_diff_regs, "Compare two saved register dumps",
+	  "		FILE1 FILE2\n"
+	  "		[ driver NAME ]\n"
+	  "		[ version N ]\n"
+	  "		[ hex on|off ]\n"
+	  "		[ json on|off ]\n"
+	  "		[ select REGISTER[.FIELD][,...] ]\n" },
+	{ "--batch", 0, do_batch, "Run commands read from a file",
+	  "		FILE|-\n" },
+	{ "--monitor", 0, do_monitor, "Report link and feature changes",
+	  "		[ DEVNAME... ]\n" },
 	{ "-h|--help", 0, show_usage, "Show this help" },
 	{ "--version", 0, do_version, "Show version number" },
 	{}
@@ -5493,6 +9371,8 @@ static int show_usage(struct cmd_context *ctx maybe_unused)
 	fprintf(stdout, PACKAGE " version " VERSION "\n");
 	fprintf(stdout,
 		"Usage:\n"
+		"        ethtool [ --trace ] [ --trace-file FILE ] ...\t"
+		"Time each request made by the command\n"
 		"        ethtool DEVNAME\t"
 		"Display standard information about device\n");
 	for (i = 0; args[i].opts; i++) {
@@ -5699,19 +9579,15 @@ static int do_perqueue(struct cmd_context *ctx)
 	return 0;
 }
 
-int main(int argc, char **argp)
+static int run_command(int argc, char **argp, int *fd,
+		       struct feature_defs **batch_defs,
+		       struct nl_context *nl)
 {
 	int (*func)(struct cmd_context *);
 	int want_device;
 	struct cmd_context ctx;
 	int k;
 
-	init_global_link_mode_masks();
-
-	/* Skip command name */
-	argp++;
-	argc--;
-
 	/* First argument must be either a valid option or a device
 	 * name to get settings for (which we don't expect to begin
 	 * with '-').
@@ -5746,20 +9622,173 @@ opt_found:
 		memset(&ctx.ifr, 0, sizeof(ctx.ifr));
 		strcpy(ctx.ifr.ifr_name, ctx.devname);
 
-		/* Open control socket. */
-		ctx.fd = socket(AF_INET, SOCK_DGRAM, 0);
-		if (ctx.fd < 0)
-			ctx.fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
-		if (ctx.fd < 0) {
+		/* Open control socket, unless a batch already did. */
+		if (*fd < 0)
+			*fd = socket(AF_INET, SOCK_DGRAM, 0);
+		if (*fd < 0)
+			*fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+		if (*fd < 0) {
 			perror("Cannot get control socket");
 			return 70;
 		}
+		ctx.fd = *fd;
+		ctx.nl = nl;
 	} else {
 		ctx.fd = -1;
+		ctx.nl = NULL;
 	}
 
 	ctx.argc = argc;
 	ctx.argp = argp;
+	ctx.batch_defs = batch_defs;
 
 	return func(&ctx);
 }
+
+#define BATCH_MAX_LINE	4096
+
+/* Run one command per line of a file, sharing the control sockets and
+ * the feature names between them.  Blank lines and lines starting
+ * with '#' are skipped.  Invalid arguments end the batch, as they
+ * would end a single command.
+ */
+static int do_batch(struct cmd_context *ctx)
+{
+	struct feature_defs *batch_defs = NULL;
+	struct nl_context *nl = NULL;
+	char line[BATCH_MAX_LINE];
+	char **line_argp = NULL;
+	unsigned int line_no = 0;
+	int fd = -1, rc = 0, err;
+	int line_argc;
+	size_t len;
+	char *tok;
+	FILE *file;
+
+	if (ctx->argc != 1)
+		exit_bad_args();
+	/* A batch must not start another one */
+	if (ctx->batch_defs)
+		exit_bad_args();
+
+	if (!strcmp(ctx->argp[0], "-")) {
+		file = stdin;
+	} else {
+		file = fopen(ctx->argp[0], "r");
+		if (!file) {
+			perror("Cannot open batch file");
+			return 1;
+		}
+	}
+
+	/* Every line has fewer words than half its length */
+	line_argp = calloc(BATCH_MAX_LINE / 2 + 1, sizeof(line_argp[0]));
+	if (!line_argp) {
+		perror("Cannot allocate memory for batch");
+		rc = 1;
+		goto out;
+	}
+	nl = netlink_new();
+
+	while (fgets(line, sizeof(line), file)) {
+		line_no++;
+		len = strlen(line);
+		if (len && line[len - 1] == '\n') {
+			line[len - 1] = 0;
+		} else if (!feof(file)) {
+			fprintf(stderr, "%s:%u: line too long\n",
+				ctx->argp[0], line_no);
+			rc = 1;
+			break;
+		}
+
+		line_argc = 0;
+		for (tok = strtok(line, " \t"); tok; tok = strtok(NULL, " \t"))
+			line_argp[line_argc++] = tok;
+		line_argp[line_argc] = NULL;
+		if (line_argc == 0 || line_argp[0][0] == '#')
+			continue;
+
+		err = run_command(line_argc, line_argp, &fd, &batch_defs, nl);
+		if (err) {
+			fprintf(stderr, "%s:%u: command failed (%d)\n",
+				ctx->argp[0], line_no, err);
+			rc = 1;
+		}
+		fflush(stdout);
+	}
+	if (ferror(file)) {
+		perror("Cannot read batch file");
+		rc = 1;
+	}
+
+out:
+	free(line_argp);
+	free(batch_defs);
+	netlink_free(nl);
+	if (fd >= 0)
+		close(fd);
+	if (file != stdin)
+		fclose(file);
+	return rc;
+}
+
+/* Options that apply to the whole command line; they come first */
+static void parse_global_options(int *argc, char ***argp)
+{
+	int i;
+
+	memset(&trace, 0, sizeof(trace));
+
+	while (*argc > 0 && !strncmp(**argp, "--trace", 7)) {
+		if (!strcmp(**argp, "--trace-file")) {
+			if (*argc < 2 || trace.file)
+				exit_bad_args();
+			(*argp)++;
+			(*argc)--;
+			trace.file = fopen(**argp, "a");
+			if (!trace.file) {
+				perror("Cannot open trace file");
+				exit(1);
+			}
+		} else if (strcmp(**argp, "--trace")) {
+			exit_bad_args();
+		}
+		trace.enabled = 1;
+		(*argp)++;
+		(*argc)--;
+	}
+
+	/* Separate the runs in a file that collects several */
+	if (trace.file) {
+		fputs("# ethtool", trace.file);
+		for (i = 0; i < *argc; i++)
+			fprintf(trace.file, " %s", (*argp)[i]);
+		fputc('\n', trace.file);
+	}
+#ifndef TEST_ETHTOOL
+	/* Commands that exit early still get a summary */
+	if (trace.enabled)
+		atexit(trace_finish);
+#endif
+}
+
+int main(int argc, char **argp)
+{
+	int fd = -1, rc;
+
+	init_global_link_mode_masks();
+
+	/* Skip command name */
+	argp++;
+	argc--;
+
+	parse_global_options(&argc, &argp);
+
+	/* One command makes too few requests for netlink to save any
+	 * system calls, so everything goes through the ioctl.
+	 */
+	rc = run_command(argc, argp, &fd, NULL, NULL);
+	trace_finish();
+	return rc;
+}
@@ -0,0 +1,782 @@
+/*
+ * ethtoold.c: Daemon answering ethtool queries on a local socket
+ *
+ * Agents that poll the same devices each pay for reading driver info,
+ * string sets and the link mode handshake on every run, and their
+ * statistics requests contend on the driver's lock.  The daemon keeps
+ * that metadata for each device between requests, and answers all the
+ * statistics requests that arrive together from a single ETHTOOL_GSTATS.
+ * See ethtoold.h for the protocol.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <syslog.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <linux/netlink.h>
+#include "internal.h"
+#include "libethtool.h"
+#include "ethtoold.h"
+
+#define ETHTOOLD_MAX_CLIENTS	256
+#define ETHTOOLD_MAX_DEVS	1024
+#define ETHTOOLD_N_SETS		32	/* string sets that are kept */
+#define ETHTOOLD_RETRIES	3	/* when a count changes under us */
+/* How long to stop accepting after running out of descriptors, unless
+ * a client goes away first
+ */
+#define ETHTOOLD_ACCEPT_PAUSE_MS	1000
+
+struct ethtoold_names {
+	int loaded;
+	__u32 count;
+	char (*names)[ETH_GSTRING_LEN];
+};
+
+struct ethtoold_dev {
+	struct ethtoold_dev *next;
+	struct ethtool_dev dev;
+	struct timespec loaded;		/* when the metadata was read */
+	__u32 generation;
+	struct ethtool_drvinfo drvinfo;
+	struct ethtoold_names sets[ETHTOOLD_N_SETS];
+	int link_nwords;		/* 0 until learnt */
+	/* Result of the last statistics fetch, shared by a round */
+	unsigned long stats_round;
+	struct timespec stats_time;
+	int stats_err;
+	__u64 *stats;
+	__u32 n_stats, stats_size;
+};
+
+struct ethtoold_client {
+	int fd;
+	struct ethtoold_request req;
+	size_t in_len;
+	/* Reply being written; nothing more is read until it is sent */
+	int busy;
+	struct ethtoold_reply reply;
+	void *payload;
+	size_t out_off;
+};
+
+struct ethtoold_server {
+	struct ethtoold_config cfg;
+	int listen_fd, ctl_fd;
+	struct ethtoold_client clients[ETHTOOLD_MAX_CLIENTS];
+	unsigned int n_clients;
+	struct pollfd pfds[ETHTOOLD_MAX_CLIENTS + 1];
+	int accept_paused;
+	struct timespec accept_pause_start;
+	struct ethtoold_dev *devs;
+	unsigned int n_devs;
+	__u32 generation;
+	unsigned long round;
+};
+
+/* Layout of an ETHTOOLD_LINK payload with the largest masks */
+struct ethtoold_link {
+	struct ethtool_link_settings req;
+	__u32 masks[3 * LIBETHTOOL_LINK_MODE_WORDS];
+};
+
+static void ethtoold_now(struct timespec *ts)
+{
+	clock_gettime(CLOCK_MONOTONIC, ts);
+}
+
+static unsigned long ethtoold_ms_since(const struct timespec *then,
+				       const struct timespec *now)
+{
+	return (now->tv_sec - then->tv_sec) * 1000 +
+		(now->tv_nsec - then->tv_nsec) / 1000000;
+}
+
+static void ethtoold_forget_names(struct ethtoold_names *names)
+{
+	free(names->names);
+	memset(names, 0, sizeof(*names));
+}
+
+/*
+ * (Re)read a device's driver info.  If neither it nor the sizes of the
+ * string sets read so far changed, the names and the generation are
+ * kept; otherwise everything learnt from the device is dropped.
+ */
+static int ethtoold_dev_load(struct ethtoold_server *srv,
+			     struct ethtoold_dev *d)
+{
+	struct {
+		struct ethtool_sset_info hdr;
+		__u32 counts[ETHTOOLD_N_SETS];
+	} sset_info;
+	struct ethtool_drvinfo drvinfo;
+	unsigned int i, n;
+	int err, same;
+
+	ethtoold_now(&d->loaded);
+	d->stats_round = 0;
+	err = ethtool_get_drvinfo(&d->dev, &drvinfo);
+	if (err)
+		return err;
+
+	same = d->generation && !memcmp(&drvinfo, &d->drvinfo, sizeof(drvinfo));
+	memset(&sset_info, 0, sizeof(sset_info));
+	sset_info.hdr.cmd = ETHTOOL_GSSET_INFO;
+	for (i = 0; i < ETHTOOLD_N_SETS; i++)
+		if (d->sets[i].loaded)
+			sset_info.hdr.sset_mask |= 1ULL << i;
+	if (same && sset_info.hdr.sset_mask) {
+		/* A set that is gone is left out of the mask */
+		err = ethtool_request(&d->dev, &sset_info);
+		for (i = 0, n = 0; !err && same && i < ETHTOOLD_N_SETS; i++) {
+			if (!d->sets[i].loaded)
+				continue;
+			same = sset_info.hdr.sset_mask & (1ULL << i) &&
+				sset_info.counts[n++] == d->sets[i].count;
+		}
+		same = same && !err;
+	}
+	if (same)
+		return 0;
+
+	for (i = 0; i < ETHTOOLD_N_SETS; i++)
+		ethtoold_forget_names(&d->sets[i]);
+	d->link_nwords = 0;
+	d->drvinfo = drvinfo;
+	d->generation = ++srv->generation;
+	return 0;
+}
+
+static void ethtoold_dev_free(struct ethtoold_dev *d)
+{
+	unsigned int i;
+
+	for (i = 0; i < ETHTOOLD_N_SETS; i++)
+		ethtoold_forget_names(&d->sets[i]);
+	free(d->stats);
+	free(d);
+}
+
+static void ethtoold_dev_drop(struct ethtoold_server *srv,
+			      struct ethtoold_dev *d)
+{
+	struct ethtoold_dev **pd;
+
+	for (pd = &srv->devs; *pd; pd = &(*pd)->next) {
+		if (*pd == d) {
+			*pd = d->next;
+			srv->n_devs--;
+			ethtoold_dev_free(d);
+			return;
+		}
+	}
+}
+
+static struct ethtoold_dev *ethtoold_dev_get(struct ethtoold_server *srv,
+					     const char *devname, int *err)
+{
+	struct ethtoold_dev *d;
+	struct timespec now;
+
+	for (d = srv->devs; d; d = d->next)
+		if (!strcmp(d->dev.ifr.ifr_name, devname))
+			break;
+
+	if (d) {
+		ethtoold_now(&now);
+		if (ethtoold_ms_since(&d->loaded, &now) <
+		    srv->cfg.refresh_s * 1000UL)
+			return d;
+		*err = ethtoold_dev_load(srv, d);
+		if (!*err)
+			return d;
+		ethtoold_dev_drop(srv, d);
+		return NULL;
+	}
+
+	if (srv->n_devs >= ETHTOOLD_MAX_DEVS) {
+		*err = -ENOSPC;
+		return NULL;
+	}
+	d = calloc(1, sizeof(*d));
+	if (!d) {
+		*err = -ENOMEM;
+		return NULL;
+	}
+	*err = ethtool_dev_init(&d->dev, srv->ctl_fd, devname);
+	if (!*err) {
+		if (srv->cfg.send) {
+			d->dev.send = srv->cfg.send;
+			d->dev.priv = srv->cfg.priv;
+		}
+		*err = ethtoold_dev_load(srv, d);
+	}
+	if (*err) {
+		ethtoold_dev_free(d);
+		return NULL;
+	}
+	d->next = srv->devs;
+	srv->devs = d;
+	srv->n_devs++;
+	return d;
+}
+
+static int ethtoold_names(struct ethtoold_dev *d, __u32 set,
+			  struct ethtoold_names **namesp)
+{
+	struct ethtoold_names *names;
+	char (*buf)[ETH_GSTRING_LEN];
+	__u32 count;
+	int err;
+
+	if (set >= ETHTOOLD_N_SETS)
+		return -EINVAL;
+	names = &d->sets[set];
+	if (!names->loaded) {
+		err = ethtool_get_string_count(&d->dev, set, &count);
+		if (err)
+			return err;
+		buf = calloc(count ? count : 1, ETH_GSTRING_LEN);
+		if (!buf)
+			return -ENOMEM;
+		err = ethtool_get_strings(&d->dev, set, buf, &count);
+		if (err) {
+			free(buf);
+			return err;
+		}
+		names->names = buf;
+		names->count = count;
+		names->loaded = 1;
+	}
+	*namesp = names;
+	return 0;
+}
+
+/*
+ * Fetch the statistics, unless they were already fetched in this round
+ * or are young enough to be reused.
+ */
+static int ethtoold_stats(struct ethtoold_server *srv, struct ethtoold_dev *d)
+{
+	struct ethtoold_names *names = &d->sets[ETH_SS_STATS];
+	struct timespec now;
+	unsigned int tries;
+	__u64 *stats;
+	__u32 count;
+	int err;
+
+	ethtoold_now(&now);
+	if (d->stats_round == srv->round ||
+	    (d->stats_round &&
+	     ethtoold_ms_since(&d->stats_time, &now) < srv->cfg.max_age_ms))
+		return d->stats_err;
+
+	for (tries = 0; tries < ETHTOOLD_RETRIES; tries++) {
+		count = d->stats_size;
+		err = ethtool_get_stats(&d->dev, d->stats, &count);
+		if (err != -ENOSPC)
+			break;
+		stats = realloc(d->stats, count * sizeof(*stats));
+		if (!stats) {
+			err = -ENOMEM;
+			break;
+		}
+		d->stats = stats;
+		d->stats_size = count;
+	}
+	d->n_stats = err ? 0 : count;
+	d->stats_err = err;
+	d->stats_round = srv->round;
+	d->stats_time = now;
+
+	/* The driver's statistics changed, so their names did too */
+	if (!err && names->loaded && names->count != count) {
+		ethtoold_forget_names(names);
+		d->generation = ++srv->generation;
+	}
+	return err;
+}
+
+static int ethtoold_link(struct ethtoold_dev *d, struct ethtoold_link *link)
+{
+	struct ethtool_link_info info;
+	int nwords, err;
+
+	if (d->link_nwords) {
+		memset(link, 0, sizeof(*link));
+		link->req.cmd = ETHTOOL_GLINKSETTINGS;
+		link->req.link_mode_masks_nwords = d->link_nwords;
+		err = ethtool_request(&d->dev, link);
+		if (err || link->req.link_mode_masks_nwords == d->link_nwords)
+			return err;
+	}
+
+	/* Not learnt yet, or the kernel now wants another size */
+	err = ethtool_get_link_info(&d->dev, &info);
+	if (err)
+		return err;
+	nwords = info.base.link_mode_masks_nwords;
+	d->link_nwords = nwords;
+	link->req = info.base;
+	memcpy(link->masks, info.supported, 4 * nwords);
+	memcpy(link->masks + nwords, info.advertising, 4 * nwords);
+	memcpy(link->masks + 2 * nwords, info.lp_advertising, 4 * nwords);
+	return 0;
+}
+
+static void *ethtoold_payload(struct ethtoold_client *c, size_t len)
+{
+	c->payload = malloc(len ? len : 1);
+	c->reply.len = len;
+	return c->payload;
+}
+
+static int ethtoold_copy(struct ethtoold_client *c, const void *data,
+			 size_t len)
+{
+	void *payload = ethtoold_payload(c, len);
+
+	if (!payload)
+		return -ENOMEM;
+	memcpy(payload, data, len);
+	return 0;
+}
+
+static int ethtoold_features(struct ethtoold_dev *d,
+			     struct ethtoold_client *c)
+{
+	struct ethtool_get_features_block *blocks = NULL;
+	struct ethtoold_names *names;
+	unsigned int tries;
+	__u32 n_blocks;
+	int err;
+
+	err = ethtoold_names(d, ETH_SS_FEATURES, &names);
+	if (err)
+		return err;
+	n_blocks = DIV_ROUND_UP(names->count, 32U);
+	for (tries = 0; tries < ETHTOOLD_RETRIES; tries++) {
+		free(blocks);
+		blocks = ethtoold_payload(c, n_blocks * sizeof(*blocks));
+		if (!blocks)
+			return -ENOMEM;
+		err = ethtool_get_features(&d->dev, blocks, &n_blocks);
+		if (err != -ENOSPC)
+			break;
+	}
+	c->reply.len = n_blocks * sizeof(*blocks);
+	return err;
+}
+
+static int ethtoold_op(struct ethtoold_server *srv, struct ethtoold_dev *d,
+		       struct ethtoold_client *c)
+{
+	const struct ethtoold_request *req = &c->req;
+	struct ethtoold_names *names;
+	struct ethtoold_link link;
+	struct ethtool_modinfo modinfo;
+	void *payload;
+	int err;
+
+	switch (req->op) {
+	case ETHTOOLD_DRVINFO:
+		return ethtoold_copy(c, &d->drvinfo, sizeof(d->drvinfo));
+	case ETHTOOLD_STRINGS:
+		err = ethtoold_names(d, req->arg, &names);
+		if (err)
+			return err;
+		return ethtoold_copy(c, names->names,
+				     names->count * ETH_GSTRING_LEN);
+	case ETHTOOLD_STATS:
+		err = ethtoold_stats(srv, d);
+		if (err)
+			return err;
+		return ethtoold_copy(c, d->stats,
+				     d->n_stats * sizeof(d->stats[0]));
+	case ETHTOOLD_LINK:
+		err = ethtoold_link(d, &link);
+		if (err)
+			return err;
+		return ethtoold_copy(c, &link, sizeof(link.req) +
+				     12 * link.req.link_mode_masks_nwords);
+	case ETHTOOLD_FEATURES:
+		return ethtoold_features(d, c);
+	case ETHTOOLD_MODULE_INFO:
+		err = ethtool_get_module_info(&d->dev, &modinfo);
+		if (err)
+			return err;
+		return ethtoold_copy(c, &modinfo, sizeof(modinfo));
+	case ETHTOOLD_MODULE_EEPROM:
+		if (!req->len || req->len > ETHTOOLD_MAX_EEPROM)
+			return -EINVAL;
+		payload = ethtoold_payload(c, req->len);
+		if (!payload)
+			return -ENOMEM;
+		return ethtool_get_module_eeprom(&d->dev, req->arg, payload,
+						 req->len);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+static void ethtoold_handle(struct ethtoold_server *srv,
+			    struct ethtoold_client *c)
+{
+	struct ethtoold_request *req = &c->req;
+	struct ethtoold_dev *d = NULL;
+	int err;
+
+	memset(&c->reply, 0, sizeof(c->reply));
+	c->reply.version = ETHTOOLD_VERSION;
+	c->reply.op = req->op;
+	req->devname[IFNAMSIZ - 1] = 0;
+
+	if (req->version != ETHTOOLD_VERSION) {
+		err = -EPROTO;
+	} else {
+		d = ethtoold_dev_get(srv, req->devname, &err);
+		if (d)
+			err = ethtoold_op(srv, d, c);
+	}
+
+	if (err) {
+		free(c->payload);
+		c->payload = NULL;
+		c->reply.len = 0;
+	}
+	c->reply.status = err;
+	if (d) {
+		c->reply.generation = d->generation;
+		if (err == -ENODEV)
+			ethtoold_dev_drop(srv, d);
+	}
+	c->out_off = 0;
+	c->busy = 1;
+}
+
+/* Send what the socket takes of the pending reply; < 0 to close */
+static int ethtoold_write(struct ethtoold_client *c)
+{
+	size_t hdr_len = sizeof(c->reply), off;
+	struct msghdr msg;
+	struct iovec iov[2];
+	ssize_t n;
+
+	while (c->busy) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		off = c->out_off;
+		if (off < hdr_len) {
+			iov[0].iov_base = (char *)&c->reply + off;
+			iov[0].iov_len = hdr_len - off;
+			iov[1].iov_base = c->payload;
+			iov[1].iov_len = c->reply.len;
+			msg.msg_iovlen = 2;
+		} else {
+			iov[0].iov_base = (char *)c->payload + off - hdr_len;
+			iov[0].iov_len = hdr_len + c->reply.len - off;
+			msg.msg_iovlen = 1;
+		}
+		n = sendmsg(c->fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return errno == EAGAIN ? 0 : -errno;
+		}
+		c->out_off += n;
+		if (c->out_off == hdr_len + c->reply.len) {
+			free(c->payload);
+			c->payload = NULL;
+			c->busy = 0;
+		}
+	}
+	return 0;
+}
+
+static int ethtoold_read(struct ethtoold_server *srv,
+			 struct ethtoold_client *c)
+{
+	ssize_t n;
+
+	n = recv(c->fd, (char *)&c->req + c->in_len,
+		 sizeof(c->req) - c->in_len, MSG_DONTWAIT);
+	if (n == 0)
+		return -ECONNRESET;
+	if (n < 0)
+		return errno == EAGAIN || errno == EINTR ? 0 : -errno;
+	c->in_len += n;
+	if (c->in_len < sizeof(c->req))
+		return 0;
+	c->in_len = 0;
+	ethtoold_handle(srv, c);
+	return ethtoold_write(c);
+}
+
+static void ethtoold_accept(struct ethtoold_server *srv)
+{
+	struct ethtoold_client *c;
+	int fd;
+
+	for (;;) {
+		fd = accept4(srv->listen_fd, NULL, NULL,
+			     SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			/* The connection stays queued, so polling for it
+			 * would only spin until a descriptor is free
+			 */
+			if (errno == EMFILE || errno == ENFILE) {
+				srv->accept_paused = 1;
+				ethtoold_now(&srv->accept_pause_start);
+			}
+			return;
+		}
+		if (srv->n_clients == ETHTOOLD_MAX_CLIENTS) {
+			close(fd);
+			continue;
+		}
+		c = &srv->clients[srv->n_clients++];
+		memset(c, 0, sizeof(*c));
+		c->fd = fd;
+	}
+}
+
+struct ethtoold_server *ethtoold_server_new(int listen_fd, int ctl_fd,
+					    const struct ethtoold_config *cfg)
+{
+	struct ethtoold_server *srv;
+
+	srv = calloc(1, sizeof(*srv));
+	if (!srv)
+		return NULL;
+	srv->cfg = *cfg;
+	srv->listen_fd = listen_fd;
+	srv->ctl_fd = ctl_fd;
+	return srv;
+}
+
+/*
+ * Wait up to @timeout_ms for requests and answer all that have arrived.
+ * The requests read in one call make up a round, and share a single
+ * statistics fetch per device.
+ */
+int ethtoold_server_poll(struct ethtoold_server *srv, int timeout_ms)
+{
+	struct ethtoold_client *c;
+	unsigned long paused_ms;
+	struct timespec now;
+	unsigned int i, n;
+	short revents;
+	int ret;
+
+	if (srv->accept_paused) {
+		ethtoold_now(&now);
+		paused_ms = ethtoold_ms_since(&srv->accept_pause_start, &now);
+		if (paused_ms >= ETHTOOLD_ACCEPT_PAUSE_MS)
+			srv->accept_paused = 0;
+		else if (timeout_ms < 0 ||
+			 timeout_ms > ETHTOOLD_ACCEPT_PAUSE_MS - paused_ms)
+			timeout_ms = ETHTOOLD_ACCEPT_PAUSE_MS - paused_ms;
+	}
+
+	/* poll() skips a negative descriptor */
+	srv->pfds[0].fd = srv->accept_paused ? -1 : srv->listen_fd;
+	srv->pfds[0].events = POLLIN;
+	for (i = 0; i < srv->n_clients; i++) {
+		srv->pfds[i + 1].fd = srv->clients[i].fd;
+		srv->pfds[i + 1].events =
+			srv->clients[i].busy ? POLLOUT : POLLIN;
+	}
+
+	ret = poll(srv->pfds, srv->n_clients + 1, timeout_ms);
+	if (ret <= 0)
+		return ret < 0 && errno != EINTR ? -errno : 0;
+	srv->round++;
+
+	for (i = 0; i < srv->n_clients; i++) {
+		c = &srv->clients[i];
+		revents = srv->pfds[i + 1].revents;
+		if (!revents)
+			continue;
+		if (c->busy && (revents & POLLOUT))
+			ret = ethtoold_write(c);
+		else if (!c->busy && (revents & POLLIN))
+			ret = ethtoold_read(srv, c);
+		else
+			ret = -ECONNRESET;
+		if (ret) {
+			close(c->fd);
+			free(c->payload);
+			c->fd = -1;
+			srv->accept_paused = 0;
+		}
+	}
+
+	for (i = 0, n = 0; i < srv->n_clients; i++)
+		if (srv->clients[i].fd >= 0)
+			srv->clients[n++] = srv->clients[i];
+	srv->n_clients = n;
+
+	if (srv->pfds[0].revents & POLLIN)
+		ethtoold_accept(srv);
+	return 0;
+}
+
+void ethtoold_server_free(struct ethtoold_server *srv)
+{
+	struct ethtoold_dev *d;
+	unsigned int i;
+
+	for (i = 0; i < srv->n_clients; i++) {
+		close(srv->clients[i].fd);
+		free(srv->clients[i].payload);
+	}
+	while ((d = srv->devs)) {
+		srv->devs = d->next;
+		ethtoold_dev_free(d);
+	}
+	free(srv);
+}
+
+#ifndef TEST_ETHTOOL
+
+static volatile sig_atomic_t ethtoold_stop;
+
+static void ethtoold_signal(int sig)
+{
+	ethtoold_stop = 1;
+}
+
+static void usage(FILE *file)
+{
+	fprintf(file,
+		"Usage: ethtoold [-f] [-s SOCKET] [-a MSEC] [-r SEC]\n"
+		"	-f	stay in the foreground\n"
+		"	-s	listen on SOCKET (default " ETHTOOLD_SOCKET_PATH ")\n"
+		"	-a	reuse statistics up to MSEC old (default 0)\n"
+		"	-r	read device metadata again after SEC (default 60)\n");
+}
+
+static int ethtoold_listen(const char *path)
+{
+	struct sockaddr_un addr;
+	mode_t mask;
+	int fd, err;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path %s is too long\n", path);
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("Cannot create socket");
+		return -1;
+	}
+	unlink(path);
+	/* The socket is created 0660, so it is never open to others */
+	mask = umask(0117);
+	err = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (err || listen(fd, SOMAXCONN)) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int main(int argc, char **argp)
+{
+	struct ethtoold_config cfg = { .refresh_s = 60 };
+	const char *path = ETHTOOLD_SOCKET_PATH;
+	struct ethtoold_server *srv;
+	struct sigaction sa;
+	int listen_fd, ctl_fd, foreground = 0;
+	int opt, err = 0;
+
+	while ((opt = getopt(argc, argp, "a:fhr:s:")) != -1) {
+		switch (opt) {
+		case 'a':
+			cfg.max_age_ms = strtoul(optarg, NULL, 0);
+			break;
+		case 'f':
+			foreground = 1;
+			break;
+		case 'r':
+			cfg.refresh_s = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			path = optarg;
+			break;
+		case 'h':
+			usage(stdout);
+			return 0;
+		default:
+			usage(stderr);
+			return 1;
+		}
+	}
+	if (optind != argc) {
+		usage(stderr);
+		return 1;
+	}
+
+	ctl_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (ctl_fd < 0)
+		ctl_fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+	if (ctl_fd < 0) {
+		perror("Cannot get control socket");
+		return 1;
+	}
+	listen_fd = ethtoold_listen(path);
+	if (listen_fd < 0)
+		return 1;
+	srv = ethtoold_server_new(listen_fd, ctl_fd, &cfg);
+	if (!srv) {
+		perror("Cannot allocate memory");
+		return 1;
+	}
+	if (!foreground && daemon(0, 0)) {
+		perror("Cannot run in the background");
+		return 1;
+	}
+
+	openlog("ethtoold", LOG_PID | (foreground ? LOG_PERROR : 0),
+		LOG_DAEMON);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = ethtoold_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	while (!ethtoold_stop) {
+		err = ethtoold_server_poll(srv, -1);
+		if (err) {
+			syslog(LOG_ERR, "poll failed: %s", strerror(-err));
+			break;
+		}
+	}
+
+	ethtoold_server_free(srv);
+	close(listen_fd);
+	close(ctl_fd);
+	unlink(path);
+	return err ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * ethtoold.h: Protocol of the ethtool query daemon
+ *
+ * A client connects to the daemon's UNIX stream socket and sends fixed
+ * size requests; each is answered, in order, by a reply header and a
+ * payload of reply.len bytes.  All fields are in host byte order.
+ *
+ * The daemon keeps the string sets of each device it has been asked
+ * about.  reply.generation changes whenever it has to read them again
+ * (the driver was reloaded, or its statistics changed), so a client can
+ * keep the names it fetched while the generation is unchanged.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#ifndef ETHTOOLD_H__
+#define ETHTOOLD_H__
+
+#include <net/if.h>
+#include <linux/types.h>
+
+#define ETHTOOLD_SOCKET_PATH	"/run/ethtoold.sock"
+#define ETHTOOLD_VERSION	1
+
+enum ethtoold_op {
+	ETHTOOLD_DRVINFO = 1,	/* struct ethtool_drvinfo */
+	ETHTOOLD_STRINGS,	/* arg is the string set; names of
+				 * ETH_GSTRING_LEN bytes */
+	ETHTOOLD_STATS,		/* __u64 per ETH_SS_STATS name */
+	ETHTOOLD_LINK,		/* struct ethtool_link_settings, then the
+				 * supported, advertising and link partner
+				 * masks of link_mode_masks_nwords each */
+	ETHTOOLD_FEATURES,	/* struct ethtool_get_features_block per 32
+				 * ETH_SS_FEATURES names */
+	ETHTOOLD_MODULE_INFO,	/* struct ethtool_modinfo */
+	ETHTOOLD_MODULE_EEPROM,	/* arg is the offset; len bytes */
+};
+
+#define ETHTOOLD_MAX_EEPROM	65536
+
+struct ethtoold_request {
+	__u16 version;
+	__u16 op;
+	__u32 arg;
+	__u32 len;
+	char devname[IFNAMSIZ];
+};
+
+struct ethtoold_reply {
+	__u16 version;
+	__u16 op;
+	__s32 status;		/* 0 or a negative errno */
+	__u32 generation;
+	__u32 len;		/* of the payload; 0 on error */
+};
+
+#endif /* ETHTOOLD_H__ */
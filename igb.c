@@ -1,6 +1,7 @@
 /* Copyright (c) 2007 Intel Corporation */
 #include <stdio.h>
 #include "internal.h"
+#include "regs-desc.h"
 
 /* Register Bit Masks */
 /* Device Control */
@@ -88,789 +89,316 @@
 #define E1000_TCTL_RTLC   0x01000000    /* Re-transmit on late collision */
 #define E1000_TCTL_NRTU   0x02000000    /* No Re-transmit on underrun */
 
-int igb_dump_regs(struct ethtool_drvinfo *info maybe_unused,
-		  struct ethtool_regs *regs)
-{
-	u32 *regs_buff = (u32 *)regs->data;
-	u32 reg;
-	u8 i;
-	u8 version = (u8)(regs->version >> 24);
-
-	if (version != 1)
-		return -1;
-
-	/* Device control register */
-	reg = regs_buff[0];
-	fprintf(stdout,
-		"0x00000: CTRL (Device control register)               0x%08X\n"
-		"       Invert Loss-Of-Signal:                         %s\n"
-		"       Receive flow control:                          %s\n"
-		"       Transmit flow control:                         %s\n"
-		"       VLAN mode:                                     %s\n"
-		"       Set link up:                                   %s\n"
-		"       D3COLD WakeUp capability advertisement:        %s\n",
-		reg,
-		reg & E1000_CTRL_ILOS     ? "yes"      : "no",
-		reg & E1000_CTRL_RFCE     ? "enabled"  : "disabled",
-		reg & E1000_CTRL_TFCE     ? "enabled"  : "disabled",
-		reg & E1000_CTRL_VME      ? "enabled"  : "disabled",
-		reg & E1000_CTRL_SLU      ? "1"        : "0",
-		reg & E1000_CTRL_ADVD3WUC ? "enabled"  : "disabled");
-	fprintf(stdout,
-		"       Auto speed detect:                             %s\n"
-		"       Speed select:                                  %s\n"
-		"       Force speed:                                   %s\n"
-		"       Force duplex:                                  %s\n",
-		reg & E1000_CTRL_ASDE   ? "enabled"  : "disabled",
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_10   ? "10Mb/s"   :
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_100  ? "100Mb/s"  :
-		(reg & E1000_CTRL_SPD_SEL) == E1000_CTRL_SPD_1000 ? "1000Mb/s" :
-		"not used",
-		reg & E1000_CTRL_FRCSPD ? "yes"      : "no",
-		reg & E1000_CTRL_FRCDPX ? "yes"      : "no");
-
-	/* Device status register */
-	reg = regs_buff[1];
-	fprintf(stdout,
-		"0x00008: STATUS (Device status register)              0x%08X\n"
-		"       Duplex:                                        %s\n"
-		"       Link up:                                       %s\n"
-		"       Transmission:                                  %s\n"
-		"       DMA clock gating:                              %s\n",
-		reg,
-		reg & E1000_STATUS_FD       ? "full"        : "half",
-		reg & E1000_STATUS_LU       ? "link config" : "no link config",
-		reg & E1000_STATUS_TXOFF    ? "paused"      : "on",
-		reg & E1000_STATUS_DMA_CGEN ? "enabled"     : "disabled");
-	fprintf(stdout,
-		"       TBI mode:                                      %s\n"
-		"       Link speed:                                    %s\n"
-		"       Bus type:                                      %s\n",
-		reg & E1000_STATUS_TBIMODE ? "enabled"     : "disabled",
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_10   ?
-		"10Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_100  ?
-		"100Mb/s" :
-		(reg & E1000_STATUS_SPEED_MASK) == E1000_STATUS_SPEED_1000 ?
-		"1000Mb/s" : "not used",
-		"PCI Express");
-
-	/* Receive control register */
-	reg = regs_buff[32];
-	fprintf(stdout,
-		"0x00100: RCTL (Receive control register)              0x%08X\n"
-		"       Receiver:                                      %s\n"
-		"       Store bad packets:                             %s\n"
-		"       Unicast promiscuous:                           %s\n"
-		"       Multicast promiscuous:                         %s\n"
-		"       Long packet:                                   %s\n"
-		"       Descriptor minimum threshold size:             %s\n"
-		"       Broadcast accept mode:                         %s\n"
-		"       VLAN filter:                                   %s\n"
-		"       Cononical form indicator:                      %s\n"
-		"       Discard pause frames:                          %s\n"
-		"       Pass MAC control frames:                       %s\n"
-		"       Loopback mode:                                 %s\n",
-		reg,
-		reg & E1000_RCTL_EN      ? "enabled"  : "disabled",
-		reg & E1000_RCTL_SBP     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_UPE     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_MPE     ? "enabled"  : "disabled",
-		reg & E1000_RCTL_LPE     ? "enabled"  : "disabled",
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_HALF  ? "1/2" :
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_QUAT  ? "1/4" :
-		(reg & E1000_RCTL_RDMTS) == E1000_RCTL_RDMTS_EIGTH ? "1/8" :
-		"reserved",
-		reg & E1000_RCTL_BAM      ? "accept"   : "ignore",
-		reg & E1000_RCTL_VFE      ? "enabled"  : "disabled",
-		reg & E1000_RCTL_CFIEN    ? "enabled"  : "disabled",
-		reg & E1000_RCTL_DPF      ? "ignored"  : "filtered",
-		reg & E1000_RCTL_PMCF     ? "pass"     : "don't pass",
-		(reg & E1000_RCTL_LBM_MASK) == E1000_RCTL_LBM_NORM   ? "normal" :
-		(reg & E1000_RCTL_LBM_MASK) == E1000_RCTL_LBM_MAC    ? "MAC":
-		(reg & E1000_RCTL_LBM_MASK) == E1000_RCTL_LBM_SERDES ? "SERDES":
-		"undefined");
-	fprintf(stdout,
-		"       Receive buffer size:                           %s\n",
-		(reg & E1000_RCTL_BSIZE)==E1000_RCTL_BSIZE_2048  ? "2048"  :
-		(reg & E1000_RCTL_BSIZE)==E1000_RCTL_BSIZE_1024  ? "1024"  :
-		(reg & E1000_RCTL_BSIZE)==E1000_RCTL_BSIZE_512   ? "512"   :
-		"256");
+static const struct regs_desc_value igb_speed_values[] = {
+	{ 0, E1000_CTRL_SPD_10, "10Mb/s" },
+	{ 0, E1000_CTRL_SPD_100, "100Mb/s" },
+	{ 0, E1000_CTRL_SPD_1000, "1000Mb/s" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field igb_ctrl_fields[] = {
+	REGS_BOOL("Invert Loss-Of-Signal", E1000_CTRL_ILOS, "no", "yes"),
+	REGS_BOOL("Receive flow control", E1000_CTRL_RFCE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Transmit flow control", E1000_CTRL_TFCE,
+		  "disabled", "enabled"),
+	REGS_BOOL("VLAN mode", E1000_CTRL_VME, "disabled", "enabled"),
+	REGS_BOOL("Set link up", E1000_CTRL_SLU, "0", "1"),
+	REGS_BOOL("D3COLD WakeUp capability advertisement",
+		  E1000_CTRL_ADVD3WUC, "disabled", "enabled"),
+	REGS_BOOL("Auto speed detect", E1000_CTRL_ASDE, "disabled", "enabled"),
+	REGS_ENUM("Speed select", E1000_CTRL_SPD_SEL, igb_speed_values,
+		  "not used"),
+	REGS_BOOL("Force speed", E1000_CTRL_FRCSPD, "no", "yes"),
+	REGS_BOOL("Force duplex", E1000_CTRL_FRCDPX, "no", "yes"),
+	{ NULL }
+};
+
+static const struct regs_desc_value igb_link_speed_values[] = {
+	{ 0, E1000_STATUS_SPEED_10, "10Mb/s" },
+	{ 0, E1000_STATUS_SPEED_100, "100Mb/s" },
+	{ 0, E1000_STATUS_SPEED_1000, "1000Mb/s" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field igb_status_fields[] = {
+	REGS_BOOL("Duplex", E1000_STATUS_FD, "half", "full"),
+	REGS_BOOL("Link up", E1000_STATUS_LU, "no link config", "link config"),
+	REGS_BOOL("Transmission", E1000_STATUS_TXOFF, "on", "paused"),
+	REGS_BOOL("DMA clock gating", E1000_STATUS_DMA_CGEN,
+		  "disabled", "enabled"),
+	REGS_BOOL("TBI mode", E1000_STATUS_TBIMODE, "disabled", "enabled"),
+	REGS_ENUM("Link speed", E1000_STATUS_SPEED_MASK,
+		  igb_link_speed_values, "not used"),
+	REGS_ENUM("Bus type", 0, NULL, "PCI Express"),
+	{ NULL }
+};
+
+static const struct regs_desc_value igb_rdmts_values[] = {
+	{ 0, E1000_RCTL_RDMTS_HALF, "1/2" },
+	{ 0, E1000_RCTL_RDMTS_QUAT, "1/4" },
+	{ 0, E1000_RCTL_RDMTS_EIGTH, "1/8" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value igb_loopback_values[] = {
+	{ 0, E1000_RCTL_LBM_NORM, "normal" },
+	{ 0, E1000_RCTL_LBM_MAC, "MAC" },
+	{ 0, E1000_RCTL_LBM_SERDES, "SERDES" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_value igb_buffer_size_values[] = {
+	{ 0, E1000_RCTL_BSIZE_2048, "2048" },
+	{ 0, E1000_RCTL_BSIZE_1024, "1024" },
+	{ 0, E1000_RCTL_BSIZE_512, "512" },
+	{ 0, 0, NULL }
+};
+
+static const struct regs_desc_field igb_rctl_fields[] = {
+	REGS_BOOL("Receiver", E1000_RCTL_EN, "disabled", "enabled"),
+	REGS_BOOL("Store bad packets", E1000_RCTL_SBP, "disabled", "enabled"),
+	REGS_BOOL("Unicast promiscuous", E1000_RCTL_UPE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Multicast promiscuous", E1000_RCTL_MPE,
+		  "disabled", "enabled"),
+	REGS_BOOL("Long packet", E1000_RCTL_LPE, "disabled", "enabled"),
+	REGS_ENUM("Descriptor minimum threshold size", E1000_RCTL_RDMTS,
+		  igb_rdmts_values, "reserved"),
+	REGS_BOOL("Broadcast accept mode", E1000_RCTL_BAM, "ignore", "accept"),
+	REGS_BOOL("VLAN filter", E1000_RCTL_VFE, "disabled", "enabled"),
+	REGS_BOOL("Cononical form indicator", E1000_RCTL_CFIEN,
+		  "disabled", "enabled"),
+	REGS_BOOL("Discard pause frames", E1000_RCTL_DPF,
+		  "filtered", "ignored"),
+	REGS_BOOL("Pass MAC control frames", E1000_RCTL_PMCF,
+		  "don't pass", "pass"),
+	REGS_ENUM("Loopback mode", E1000_RCTL_LBM_MASK, igb_loopback_values,
+		  "undefined"),
+	REGS_ENUM("Receive buffer size", E1000_RCTL_BSIZE,
+		  igb_buffer_size_values, "256"),
+	{ NULL }
+};
+
+static const struct regs_desc_field igb_tctl_fields[] = {
+	REGS_BOOL("Transmitter", E1000_TCTL_EN, "disabled", "enabled"),
+	REGS_BOOL("Pad short packets", E1000_TCTL_PSP, "disabled", "enabled"),
+	REGS_BOOL("Software XOFF Transmission", E1000_TCTL_SWXOFF,
+		  "disabled", "enabled"),
+	REGS_BOOL("Re-transmit on late collision", E1000_TCTL_RTLC,
+		  "disabled", "enabled"),
+	{ NULL }
+};
+
+static const struct regs_desc_reg igb_regs[] = {
+	REGS_DECODE("CTRL", "Device control register", 0x00000, 0,
+		    igb_ctrl_fields),
+	REGS_DECODE("STATUS", "Device status register", 0x00008, 1,
+		    igb_status_fields),
+	REGS_DECODE("RCTL", "Receive control register", 0x00100, 32,
+		    igb_rctl_fields),
 
 	/* Receive descriptor registers */
-	fprintf(stdout,
-		"0x02808: RDLEN  (Receive desc length)                 0x%08X\n",
-		regs_buff[137]);
-	fprintf(stdout,
-		"0x02810: RDH    (Receive desc head)                   0x%08X\n",
-		regs_buff[141]);
-	fprintf(stdout,
-		"0x02818: RDT    (Receive desc tail)                   0x%08X\n",
-		regs_buff[145]);
+	/* Narrower than the rest, as the old decoder printed them */
+	REGS_REG_WIDTH("RDLEN", "Receive desc length", 0x02808, 137, 6),
+	REGS_REG_WIDTH("RDH", "Receive desc head", 0x02810, 141, 6),
+	REGS_REG_WIDTH("RDT", "Receive desc tail", 0x02818, 145, 6),
 
-	/* Transmit control register */
-	reg = regs_buff[38];
-	fprintf(stdout,
-		"0x00400: TCTL (Transmit ctrl register)                0x%08X\n"
-		"       Transmitter:                                   %s\n"
-		"       Pad short packets:                             %s\n"
-		"       Software XOFF Transmission:                    %s\n",
-		reg,
-		reg & E1000_TCTL_EN      ? "enabled"  : "disabled",
-		reg & E1000_TCTL_PSP     ? "enabled"  : "disabled",
-		reg & E1000_TCTL_SWXOFF  ? "enabled"  : "disabled");
-	fprintf(stdout,
-		"       Re-transmit on late collision:                 %s\n",
-		reg & E1000_TCTL_RTLC    ? "enabled"  : "disabled");
+	REGS_DECODE("TCTL", "Transmit ctrl register", 0x00400, 38,
+		    igb_tctl_fields),
 
 	/* Transmit descriptor registers */
-	fprintf(stdout,
-		"0x03808: TDLEN       (Transmit desc length)           0x%08X\n",
-		regs_buff[219]);
-	fprintf(stdout,
-		"0x03810: TDH         (Transmit desc head)             0x%08X\n",
-		regs_buff[223]);
-	fprintf(stdout,
-		"0x03818: TDT         (Transmit desc tail)             0x%08X\n",
-		regs_buff[227]);
-
-
-	fprintf(stdout,
-		"0x00018: CTRL_EXT    (Extended device control)        0x%08X\n",
-		regs_buff[2]);
-
-	fprintf(stdout,
-		"0x00018: MDIC        (MDI control)                    0x%08X\n",
-		regs_buff[3]);
-
-	fprintf(stdout,
-		"0x00024: SCTL        (SERDES ANA)                     0x%08X\n",
-		regs_buff[4]);
-
-	fprintf(stdout,
-		"0x00034: CONNSW      (Copper/Fiber switch control)    0x%08X\n",
-		regs_buff[5]);
-
-	fprintf(stdout,
-		"0x00038: VET         (VLAN Ether type)                0x%08X\n",
-		regs_buff[6]);
-
-	fprintf(stdout,
-		"0x00E00: LEDCTL      (LED control)                    0x%08X\n",
-		regs_buff[7]);
-
-	fprintf(stdout,
-		"0x01000: PBA         (Packet buffer allocation)       0x%08X\n",
-		regs_buff[8]);
-
-	fprintf(stdout,
-		"0x01008: PBS         (Packet buffer size)             0x%08X\n",
-		regs_buff[9]);
-
-	fprintf(stdout,
-		"0x01048: FRTIMER     (Free running timer)             0x%08X\n",
-		regs_buff[10]);
-
-	fprintf(stdout,
-		"0x0104C: TCPTIMER    (TCP timer)                      0x%08X\n",
-		regs_buff[11]);
-
-	fprintf(stdout,
-		"0x00010: EEC         (EEPROM/FLASH control)           0x%08X\n",
-		regs_buff[12]);
-
-	fprintf(stdout,
-		"0x01580: EICR        (Extended interrupt cause)       0x%08X\n",
-		regs_buff[13]);
-
-	fprintf(stdout,
-		"0x01520: EICS        (Extended interrupt cause set)   0x%08X\n",
-		regs_buff[14]);
-
-	fprintf(stdout,
-		"0x01524: EIMS        (Extended interrup set/read)     0x%08X\n",
-		regs_buff[15]);
-
-	fprintf(stdout,
-		"0x01528: EIMC        (Extended interrupt mask clear)  0x%08X\n",
-		regs_buff[16]);
-
-	fprintf(stdout,
-		"0x0152C: EIAC        (Extended interrupt auto clear)  0x%08X\n",
-		regs_buff[17]);
-
-	fprintf(stdout,
-		"0x01530: EIAM        (Extended interrupt auto mask)   0x%08X\n",
-		regs_buff[18]);
-
-	fprintf(stdout,
-		"0x01500: ICR         (Interrupt cause read)           0x%08X\n",
-		regs_buff[19]);
-
-	fprintf(stdout,
-		"0x01504: ICS         (Interrupt cause set)            0x%08X\n",
-		regs_buff[20]);
-
-	fprintf(stdout,
-		"0x01508: IMS         (Interrupt mask set/read)        0x%08X\n",
-		regs_buff[21]);
-
-	fprintf(stdout,
-		"0x0150C: IMC         (Interrupt mask clear)           0x%08X\n",
-		regs_buff[22]);
-
-	fprintf(stdout,
-		"0x04100: IAC         (Interrupt assertion count)      0x%08X\n",
-		regs_buff[23]);
-
-	fprintf(stdout,
-		"0x01510: IAM         (Interr acknowledge auto-mask)   0x%08X\n",
-		regs_buff[24]);
-
-	fprintf(stdout,
-		"0x05AC0: IMIRVP      (Immed interr rx VLAN priority)  0x%08X\n",
-		regs_buff[25]);
-
-	fprintf(stdout,
-		"0x00028: FCAL        (Flow control address low)       0x%08X\n",
-		regs_buff[26]);
-
-	fprintf(stdout,
-		"0x0002C: FCAH        (Flow control address high)      0x%08X\n",
-		regs_buff[27]);
-
-	fprintf(stdout,
-		"0x00170: FCTTV       (Flow control tx timer value)    0x%08X\n",
-		regs_buff[28]);
-
-	fprintf(stdout,
-		"0x02160: FCRTL       (Flow control rx threshold low)  0x%08X\n",
-		regs_buff[29]);
-
-	fprintf(stdout,
-		"0x02168: FCRTH       (Flow control rx threshold high) 0x%08X\n",
-		regs_buff[30]);
-
-	fprintf(stdout,
-		"0x02460: FCRTV       (Flow control refresh threshold) 0x%08X\n",
-		regs_buff[31]);
-
-	fprintf(stdout,
-		"0x05000: RXCSUM      (Receive checksum control)       0x%08X\n",
-		regs_buff[33]);
-
-	fprintf(stdout,
-		"0x05004: RLPML       (Receive long packet max length) 0x%08X\n",
-		regs_buff[34]);
-
-	fprintf(stdout,
-		"0x05008: RFCTL       (Receive filter control)         0x%08X\n",
-		regs_buff[35]);
-
-	fprintf(stdout,
-		"0x05818: MRQC        (Multiple rx queues command)     0x%08X\n",
-		regs_buff[36]);
-
-	fprintf(stdout,
-		"0x0581C: VMD_CTL     (VMDq control)                   0x%08X\n",
-		regs_buff[37]);
-
-	fprintf(stdout,
-		"0x00404: TCTL_EXT    (Transmit control extended)      0x%08X\n",
-		regs_buff[39]);
-
-	fprintf(stdout,
-		"0x00410: TIPG        (Transmit IPG)                   0x%08X\n",
-		regs_buff[40]);
-
-	fprintf(stdout,
-		"0x03590: DTXCTL      (DMA tx control)                 0x%08X\n",
-		regs_buff[41]);
-
-	fprintf(stdout,
-		"0x05800: WUC         (Wake up control)                0x%08X\n",
-		regs_buff[42]);
-
-	fprintf(stdout,
-		"0x05808: WUFC        (Wake up filter control)         0x%08X\n",
-		regs_buff[43]);
-
-	fprintf(stdout,
-		"0x05810: WUS         (Wake up status)                 0x%08X\n",
-		regs_buff[44]);
-
-	fprintf(stdout,
-		"0x05838: IPAV        (IP address valid)               0x%08X\n",
-		regs_buff[45]);
-
-	fprintf(stdout,
-		"0x05900: WUPL        (Wake up packet length)          0x%08X\n",
-		regs_buff[46]);
-
-	fprintf(stdout,
-		"0x04200: PCS_CFG     (PCS configuration 0)            0x%08X\n",
-		regs_buff[47]);
-
-	fprintf(stdout,
-		"0x04208: PCS_LCTL    (PCS link control)               0x%08X\n",
-		regs_buff[48]);
-
-	fprintf(stdout,
-		"0x0420C: PCS_LSTS    (PCS link status)                0x%08X\n",
-		regs_buff[49]);
-
-	fprintf(stdout,
-		"0x04218: PCS_ANADV   (AN advertisement)               0x%08X\n",
-		regs_buff[50]);
-
-	fprintf(stdout,
-		"0x0421C: PCS_LPAB    (Link partner ability)           0x%08X\n",
-		regs_buff[51]);
-
-	fprintf(stdout,
-		"0x04220: PCS_NPTX    (Next Page transmit)             0x%08X\n",
-		regs_buff[52]);
-
-	fprintf(stdout,
-		"0x04224: PCS_LPABNP  (Link partner ability Next Page) 0x%08X\n",
-		regs_buff[53]);
-
-	fprintf(stdout,
-		"0x04000: CRCERRS     (CRC error count)                0x%08X\n",
-		regs_buff[54]);
-
-	fprintf(stdout,
-		"0x04004: ALGNERRC    (Alignment error count)          0x%08X\n",
-		regs_buff[55]);
-
-	fprintf(stdout,
-		"0x04008: SYMERRS     (Symbol error count)             0x%08X\n",
-		regs_buff[56]);
-
-	fprintf(stdout,
-		"0x0400C: RXERRC      (RX error count)                 0x%08X\n",
-		regs_buff[57]);
-
-	fprintf(stdout,
-		"0x04010: MPC         (Missed packets count)           0x%08X\n",
-		regs_buff[58]);
-
-	fprintf(stdout,
-		"0x04014: SCC         (Single collision count)         0x%08X\n",
-		regs_buff[59]);
-
-	fprintf(stdout,
-		"0x04018: ECOL        (Excessive collisions count)     0x%08X\n",
-		regs_buff[60]);
-
-	fprintf(stdout,
-		"0x0401C: MCC         (Multiple collision count)       0x%08X\n",
-		regs_buff[61]);
-
-	fprintf(stdout,
-		"0x04020: LATECOL     (Late collisions count)          0x%08X\n",
-		regs_buff[62]);
-
-	fprintf(stdout,
-		"0x04028: COLC        (Collision count)                0x%08X\n",
-		regs_buff[63]);
-
-	fprintf(stdout,
-		"0x04030: DC          (Defer count)                    0x%08X\n",
-		regs_buff[64]);
-
-	fprintf(stdout,
-		"0x04034: TNCRS       (Transmit with no CRS)           0x%08X\n",
-		regs_buff[65]);
-
-	fprintf(stdout,
-		"0x04038: SEC         (Sequence error count)           0x%08X\n",
-		regs_buff[66]);
-
-	fprintf(stdout,
-		"0x0403C: HTDPMC      (Host tx discrd pkts MAC count)  0x%08X\n",
-		regs_buff[67]);
-
-	fprintf(stdout,
-		"0x04040: RLEC        (Receive length error count)     0x%08X\n",
-		regs_buff[68]);
-
-	fprintf(stdout,
-		"0x04048: XONRXC      (XON received count)             0x%08X\n",
-		regs_buff[69]);
-
-	fprintf(stdout,
-		"0x0404C: XONTXC      (XON transmitted count)          0x%08X\n",
-		regs_buff[70]);
-
-	fprintf(stdout,
-		"0x04050: XOFFRXC     (XOFF received count)            0x%08X\n",
-		regs_buff[71]);
-
-	fprintf(stdout,
-		"0x04054: XOFFTXC     (XOFF transmitted count)         0x%08X\n",
-		regs_buff[72]);
-
-	fprintf(stdout,
-		"0x04058: FCRUC       (FC received unsupported count)  0x%08X\n",
-		regs_buff[73]);
-
-	fprintf(stdout,
-		"0x0405C: PRC64       (Packets rx (64 B) count)        0x%08X\n",
-		regs_buff[74]);
-
-	fprintf(stdout,
-		"0x04060: PRC127      (Packets rx (65-127 B) count)    0x%08X\n",
-		regs_buff[75]);
-
-	fprintf(stdout,
-		"0x04064: PRC255      (Packets rx (128-255 B) count)   0x%08X\n",
-		regs_buff[76]);
-
-	fprintf(stdout,
-		"0x04068: PRC511      (Packets rx (256-511 B) count)   0x%08X\n",
-		regs_buff[77]);
-
-	fprintf(stdout,
-		"0x0406C: PRC1023     (Packets rx (512-1023 B) count)  0x%08X\n",
-		regs_buff[78]);
-
-	fprintf(stdout,
-		"0x04070: PRC1522     (Packets rx (1024-max B) count)  0x%08X\n",
-		regs_buff[79]);
-
-	fprintf(stdout,
-		"0x04074: GPRC        (Good packets received count)    0x%08X\n",
-		regs_buff[80]);
-
-	fprintf(stdout,
-		"0x04078: BPRC        (Broadcast packets rx count)     0x%08X\n",
-		regs_buff[81]);
-
-	fprintf(stdout,
-		"0x0407C: MPRC        (Multicast packets rx count)     0x%08X\n",
-		regs_buff[82]);
-
-	fprintf(stdout,
-		"0x04080: GPTC        (Good packets tx count)          0x%08X\n",
-		regs_buff[83]);
-
-	fprintf(stdout,
-		"0x04088: GORCL       (Good octets rx count lower)     0x%08X\n",
-		regs_buff[84]);
-
-	fprintf(stdout,
-		"0x0408C: GORCH       (Good octets rx count upper)     0x%08X\n",
-		regs_buff[85]);
-
-	fprintf(stdout,
-		"0x04090: GOTCL       (Good octets tx count lower)     0x%08X\n",
-		regs_buff[86]);
-
-	fprintf(stdout,
-		"0x04094: GOTCH       (Good octets tx count upper)     0x%08X\n",
-		regs_buff[87]);
-
-	fprintf(stdout,
-		"0x040A0: RNBC        (Receive no buffers count)       0x%08X\n",
-		regs_buff[88]);
-
-	fprintf(stdout,
-		"0x040A4: RUC         (Receive undersize count)        0x%08X\n",
-		regs_buff[89]);
-
-	fprintf(stdout,
-		"0x040A8: RFC         (Receive fragment count)         0x%08X\n",
-		regs_buff[90]);
-
-	fprintf(stdout,
-		"0x040AC: ROC         (Receive oversize count)         0x%08X\n",
-		regs_buff[91]);
-
-	fprintf(stdout,
-		"0x040B0: RJC         (Receive jabber count)           0x%08X\n",
-		regs_buff[92]);
-
-	fprintf(stdout,
-		"0x040B4: MGPRC       (Management packets rx count)    0x%08X\n",
-		regs_buff[93]);
-
-	fprintf(stdout,
-		"0x040B8: MGPDC       (Management pkts dropped count)  0x%08X\n",
-		regs_buff[94]);
-
-	fprintf(stdout,
-		"0x040BC: MGPTC       (Management packets tx count)    0x%08X\n",
-		regs_buff[95]);
-
-	fprintf(stdout,
-		"0x040C0: TORL        (Total octets received lower)    0x%08X\n",
-		regs_buff[96]);
-
-	fprintf(stdout,
-		"0x040C4: TORH        (Total octets received upper)    0x%08X\n",
-		regs_buff[97]);
-
-	fprintf(stdout,
-		"0x040C8: TOTL        (Total octets transmitted lower) 0x%08X\n",
-		regs_buff[98]);
-
-	fprintf(stdout,
-		"0x040CC: TOTH        (Total octets transmitted upper) 0x%08X\n",
-		regs_buff[99]);
-
-	fprintf(stdout,
-		"0x040D0: TPR         (Total packets received)         0x%08X\n",
-		regs_buff[100]);
-
-	fprintf(stdout,
-		"0x040D4: TPT         (Total packets transmitted)      0x%08X\n",
-		regs_buff[101]);
-
-	fprintf(stdout,
-		"0x040D8: PTC64       (Packets tx (64 B) count)        0x%08X\n",
-		regs_buff[102]);
-
-	fprintf(stdout,
-		"0x040DC: PTC127      (Packets tx (65-127 B) count)    0x%08X\n",
-		regs_buff[103]);
-
-	fprintf(stdout,
-		"0x040E0: PTC255      (Packets tx (128-255 B) count)   0x%08X\n",
-		regs_buff[104]);
-
-	fprintf(stdout,
-		"0x040E4: PTC511      (Packets tx (256-511 B) count)   0x%08X\n",
-		regs_buff[105]);
-
-	fprintf(stdout,
-		"0x040E8: PTC1023     (Packets tx (512-1023 B) count)  0x%08X\n",
-		regs_buff[106]);
-
-	fprintf(stdout,
-		"0x040EC: PTC1522     (Packets tx (> 1024 B) count)    0x%08X\n",
-		regs_buff[107]);
-
-	fprintf(stdout,
-		"0x040F0: MPTC        (Multicast packets tx count)     0x%08X\n",
-		regs_buff[108]);
-
-	fprintf(stdout,
-		"0x040F4: BPTC        (Broadcast packets tx count)     0x%08X\n",
-		regs_buff[109]);
-
-	fprintf(stdout,
-		"0x040F8: TSCTC       (TCP segment context tx count)   0x%08X\n",
-		regs_buff[110]);
-
-	fprintf(stdout,
-		"0x04100: IAC         (Interrupt assertion count)      0x%08X\n",
-		regs_buff[111]);
-
-	fprintf(stdout,
-		"0x04104: RPTHC       (Rx packets to host count)       0x%08X\n",
-		regs_buff[112]);
-
-	fprintf(stdout,
-		"0x04118: HGPTC       (Host good packets tx count)     0x%08X\n",
-		regs_buff[113]);
-
-	fprintf(stdout,
-		"0x04128: HGORCL      (Host good octets rx cnt lower)  0x%08X\n",
-		regs_buff[114]);
-
-	fprintf(stdout,
-		"0x0412C: HGORCH      (Host good octets rx cnt upper)  0x%08X\n",
-		regs_buff[115]);
-
-	fprintf(stdout,
-		"0x04130: HGOTCL      (Host good octets tx cnt lower)  0x%08X\n",
-		regs_buff[116]);
-
-	fprintf(stdout,
-		"0x04134: HGOTCH      (Host good octets tx cnt upper)  0x%08X\n",
-		regs_buff[117]);
-
-	fprintf(stdout,
-		"0x04138: LENNERS     (Length error count)             0x%08X\n",
-		regs_buff[118]);
-
-	fprintf(stdout,
-		"0x04228: SCVPC       (SerDes/SGMII code viol pkt cnt) 0x%08X\n",
-		regs_buff[119]);
-
-	fprintf(stdout,
-		"0x0A018: HRMPC       (Header redir missed pkt count)  0x%08X\n",
-		regs_buff[120]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: SRRCTL%d     (Split and replic rx ctl%d)       0x%08X\n",
-		0x0280C + (0x100 * i), i, i, regs_buff[121 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: PSRTYPE%d    (Packet split receive type%d)     0x%08X\n",
-		0x05480 + (0x4 * i), i, i, regs_buff[125 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RDBAL%d      (Rx desc base addr low%d)         0x%08X\n",
-		0x02800 + (0x100 * i), i, i, regs_buff[129 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RDBAH%d      (Rx desc base addr high%d)        0x%08X\n",
-		0x02804 + (0x100 * i), i, i, regs_buff[133 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RDLEN%d      (Rx descriptor length%d)          0x%08X\n",
-		0x02808 + (0x100 * i), i, i, regs_buff[137 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RDH%d        (Rx descriptor head%d)            0x%08X\n",
-		0x02810 + (0x100 * i), i, i, regs_buff[141 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RDT%d        (Rx descriptor tail%d)            0x%08X\n",
-		0x02818 + (0x100 * i), i, i, regs_buff[145 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: RXDCTL%d     (Rx descriptor control%d)         0x%08X\n",
-		0x02828 + (0x100 * i), i, i, regs_buff[149 + i]);
-
-	for (i = 0; i < 10; i++)
-		fprintf(stdout,
-		"0x0%02X: EITR%d       (Interrupt throttle%d)            0x%08X\n",
-		0x01680 + (0x4 * i), i, i, regs_buff[153 + i]);
-
-	for (i = 0; i < 8; i++)
-		fprintf(stdout,
-		"0x0%02X: IMIR%d       (Immediate interrupt Rx%d)        0x%08X\n",
-		0x05A80 + (0x4 * i), i, i, regs_buff[163 + i]);
-
-	for (i = 0; i < 8; i++)
-		fprintf(stdout,
-		"0x0%02X: IMIREXT%d    (Immediate interr Rx extended%d)  0x%08X\n",
-		0x05AA0 + (0x4 * i), i, i, regs_buff[171 + i]);
-
-	for (i = 0; i < 16; i++)
-		fprintf(stdout,
-		"0x0%02X: RAL%02d       (Receive address low%02d)          0x%08X\n",
-		0x05400 + (0x8 * i), i,i, regs_buff[179 + i]);
-
-	for (i = 0; i < 16; i++)
-		fprintf(stdout,
-		"0x0%02X: RAH%02d       (Receive address high%02d)         0x%08X\n",
-		0x05404 + (0x8 * i), i, i, regs_buff[195 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDBAL%d      (Tx desc base address low%d)      0x%08X\n",
-		0x03800 + (0x100 * i), i, i, regs_buff[211 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDBAH%d      (Tx desc base address high%d)     0x%08X\n",
-		0x03804 + (0x100 * i), i, i, regs_buff[215 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDLEN%d      (Tx descriptor length%d)          0x%08X\n",
-		0x03808 + (0x100 * i), i, i, regs_buff[219 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDH%d        (Transmit descriptor head%d)      0x%08X\n",
-		0x03810 + (0x100 * i), i, i, regs_buff[223 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDT%d        (Transmit descriptor tail%d)      0x%08X\n",
-		0x03818 + (0x100 * i), i, i, regs_buff[227 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TXDCTL%d     (Transmit descriptor control%d)   0x%08X\n",
-		0x03828 + (0x100 * i), i, i, regs_buff[231 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDWBAL%d     (Tx desc complete wb addr low%d)  0x%08X\n",
-		0x03838 + (0x100 * i), i, i, regs_buff[235 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: TDWBAH%d     (Tx desc complete wb addr hi%d)   0x%08X\n",
-		0x0383C + (0x100 * i), i, i, regs_buff[239 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: DCA_TXCTRL%d (Tx DCA control%d)                0x%08X\n",
-		0x03814 + (0x100 * i), i, i, regs_buff[243 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: IP4AT%d      (IPv4 address table%d)            0x%08X\n",
-		0x05840 + (0x8 * i), i, i, regs_buff[247 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: IP6AT%d      (IPv6 address table%d)            0x%08X\n",
-		0x05880 + (0x4 * i), i, i, regs_buff[251 + i]);
-
-	for (i = 0; i < 32; i++)
-		fprintf(stdout,
-		"0x0%02X: WUPM%02d      (Wake up packet memory%02d)        0x%08X\n",
-		0x05A00 + (0x4 * i), i, i, regs_buff[255 + i]);
-
-	for (i = 0; i < 128; i++)
-		fprintf(stdout,
-		"0x0%02X: FFMT%03d     (Flexible filter mask table%03d)  0x%08X\n",
-		0x09000 + (0x8 * i), i, i, regs_buff[287 + i]);
-
-	for (i = 0; i < 128; i++)
-		fprintf(stdout,
-		"0x0%02X: FFVT%03d     (Flexible filter value table%03d) 0x%08X\n",
-		0x09800 + (0x8 * i), i, i, regs_buff[415 + i]);
-
-	for (i = 0; i < 4; i++)
-		fprintf(stdout,
-		"0x0%02X: FFLT%d       (Flexible filter length table%d)  0x%08X\n",
-		0x05F00 + (0x8 * i), i, i, regs_buff[543 + i]);
-
-	fprintf(stdout,
-		"0x03410: TDFH        (Tx data FIFO head)              0x%08X\n",
-		regs_buff[547]);
-
-	fprintf(stdout,
-		"0x03418: TDFT        (Tx data FIFO tail)              0x%08X\n",
-		regs_buff[548]);
-
-	fprintf(stdout,
-		"0x03420: TDFHS       (Tx data FIFO head saved)        0x%08X\n",
-		regs_buff[549]);
-
-	fprintf(stdout,
-		"0x03430: TDFPC       (Tx data FIFO packet count)      0x%08X\n",
-		regs_buff[550]);
-
-	/*
-	 * Starting from kernel version 5.3 the registers dump buffer grew from
-	 * 739 4-byte words to 740 words, and word 740 contains the RR2DCDELAY
-	 * register.
-	 */
-	if (regs->len < 740)
-		return 0;
+	REGS_REG("TDLEN", "Transmit desc length", 0x03808, 219),
+	REGS_REG("TDH", "Transmit desc head", 0x03810, 223),
+	REGS_REG("TDT", "Transmit desc tail", 0x03818, 227),
+
+	REGS_REG("CTRL_EXT", "Extended device control", 0x00018, 2),
+	REGS_REG("MDIC", "MDI control", 0x00018, 3),
+	REGS_REG("SCTL", "SERDES ANA", 0x00024, 4),
+	REGS_REG("CONNSW", "Copper/Fiber switch control", 0x00034, 5),
+	REGS_REG("VET", "VLAN Ether type", 0x00038, 6),
+	REGS_REG("LEDCTL", "LED control", 0x00E00, 7),
+	REGS_REG("PBA", "Packet buffer allocation", 0x01000, 8),
+	REGS_REG("PBS", "Packet buffer size", 0x01008, 9),
+	REGS_REG("FRTIMER", "Free running timer", 0x01048, 10),
+	REGS_REG("TCPTIMER", "TCP timer", 0x0104C, 11),
+	REGS_REG("EEC", "EEPROM/FLASH control", 0x00010, 12),
+	REGS_REG("EICR", "Extended interrupt cause", 0x01580, 13),
+	REGS_REG("EICS", "Extended interrupt cause set", 0x01520, 14),
+	REGS_REG("EIMS", "Extended interrup set/read", 0x01524, 15),
+	REGS_REG("EIMC", "Extended interrupt mask clear", 0x01528, 16),
+	REGS_REG("EIAC", "Extended interrupt auto clear", 0x0152C, 17),
+	REGS_REG("EIAM", "Extended interrupt auto mask", 0x01530, 18),
+	REGS_REG("ICR", "Interrupt cause read", 0x01500, 19),
+	REGS_REG("ICS", "Interrupt cause set", 0x01504, 20),
+	REGS_REG("IMS", "Interrupt mask set/read", 0x01508, 21),
+	REGS_REG("IMC", "Interrupt mask clear", 0x0150C, 22),
+	REGS_REG("IAC", "Interrupt assertion count", 0x04100, 23),
+	REGS_REG("IAM", "Interr acknowledge auto-mask", 0x01510, 24),
+	REGS_REG("IMIRVP", "Immed interr rx VLAN priority", 0x05AC0, 25),
+	REGS_REG("FCAL", "Flow control address low", 0x00028, 26),
+	REGS_REG("FCAH", "Flow control address high", 0x0002C, 27),
+	REGS_REG("FCTTV", "Flow control tx timer value", 0x00170, 28),
+	REGS_REG("FCRTL", "Flow control rx threshold low", 0x02160, 29),
+	REGS_REG("FCRTH", "Flow control rx threshold high", 0x02168, 30),
+	REGS_REG("FCRTV", "Flow control refresh threshold", 0x02460, 31),
+	REGS_REG("RXCSUM", "Receive checksum control", 0x05000, 33),
+	REGS_REG("RLPML", "Receive long packet max length", 0x05004, 34),
+	REGS_REG("RFCTL", "Receive filter control", 0x05008, 35),
+	REGS_REG("MRQC", "Multiple rx queues command", 0x05818, 36),
+	REGS_REG("VMD_CTL", "VMDq control", 0x0581C, 37),
+	REGS_REG("TCTL_EXT", "Transmit control extended", 0x00404, 39),
+	REGS_REG("TIPG", "Transmit IPG", 0x00410, 40),
+	REGS_REG("DTXCTL", "DMA tx control", 0x03590, 41),
+	REGS_REG("WUC", "Wake up control", 0x05800, 42),
+	REGS_REG("WUFC", "Wake up filter control", 0x05808, 43),
+	REGS_REG("WUS", "Wake up status", 0x05810, 44),
+	REGS_REG("IPAV", "IP address valid", 0x05838, 45),
+	REGS_REG("WUPL", "Wake up packet length", 0x05900, 46),
+	REGS_REG("PCS_CFG", "PCS configuration 0", 0x04200, 47),
+	REGS_REG("PCS_LCTL", "PCS link control", 0x04208, 48),
+	REGS_REG("PCS_LSTS", "PCS link status", 0x0420C, 49),
+	REGS_REG("PCS_ANADV", "AN advertisement", 0x04218, 50),
+	REGS_REG("PCS_LPAB", "Link partner ability", 0x0421C, 51),
+	REGS_REG("PCS_NPTX", "Next Page transmit", 0x04220, 52),
+	REGS_REG("PCS_LPABNP", "Link partner ability Next Page", 0x04224, 53),
+	REGS_REG("CRCERRS", "CRC error count", 0x04000, 54),
+	REGS_REG("ALGNERRC", "Alignment error count", 0x04004, 55),
+	REGS_REG("SYMERRS", "Symbol error count", 0x04008, 56),
+	REGS_REG("RXERRC", "RX error count", 0x0400C, 57),
+	REGS_REG("MPC", "Missed packets count", 0x04010, 58),
+	REGS_REG("SCC", "Single collision count", 0x04014, 59),
+	REGS_REG("ECOL", "Excessive collisions count", 0x04018, 60),
+	REGS_REG("MCC", "Multiple collision count", 0x0401C, 61),
+	REGS_REG("LATECOL", "Late collisions count", 0x04020, 62),
+	REGS_REG("COLC", "Collision count", 0x04028, 63),
+	REGS_REG("DC", "Defer count", 0x04030, 64),
+	REGS_REG("TNCRS", "Transmit with no CRS", 0x04034, 65),
+	REGS_REG("SEC", "Sequence error count", 0x04038, 66),
+	REGS_REG("HTDPMC", "Host tx discrd pkts MAC count", 0x0403C, 67),
+	REGS_REG("RLEC", "Receive length error count", 0x04040, 68),
+	REGS_REG("XONRXC", "XON received count", 0x04048, 69),
+	REGS_REG("XONTXC", "XON transmitted count", 0x0404C, 70),
+	REGS_REG("XOFFRXC", "XOFF received count", 0x04050, 71),
+	REGS_REG("XOFFTXC", "XOFF transmitted count", 0x04054, 72),
+	REGS_REG("FCRUC", "FC received unsupported count", 0x04058, 73),
+	REGS_REG("PRC64", "Packets rx (64 B) count", 0x0405C, 74),
+	REGS_REG("PRC127", "Packets rx (65-127 B) count", 0x04060, 75),
+	REGS_REG("PRC255", "Packets rx (128-255 B) count", 0x04064, 76),
+	REGS_REG("PRC511", "Packets rx (256-511 B) count", 0x04068, 77),
+	REGS_REG("PRC1023", "Packets rx (512-1023 B) count", 0x0406C, 78),
+	REGS_REG("PRC1522", "Packets rx (1024-max B) count", 0x04070, 79),
+	REGS_REG("GPRC", "Good packets received count", 0x04074, 80),
+	REGS_REG("BPRC", "Broadcast packets rx count", 0x04078, 81),
+	REGS_REG("MPRC", "Multicast packets rx count", 0x0407C, 82),
+	REGS_REG("GPTC", "Good packets tx count", 0x04080, 83),
+	REGS_REG("GORCL", "Good octets rx count lower", 0x04088, 84),
+	REGS_REG("GORCH", "Good octets rx count upper", 0x0408C, 85),
+	REGS_REG("GOTCL", "Good octets tx count lower", 0x04090, 86),
+	REGS_REG("GOTCH", "Good octets tx count upper", 0x04094, 87),
+	REGS_REG("RNBC", "Receive no buffers count", 0x040A0, 88),
+	REGS_REG("RUC", "Receive undersize count", 0x040A4, 89),
+	REGS_REG("RFC", "Receive fragment count", 0x040A8, 90),
+	REGS_REG("ROC", "Receive oversize count", 0x040AC, 91),
+	REGS_REG("RJC", "Receive jabber count", 0x040B0, 92),
+	REGS_REG("MGPRC", "Management packets rx count", 0x040B4, 93),
+	REGS_REG("MGPDC", "Management pkts dropped count", 0x040B8, 94),
+	REGS_REG("MGPTC", "Management packets tx count", 0x040BC, 95),
+	REGS_REG("TORL", "Total octets received lower", 0x040C0, 96),
+	REGS_REG("TORH", "Total octets received upper", 0x040C4, 97),
+	REGS_REG("TOTL", "Total octets transmitted lower", 0x040C8, 98),
+	REGS_REG("TOTH", "Total octets transmitted upper", 0x040CC, 99),
+	REGS_REG("TPR", "Total packets received", 0x040D0, 100),
+	REGS_REG("TPT", "Total packets transmitted", 0x040D4, 101),
+	REGS_REG("PTC64", "Packets tx (64 B) count", 0x040D8, 102),
+	REGS_REG("PTC127", "Packets tx (65-127 B) count", 0x040DC, 103),
+	REGS_REG("PTC255", "Packets tx (128-255 B) count", 0x040E0, 104),
+	REGS_REG("PTC511", "Packets tx (256-511 B) count", 0x040E4, 105),
+	REGS_REG("PTC1023", "Packets tx (512-1023 B) count", 0x040E8, 106),
+	REGS_REG("PTC1522", "Packets tx (> 1024 B) count", 0x040EC, 107),
+	REGS_REG("MPTC", "Multicast packets tx count", 0x040F0, 108),
+	REGS_REG("BPTC", "Broadcast packets tx count", 0x040F4, 109),
+	REGS_REG("TSCTC", "TCP segment context tx count", 0x040F8, 110),
+	REGS_REG("IAC", "Interrupt assertion count", 0x04100, 111),
+	REGS_REG("RPTHC", "Rx packets to host count", 0x04104, 112),
+	REGS_REG("HGPTC", "Host good packets tx count", 0x04118, 113),
+	REGS_REG("HGORCL", "Host good octets rx cnt lower", 0x04128, 114),
+	REGS_REG("HGORCH", "Host good octets rx cnt upper", 0x0412C, 115),
+	REGS_REG("HGOTCL", "Host good octets tx cnt lower", 0x04130, 116),
+	REGS_REG("HGOTCH", "Host good octets tx cnt upper", 0x04134, 117),
+	REGS_REG("LENNERS", "Length error count", 0x04138, 118),
+	REGS_REG("SCVPC", "SerDes/SGMII code viol pkt cnt", 0x04228, 119),
+	REGS_REG("HRMPC", "Header redir missed pkt count", 0x0A018, 120),
+	REGS_ARRAY("SRRCTL%d", "Split and replic rx ctl%d", 0x0280C, 0x100, 121,
+	           4),
+	REGS_ARRAY("PSRTYPE%d", "Packet split receive type%d", 0x05480, 4, 125,
+	           4),
+	REGS_ARRAY("RDBAL%d", "Rx desc base addr low%d", 0x02800, 0x100, 129,
+	           4),
+	REGS_ARRAY("RDBAH%d", "Rx desc base addr high%d", 0x02804, 0x100, 133,
+	           4),
+	REGS_ARRAY("RDLEN%d", "Rx descriptor length%d", 0x02808, 0x100, 137, 4),
+	REGS_ARRAY("RDH%d", "Rx descriptor head%d", 0x02810, 0x100, 141, 4),
+	REGS_ARRAY("RDT%d", "Rx descriptor tail%d", 0x02818, 0x100, 145, 4),
+	REGS_ARRAY("RXDCTL%d", "Rx descriptor control%d", 0x02828, 0x100, 149,
+	           4),
+	REGS_ARRAY("EITR%d", "Interrupt throttle%d", 0x01680, 4, 153, 10),
+	REGS_ARRAY("IMIR%d", "Immediate interrupt Rx%d", 0x05A80, 4, 163, 8),
+	REGS_ARRAY("IMIREXT%d", "Immediate interr Rx extended%d", 0x05AA0, 4,
+	           171, 8),
+	REGS_ARRAY("RAL%02d", "Receive address low%02d", 0x05400, 8, 179, 16),
+	REGS_ARRAY("RAH%02d", "Receive address high%02d", 0x05404, 8, 195, 16),
+	REGS_ARRAY("TDBAL%d", "Tx desc base address low%d", 0x03800, 0x100, 211,
+	           4),
+	REGS_ARRAY("TDBAH%d", "Tx desc base address high%d", 0x03804, 0x100,
+	           215, 4),
+	REGS_ARRAY("TDLEN%d", "Tx descriptor length%d", 0x03808, 0x100, 219, 4),
+	REGS_ARRAY("TDH%d", "Transmit descriptor head%d", 0x03810, 0x100, 223,
+	           4),
+	REGS_ARRAY("TDT%d", "Transmit descriptor tail%d", 0x03818, 0x100, 227,
+	           4),
+	REGS_ARRAY("TXDCTL%d", "Transmit descriptor control%d", 0x03828, 0x100,
+	           231, 4),
+	REGS_ARRAY("TDWBAL%d", "Tx desc complete wb addr low%d", 0x03838, 0x100,
+	           235, 4),
+	REGS_ARRAY("TDWBAH%d", "Tx desc complete wb addr hi%d", 0x0383C, 0x100,
+	           239, 4),
+	REGS_ARRAY("DCA_TXCTRL%d", "Tx DCA control%d", 0x03814, 0x100, 243, 4),
+	REGS_ARRAY("IP4AT%d", "IPv4 address table%d", 0x05840, 8, 247, 4),
+	REGS_ARRAY("IP6AT%d", "IPv6 address table%d", 0x05880, 4, 251, 4),
+	REGS_ARRAY("WUPM%02d", "Wake up packet memory%02d", 0x05A00, 4, 255,
+	           32),
+	REGS_ARRAY("FFMT%03d", "Flexible filter mask table%03d", 0x09000, 8,
+	           287, 128),
+	REGS_ARRAY("FFVT%03d", "Flexible filter value table%03d", 0x09800, 8,
+	           415, 128),
+	REGS_ARRAY("FFLT%d", "Flexible filter length table%d", 0x05F00, 8, 543,
+	           4),
+	REGS_REG("TDFH", "Tx data FIFO head", 0x03410, 547),
+	REGS_REG("TDFT", "Tx data FIFO tail", 0x03418, 548),
+	REGS_REG("TDFHS", "Tx data FIFO head saved", 0x03420, 549),
+	REGS_REG("TDFPC", "Tx data FIFO packet count", 0x03430, 550),
+	/* Only in dumps from kernel 5.3 on, which grew to 740 words */
+	REGS_REG("RR2DCDELAY", "Max. DMA read delay", 0x05BF4, 739),
+};
+
+static const struct regs_desc_table igb_regs_table = {
+	.regs = igb_regs,
+	.n_regs = ARRAY_SIZE(igb_regs),
+	.name_width = 11,
+	.value_col = 54,
+	.field_indent = 7,
+};
+
+int igb_describe_regs(struct ethtool_drvinfo *info maybe_unused,
+		      struct ethtool_regs *regs, struct regs_desc *desc)
+{
+	u8 version = (u8)(regs->version >> 24);
 
-	fprintf(stdout,
-		"0x05BF4: RR2DCDELAY  (Max. DMA read delay)            0x%08X\n",
-		regs_buff[739]);
+	if (version != 1)
+		return -1;
 
+	desc->table = &igb_regs_table;
+	desc->mac = 0;
 	return 0;
 }
-
@@ -103,6 +103,11 @@ static inline int test_bit(unsigned int nr, const unsigned long *addr)
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
+/* Break the build if @cond is true */
+#ifndef BUILD_BUG_ON
+#define BUILD_BUG_ON(cond) ((void)sizeof(char[1 - 2 * !!(cond)]))
+#endif
+
 #ifndef SIOCETHTOOL
 #define SIOCETHTOOL     0x8946
 #endif
@@ -179,17 +184,20 @@ static inline int ethtool_link_mode_test_bit(unsigned int nr, const u32 *mask)
 {
 	if (nr >= ETHTOOL_LINK_MODE_MASK_MAX_KERNEL_NBITS)
 		return !!0;
-	return !!(mask[nr / 32] & (1 << (nr % 32)));
+	return !!(mask[nr / 32] & (1U << (nr % 32)));
 }
 
 static inline int ethtool_link_mode_set_bit(unsigned int nr, u32 *mask)
 {
 	if (nr >= ETHTOOL_LINK_MODE_MASK_MAX_KERNEL_NBITS)
 		return -1;
-	mask[nr / 32] |= (1 << (nr % 32));
+	mask[nr / 32] |= (1U << (nr % 32));
 	return 0;
 }
 
+struct feature_defs;
+struct nl_context;
+
 /* Context for sub-commands */
 struct cmd_context {
 	const char *devname;	/* net device name */
@@ -197,10 +205,16 @@ struct cmd_context {
 	struct ifreq ifr;	/* ifreq suitable for ethtool ioctl */
 	int argc;		/* number of arguments to the sub-command */
 	char **argp;		/* arguments to the sub-command */
+	/* Feature names kept for the rest of a --batch run, or NULL */
+	struct feature_defs **batch_defs;
+	struct nl_context *nl;	/* netlink transport, or NULL */
 };
 
+struct ethtool_dev;		/* libethtool.h */
+
 #ifdef TEST_ETHTOOL
 int test_cmdline(const char *args);
+int test_cmdline_output(const char *args, FILE *output);
 
 struct cmd_expect {
 	const void *cmd;	/* expected command; NULL at end of list */
@@ -212,6 +226,57 @@ struct cmd_expect {
 int test_ioctl(const struct cmd_expect *expect, void *cmd);
 #define TEST_IOCTL_MISMATCH (-2)
 
+/* Allocations through the test wrappers.  count and peak only grow;
+ * bytes is what is currently allocated.
+ */
+struct test_alloc_stats {
+	unsigned long count;
+	size_t bytes, peak;
+};
+extern struct test_alloc_stats test_alloc_stats;
+
+/* Mock netlink socket.  If set, each message sent on a netlink socket
+ * is passed to this, which writes any replies to @reply_fd.  If not,
+ * netlink sockets cannot be created.
+ */
+extern void (*test_netlink)(int reply_fd, const void *msg, size_t len);
+/* Send a notification to the sockets of @protocol that joined a group,
+ * or with @msg NULL, shut them down
+ */
+void test_netlink_event(int protocol, const void *msg, size_t len);
+/* Sockets created and messages sent and received through the wrappers;
+ * a test's ioctl_send() adds its ioctls
+ */
+extern unsigned long test_syscalls;
+
+/* Simulated device (test-fakenic.c).  A test's ioctl_send() may pass
+ * every request to fakenic_ioctl().
+ */
+struct fakenic_config {
+	unsigned int n_stats;
+	unsigned int n_queues;		/* combined channels */
+	unsigned int n_rules;		/* RX classification table size */
+	int driver_select;		/* driver chooses rule locations */
+	unsigned int indir_size;	/* RSS indirection table size */
+	unsigned int regs_len;
+	u32 module_type;		/* ETH_MODULE_SFF_*, or 0 for none */
+	const u8 *module_image;		/* NULL to generate one */
+	unsigned int module_len;	/* 0 for the type's usual length */
+	unsigned int latency_us;	/* added to every request */
+};
+int fakenic_create(const struct fakenic_config *config);
+void fakenic_destroy(void);
+int fakenic_ioctl(struct cmd_context *ctx, void *cmd);
+/* The same as the send() of a libethtool device */
+int fakenic_send(struct ethtool_dev *dev, void *cmd);
+
+/* Requests handled and bytes they copied in and out, as the kernel would */
+struct fakenic_io {
+	unsigned long requests;
+	unsigned long long bytes;
+};
+extern struct fakenic_io fakenic_io;
+
 int test_main(int argc, char **argp);
 void test_exit(int rc) __attribute__((noreturn));
 
@@ -243,6 +308,19 @@ int test_socket(int domain, int type, int protocol);
 int test_close(int fd);
 #undef close
 #define close(fd) test_close(fd)
+ssize_t test_send(int fd, const void *buf, size_t len, int flags);
+#undef send
+#define send(fd, buf, len, flags) test_send(fd, buf, len, flags)
+ssize_t test_recv(int fd, void *buf, size_t len, int flags);
+#undef recv
+#define recv(fd, buf, len, flags) test_recv(fd, buf, len, flags)
+int test_bind(int fd, const struct sockaddr *addr, socklen_t len);
+#undef bind
+#define bind(fd, addr, len) test_bind(fd, addr, len)
+int test_setsockopt(int fd, int level, int name, const void *val,
+		    socklen_t len);
+#undef setsockopt
+#define setsockopt(...) test_setsockopt(__VA_ARGS__)
 FILE *test_fopen(const char *path, const char *mode);
 #undef fopen
 #define fopen(path, mode) test_fopen(path, mode)
@@ -253,8 +331,42 @@ int test_fclose(FILE *fh);
 #endif
 
 int send_ioctl(struct cmd_context *ctx, void *cmd);
+size_t request_size(const void *cmd, int header_only);
+bool request_is_read(u32 cmd);
+/* A libethtool device whose requests go through send_ioctl() */
+void ctx_ethtool_dev(struct cmd_context *ctx, struct ethtool_dev *dev);
+/* Requests shared with libethtool.  Each returns 0 or a negative errno
+ * and on success a request structure that the caller must free.
+ */
+int ethtool_fetch_strings(struct ethtool_dev *dev, enum ethtool_stringset set,
+			  u32 len, int null_terminate,
+			  struct ethtool_gstrings **strings);
+int ethtool_fetch_rxfh(struct ethtool_dev *dev, u32 rss_context,
+		       struct ethtool_rxfh **rss);
+int ethtool_fetch_rule_locs(struct ethtool_dev *dev, u32 count,
+			    struct ethtool_rxnfc **rules);
+/* Transports behind send_ioctl(); tests replace ioctl_send() */
+int ioctl_send(struct cmd_context *ctx, void *cmd);
+struct nl_context *netlink_new(void);
+void netlink_free(struct nl_context *nl);
+bool netlink_send(struct cmd_context *ctx, void *cmd, int *ret);
 
 void dump_hex(FILE *f, const u8 *data, int len, int offset);
+/* dump_hex_fmt() flags */
+#define DUMP_HEX_ASCII		(1 << 0)	/* printable characters too */
+#define DUMP_HEX_SQUEEZE	(1 << 1)	/* repeated lines as one "*" */
+void dump_hex_fmt(FILE *f, const u8 *data, int len, int offset,
+		  unsigned int flags);
+
+/* Drivers with a register description table (see regs-desc.h) */
+struct regs_desc;
+
+/* Restricts the register tables a driver prints, and their rows */
+struct regs_table_filter {
+	const char *table;	/* table name glob, or NULL for all */
+	const char *field;	/* field name glob, or NULL for all */
+	u32 first_row, last_row;	/* inclusive */
+};
 
 /* National Semiconductor DP83815, DP83816 */
 int natsemi_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
@@ -265,9 +377,11 @@ int natsemi_dump_eeprom(struct ethtool_drvinfo *info,
 int de2104x_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 
 /* Intel(R) PRO/1000 Gigabit Adapter Family */
-int e1000_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
+int e1000_describe_regs(struct ethtool_drvinfo *info,
+			struct ethtool_regs *regs, struct regs_desc *desc);
 
-int igb_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
+int igb_describe_regs(struct ethtool_drvinfo *info,
+		      struct ethtool_regs *regs, struct regs_desc *desc);
 
 /* RealTek PCI */
 int realtek_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
@@ -293,7 +407,8 @@ int ibm_emac_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 /* Intel(R) PRO/10GBe Gigabit Adapter Family */
 int ixgb_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 
-int ixgbe_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
+int ixgbe_describe_regs(struct ethtool_drvinfo *info,
+			struct ethtool_regs *regs, struct regs_desc *desc);
 
 int ixgbevf_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 
@@ -316,6 +431,9 @@ int at76c50x_usb_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *re
 
 /* Solarflare Solarstorm controllers */
 int sfc_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
+int sfc_dump_regs_tables(struct ethtool_drvinfo *info,
+			 struct ethtool_regs *regs,
+			 const struct regs_table_filter *filter);
 
 /* STMMAC embedded ethernet controller */
 int st_mac100_dump_regs(struct ethtool_drvinfo *info,
@@ -358,8 +476,26 @@ int lan78xx_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 
 /* Distributed Switch Architecture */
 int dsa_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
+int dsa_dump_regs_ports(struct ethtool_drvinfo *info,
+			struct ethtool_regs **regs, const char *const *names,
+			unsigned int n, int colour);
 
 /* i.MX Fast Ethernet Controller */
 int fec_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs);
 
+/* Query daemon */
+struct ethtool_dev;
+struct ethtoold_server;
+struct ethtoold_config {
+	unsigned int max_age_ms;	/* statistics are reused for this long */
+	unsigned int refresh_s;		/* device metadata is read again after */
+	/* Replaces the ioctl for every device if set, as in tests */
+	int (*send)(struct ethtool_dev *dev, void *cmd);
+	void *priv;
+};
+struct ethtoold_server *ethtoold_server_new(int listen_fd, int ctl_fd,
+					    const struct ethtoold_config *cfg);
+int ethtoold_server_poll(struct ethtoold_server *srv, int timeout_ms);
+void ethtoold_server_free(struct ethtoold_server *srv);
+
 #endif /* ETHTOOL_INTERNAL_H__ */
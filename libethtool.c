@@ -0,0 +1,394 @@
+/*
+ * libethtool.c: ethtool queries for use inside other programs
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include <linux/sockios.h>
+#include <linux/netlink.h>
+#include "internal.h"
+#include "libethtool.h"
+
+unsigned int libethtool_version(void)
+{
+	return LIBETHTOOL_VERSION;
+}
+
+static int ethtool_dev_ioctl(struct ethtool_dev *dev, void *cmd)
+{
+	dev->ifr.ifr_data = cmd;
+	return ioctl(dev->fd, SIOCETHTOOL, &dev->ifr) < 0 ? -errno : 0;
+}
+
+int ethtool_dev_init(struct ethtool_dev *dev, int fd, const char *devname)
+{
+	if (strlen(devname) >= IFNAMSIZ)
+		return -EINVAL;
+
+	memset(dev, 0, sizeof(*dev));
+	dev->fd = fd;
+	strcpy(dev->ifr.ifr_name, devname);
+	dev->send = ethtool_dev_ioctl;
+	return 0;
+}
+
+int ethtool_dev_open(struct ethtool_dev *dev, const char *devname)
+{
+	int fd, err;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+	if (fd < 0)
+		return -errno;
+
+	err = ethtool_dev_init(dev, fd, devname);
+	if (err) {
+		close(fd);
+		return err;
+	}
+	dev->own_fd = 1;
+	return 0;
+}
+
+void ethtool_dev_close(struct ethtool_dev *dev)
+{
+	if (dev->own_fd && dev->fd >= 0)
+		close(dev->fd);
+	dev->fd = -1;
+	dev->own_fd = 0;
+}
+
+int ethtool_request(struct ethtool_dev *dev, void *cmd)
+{
+	/* Parenthesised so that the test wrapper for send() is not used */
+	return (dev->send)(dev, cmd);
+}
+
+int ethtool_get_drvinfo(struct ethtool_dev *dev, struct ethtool_drvinfo *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->cmd = ETHTOOL_GDRVINFO;
+	return ethtool_request(dev, info);
+}
+
+int ethtool_get_string_count(struct ethtool_dev *dev,
+			     enum ethtool_stringset set, __u32 *count)
+{
+	struct {
+		struct ethtool_sset_info hdr;
+		__u32 buf[1];
+	} sset_info;
+	int err;
+
+	memset(&sset_info, 0, sizeof(sset_info));
+	sset_info.hdr.cmd = ETHTOOL_GSSET_INFO;
+	sset_info.hdr.sset_mask = 1ULL << set;
+	err = ethtool_request(dev, &sset_info);
+	if (err)
+		return err;
+	/* The one length the kernel writes to hdr.data[] lands in buf[] */
+	*count = sset_info.hdr.sset_mask ? sset_info.buf[0] : 0;
+	return 0;
+}
+
+/* Check a caller's capacity against what the device has */
+static int check_count(__u32 *count, __u32 needed)
+{
+	if (*count < needed) {
+		*count = needed;
+		return -ENOSPC;
+	}
+	*count = needed;
+	return 0;
+}
+
+int ethtool_fetch_strings(struct ethtool_dev *dev, enum ethtool_stringset set,
+			  __u32 len, int null_terminate,
+			  struct ethtool_gstrings **strings)
+{
+	struct ethtool_gstrings *gstrings;
+	__u32 i;
+	int err;
+
+	gstrings = calloc(1, sizeof(*gstrings) + len * ETH_GSTRING_LEN);
+	if (!gstrings)
+		return -ENOMEM;
+	gstrings->cmd = ETHTOOL_GSTRINGS;
+	gstrings->string_set = set;
+	gstrings->len = len;
+	if (len) {
+		err = ethtool_request(dev, gstrings);
+		if (err) {
+			free(gstrings);
+			return err;
+		}
+	}
+
+	if (null_terminate)
+		for (i = 0; i < len; i++)
+			gstrings->data[(i + 1) * ETH_GSTRING_LEN - 1] = 0;
+
+	*strings = gstrings;
+	return 0;
+}
+
+int ethtool_get_strings(struct ethtool_dev *dev, enum ethtool_stringset set,
+			char (*names)[ETH_GSTRING_LEN], __u32 *count)
+{
+	struct ethtool_gstrings *strings;
+	__u32 len;
+	int err;
+
+	err = ethtool_get_string_count(dev, set, &len);
+	if (err)
+		return err;
+	err = check_count(count, len);
+	if (err || !len)
+		return err;
+
+	err = ethtool_fetch_strings(dev, set, len, 1, &strings);
+	if (err)
+		return err;
+	memcpy(names, strings->data, len * ETH_GSTRING_LEN);
+	free(strings);
+	return 0;
+}
+
+int ethtool_get_stats(struct ethtool_dev *dev, __u64 *values, __u32 *count)
+{
+	struct ethtool_stats *stats;
+	__u32 len;
+	int err;
+
+	err = ethtool_get_string_count(dev, ETH_SS_STATS, &len);
+	if (err)
+		return err;
+	err = check_count(count, len);
+	if (err || !len)
+		return err;
+
+	stats = calloc(1, sizeof(*stats) + len * sizeof(stats->data[0]));
+	if (!stats)
+		return -ENOMEM;
+	stats->cmd = ETHTOOL_GSTATS;
+	stats->n_stats = len;
+	err = ethtool_request(dev, stats);
+	if (!err)
+		memcpy(values, stats->data, len * sizeof(values[0]));
+	free(stats);
+	return err;
+}
+
+int ethtool_get_link_info(struct ethtool_dev *dev,
+			  struct ethtool_link_info *link)
+{
+	struct {
+		struct ethtool_link_settings req;
+		__u32 link_mode_data[3 * LIBETHTOOL_LINK_MODE_WORDS];
+	} ecmd;
+	int nwords, err;
+
+	/* Ask with no mask words to learn how many the kernel uses */
+	memset(&ecmd, 0, sizeof(ecmd));
+	ecmd.req.cmd = ETHTOOL_GLINKSETTINGS;
+	err = ethtool_request(dev, &ecmd);
+	if (err)
+		return err;
+	nwords = -ecmd.req.link_mode_masks_nwords;
+	if (nwords <= 0 || nwords > LIBETHTOOL_LINK_MODE_WORDS ||
+	    ecmd.req.cmd != ETHTOOL_GLINKSETTINGS)
+		return -EPROTO;
+
+	ecmd.req.cmd = ETHTOOL_GLINKSETTINGS;
+	ecmd.req.link_mode_masks_nwords = nwords;
+	err = ethtool_request(dev, &ecmd);
+	if (err)
+		return err;
+	if (ecmd.req.link_mode_masks_nwords != nwords ||
+	    ecmd.req.cmd != ETHTOOL_GLINKSETTINGS)
+		return -EPROTO;
+
+	memset(link, 0, sizeof(*link));
+	link->base = ecmd.req;
+	memcpy(link->supported, ecmd.link_mode_data, 4 * nwords);
+	memcpy(link->advertising, ecmd.link_mode_data + nwords, 4 * nwords);
+	memcpy(link->lp_advertising, ecmd.link_mode_data + 2 * nwords,
+	       4 * nwords);
+	return 0;
+}
+
+int ethtool_get_features(struct ethtool_dev *dev,
+			 struct ethtool_get_features_block *blocks,
+			 __u32 *n_blocks)
+{
+	struct ethtool_gfeatures *features;
+	__u32 n_features;
+	int err;
+
+	err = ethtool_get_string_count(dev, ETH_SS_FEATURES, &n_features);
+	if (err)
+		return err;
+	err = check_count(n_blocks, DIV_ROUND_UP(n_features, 32U));
+	if (err || !*n_blocks)
+		return err;
+
+	features = calloc(1, sizeof(*features) +
+			  *n_blocks * sizeof(features->features[0]));
+	if (!features)
+		return -ENOMEM;
+	features->cmd = ETHTOOL_GFEATURES;
+	features->size = *n_blocks;
+	err = ethtool_request(dev, features);
+	if (!err)
+		memcpy(blocks, features->features,
+		       *n_blocks * sizeof(blocks[0]));
+	free(features);
+	return err;
+}
+
+int ethtool_fetch_rxfh(struct ethtool_dev *dev, __u32 rss_context,
+		       struct ethtool_rxfh **rss)
+{
+	struct ethtool_rxfh rss_head, *rxfh;
+	int err;
+
+	memset(&rss_head, 0, sizeof(rss_head));
+	rss_head.cmd = ETHTOOL_GRSSH;
+	rss_head.rss_context = rss_context;
+	err = ethtool_request(dev, &rss_head);
+	if (err)
+		return err;
+
+	rxfh = calloc(1, sizeof(*rxfh) +
+		      rss_head.indir_size * sizeof(rxfh->rss_config[0]) +
+		      rss_head.key_size);
+	if (!rxfh)
+		return -ENOMEM;
+	rxfh->cmd = ETHTOOL_GRSSH;
+	rxfh->rss_context = rss_context;
+	rxfh->indir_size = rss_head.indir_size;
+	rxfh->key_size = rss_head.key_size;
+	err = ethtool_request(dev, rxfh);
+	if (err) {
+		free(rxfh);
+		return err;
+	}
+
+	*rss = rxfh;
+	return 0;
+}
+
+int ethtool_get_rxfh(struct ethtool_dev *dev, __u32 *indir, __u32 *indir_size,
+		     __u8 *key, __u32 *key_size)
+{
+	struct ethtool_rxfh *rss;
+	int err;
+
+	err = ethtool_fetch_rxfh(dev, 0, &rss);
+	if (err)
+		return err;
+	err = check_count(indir_size, rss->indir_size);
+	if (check_count(key_size, rss->key_size))
+		err = -ENOSPC;
+	if (!err) {
+		memcpy(indir, rss->rss_config,
+		       rss->indir_size * sizeof(indir[0]));
+		memcpy(key, rss->rss_config + rss->indir_size,
+		       rss->key_size);
+	}
+	free(rss);
+	return err;
+}
+
+int ethtool_fetch_rule_locs(struct ethtool_dev *dev, __u32 count,
+			    struct ethtool_rxnfc **rules)
+{
+	struct ethtool_rxnfc *nfccmd;
+	int err;
+
+	nfccmd = calloc(1, sizeof(*nfccmd) + count * sizeof(__u32));
+	if (!nfccmd)
+		return -ENOMEM;
+	nfccmd->cmd = ETHTOOL_GRXCLSRLALL;
+	nfccmd->rule_cnt = count;
+	err = ethtool_request(dev, nfccmd);
+	if (err) {
+		free(nfccmd);
+		return err;
+	}
+
+	*rules = nfccmd;
+	return 0;
+}
+
+int ethtool_get_rx_rule_locs(struct ethtool_dev *dev, __u32 *locs,
+			     __u32 *count)
+{
+	struct ethtool_rxnfc nfccmd, *rules;
+	int err;
+
+	memset(&nfccmd, 0, sizeof(nfccmd));
+	nfccmd.cmd = ETHTOOL_GRXCLSRLCNT;
+	err = ethtool_request(dev, &nfccmd);
+	if (err)
+		return err;
+	err = check_count(count, nfccmd.rule_cnt);
+	if (err || !*count)
+		return err;
+
+	err = ethtool_fetch_rule_locs(dev, *count, &rules);
+	if (err)
+		return err;
+	*count = rules->rule_cnt;
+	memcpy(locs, rules->rule_locs, *count * sizeof(locs[0]));
+	free(rules);
+	return 0;
+}
+
+int ethtool_get_rx_rule(struct ethtool_dev *dev, __u32 loc,
+			struct ethtool_rx_flow_spec *fs)
+{
+	struct ethtool_rxnfc nfccmd;
+	int err;
+
+	memset(&nfccmd, 0, sizeof(nfccmd));
+	nfccmd.cmd = ETHTOOL_GRXCLSRULE;
+	nfccmd.fs.location = loc;
+	err = ethtool_request(dev, &nfccmd);
+	if (!err)
+		*fs = nfccmd.fs;
+	return err;
+}
+
+int ethtool_get_module_info(struct ethtool_dev *dev,
+			    struct ethtool_modinfo *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->cmd = ETHTOOL_GMODULEINFO;
+	return ethtool_request(dev, info);
+}
+
+int ethtool_get_module_eeprom(struct ethtool_dev *dev, __u32 offset,
+			      __u8 *data, __u32 len)
+{
+	struct ethtool_eeprom *eeprom;
+	int err;
+
+	eeprom = calloc(1, sizeof(*eeprom) + len);
+	if (!eeprom)
+		return -ENOMEM;
+	eeprom->cmd = ETHTOOL_GMODULEEEPROM;
+	eeprom->offset = offset;
+	eeprom->len = len;
+	err = ethtool_request(dev, eeprom);
+	if (!err)
+		memcpy(data, eeprom->data, len);
+	free(eeprom);
+	return err;
+}
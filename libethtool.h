@@ -0,0 +1,107 @@
+/*
+ * libethtool.h: ethtool queries for use inside other programs
+ *
+ * The library sends the same requests as the ethtool command, but
+ * returns the results in buffers owned by the caller and never prints
+ * anything.  Every function returns 0 on success or a negative errno.
+ * Where a caller's buffer has a capacity, it is passed in through a
+ * count that is updated to what the device reported; if the buffer is
+ * too small, -ENOSPC is returned with the count set to what is needed.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#ifndef LIBETHTOOL_H__
+#define LIBETHTOOL_H__
+
+#include <net/if.h>
+#include <linux/types.h>
+#include <linux/ethtool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIBETHTOOL_VERSION_MAJOR	1
+#define LIBETHTOOL_VERSION_MINOR	1
+#define LIBETHTOOL_VERSION					\
+	(LIBETHTOOL_VERSION_MAJOR << 16 | LIBETHTOOL_VERSION_MINOR)
+
+/* Version of the library linked with; the major numbers must match */
+unsigned int libethtool_version(void);
+
+struct ethtool_dev {
+	int fd;
+	int own_fd;		/* fd was opened by ethtool_dev_open() */
+	struct ifreq ifr;
+	/* Sends one request and returns 0 or a negative errno.  This is
+	 * the SIOCETHTOOL ioctl unless the caller replaces it.
+	 */
+	int (*send)(struct ethtool_dev *dev, void *cmd);
+	void *priv;		/* for use by a replacement send() */
+};
+
+/* Open a control socket for the named device */
+int ethtool_dev_open(struct ethtool_dev *dev, const char *devname);
+/* Use a control socket the caller already has, e.g. for many devices */
+int ethtool_dev_init(struct ethtool_dev *dev, int fd, const char *devname);
+void ethtool_dev_close(struct ethtool_dev *dev);
+
+/* Send any ETHTOOL_* request structure */
+int ethtool_request(struct ethtool_dev *dev, void *cmd);
+
+int ethtool_get_drvinfo(struct ethtool_dev *dev,
+			struct ethtool_drvinfo *info);
+
+/* Names in a string set, each NUL-terminated */
+int ethtool_get_string_count(struct ethtool_dev *dev,
+			     enum ethtool_stringset set, __u32 *count);
+int ethtool_get_strings(struct ethtool_dev *dev, enum ethtool_stringset set,
+			char (*names)[ETH_GSTRING_LEN], __u32 *count);
+
+/* NIC statistics, in the order of the ETH_SS_STATS names */
+int ethtool_get_stats(struct ethtool_dev *dev, __u64 *values, __u32 *count);
+
+#define LIBETHTOOL_LINK_MODE_WORDS	127
+
+struct ethtool_link_info {
+	struct ethtool_link_settings base;
+	__u32 supported[LIBETHTOOL_LINK_MODE_WORDS];
+	__u32 advertising[LIBETHTOOL_LINK_MODE_WORDS];
+	__u32 lp_advertising[LIBETHTOOL_LINK_MODE_WORDS];
+};
+
+/* Link settings through ETHTOOL_GLINKSETTINGS; base.link_mode_masks_nwords
+ * gives the number of words used in each mask
+ */
+int ethtool_get_link_info(struct ethtool_dev *dev,
+			  struct ethtool_link_info *link);
+
+/* Feature state, one block per 32 ETH_SS_FEATURES names */
+int ethtool_get_features(struct ethtool_dev *dev,
+			 struct ethtool_get_features_block *blocks,
+			 __u32 *n_blocks);
+
+/* RSS indirection table and hash key of the default context */
+int ethtool_get_rxfh(struct ethtool_dev *dev, __u32 *indir, __u32 *indir_size,
+		     __u8 *key, __u32 *key_size);
+
+/* Locations of the receive classification rules, and one rule */
+int ethtool_get_rx_rule_locs(struct ethtool_dev *dev, __u32 *locs,
+			     __u32 *count);
+int ethtool_get_rx_rule(struct ethtool_dev *dev, __u32 loc,
+			struct ethtool_rx_flow_spec *fs);
+
+/* Plug-in module type and EEPROM contents */
+int ethtool_get_module_info(struct ethtool_dev *dev,
+			    struct ethtool_modinfo *info);
+int ethtool_get_module_eeprom(struct ethtool_dev *dev, __u32 offset,
+			      __u8 *data, __u32 len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBETHTOOL_H__ */
@@ -0,0 +1,716 @@
+/*
+ * netlink.c: Generic netlink transport for ethtool requests
+ *
+ * Kernels from 5.6 on answer many ethtool queries through the "ethtool"
+ * generic netlink family.  Netlink only saves system calls when many
+ * devices are queried, so only --batch and --monitor use it, and only
+ * for string sets: the first ETHTOOL_GSSET_INFO dumps the requested
+ * sets of every device, names included, and later ETHTOOL_GSSET_INFO
+ * and ETHTOOL_GSTRINGS requests for any device are answered from that
+ * dump without a system call.  A request that may change a device
+ * drops the dump.  Everything else, and everything on kernels without
+ * the family, goes to the SIOCETHTOOL ioctl.
+ *
+ * netlink_monitor_open() subscribes to the family's notifications for
+ * --monitor.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include "netlink.h"
+
+#define NL_MAX_STRSETS	64	/* bits in ethtool_sset_info::sset_mask */
+#define NL_ATTR_HEADER	1	/* every message's header attribute */
+#define NL_RBUF_SIZE	32768	/* the most the kernel puts in a dump part */
+
+enum nl_state {
+	NL_UNPROBED,
+	NL_AVAILABLE,
+	NL_UNAVAILABLE,
+};
+
+/* A string set from the last dump */
+struct nl_strset {
+	u32 id;
+	u32 count;
+	char *data;		/* count names of ETH_GSTRING_LEN */
+};
+
+/* A device in the last dump */
+struct nl_dev {
+	char devname[IFNAMSIZ];
+	struct nl_strset *sets;
+	unsigned int n_sets;
+};
+
+struct nl_context {
+	int fd;
+	enum nl_state state;
+	u16 family;
+	u32 monitor_group;	/* multicast group of notifications, or 0 */
+	u32 seq;
+	u32 unsupported;	/* bit per ETHTOOL_MSG_*_GET that failed */
+	u64 dumped_sets;	/* string sets in the last dump */
+	struct nl_dev *devs;
+	unsigned int n_devs;
+	char *rbuf;
+	size_t rbuf_size;
+};
+
+/* Message building */
+
+static void *nl_msg_room(struct nl_msg *msg, size_t len)
+{
+	size_t need = msg->len + NLMSG_ALIGN(len);
+	char *buf, *p;
+
+	if (msg->oom)
+		return NULL;
+	if (need > msg->size) {
+		msg->size = need > 2 * msg->size ? need : 2 * msg->size;
+		buf = realloc(msg->buf, msg->size);
+		if (!buf) {
+			msg->oom = 1;
+			return NULL;
+		}
+		msg->buf = buf;
+	}
+	p = msg->buf + msg->len;
+	memset(p, 0, NLMSG_ALIGN(len));
+	msg->len = need;
+	((struct nlmsghdr *)msg->buf)->nlmsg_len = msg->len;
+	return p;
+}
+
+/* Start a generic netlink message, reusing the buffer of any earlier one */
+void nl_msg_genl(struct nl_msg *msg, u16 type, u16 flags, u8 cmd,
+		 u8 version)
+{
+	struct genlmsghdr *genl;
+	struct nlmsghdr *nlh;
+
+	msg->len = 0;
+	nlh = nl_msg_room(msg, NLMSG_HDRLEN);
+	if (!nlh)
+		return;
+	nlh->nlmsg_type = type;
+	nlh->nlmsg_flags = flags;
+	genl = nl_msg_room(msg, GENL_HDRLEN);
+	if (!genl)
+		return;
+	genl->cmd = cmd;
+	genl->version = version;
+}
+
+void nl_msg_free(struct nl_msg *msg)
+{
+	free(msg->buf);
+	memset(msg, 0, sizeof(*msg));
+}
+
+void nl_put(struct nl_msg *msg, u16 type, const void *data, size_t len)
+{
+	struct nlattr *nla = nl_msg_room(msg, NLA_HDRLEN + len);
+
+	if (!nla)
+		return;
+	nla->nla_type = type;
+	nla->nla_len = NLA_HDRLEN + len;
+	memcpy((char *)nla + NLA_HDRLEN, data, len);
+}
+
+void nl_put_u8(struct nl_msg *msg, u16 type, u8 value)
+{
+	nl_put(msg, type, &value, sizeof(value));
+}
+
+void nl_put_u16(struct nl_msg *msg, u16 type, u16 value)
+{
+	nl_put(msg, type, &value, sizeof(value));
+}
+
+void nl_put_u32(struct nl_msg *msg, u16 type, u32 value)
+{
+	nl_put(msg, type, &value, sizeof(value));
+}
+
+void nl_put_str(struct nl_msg *msg, u16 type, const char *str)
+{
+	nl_put(msg, type, str, strlen(str) + 1);
+}
+
+size_t nl_nest_start(struct nl_msg *msg, u16 type)
+{
+	size_t nest = msg->len;
+	struct nlattr *nla = nl_msg_room(msg, NLA_HDRLEN);
+
+	if (nla)
+		nla->nla_type = type | NLA_F_NESTED;
+	return nest;
+}
+
+void nl_nest_end(struct nl_msg *msg, size_t nest)
+{
+	if (!msg->oom)
+		((struct nlattr *)(msg->buf + nest))->nla_len = msg->len - nest;
+}
+
+/* Message parsing */
+
+/* Index attributes by type; a later duplicate replaces an earlier one */
+void nl_parse(const void *data, int len, const struct nlattr **tb,
+	      unsigned int max)
+{
+	const struct nlattr *nla;
+	unsigned int type;
+	int rem;
+
+	memset(tb, 0, (max + 1) * sizeof(tb[0]));
+	nl_for_each_attr(nla, data, len, rem) {
+		type = nla->nla_type & NLA_TYPE_MASK;
+		if (type <= max)
+			tb[type] = nla;
+	}
+}
+
+void nl_parse_nested(const struct nlattr *nest, const struct nlattr **tb,
+		     unsigned int max)
+{
+	nl_parse(nl_attr_data(nest), nl_attr_len(nest), tb, max);
+}
+
+u8 nl_get_u8(const struct nlattr *nla)
+{
+	return nl_attr_len(nla) >= 1 ? *(const u8 *)nl_attr_data(nla) : 0;
+}
+
+u16 nl_get_u16(const struct nlattr *nla)
+{
+	u16 value = 0;
+
+	if (nl_attr_len(nla) >= (int)sizeof(value))
+		memcpy(&value, nl_attr_data(nla), sizeof(value));
+	return value;
+}
+
+u32 nl_get_u32(const struct nlattr *nla)
+{
+	u32 value = 0;
+
+	if (nl_attr_len(nla) >= (int)sizeof(value))
+		memcpy(&value, nl_attr_data(nla), sizeof(value));
+	return value;
+}
+
+/* Requests */
+
+/*
+ * Receive one datagram.  Returns its length or a negative errno, and
+ * -EMSGSIZE if it did not fit: the buffer is then grown to fit it, but
+ * the datagram is gone, so the request must be sent again.
+ */
+static ssize_t nl_recv(struct nl_context *nl, int flags)
+{
+	ssize_t n;
+	char *buf;
+
+	do
+		n = recv(nl->fd, nl->rbuf, nl->rbuf_size, flags | MSG_TRUNC);
+	while (n < 0 && errno == EINTR);
+	if (n < 0)
+		return -errno;
+	if ((size_t)n > nl->rbuf_size) {
+		buf = realloc(nl->rbuf, n);
+		if (!buf)
+			return -ENOMEM;
+		nl->rbuf = buf;
+		nl->rbuf_size = n;
+		return -EMSGSIZE;
+	}
+	return n;
+}
+
+static int nl_send(struct nl_context *nl, struct nl_msg *msg)
+{
+	struct nlmsghdr *nlh = (struct nlmsghdr *)msg->buf;
+
+	if (msg->oom)
+		return -ENOMEM;
+	nlh->nlmsg_seq = ++nl->seq;
+	return send(nl->fd, msg->buf, msg->len, 0) < 0 ? -errno : 0;
+}
+
+/* The error in an NLMSG_ERROR message, which is 0 for an acknowledgement */
+static int nl_msg_error(const struct nlmsghdr *nlh)
+{
+	const struct nlmsgerr *nlerr = NLMSG_DATA(nlh);
+
+	if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*nlerr)))
+		return -EPROTO;
+	return nlerr->error ? nlerr->error : -EPROTO;
+}
+
+/*
+ * Send @msg and receive its reply.  On success, *attrs and *len give
+ * the attributes following the generic netlink header.  Returns 0 or a
+ * negative errno, including errors reported by the kernel.
+ */
+static int nl_transact(struct nl_context *nl, struct nl_msg *msg,
+		       const void **attrs, int *len)
+{
+	struct nlmsghdr *nlh;
+	ssize_t n;
+	int err;
+
+resend:
+	err = nl_send(nl, msg);
+	if (err)
+		return err;
+
+	for (;;) {
+		n = nl_recv(nl, 0);
+		if (n == -EMSGSIZE)
+			goto resend;
+		if (n < 0)
+			return n;
+
+		nlh = (struct nlmsghdr *)nl->rbuf;
+		if (!NLMSG_OK(nlh, n))
+			return -EPROTO;
+		/* A late reply to an earlier request */
+		if (nlh->nlmsg_seq != nl->seq)
+			continue;
+		if (nlh->nlmsg_type == NLMSG_ERROR)
+			return nl_msg_error(nlh);
+		if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN))
+			return -EPROTO;
+		*attrs = (char *)NLMSG_DATA(nlh) + GENL_HDRLEN;
+		*len = nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+		return 0;
+	}
+}
+
+/*
+ * Send the dump request @msg and pass the attributes of each message in
+ * the reply to @cb, which may stop the dump with an error.  A dump part
+ * too big for the buffer makes the dump start over, after the rest of
+ * it, which the kernel has already queued, has been read.
+ */
+static int nl_dump(struct nl_context *nl, struct nl_msg *msg,
+		   int (*cb)(struct nl_context *nl, const void *attrs, int len))
+{
+	struct nlmsghdr *nlh;
+	ssize_t n;
+	int err;
+
+resend:
+	err = nl_send(nl, msg);
+	if (err)
+		return err;
+
+	for (;;) {
+		n = nl_recv(nl, 0);
+		if (n == -EMSGSIZE) {
+			while (nl_recv(nl, MSG_DONTWAIT) != -EAGAIN)
+				;
+			goto resend;
+		}
+		if (n < 0)
+			return n;
+
+		for (nlh = (struct nlmsghdr *)nl->rbuf; NLMSG_OK(nlh, n);
+		     nlh = NLMSG_NEXT(nlh, n)) {
+			if (nlh->nlmsg_seq != nl->seq)
+				continue;
+			if (nlh->nlmsg_type == NLMSG_DONE)
+				return 0;
+			if (nlh->nlmsg_type == NLMSG_ERROR)
+				return nl_msg_error(nlh);
+			if (nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN))
+				return -EPROTO;
+			err = cb(nl, (char *)NLMSG_DATA(nlh) + GENL_HDRLEN,
+				 nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+			if (err)
+				return err;
+		}
+	}
+}
+
+/* Note the ID of the notification group among the family's groups */
+static void nl_find_monitor_group(struct nl_context *nl,
+				  const struct nlattr *groups)
+{
+	const struct nlattr *tb[CTRL_ATTR_MCAST_GRP_ID + 1];
+	const struct nlattr *nla;
+	int rem;
+
+	nl_for_each_attr(nla, nl_attr_data(groups), nl_attr_len(groups), rem) {
+		nl_parse_nested(nla, tb, CTRL_ATTR_MCAST_GRP_ID);
+		if (!tb[CTRL_ATTR_MCAST_GRP_NAME] || !tb[CTRL_ATTR_MCAST_GRP_ID])
+			continue;
+		if (strncmp(nl_attr_data(tb[CTRL_ATTR_MCAST_GRP_NAME]),
+			    ETHTOOL_MCGRP_MONITOR_NAME,
+			    nl_attr_len(tb[CTRL_ATTR_MCAST_GRP_NAME])))
+			continue;
+		nl->monitor_group = nl_get_u32(tb[CTRL_ATTR_MCAST_GRP_ID]);
+	}
+}
+
+/* Open the socket and look up the ethtool family */
+static int nl_open(struct nl_context *nl)
+{
+	const struct nlattr *tb[CTRL_ATTR_MCAST_GROUPS + 1];
+	struct nl_msg msg = {};
+	const void *attrs = NULL;
+	int len = 0, err;
+
+	nl->rbuf = malloc(NL_RBUF_SIZE);
+	if (!nl->rbuf)
+		return -ENOMEM;
+	nl->rbuf_size = NL_RBUF_SIZE;
+	nl->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC);
+	if (nl->fd < 0)
+		return -errno;
+
+	nl_msg_genl(&msg, GENL_ID_CTRL, NLM_F_REQUEST, CTRL_CMD_GETFAMILY, 1);
+	nl_put_str(&msg, CTRL_ATTR_FAMILY_NAME, ETHTOOL_GENL_NAME);
+	err = nl_transact(nl, &msg, &attrs, &len);
+	nl_msg_free(&msg);
+	if (err)
+		return err;
+
+	nl_parse(attrs, len, tb, CTRL_ATTR_MCAST_GROUPS);
+	if (!tb[CTRL_ATTR_FAMILY_ID])
+		return -EPROTO;
+	nl->family = nl_get_u16(tb[CTRL_ATTR_FAMILY_ID]);
+	if (tb[CTRL_ATTR_MCAST_GROUPS])
+		nl_find_monitor_group(nl, tb[CTRL_ATTR_MCAST_GROUPS]);
+	return 0;
+}
+
+/* String sets */
+
+static void nl_forget_strsets(struct nl_context *nl)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < nl->n_devs; i++) {
+		for (j = 0; j < nl->devs[i].n_sets; j++)
+			free(nl->devs[i].sets[j].data);
+		free(nl->devs[i].sets);
+	}
+	free(nl->devs);
+	nl->devs = NULL;
+	nl->n_devs = 0;
+	nl->dumped_sets = 0;
+}
+
+static struct nl_dev *nl_find_dev(struct nl_context *nl, const char *devname)
+{
+	unsigned int i;
+
+	for (i = 0; i < nl->n_devs; i++)
+		if (!strcmp(nl->devs[i].devname, devname))
+			return &nl->devs[i];
+	return NULL;
+}
+
+static int nl_store_strset(struct nl_dev *dev, const struct nlattr *nest)
+{
+	const struct nlattr *tb[ETHTOOL_A_STRINGSET_MAX + 1];
+	const struct nlattr *str[ETHTOOL_A_STRING_MAX + 1];
+	const struct nlattr *nla;
+	struct nl_strset *set;
+	u32 index;
+	int rem, len;
+
+	nl_parse_nested(nest, tb, ETHTOOL_A_STRINGSET_MAX);
+	if (!tb[ETHTOOL_A_STRINGSET_ID] || !tb[ETHTOOL_A_STRINGSET_COUNT] ||
+	    dev->n_sets == NL_MAX_STRSETS)
+		return -EPROTO;
+
+	set = &dev->sets[dev->n_sets];
+	set->id = nl_get_u32(tb[ETHTOOL_A_STRINGSET_ID]);
+	set->count = nl_get_u32(tb[ETHTOOL_A_STRINGSET_COUNT]);
+	set->data = calloc(set->count ? set->count : 1, ETH_GSTRING_LEN);
+	if (!set->data)
+		return -ENOMEM;
+	dev->n_sets++;
+
+	if (!tb[ETHTOOL_A_STRINGSET_STRINGS])
+		return 0;
+	nl_for_each_attr(nla, nl_attr_data(tb[ETHTOOL_A_STRINGSET_STRINGS]),
+			 nl_attr_len(tb[ETHTOOL_A_STRINGSET_STRINGS]), rem) {
+		nl_parse_nested(nla, str, ETHTOOL_A_STRING_MAX);
+		if (!str[ETHTOOL_A_STRING_INDEX] ||
+		    !str[ETHTOOL_A_STRING_VALUE])
+			continue;
+		index = nl_get_u32(str[ETHTOOL_A_STRING_INDEX]);
+		len = nl_attr_len(str[ETHTOOL_A_STRING_VALUE]);
+		if (index >= set->count || len <= 0)
+			continue;
+		memcpy(set->data + index * ETH_GSTRING_LEN,
+		       nl_attr_data(str[ETHTOOL_A_STRING_VALUE]),
+		       len < ETH_GSTRING_LEN ? len : ETH_GSTRING_LEN - 1);
+	}
+	return 0;
+}
+
+/* Keep the string sets of the device in one message of the dump */
+static int nl_store_dev(struct nl_context *nl, const void *attrs, int len)
+{
+	const struct nlattr *hdr[ETHTOOL_A_HEADER_MAX + 1];
+	const struct nlattr *tb[ETHTOOL_A_STRSET_MAX + 1];
+	const struct nlattr *nla, *name;
+	struct nl_dev *dev;
+	int rem, err;
+
+	nl_parse(attrs, len, tb, ETHTOOL_A_STRSET_MAX);
+	if (!tb[ETHTOOL_A_STRSET_HEADER])
+		return -EPROTO;
+	nl_parse_nested(tb[ETHTOOL_A_STRSET_HEADER], hdr, ETHTOOL_A_HEADER_MAX);
+	name = hdr[ETHTOOL_A_HEADER_DEV_NAME];
+	if (!name || nl_attr_len(name) <= 0 || nl_attr_len(name) > IFNAMSIZ)
+		return -EPROTO;
+
+	dev = realloc(nl->devs, (nl->n_devs + 1) * sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+	nl->devs = dev;
+	dev = &nl->devs[nl->n_devs];
+	memset(dev, 0, sizeof(*dev));
+	dev->sets = calloc(NL_MAX_STRSETS, sizeof(dev->sets[0]));
+	if (!dev->sets)
+		return -ENOMEM;
+	memcpy(dev->devname, nl_attr_data(name), nl_attr_len(name));
+	dev->devname[IFNAMSIZ - 1] = 0;
+	nl->n_devs++;
+
+	if (!tb[ETHTOOL_A_STRSET_STRINGSETS])
+		return 0;
+	nl_for_each_attr(nla, nl_attr_data(tb[ETHTOOL_A_STRSET_STRINGSETS]),
+			 nl_attr_len(tb[ETHTOOL_A_STRSET_STRINGSETS]), rem) {
+		err = nl_store_strset(dev, nla);
+		if (err)
+			return err;
+	}
+	return 0;
+}
+
+/* Dump string sets @mask of every device, replacing the last dump */
+static int nl_dump_strsets(struct nl_context *nl, u64 mask)
+{
+	struct nl_msg msg = {};
+	size_t sets, set;
+	unsigned int i;
+	int err;
+
+	nl_forget_strsets(nl);
+	nl_msg_genl(&msg, nl->family, NLM_F_REQUEST | NLM_F_DUMP,
+		    ETHTOOL_MSG_STRSET_GET, ETHTOOL_GENL_VERSION);
+	sets = nl_nest_start(&msg, ETHTOOL_A_STRSET_STRINGSETS);
+	for (i = 0; i < NL_MAX_STRSETS; i++) {
+		if (!(mask & (1ULL << i)))
+			continue;
+		set = nl_nest_start(&msg, ETHTOOL_A_STRINGSETS_STRINGSET);
+		nl_put_u32(&msg, ETHTOOL_A_STRINGSET_ID, i);
+		nl_nest_end(&msg, set);
+	}
+	nl_nest_end(&msg, sets);
+	err = nl_dump(nl, &msg, nl_store_dev);
+	nl_msg_free(&msg);
+	if (err) {
+		nl_forget_strsets(nl);
+		return err;
+	}
+	nl->dumped_sets = mask;
+	return 0;
+}
+
+/*
+ * Answer ETHTOOL_GSSET_INFO from the dump, dumping the sets first if
+ * they were not in it.  Returns 1 if the device was not in the dump,
+ * for the ioctl to find out why.
+ */
+static int nl_gsset_info(struct cmd_context *ctx,
+			 struct ethtool_sset_info *info)
+{
+	struct nl_context *nl = ctx->nl;
+	struct nl_dev *dev;
+	unsigned int i, j, n;
+	u64 mask;
+	int err;
+
+	if ((nl->dumped_sets & info->sset_mask) != info->sset_mask) {
+		err = nl_dump_strsets(nl, nl->dumped_sets | info->sset_mask);
+		if (err)
+			return err;
+	}
+	dev = nl_find_dev(nl, ctx->devname);
+	if (!dev)
+		return 1;
+
+	/* A set the device does not have comes back empty */
+	mask = 0;
+	n = 0;
+	for (i = 0; i < NL_MAX_STRSETS; i++) {
+		if (!(info->sset_mask & (1ULL << i)))
+			continue;
+		for (j = 0; j < dev->n_sets; j++) {
+			if (dev->sets[j].id == i && dev->sets[j].count) {
+				mask |= 1ULL << i;
+				info->data[n++] = dev->sets[j].count;
+			}
+		}
+	}
+	info->sset_mask = mask;
+	return 0;
+}
+
+/* Answer ETHTOOL_GSTRINGS from the dump, if we can */
+static bool nl_gstrings(struct cmd_context *ctx,
+			struct ethtool_gstrings *strings)
+{
+	struct nl_dev *dev = nl_find_dev(ctx->nl, ctx->devname);
+	struct nl_strset *set;
+	u32 len;
+
+	if (!dev)
+		return false;
+	for (set = dev->sets; set < dev->sets + dev->n_sets; set++) {
+		if (set->id != strings->string_set)
+			continue;
+		len = strings->len < set->count ? strings->len : set->count;
+		memcpy(strings->data, set->data, len * ETH_GSTRING_LEN);
+		strings->len = len;
+		return true;
+	}
+	return false;
+}
+
+struct nl_context *netlink_new(void)
+{
+	struct nl_context *nl = calloc(1, sizeof(*nl));
+
+	if (nl)
+		nl->fd = -1;
+	return nl;
+}
+
+void netlink_free(struct nl_context *nl)
+{
+	if (!nl)
+		return;
+	nl_forget_strsets(nl);
+	if (nl->fd >= 0)
+		close(nl->fd);
+	free(nl->rbuf);
+	free(nl);
+}
+
+/*
+ * Offer a request to the netlink transport.  Returns true if it was
+ * handled, with *ret set as ioctl() would set it, or false if it must
+ * go to the ioctl.
+ */
+bool netlink_send(struct cmd_context *ctx, void *cmd, int *ret)
+{
+	struct nl_context *nl = ctx->nl;
+	int err;
+
+	if (!nl || !ctx->devname)
+		return false;
+
+	switch (*(u32 *)cmd) {
+	case ETHTOOL_GSTRINGS:
+		if (!nl_gstrings(ctx, cmd))
+			return false;
+		*ret = 0;
+		return true;
+	case ETHTOOL_GSSET_INFO:
+		break;
+	default:
+		/* The names, or how many there are, may change with it */
+		if (!request_is_read(*(u32 *)cmd))
+			nl_forget_strsets(nl);
+		return false;
+	}
+	if (nl->state == NL_UNAVAILABLE ||
+	    nl->unsupported & (1U << ETHTOOL_MSG_STRSET_GET))
+		return false;
+
+	if (nl->state == NL_UNPROBED) {
+		if (nl_open(nl)) {
+			nl->state = NL_UNAVAILABLE;
+			return false;
+		}
+		nl->state = NL_AVAILABLE;
+	}
+
+	err = nl_gsset_info(ctx, cmd);
+	if (err == -EOPNOTSUPP)
+		nl->unsupported |= 1U << ETHTOOL_MSG_STRSET_GET;
+	if (err == -EOPNOTSUPP || err == 1)
+		return false;
+	if (err) {
+		errno = -err;
+		*ret = -1;
+	} else {
+		*ret = 0;
+	}
+	return true;
+}
+
+/*
+ * Open a socket receiving the ethtool family's notifications.  Returns
+ * the socket, or a negative errno if the kernel sends none.
+ */
+int netlink_monitor_open(void)
+{
+	struct nl_context *nl = netlink_new();
+	int fd, err;
+
+	if (!nl)
+		return -ENOMEM;
+	err = nl_open(nl);
+	if (!err && !nl->monitor_group)
+		err = -EOPNOTSUPP;
+	if (!err && setsockopt(nl->fd, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP,
+			       &nl->monitor_group, sizeof(nl->monitor_group)))
+		err = -errno;
+	fd = nl->fd;
+	if (!err)
+		nl->fd = -1;
+	netlink_free(nl);
+	return err ? err : fd;
+}
+
+/*
+ * Find the device a notification is about.  Returns its
+ * ETHTOOL_MSG_*_NTF type with *ifindex set, or 0 if @nlh is not a
+ * notification naming a device.
+ */
+u8 netlink_ntf_parse(const struct nlmsghdr *nlh, int *ifindex)
+{
+	const struct nlattr *hdr[ETHTOOL_A_HEADER_MAX + 1];
+	const struct nlattr *tb[NL_ATTR_HEADER + 1];
+	const struct genlmsghdr *genl = NLMSG_DATA(nlh);
+
+	if (nlh->nlmsg_type < NLMSG_MIN_TYPE ||
+	    nlh->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN))
+		return 0;
+	nl_parse((const char *)genl + GENL_HDRLEN,
+		 nlh->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), tb, NL_ATTR_HEADER);
+	if (!tb[NL_ATTR_HEADER])
+		return 0;
+	nl_parse_nested(tb[NL_ATTR_HEADER], hdr, ETHTOOL_A_HEADER_MAX);
+	if (!hdr[ETHTOOL_A_HEADER_DEV_INDEX])
+		return 0;
+	*ifindex = nl_get_u32(hdr[ETHTOOL_A_HEADER_DEV_INDEX]);
+	return genl->cmd;
+}
@@ -0,0 +1,61 @@
+/*
+ * netlink.h: Generic netlink transport for ethtool requests
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#ifndef ETHTOOL_NETLINK_H__
+#define ETHTOOL_NETLINK_H__
+
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include "internal.h"
+#include "ethtool_netlink-copy.h"
+
+/* A message being built; after an allocation failure, oom is set and
+ * further additions are ignored
+ */
+struct nl_msg {
+	char *buf;
+	size_t len, size;
+	int oom;
+};
+
+void nl_msg_genl(struct nl_msg *msg, u16 type, u16 flags, u8 cmd,
+		 u8 version);
+void nl_msg_free(struct nl_msg *msg);
+void nl_put(struct nl_msg *msg, u16 type, const void *data, size_t len);
+void nl_put_u8(struct nl_msg *msg, u16 type, u8 value);
+void nl_put_u16(struct nl_msg *msg, u16 type, u16 value);
+void nl_put_u32(struct nl_msg *msg, u16 type, u32 value);
+void nl_put_str(struct nl_msg *msg, u16 type, const char *str);
+size_t nl_nest_start(struct nl_msg *msg, u16 type);
+void nl_nest_end(struct nl_msg *msg, size_t nest);
+
+#define nl_attr_data(nla)	((const void *)((const char *)(nla) + NLA_HDRLEN))
+#define nl_attr_len(nla)	((int)(nla)->nla_len - NLA_HDRLEN)
+
+/* Walk the attributes in @len bytes at @data, stopping at a malformed one */
+#define nl_for_each_attr(nla, data, len, rem)				\
+	for ((nla) = (const struct nlattr *)(data), (rem) = (len);	\
+	     (rem) >= NLA_HDRLEN && (nla)->nla_len >= NLA_HDRLEN &&	\
+	     (nla)->nla_len <= (rem);					\
+	     (rem) -= NLA_ALIGN((nla)->nla_len),			\
+	     (nla) = (const struct nlattr *)((const char *)(nla) +	\
+					     NLA_ALIGN((nla)->nla_len)))
+
+void nl_parse(const void *data, int len, const struct nlattr **tb,
+	      unsigned int max);
+void nl_parse_nested(const struct nlattr *nest, const struct nlattr **tb,
+		     unsigned int max);
+u8 nl_get_u8(const struct nlattr *nla);
+u16 nl_get_u16(const struct nlattr *nla);
+u32 nl_get_u32(const struct nlattr *nla);
+
+/* Notifications */
+int netlink_monitor_open(void);
+u8 netlink_ntf_parse(const struct nlmsghdr *nlh, int *ifindex);
+
+#endif /* ETHTOOL_NETLINK_H__ */
@@ -602,18 +602,51 @@ static void sff8636_show_revision_compliance(const __u8 *id)
  */
 #define SFF8636_OFFSET_TO_TEMP(offset) ((__s16)OFFSET_TO_U16(offset))
 
-static void sff8636_dom_parse(const __u8 *id, struct sff_diags *sd)
-{
-	int i = 0;
+static const struct sff_lane_layout sff8636_lane_layout = {
+	.n_lanes = SFF8636_LANE_NUM,
+	.stride = 2,
+	.bias_cur_offset = SFF8636_TX_BIAS_1_OFFSET,
+	.tx_power_offset = SFF8636_TX_PWR_1_OFFSET,
+	.rx_power_offset = SFF8636_RX_PWR_1_OFFSET,
+	.aw_format = SFF_LANE_AW_NIBBLE,
+	.bias_cur_aw = {
+		SFF8636_TX_BIAS_12_AW_OFFSET, SFF8636_TX_BIAS_12_AW_OFFSET,
+		SFF8636_TX_BIAS_12_AW_OFFSET, SFF8636_TX_BIAS_12_AW_OFFSET,
+	},
+	.tx_power_aw = {
+		SFF8636_TX_PWR_12_AW_OFFSET, SFF8636_TX_PWR_12_AW_OFFSET,
+		SFF8636_TX_PWR_12_AW_OFFSET, SFF8636_TX_PWR_12_AW_OFFSET,
+	},
+	.rx_power_aw = {
+		SFF8636_RX_PWR_12_AW_OFFSET, SFF8636_RX_PWR_12_AW_OFFSET,
+		SFF8636_RX_PWR_12_AW_OFFSET, SFF8636_RX_PWR_12_AW_OFFSET,
+	},
+	.rx_los = { SFF8636_LOS_AW_OFFSET, 0 },
+	.tx_los = { SFF8636_LOS_AW_OFFSET, 4 },
+	.tx_fault = { SFF8636_FAULT_AW_OFFSET, 0 },
+	.rx_lol = { SFF8636_LOL_AW_OFFSET, 0 },
+	.tx_lol = { SFF8636_LOL_AW_OFFSET, 4 },
+};
 
-	/* Monitoring Thresholds for Alarms and Warnings */
+static void sff8636_dom_parse(const __u8 *id, __u32 eeprom_len,
+			      struct sff_diags *sd)
+{
 	sd->sfp_voltage[MCURR] = OFFSET_TO_U16(SFF8636_VCC_CURR);
+	sd->sfp_temp[MCURR] = SFF8636_OFFSET_TO_TEMP(SFF8636_TEMP_CURR);
+
+	sff_lanes_parse(id, &sff8636_lane_layout, sd);
+
+	/* Monitoring Thresholds for Alarms and Warnings live in page 03h,
+	 * which is only present in the 640 byte image
+	 */
+	if (eeprom_len < ETH_MODULE_SFF_8636_MAX_LEN)
+		return;
+
 	sd->sfp_voltage[HALRM] = OFFSET_TO_U16(SFF8636_VCC_HALRM);
 	sd->sfp_voltage[LALRM] = OFFSET_TO_U16(SFF8636_VCC_LALRM);
 	sd->sfp_voltage[HWARN] = OFFSET_TO_U16(SFF8636_VCC_HWARN);
 	sd->sfp_voltage[LWARN] = OFFSET_TO_U16(SFF8636_VCC_LWARN);
 
-	sd->sfp_temp[MCURR] = SFF8636_OFFSET_TO_TEMP(SFF8636_TEMP_CURR);
 	sd->sfp_temp[HALRM] = SFF8636_OFFSET_TO_TEMP(SFF8636_TEMP_HALRM);
 	sd->sfp_temp[LALRM] = SFF8636_OFFSET_TO_TEMP(SFF8636_TEMP_LALRM);
 	sd->sfp_temp[HWARN] = SFF8636_OFFSET_TO_TEMP(SFF8636_TEMP_HWARN);
@@ -633,40 +666,6 @@ static void sff8636_dom_parse(const __u8 *id, struct sff_diags *sd)
 	sd->rx_power[LALRM] = OFFSET_TO_U16(SFF8636_RX_PWR_LALRM);
 	sd->rx_power[HWARN] = OFFSET_TO_U16(SFF8636_RX_PWR_HWARN);
 	sd->rx_power[LWARN] = OFFSET_TO_U16(SFF8636_RX_PWR_LWARN);
-
-
-	/* Channel Specific Data */
-	for (i = 0; i < MAX_CHANNEL_NUM; i++) {
-		u8 rx_power_offset, tx_bias_offset;
-		u8 tx_power_offset;
-
-		switch (i) {
-		case 0:
-			rx_power_offset = SFF8636_RX_PWR_1_OFFSET;
-			tx_power_offset = SFF8636_TX_PWR_1_OFFSET;
-			tx_bias_offset = SFF8636_TX_BIAS_1_OFFSET;
-			break;
-		case 1:
-			rx_power_offset = SFF8636_RX_PWR_2_OFFSET;
-			tx_power_offset = SFF8636_TX_PWR_2_OFFSET;
-			tx_bias_offset = SFF8636_TX_BIAS_2_OFFSET;
-			break;
-		case 2:
-			rx_power_offset = SFF8636_RX_PWR_3_OFFSET;
-			tx_power_offset = SFF8636_TX_PWR_3_OFFSET;
-			tx_bias_offset = SFF8636_TX_BIAS_3_OFFSET;
-			break;
-		case 3:
-			rx_power_offset = SFF8636_RX_PWR_4_OFFSET;
-			tx_power_offset = SFF8636_TX_PWR_4_OFFSET;
-			tx_bias_offset = SFF8636_TX_BIAS_4_OFFSET;
-			break;
-		}
-		sd->scd[i].bias_cur = OFFSET_TO_U16(tx_bias_offset);
-		sd->scd[i].rx_power = OFFSET_TO_U16(rx_power_offset);
-		sd->scd[i].tx_power = OFFSET_TO_U16(tx_power_offset);
-	}
-
 }
 
 static void sff8636_show_dom(const __u8 *id, __u32 eeprom_len)
@@ -696,7 +695,7 @@ static void sff8636_show_dom(const __u8 *id, __u32 eeprom_len)
 	sd.tx_power_type = id[SFF8636_DIAG_TYPE_OFFSET] &
 						SFF8636_RX_PWR_TYPE_MASK;
 
-	sff8636_dom_parse(id, &sd);
+	sff8636_dom_parse(id, eeprom_len, &sd);
 
 	PRINT_TEMP("Module temperature", sd.sfp_temp[MCURR]);
 	PRINT_VCC("Module voltage", sd.sfp_voltage[MCURR]);
@@ -713,13 +712,13 @@ static void sff8636_show_dom(const __u8 *id, __u32 eeprom_len)
 	printf("\t%-41s : %s\n", "Alarm/warning flags implemented",
 		(sd.supports_alarms ? "Yes" : "No"));
 
-	for (i = 0; i < MAX_CHANNEL_NUM; i++) {
+	for (i = 0; i < sd.n_lanes; i++) {
 		snprintf(power_string, MAX_DESC_SIZE, "%s (Channel %d)",
 					"Laser tx bias current", i+1);
 		PRINT_BIAS(power_string, sd.scd[i].bias_cur);
 	}
 
-	for (i = 0; i < MAX_CHANNEL_NUM; i++) {
+	for (i = 0; i < sd.n_lanes; i++) {
 		snprintf(power_string, MAX_DESC_SIZE, "%s (Channel %d)",
 					"Transmit avg optical power", i+1);
 		PRINT_xX_PWR(power_string, sd.scd[i].tx_power);
@@ -730,12 +729,14 @@ static void sff8636_show_dom(const __u8 *id, __u32 eeprom_len)
 	else
 		rx_power_string = "Rcvr signal avg optical power";
 
-	for (i = 0; i < MAX_CHANNEL_NUM; i++) {
+	for (i = 0; i < sd.n_lanes; i++) {
 		snprintf(power_string, MAX_DESC_SIZE, "%s(Channel %d)",
 					rx_power_string, i+1);
 		PRINT_xX_PWR(power_string, sd.scd[i].rx_power);
 	}
 
+	sff_show_lane_flags(&sd);
+
 	if (sd.supports_alarms) {
 		for (i = 0; sff8636_aw_flags[i].str; ++i) {
 			printf("\t%-41s : %s\n", sff8636_aw_flags[i].str,
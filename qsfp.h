@@ -63,6 +63,16 @@
 #define	 SFF8636_TX2_FAULT_AW	(1 << 1)
 #define	 SFF8636_TX1_FAULT_AW	(1 << 0)
 
+#define	SFF8636_LOL_AW_OFFSET	0x05
+#define	 SFF8636_TX4_LOL_AW		(1 << 7)
+#define	 SFF8636_TX3_LOL_AW		(1 << 6)
+#define	 SFF8636_TX2_LOL_AW		(1 << 5)
+#define	 SFF8636_TX1_LOL_AW		(1 << 4)
+#define	 SFF8636_RX4_LOL_AW		(1 << 3)
+#define	 SFF8636_RX3_LOL_AW		(1 << 2)
+#define	 SFF8636_RX2_LOL_AW		(1 << 1)
+#define	 SFF8636_RX1_LOL_AW		(1 << 0)
+
 /* Module Monitor Interrupt Flags - 6-8 */
 #define	SFF8636_TEMP_AW_OFFSET	0x06
 #define	 SFF8636_TEMP_HALARM_STATUS		(1 << 7)
@@ -162,6 +172,8 @@
 #define	SFF8636_TX_PWR_3_OFFSET		0x36
 #define	SFF8636_TX_PWR_4_OFFSET		0x38
 
+#define	SFF8636_LANE_NUM		4
+
 /* Control Bytes - 86 - 99 */
 #define	SFF8636_TX_DISABLE_OFFSET	0x56
 #define	 SFF8636_TX_DISABLE_4			(1 << 3)
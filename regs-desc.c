@@ -0,0 +1,536 @@
+/*
+ * regs-desc.c: Decode engine for declarative register dump descriptions
+ *
+ * See regs-desc.h for the table format.  Registers are visited in table
+ * order and each one is formatted only if it is present in the dump,
+ * applies to the MAC type and is selected, so printing a few selected
+ * registers costs little more than the selection itself.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <ctype.h>
+#include <fnmatch.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "regs-desc.h"
+
+#define REGS_NAME_LEN	64
+#define REGS_LINE_LEN	256
+
+static int regs_mac_ok(unsigned int mac, u8 min_mac, u8 max_mac)
+{
+	return (!min_mac || mac >= min_mac) && (!max_mac || mac <= max_mac);
+}
+
+static void regs_fold(char *dst, const char *src, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len && src[i]; i++)
+		dst[i] = tolower((unsigned char)src[i]);
+	dst[i] = 0;
+}
+
+/* Case-insensitive glob match of the first @len characters of @pattern */
+static int regs_match(const char *pattern, size_t len, const char *str)
+{
+	char fpattern[REGS_NAME_LEN], fstr[REGS_NAME_LEN];
+
+	if (len >= sizeof(fpattern))
+		return 0;
+	regs_fold(fpattern, pattern, len);
+	regs_fold(fstr, str, sizeof(fstr) - 1);
+	return !fnmatch(fpattern, fstr, 0);
+}
+
+/*
+ * Is field @label of register @name selected?  With a NULL @label, is
+ * the whole register selected?  Patterns are REGISTER or
+ * REGISTER.FIELD, matched against instance names and field labels.
+ */
+static int regs_selected(const struct regs_desc_opts *opts,
+			 const char *name, const char *label)
+{
+	const char *pattern, *dot;
+	unsigned int i;
+
+	if (!opts || !opts->n_select)
+		return 1;
+
+	for (i = 0; i < opts->n_select; i++) {
+		pattern = opts->select[i];
+		dot = strchr(pattern, '.');
+		if (!regs_match(pattern,
+				dot ? (size_t)(dot - pattern) : strlen(pattern),
+				name))
+			continue;
+		if (!dot)
+			return 1;
+		if (label && regs_match(dot + 1, strlen(dot + 1), label))
+			return 1;
+	}
+	return 0;
+}
+
+static const char *regs_lookup(const struct regs_desc_value *values,
+			       u32 mask, u32 reg, const char *fallback)
+{
+	const struct regs_desc_value *v;
+
+	for (v = values; v && v->text; v++)
+		if ((reg & (v->mask ? v->mask : mask)) == v->value)
+			return v->text;
+	return fallback;
+}
+
+static u32 regs_field_raw(const struct regs_desc_field *field, u32 reg)
+{
+	return field->mask ? (reg & field->mask) >> (ffs(field->mask) - 1) : 0;
+}
+
+static const char *regs_field_text(const struct regs_desc_field *field,
+				   u32 reg, char *buf, size_t size)
+{
+	const char *text;
+	u32 value;
+
+	switch (field->format) {
+	case REGS_FIELD_BOOL:
+		text = field->text[!!(reg & field->mask)];
+		break;
+	case REGS_FIELD_ENUM:
+		text = regs_lookup(field->values, field->mask, reg,
+				   field->text[0]);
+		break;
+	default:
+		value = regs_field_raw(field, reg);
+		if (field->max && value > field->max)
+			value = field->max;
+		snprintf(buf, size, "%u%s", value,
+			 field->unit ? field->unit : "");
+		return buf;
+	}
+	if (!field->unit)
+		return text;
+	snprintf(buf, size, "%s%s", text, field->unit);
+	return buf;
+}
+
+static int regs_field_ok(const struct regs_desc *desc,
+			 const struct regs_desc_field *field)
+{
+	return regs_mac_ok(desc->mac, field->min_mac, field->max_mac);
+}
+
+/* Is register @reg applicable to this MAC type and dump? */
+static int regs_reg_ok(const struct regs_desc *desc,
+		       const struct regs_desc_reg *reg, const u32 *words,
+		       u32 n_words)
+{
+	if (!regs_mac_ok(desc->mac, reg->min_mac, reg->max_mac))
+		return 0;
+	if (!reg->dep_mask)
+		return 1;
+	return reg->dep_word < n_words &&
+		(words[reg->dep_word] & reg->dep_mask) == reg->dep_value;
+}
+
+static void regs_names(const struct regs_desc_reg *reg, unsigned int i,
+		       char *name, char *desc)
+{
+	snprintf(name, REGS_NAME_LEN, reg->name, i);
+	snprintf(desc, REGS_NAME_LEN, reg->desc, i);
+}
+
+static const char *regs_value_text(const struct regs_desc_reg *reg,
+				   u32 value, char *buf, size_t size)
+{
+	if (reg->values)
+		return regs_lookup(reg->values, 0xffffffff, value,
+				   reg->fallback);
+	snprintf(buf, size, "0x%08X", value);
+	return buf;
+}
+
+static void regs_format_header(const struct regs_desc_table *table,
+			       const struct regs_desc_reg *reg,
+			       unsigned int i, u32 value,
+			       char *line, size_t size)
+{
+	char name[REGS_NAME_LEN], desc[REGS_NAME_LEN], buf[16];
+	int len;
+
+	regs_names(reg, i, name, desc);
+	if (reg->addr == REGS_DESC_NO_ADDR)
+		len = snprintf(line, size, "%s:", desc);
+	else if (reg->fields)
+		len = snprintf(line, size, "0x%05X: %s (%s)",
+			       reg->addr + i * reg->stride, name, desc);
+	else
+		len = snprintf(line, size, "0x%05X: %-*s (%s)",
+			       reg->addr + i * reg->stride,
+			       reg->name_width ? reg->name_width :
+			       table->name_width, name, desc);
+	if (len < 0 || (size_t)len >= size)
+		return;
+	snprintf(line + len, size - len, "%*s%s",
+		 len < (int)table->value_col ? table->value_col - len : 1, "",
+		 regs_value_text(reg, value, buf, sizeof(buf)));
+}
+
+static void regs_format_field(const struct regs_desc_table *table,
+			      const struct regs_desc_field *field, u32 value,
+			      char *line, size_t size)
+{
+	char buf[REGS_NAME_LEN];
+	int len;
+
+	len = snprintf(line, size, "%*s%s:", table->field_indent, "",
+		       field->label);
+	if (len < 0 || (size_t)len >= size)
+		return;
+	snprintf(line + len, size - len, "%*s%s",
+		 len < (int)table->value_col ? table->value_col - len : 1, "",
+		 regs_field_text(field, value, buf, sizeof(buf)));
+}
+
+void regs_json_string(FILE *file, const char *str)
+{
+	fputc('"', file);
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			fprintf(file, "\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			fprintf(file, "\\u%04x", *str);
+		else
+			fputc(*str, file);
+	}
+	fputc('"', file);
+}
+
+static void regs_json_reg(const struct regs_desc_reg *reg, unsigned int i,
+			  const char *name, const char *desc, int *first)
+{
+	fprintf(stdout, "%s\n    {\"name\": ", *first ? "" : ",");
+	*first = 0;
+	regs_json_string(stdout, name);
+	fprintf(stdout, ", \"description\": ");
+	regs_json_string(stdout, desc);
+	if (reg->addr != REGS_DESC_NO_ADDR)
+		fprintf(stdout, ", \"offset\": %u",
+			reg->addr + i * reg->stride);
+}
+
+static void regs_json_begin(const struct ethtool_drvinfo *info,
+			    const char *list)
+{
+	fprintf(stdout, "{\"driver\": ");
+	regs_json_string(stdout, info->driver);
+	fprintf(stdout, ", \"%s\": [", list);
+}
+
+/* Is any field of @reg shown when the register itself is not selected? */
+static int regs_fields_selected(const struct regs_desc *desc,
+				const struct regs_desc_reg *reg,
+				const char *name,
+				const struct regs_desc_opts *opts)
+{
+	const struct regs_desc_field *field;
+
+	for (field = reg->fields; field && field->label; field++)
+		if (regs_field_ok(desc, field) &&
+		    regs_selected(opts, name, field->label))
+			return 1;
+	return 0;
+}
+
+/*
+ * Decide whether instance @i of @reg is shown: returns 0 if not, else
+ * fills in its names and sets *whole if all its fields are shown.
+ */
+static int regs_instance_shown(const struct regs_desc *desc,
+			       const struct regs_desc_reg *reg,
+			       unsigned int i,
+			       const struct regs_desc_opts *opts,
+			       char *name, char *desc_text, int *whole)
+{
+	regs_names(reg, i, name, desc_text);
+	*whole = regs_selected(opts, name, NULL);
+	return *whole || regs_fields_selected(desc, reg, name, opts);
+}
+
+static int regs_field_shown(const struct regs_desc *desc,
+			    const struct regs_desc_field *field,
+			    const struct regs_desc_opts *opts,
+			    const char *name, int whole)
+{
+	return regs_field_ok(desc, field) &&
+		(whole || regs_selected(opts, name, field->label));
+}
+
+static void regs_dump_json(const struct regs_desc *desc,
+			   const struct regs_desc_reg *reg, unsigned int i,
+			   u32 value, const struct regs_desc_opts *opts,
+			   int *first)
+{
+	char name[REGS_NAME_LEN], desc_text[REGS_NAME_LEN];
+	const struct regs_desc_field *field;
+	char buf[REGS_NAME_LEN];
+	int whole, first_field = 1;
+
+	if (!regs_instance_shown(desc, reg, i, opts, name, desc_text, &whole))
+		return;
+
+	regs_json_reg(reg, i, name, desc_text, first);
+	fprintf(stdout, ", \"value\": %u", value);
+	if (reg->values) {
+		fprintf(stdout, ", \"text\": ");
+		regs_json_string(stdout, regs_value_text(reg, value, buf,
+							 sizeof(buf)));
+	}
+	if (reg->fields) {
+		fprintf(stdout, ", \"fields\": [");
+		for (field = reg->fields; field->label; field++) {
+			if (!regs_field_shown(desc, field, opts, name, whole))
+				continue;
+			fprintf(stdout, "%s{\"name\": ",
+				first_field ? "" : ", ");
+			first_field = 0;
+			regs_json_string(stdout, field->label);
+			fprintf(stdout, ", \"value\": %u, \"text\": ",
+				regs_field_raw(field, value));
+			regs_json_string(stdout,
+					 regs_field_text(field, value, buf,
+							 sizeof(buf)));
+			fputc('}', stdout);
+		}
+		fputc(']', stdout);
+	}
+	fputc('}', stdout);
+}
+
+static void regs_dump_text(const struct regs_desc *desc,
+			   const struct regs_desc_reg *reg, unsigned int i,
+			   u32 value, const struct regs_desc_opts *opts)
+{
+	char name[REGS_NAME_LEN], desc_text[REGS_NAME_LEN];
+	const struct regs_desc_field *field;
+	char line[REGS_LINE_LEN];
+	int whole;
+
+	if (!regs_instance_shown(desc, reg, i, opts, name, desc_text, &whole))
+		return;
+
+	regs_format_header(desc->table, reg, i, value, line, sizeof(line));
+	fprintf(stdout, "%s\n", line);
+	for (field = reg->fields; field && field->label; field++) {
+		if (!regs_field_shown(desc, field, opts, name, whole))
+			continue;
+		regs_format_field(desc->table, field, value, line,
+				  sizeof(line));
+		fprintf(stdout, "%s\n", line);
+	}
+}
+
+int regs_desc_dump(const struct regs_desc *desc,
+		   const struct ethtool_drvinfo *info,
+		   const struct ethtool_regs *regs,
+		   const struct regs_desc_opts *opts)
+{
+	const struct regs_desc_table *table = desc->table;
+	const u32 *words = (const u32 *)regs->data;
+	u32 n_words = regs->len / sizeof(u32);
+	const struct regs_desc_reg *reg;
+	unsigned int i, count;
+	int json = opts && opts->json;
+	int first = 1;
+
+	if (json) {
+		regs_json_begin(info, "registers");
+	} else if (table->title && (!opts || !opts->n_select)) {
+		fprintf(stdout, "%s\n", table->title);
+		for (i = 0; table->title[i]; i++)
+			fputc('-', stdout);
+		fputc('\n', stdout);
+	}
+
+	for (reg = table->regs; reg < table->regs + table->n_regs; reg++) {
+		if (!regs_reg_ok(desc, reg, words, n_words))
+			continue;
+		count = reg->count ? reg->count : 1;
+		for (i = 0; i < count && reg->word + i < n_words; i++) {
+			if (json)
+				regs_dump_json(desc, reg, i,
+					       words[reg->word + i], opts,
+					       &first);
+			else
+				regs_dump_text(desc, reg, i,
+					       words[reg->word + i], opts);
+		}
+	}
+
+	if (json)
+		fprintf(stdout, "\n]}\n");
+	return 0;
+}
+
+/* Print a changed line, highlighting the fields that differ from @other */
+void regs_diff_line(char sign, const char *line, const char *other,
+		    const char *colour)
+{
+	size_t len = strlen(line), other_len = strlen(other);
+	size_t start = 0, end = 0;
+
+	if (!colour) {
+		fprintf(stdout, "%c%s\n", sign, line);
+		return;
+	}
+
+	while (start < len && start < other_len &&
+	       line[start] == other[start])
+		start++;
+	while (end < len - start && end < other_len - start &&
+	       line[len - end - 1] == other[other_len - end - 1])
+		end++;
+	/* Widen the change to whole fields */
+	while (start > 0 && !isspace((unsigned char)line[start - 1]))
+		start--;
+	while (end > 0 && !isspace((unsigned char)line[len - end]))
+		end--;
+
+	fprintf(stdout, "%c%.*s%s%.*s%s%s\n", sign, (int)start, line,
+		colour, (int)(len - start - end), line + start,
+		REGS_DIFF_END_COLOUR, line + len - end);
+}
+
+static void regs_diff_lines(const char *old, const char *new,
+			    const struct regs_desc_opts *opts)
+{
+	int colour = opts && opts->colour;
+
+	regs_diff_line('-', old, new, colour ? REGS_DIFF_OLD_COLOUR : NULL);
+	regs_diff_line('+', new, old, colour ? REGS_DIFF_NEW_COLOUR : NULL);
+}
+
+static void regs_diff_text(const struct regs_desc *desc,
+			   const struct regs_desc_reg *reg, unsigned int i,
+			   u32 old, u32 new, const char *name, int whole,
+			   const struct regs_desc_opts *opts)
+{
+	char old_line[REGS_LINE_LEN], new_line[REGS_LINE_LEN];
+	const struct regs_desc_field *field;
+
+	regs_format_header(desc->table, reg, i, old, old_line,
+			   sizeof(old_line));
+	regs_format_header(desc->table, reg, i, new, new_line,
+			   sizeof(new_line));
+	regs_diff_lines(old_line, new_line, opts);
+
+	for (field = reg->fields; field && field->label; field++) {
+		if (!regs_field_shown(desc, field, opts, name, whole))
+			continue;
+		regs_format_field(desc->table, field, old, old_line,
+				  sizeof(old_line));
+		regs_format_field(desc->table, field, new, new_line,
+				  sizeof(new_line));
+		if (strcmp(old_line, new_line))
+			regs_diff_lines(old_line, new_line, opts);
+	}
+}
+
+static void regs_diff_json(const struct regs_desc *desc,
+			   const struct regs_desc_reg *reg, unsigned int i,
+			   u32 old, u32 new, const char *name,
+			   const char *desc_text, int whole,
+			   const struct regs_desc_opts *opts, int *first)
+{
+	char old_buf[REGS_NAME_LEN], new_buf[REGS_NAME_LEN];
+	const struct regs_desc_field *field;
+	const char *old_text, *new_text;
+	int first_field = 1;
+
+	regs_json_reg(reg, i, name, desc_text, first);
+	fprintf(stdout, ", \"old\": %u, \"new\": %u", old, new);
+	if (!reg->fields) {
+		fputc('}', stdout);
+		return;
+	}
+
+	fprintf(stdout, ", \"fields\": [");
+	for (field = reg->fields; field->label; field++) {
+		if (!regs_field_shown(desc, field, opts, name, whole))
+			continue;
+		old_text = regs_field_text(field, old, old_buf,
+					   sizeof(old_buf));
+		new_text = regs_field_text(field, new, new_buf,
+					   sizeof(new_buf));
+		if (!strcmp(old_text, new_text))
+			continue;
+		fprintf(stdout, "%s{\"name\": ", first_field ? "" : ", ");
+		first_field = 0;
+		regs_json_string(stdout, field->label);
+		fprintf(stdout, ", \"old\": ");
+		regs_json_string(stdout, old_text);
+		fprintf(stdout, ", \"new\": ");
+		regs_json_string(stdout, new_text);
+		fputc('}', stdout);
+	}
+	fprintf(stdout, "]}");
+}
+
+/*
+ * Show the registers that differ between two dumps of the same layout,
+ * with the decoded fields that changed.  Returns the number of register
+ * instances shown.
+ */
+unsigned int regs_desc_diff(const struct regs_desc *desc,
+			    const struct ethtool_drvinfo *info,
+			    const struct ethtool_regs *old,
+			    const struct ethtool_regs *new,
+			    const struct regs_desc_opts *opts)
+{
+	const struct regs_desc_table *table = desc->table;
+	const u32 *old_words = (const u32 *)old->data;
+	const u32 *new_words = (const u32 *)new->data;
+	char name[REGS_NAME_LEN], desc_text[REGS_NAME_LEN];
+	u32 n_words = (old->len < new->len ? old->len : new->len) /
+		sizeof(u32);
+	const struct regs_desc_reg *reg;
+	unsigned int i, count, shown = 0;
+	int json = opts && opts->json;
+	int whole, first = 1;
+	u32 o, n;
+
+	if (json)
+		regs_json_begin(info, "changes");
+
+	for (reg = table->regs; reg < table->regs + table->n_regs; reg++) {
+		if (!regs_reg_ok(desc, reg, old_words, n_words) &&
+		    !regs_reg_ok(desc, reg, new_words, n_words))
+			continue;
+		count = reg->count ? reg->count : 1;
+		for (i = 0; i < count && reg->word + i < n_words; i++) {
+			o = old_words[reg->word + i];
+			n = new_words[reg->word + i];
+			if (o == n ||
+			    !regs_instance_shown(desc, reg, i, opts, name,
+						 desc_text, &whole))
+				continue;
+			shown++;
+			if (json)
+				regs_diff_json(desc, reg, i, o, n, name,
+					       desc_text, whole, opts, &first);
+			else
+				regs_diff_text(desc, reg, i, o, n, name,
+					       whole, opts);
+		}
+	}
+
+	if (json)
+		fprintf(stdout, "\n]}\n");
+	return shown;
+}
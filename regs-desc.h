@@ -0,0 +1,151 @@
+/*
+ * regs-desc.h: Declarative register dump descriptions
+ *
+ * A driver describes its register dump as a table of registers, each
+ * naming the dump word it occupies and the bit fields worth decoding.
+ * The shared engine in regs-desc.c prints such a table as text or
+ * JSON, restricted to selected registers and fields, or as a field
+ * level comparison of two dumps.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#ifndef REGS_DESC_H__
+#define REGS_DESC_H__
+
+#include "internal.h"
+
+/* How a field value is shown */
+enum regs_field_format {
+	REGS_FIELD_BOOL,	/* text[0] if clear, text[1] if set */
+	REGS_FIELD_ENUM,	/* first matching value, else text[0] */
+	REGS_FIELD_UINT,	/* unsigned decimal, clamped to max */
+};
+
+/*
+ * One decoded value.  The field (or register) value matches if
+ * (reg & mask) == value, where a zero mask means the field mask.
+ */
+struct regs_desc_value {
+	u32 mask;
+	u32 value;
+	const char *text;
+};
+
+struct regs_desc_field {
+	const char *label;
+	u32 mask;
+	u8 format;
+	/* Applicable MAC types; 0 means no lower or upper bound */
+	u8 min_mac, max_mac;
+	const char *text[2];
+	const struct regs_desc_value *values;	/* ends with NULL text */
+	u32 max;
+	const char *unit;
+};
+
+#define REGS_DESC_NO_ADDR	0xffffffff
+
+struct regs_desc_reg {
+	/* printf formats taking the instance number of an array */
+	const char *name;
+	const char *desc;
+	u32 addr;		/* of instance 0, or REGS_DESC_NO_ADDR */
+	u32 stride;		/* address step between instances */
+	u16 word;		/* dump word holding instance 0 */
+	u16 count;		/* number of instances, 0 meaning 1 */
+	u8 min_mac, max_mac;
+	const struct regs_desc_field *fields;	/* ends with NULL label */
+	/* Show decoded text rather than hex for the register value */
+	const struct regs_desc_value *values;
+	const char *fallback;
+	/* Show only if (dump word @dep_word & dep_mask) == dep_value */
+	u16 dep_word;
+	u32 dep_mask, dep_value;
+	/* Pad the name to this rather than the table's name_width */
+	u8 name_width;
+};
+
+struct regs_desc_table {
+	const char *title;		/* printed above a full text dump */
+	const struct regs_desc_reg *regs;
+	unsigned int n_regs;
+	unsigned int name_width;	/* undecoded names are padded to this */
+	unsigned int value_col;		/* column of all values */
+	unsigned int field_indent;
+};
+
+/* A table and the MAC type it is to be read for */
+struct regs_desc {
+	const struct regs_desc_table *table;
+	unsigned int mac;
+};
+
+struct regs_desc_opts {
+	int json;
+	int colour;			/* highlight changes in a diff */
+	char **select;			/* REGISTER[.FIELD] globs */
+	unsigned int n_select;
+};
+
+#define REGS_BOOL(_label, _mask, _clear, _set)				\
+	{ .label = _label, .mask = _mask, .format = REGS_FIELD_BOOL,	\
+	  .text = { _clear, _set } }
+#define REGS_BOOL_MAC(_label, _mask, _clear, _set, _min, _max)		\
+	{ .label = _label, .mask = _mask, .format = REGS_FIELD_BOOL,	\
+	  .text = { _clear, _set }, .min_mac = _min, .max_mac = _max }
+#define REGS_ENUM(_label, _mask, _values, _fallback)			\
+	{ .label = _label, .mask = _mask, .format = REGS_FIELD_ENUM,	\
+	  .values = _values, .text = { _fallback } }
+#define REGS_ENUM_MAC(_label, _mask, _values, _fallback, _min, _max)	\
+	{ .label = _label, .mask = _mask, .format = REGS_FIELD_ENUM,	\
+	  .values = _values, .text = { _fallback },			\
+	  .min_mac = _min, .max_mac = _max }
+#define REGS_UINT(_label, _mask, _max, _unit)				\
+	{ .label = _label, .mask = _mask, .format = REGS_FIELD_UINT,	\
+	  .max = _max, .unit = _unit }
+
+#define REGS_REG(_name, _desc, _addr, _word)				\
+	{ .name = _name, .desc = _desc, .addr = _addr, .word = _word }
+#define REGS_REG_WIDTH(_name, _desc, _addr, _word, _width)		\
+	{ .name = _name, .desc = _desc, .addr = _addr, .word = _word,	\
+	  .name_width = _width }
+#define REGS_REG_MAC(_name, _desc, _addr, _word, _min, _max)		\
+	{ .name = _name, .desc = _desc, .addr = _addr, .word = _word,	\
+	  .min_mac = _min, .max_mac = _max }
+#define REGS_ARRAY(_name, _desc, _addr, _stride, _word, _count)	\
+	{ .name = _name, .desc = _desc, .addr = _addr,			\
+	  .stride = _stride, .word = _word, .count = _count }
+#define REGS_ARRAY_MAC(_name, _desc, _addr, _stride, _word, _count,	\
+		       _min, _max)					\
+	{ .name = _name, .desc = _desc, .addr = _addr,			\
+	  .stride = _stride, .word = _word, .count = _count,		\
+	  .min_mac = _min, .max_mac = _max }
+#define REGS_DECODE(_name, _desc, _addr, _word, _fields)		\
+	{ .name = _name, .desc = _desc, .addr = _addr, .word = _word,	\
+	  .fields = _fields }
+#define REGS_DECODE_MAC(_name, _desc, _addr, _word, _fields, _min, _max) \
+	{ .name = _name, .desc = _desc, .addr = _addr, .word = _word,	\
+	  .fields = _fields, .min_mac = _min, .max_mac = _max }
+
+int regs_desc_dump(const struct regs_desc *desc,
+		   const struct ethtool_drvinfo *info,
+		   const struct ethtool_regs *regs,
+		   const struct regs_desc_opts *opts);
+unsigned int regs_desc_diff(const struct regs_desc *desc,
+			    const struct ethtool_drvinfo *info,
+			    const struct ethtool_regs *old,
+			    const struct ethtool_regs *new,
+			    const struct regs_desc_opts *opts);
+
+#define REGS_DIFF_OLD_COLOUR	"\033[1;31m"
+#define REGS_DIFF_NEW_COLOUR	"\033[1;32m"
+#define REGS_DIFF_END_COLOUR	"\033[0m"
+
+void regs_diff_line(char sign, const char *line, const char *other,
+		    const char *colour);
+void regs_json_string(FILE *file, const char *str);
+
+#endif /* REGS_DESC_H__ */
@@ -11,6 +11,7 @@
 #include <linux/sockios.h>
 #include <arpa/inet.h>
 #include "internal.h"
+#include "libethtool.h"
 
 static void invert_flow_mask(struct ethtool_rx_flow_spec *fsp)
 {
@@ -347,6 +348,7 @@ int rxclass_rule_get(struct cmd_context *ctx, __u32 loc)
 int rxclass_rule_getall(struct cmd_context *ctx)
 {
 	struct ethtool_rxnfc *nfccmd;
+	struct ethtool_dev dev;
 	__u32 *rule_locs;
 	int err, i;
 	__u32 count;
@@ -358,21 +360,12 @@ int rxclass_rule_getall(struct cmd_context *ctx)
 
 	fprintf(stdout, "Total %d rules\n\n", count);
 
-	/* alloc memory for request of location list */
-	nfccmd = calloc(1, sizeof(*nfccmd) + (count * sizeof(__u32)));
-	if (!nfccmd) {
-		perror("rxclass: Cannot allocate memory for"
-		       " RX class rule locations");
-		return -ENOMEM;
-	}
-
 	/* request location list */
-	nfccmd->cmd = ETHTOOL_GRXCLSRLALL;
-	nfccmd->rule_cnt = count;
-	err = send_ioctl(ctx, nfccmd);
-	if (err < 0) {
+	ctx_ethtool_dev(ctx, &dev);
+	err = ethtool_fetch_rule_locs(&dev, count, &nfccmd);
+	if (err) {
+		errno = -err;
 		perror("rxclass: Cannot get RX class rules");
-		free(nfccmd);
 		return err;
 	}
 
@@ -481,6 +474,7 @@ static int rmgr_find_empty_slot(struct rmgr_ctrl *rmgr,
 static int rmgr_init(struct cmd_context *ctx, struct rmgr_ctrl *rmgr)
 {
 	struct ethtool_rxnfc *nfccmd;
+	struct ethtool_dev dev;
 	int err, i;
 	__u32 *rule_locs;
 
@@ -496,21 +490,12 @@ static int rmgr_init(struct cmd_context *ctx, struct rmgr_ctrl *rmgr)
 	if (rmgr->driver_select)
 		return 0;
 
-	/* alloc memory for request of location list */
-	nfccmd = calloc(1, sizeof(*nfccmd) + (rmgr->n_rules * sizeof(__u32)));
-	if (!nfccmd) {
-		perror("rmgr: Cannot allocate memory for"
-		       " RX class rule locations");
-		return -1;
-	}
-
 	/* request location list */
-	nfccmd->cmd = ETHTOOL_GRXCLSRLALL;
-	nfccmd->rule_cnt = rmgr->n_rules;
-	err = send_ioctl(ctx, nfccmd);
-	if (err < 0) {
+	ctx_ethtool_dev(ctx, &dev);
+	err = ethtool_fetch_rule_locs(&dev, rmgr->n_rules, &nfccmd);
+	if (err) {
+		errno = -err;
 		perror("rmgr: Cannot get RX class rules");
-		free(nfccmd);
 		return err;
 	}
 
@@ -596,7 +581,7 @@ int rxclass_rule_ins(struct cmd_context *ctx,
 	else if (loc & RX_CLS_LOC_SPECIAL)
 		printf("Added rule with ID %d\n", nfccmd.fs.location);
 
-	return 0;
+	return err;
 }
 
 int rxclass_rule_del(struct cmd_context *ctx, __u32 loc)
@@ -7,6 +7,8 @@
  * by the Free Software Foundation, incorporated herein by reference.
  */
 
+#include <ctype.h>
+#include <fnmatch.h>
 #include <stdio.h>
 #include <string.h>
 #include "internal.h"
@@ -3807,53 +3809,87 @@ print_single_register(unsigned revision, const struct efx_nic_reg *reg,
 	return (const u8 *)buf + 16;
 }
 
+/* Case-insensitive glob match of a table or field name */
+static int name_matches(const char *pattern, const char *name)
+{
+	char fpattern[64], fname[64];
+	size_t i;
+
+	if (!pattern)
+		return 1;
+	for (i = 0; pattern[i] && i < sizeof(fpattern) - 1; i++)
+		fpattern[i] = toupper((unsigned char)pattern[i]);
+	fpattern[i] = 0;
+	for (i = 0; name[i] && i < sizeof(fname) - 1; i++)
+		fname[i] = toupper((unsigned char)name[i]);
+	fname[i] = 0;
+	return !fnmatch(fpattern, fname, 0);
+}
+
+static int field_shown(unsigned revision, const struct efx_nic_reg_field *field,
+		       const struct regs_table_filter *filter)
+{
+	return revision >= field->min_revision &&
+		revision <= field->max_revision &&
+		name_matches(filter->field, field->name);
+}
+
 static const void *
-print_simple_table(const struct efx_nic_reg_table *table, const void *buf)
+print_simple_table(const struct efx_nic_reg_table *table, const void *buf,
+		   const struct regs_table_filter *filter)
 {
 	const struct efx_nic_reg_field *field = &table->fields[0];
 	size_t value_width = (field->width + 3) >> 2;
 	size_t column_count = 72 / (value_width + 1);
 	size_t size = table->step > 16 ? 16 : table->step;
+	const u8 *end = (const u8 *)buf + table->rows * size;
 	size_t i;
 
-	for (i = 0; i < table->rows; i++) {
-		if (i % column_count == 0) {
-			if (i != 0)
+	for (i = filter->first_row; i < table->rows && i <= filter->last_row;
+	     i++) {
+		if ((i - filter->first_row) % column_count == 0) {
+			if (i != filter->first_row)
 				fputc('\n', stdout);
 			printf("%4zu ", i);
 		}
 		fputc(' ', stdout);
-		print_field_value(field, buf);
-		buf = (const u8 *)buf + size;
+		print_field_value(field, (const u8 *)buf + i * size);
 	}
 	fputc('\n', stdout);
 
-	return buf;
+	return end;
 }
 
+/* Rows are at most 16 bytes, so test them a word at a time */
 static int buf_is_zero(const u8 *buf, size_t size)
 {
-	size_t i;
-	for (i = 0; i < size; i++)
-		if (buf[i])
-			return 0;
-	return 1;
+	u64 acc = 0, word;
+
+	for (; size >= sizeof(word); size -= sizeof(word)) {
+		memcpy(&word, buf, sizeof(word));
+		acc |= word;
+		buf += sizeof(word);
+	}
+	while (size--)
+		acc |= *buf++;
+	return acc == 0;
 }
 
 static const void *
 print_complex_table(unsigned revision, const struct efx_nic_reg_table *table,
-		    const void *buf)
+		    const void *buf, const struct regs_table_filter *filter)
 {
 	const struct efx_nic_reg_field *field;
 	size_t size = table->step > 16 ? 16 : table->step;
+	const u8 *end = (const u8 *)buf + table->rows * size;
+	const u8 *row;
 	size_t i, j;
 
 	/* Column headings */
 	fputs("Row ", stdout);
 	for (i = 0; i < table->field_count; i++) {
 		field = &table->fields[i];
-		if (revision >= field->min_revision &&
-		    revision <= field->max_revision)
+		if (field_shown(revision, field, filter))
 			printf(" %-*s", (int)column_width(field),
 			       field->name);
 	}
@@ -3861,8 +3897,7 @@ print_complex_table(unsigned revision, const struct efx_nic_reg_table *table,
 	fputs("----", stdout);
 	for (i = 0; i < table->field_count; i++) {
 		field = &table->fields[i];
-		if (revision >= field->min_revision &&
-		    revision <= field->max_revision) {
+		if (field_shown(revision, field, filter)) {
 			fputc(' ', stdout);
 			for (j = column_width(field); j > 0; j--)
 				fputc('-', stdout);
@@ -3870,42 +3905,54 @@ print_complex_table(unsigned revision, const struct efx_nic_reg_table *table,
 	}
 	fputc('\n', stdout);
 
-	for (j = 0; j < table->rows; j++) {
-		if (!buf_is_zero(buf, size)) {
-			printf("%4zu", j);
-			for (i = 0; i < table->field_count; i++) {
-				field = &table->fields[i];
-				if (!(revision >= field->min_revision &&
-				      revision <= field->max_revision))
-					continue;
-				printf(" %*s", (int)column_padding(field), "");
-				print_field_value(field, buf);
-			}
-			fputc('\n', stdout);
+	for (j = filter->first_row; j < table->rows && j <= filter->last_row;
+	     j++) {
+		row = (const u8 *)buf + j * size;
+		if (buf_is_zero(row, size))
+			continue;
+		printf("%4zu", j);
+		for (i = 0; i < table->field_count; i++) {
+			field = &table->fields[i];
+			if (!field_shown(revision, field, filter))
+				continue;
+			printf(" %*s", (int)column_padding(field), "");
+			print_field_value(field, row);
 		}
-		buf = (const u8 *)buf + size;
+		fputc('\n', stdout);
 	}
 
-	return buf;
+	return end;
 }
 
-int
-sfc_dump_regs(struct ethtool_drvinfo *info maybe_unused, struct ethtool_regs *regs)
+/*
+ * Print the registers and tables of a dump.  With a table name in
+ * @filter, print only the matching tables, and only the given rows
+ * and fields of those; the rest of the dump is skipped undecoded.
+ */
+int sfc_dump_regs_tables(struct ethtool_drvinfo *info maybe_unused,
+			 struct ethtool_regs *regs,
+			 const struct regs_table_filter *filter)
 {
 	const struct efx_nic_reg *reg;
 	const struct efx_nic_reg_table *table;
+	struct regs_table_filter rows;
 	unsigned revision = regs->version;
 	const void *buf = regs->data;
 	const void *end = regs->data + regs->len;
+	size_t size, avail;
 
 	if (revision > REGISTER_REVISION_ED)
 		return -1;
 
-	for (reg = efx_nic_regs;	
+	for (reg = efx_nic_regs;
 	     reg < efx_nic_regs + ARRAY_SIZE(efx_nic_regs) && buf < end;
 	     reg++) {
-		if (revision >= reg->min_revision &&
-		    revision <= reg->max_revision)
+		if (!(revision >= reg->min_revision &&
+		      revision <= reg->max_revision))
+			continue;
+		if (filter->table)
+			buf = (const u8 *)buf + 16;
+		else
 			buf = print_single_register(revision, reg, buf);
 	}
 
@@ -3913,15 +3960,37 @@ sfc_dump_regs(struct ethtool_drvinfo *info maybe_unused, struct ethtool_regs *re
 	     table < efx_nic_reg_tables + ARRAY_SIZE(efx_nic_reg_tables) &&
 		     buf < end;
 	     table++) {
-		if (revision >= table->min_revision &&
-		    revision <= table->max_revision) {
-			printf("\n%s:\n", table->name);
-			if (table->field_count == 1)
-				buf = print_simple_table(table, buf);
-			else
-				buf = print_complex_table(revision, table, buf);
+		if (!(revision >= table->min_revision &&
+		      revision <= table->max_revision))
+			continue;
+		size = table->step > 16 ? 16 : table->step;
+		if (!name_matches(filter->table, table->name)) {
+			buf = (const u8 *)buf + table->rows * size;
+			continue;
 		}
+		/* Don't read rows beyond a short dump */
+		avail = ((const u8 *)end - (const u8 *)buf) / size;
+		if (!avail)
+			break;
+		rows = *filter;
+		if (rows.last_row > avail - 1)
+			rows.last_row = avail - 1;
+		printf("\n%s:\n", table->name);
+		if (table->field_count == 1)
+			buf = print_simple_table(table, buf, &rows);
+		else
+			buf = print_complex_table(revision, table, buf, &rows);
 	}
 
 	return 0;
 }
+
+int
+sfc_dump_regs(struct ethtool_drvinfo *info, struct ethtool_regs *regs)
+{
+	static const struct regs_table_filter all = {
+		.last_row = 0xffffffff,
+	};
+
+	return sfc_dump_regs_tables(info, regs, &all);
+}
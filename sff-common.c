@@ -29,6 +29,40 @@ double convert_mw_to_dbm(double mw)
 	return (10. * log10(mw / 1000.)) + 30.;
 }
 
+/*
+ * Power readings are 16-bit unsigned values in units of 0.1 uW, so
+ * every possible dBm value fits in a table.  Entries are filled as the
+ * decoders first ask for them, or all at once by sff_dbm_table_init()
+ * for callers that decode many images, and are produced by
+ * convert_mw_to_dbm() itself so they print exactly as the direct
+ * computation would.
+ */
+static double sff_dbm_table[0x10000];
+static __u8 sff_dbm_table_valid[0x10000 / 8];
+
+static double sff_dbm_table_fill(__u16 raw)
+{
+	sff_dbm_table[raw] = convert_mw_to_dbm((double)(raw / 10000.));
+	sff_dbm_table_valid[raw / 8] |= 1 << (raw % 8);
+	return sff_dbm_table[raw];
+}
+
+void sff_dbm_table_init(void)
+{
+	unsigned int raw;
+
+	for (raw = 0; raw < ARRAY_SIZE(sff_dbm_table); raw++)
+		if (!(sff_dbm_table_valid[raw / 8] & (1 << (raw % 8))))
+			sff_dbm_table_fill(raw);
+}
+
+double sff_raw_pwr_to_dbm(__u16 raw)
+{
+	if (sff_dbm_table_valid[raw / 8] & (1 << (raw % 8)))
+		return sff_dbm_table[raw];
+	return sff_dbm_table_fill(raw);
+}
+
 void sff_show_value_with_unit(const __u8 *id, unsigned int reg,
 			      const char *name, unsigned int mult,
 			      const char *unit)
@@ -136,6 +170,12 @@ void sff8024_show_identifier(const __u8 *id, int id_offset)
 	case SFF8024_ID_MICRO_QSFP:
 		printf(" (microQSFP)\n");
 		break;
+	case SFF8024_ID_QSFP_DD:
+		printf(" (QSFP-DD Double Density 8X Pluggable Transceiver)\n");
+		break;
+	case SFF8024_ID_OSFP:
+		printf(" (OSFP 8X Pluggable Transceiver)\n");
+		break;
 	default:
 		printf(" (reserved or unknown)\n");
 		break;
@@ -302,3 +342,135 @@ void sff_show_thresholds(struct sff_diags sd)
 	PRINT_xX_PWR("Laser rx power low warning threshold",
 		     sd.rx_power[LWARN]);
 }
+
+const struct sff_lane_layout cmis_lane_layout = {
+	.n_lanes = CMIS_LANE_NUM,
+	.stride = 2,
+	.bias_cur_offset = CMIS_TX_BIAS_OFFSET,
+	.tx_power_offset = CMIS_TX_PWR_OFFSET,
+	.rx_power_offset = CMIS_RX_PWR_OFFSET,
+	.aw_format = SFF_LANE_AW_BITMAP,
+	.bias_cur_aw = {
+		[LWARN] = CMIS_TX_BIAS_LWARN_OFFSET,
+		[HWARN] = CMIS_TX_BIAS_HWARN_OFFSET,
+		[LALRM] = CMIS_TX_BIAS_LALRM_OFFSET,
+		[HALRM] = CMIS_TX_BIAS_HALRM_OFFSET,
+	},
+	.tx_power_aw = {
+		[LWARN] = CMIS_TX_PWR_LWARN_OFFSET,
+		[HWARN] = CMIS_TX_PWR_HWARN_OFFSET,
+		[LALRM] = CMIS_TX_PWR_LALRM_OFFSET,
+		[HALRM] = CMIS_TX_PWR_HALRM_OFFSET,
+	},
+	.rx_power_aw = {
+		[LWARN] = CMIS_RX_PWR_LWARN_OFFSET,
+		[HWARN] = CMIS_RX_PWR_HWARN_OFFSET,
+		[LALRM] = CMIS_RX_PWR_LALRM_OFFSET,
+		[HALRM] = CMIS_RX_PWR_HALRM_OFFSET,
+	},
+	.rx_los = { CMIS_RX_LOS_OFFSET, 0 },
+	.tx_los = { CMIS_TX_LOS_OFFSET, 0 },
+	.tx_fault = { CMIS_TX_FAULT_OFFSET, 0 },
+	.rx_lol = { CMIS_RX_LOL_OFFSET, 0 },
+	.tx_lol = { CMIS_TX_LOL_OFFSET, 0 },
+};
+
+static int sff_lane_aw_test(const __u8 *id, enum sff_lane_aw_format format,
+			    unsigned int offset, unsigned int lane,
+			    unsigned int type)
+{
+	if (format == SFF_LANE_AW_BITMAP)
+		return (id[offset] >> lane) & 1;
+	/* LWARN..HALRM are bits 0..3 of the lane's nibble */
+	return (id[offset + lane / 2] >> ((lane & 1 ? 0 : 4) + type)) & 1;
+}
+
+static int sff_lane_bit_test(const __u8 *id, const struct sff_lane_bit *bit,
+			     unsigned int lane)
+{
+	return (id[bit->offset] >> (bit->shift + lane)) & 1;
+}
+
+/*
+ * Decode all per-lane monitors and flags described by layout in a
+ * single pass over the lanes.
+ */
+void sff_lanes_parse(const __u8 *id, const struct sff_lane_layout *layout,
+		     struct sff_diags *sd)
+{
+	struct sff_lane_flags *lf = &sd->lane_flags;
+	unsigned int lane, type, offset;
+
+	sd->n_lanes = layout->n_lanes;
+	if (sd->n_lanes > MAX_CHANNEL_NUM)
+		sd->n_lanes = MAX_CHANNEL_NUM;
+	memset(lf, 0, sizeof(*lf));
+
+	for (lane = 0; lane < sd->n_lanes; lane++) {
+		offset = lane * layout->stride;
+		sd->scd[lane].bias_cur =
+			OFFSET_TO_U16(layout->bias_cur_offset + offset);
+		sd->scd[lane].tx_power =
+			OFFSET_TO_U16(layout->tx_power_offset + offset);
+		sd->scd[lane].rx_power =
+			OFFSET_TO_U16(layout->rx_power_offset + offset);
+
+		lf->rx_los |= sff_lane_bit_test(id, &layout->rx_los, lane)
+			<< lane;
+		lf->tx_los |= sff_lane_bit_test(id, &layout->tx_los, lane)
+			<< lane;
+		lf->tx_fault |= sff_lane_bit_test(id, &layout->tx_fault, lane)
+			<< lane;
+		lf->rx_lol |= sff_lane_bit_test(id, &layout->rx_lol, lane)
+			<< lane;
+		lf->tx_lol |= sff_lane_bit_test(id, &layout->tx_lol, lane)
+			<< lane;
+
+		for (type = LWARN; type <= HALRM; type++) {
+			lf->bias_cur_aw[type] |=
+				sff_lane_aw_test(id, layout->aw_format,
+						 layout->bias_cur_aw[type],
+						 lane, type) << lane;
+			lf->tx_power_aw[type] |=
+				sff_lane_aw_test(id, layout->aw_format,
+						 layout->tx_power_aw[type],
+						 lane, type) << lane;
+			lf->rx_power_aw[type] |=
+				sff_lane_aw_test(id, layout->aw_format,
+						 layout->rx_power_aw[type],
+						 lane, type) << lane;
+		}
+	}
+}
+
+void sff_show_lane_status(const char *name, unsigned int n_lanes,
+			  __u32 value)
+{
+	const char *sep = "";
+	unsigned int lane;
+
+	printf("\t%-41s : ", name);
+	if (!value) {
+		printf("None\n");
+		return;
+	}
+	printf("Yes (lanes");
+	for (lane = 0; lane < n_lanes; lane++) {
+		if (value & (1U << lane)) {
+			printf("%s %u", sep, lane + 1);
+			sep = ",";
+		}
+	}
+	printf(")\n");
+}
+
+void sff_show_lane_flags(const struct sff_diags *sd)
+{
+	const struct sff_lane_flags *lf = &sd->lane_flags;
+
+	sff_show_lane_status("Rx loss of signal", sd->n_lanes, lf->rx_los);
+	sff_show_lane_status("Tx loss of signal", sd->n_lanes, lf->tx_los);
+	sff_show_lane_status("Tx fault", sd->n_lanes, lf->tx_fault);
+	sff_show_lane_status("Rx loss of lock", sd->n_lanes, lf->rx_lol);
+	sff_show_lane_status("Tx loss of lock", sd->n_lanes, lf->tx_lol);
+}
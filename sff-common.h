@@ -51,7 +51,9 @@
 #define  SFF8024_ID_HD8X_FANOUT			0x15
 #define  SFF8024_ID_CDFP_S3				0x16
 #define  SFF8024_ID_MICRO_QSFP			0x17
-#define  SFF8024_ID_LAST				SFF8024_ID_MICRO_QSFP
+#define  SFF8024_ID_QSFP_DD				0x18
+#define  SFF8024_ID_OSFP				0x19
+#define  SFF8024_ID_LAST				SFF8024_ID_OSFP
 #define  SFF8024_ID_UNALLOCATED_LAST	0x7F
 #define  SFF8024_ID_VENDOR_START		0x80
 #define  SFF8024_ID_VENDOR_LAST			0xFF
@@ -114,7 +116,7 @@
 # define PRINT_xX_PWR(string, var)                             \
 		printf("\t%-41s : %.4f mW / %.2f dBm\n", (string),         \
 		      (double)((var) / 10000.),                           \
-		       convert_mw_to_dbm((double)((var) / 10000.)))
+		       sff_raw_pwr_to_dbm(var))
 
 #define PRINT_BIAS(string, bias_cur)                             \
 		printf("\t%-41s : %.3f mA\n", (string),                       \
@@ -132,6 +134,33 @@
 # define PRINT_xX_THRESH_PWR(string, var, index)                       \
 		PRINT_xX_PWR(string, (var)[(index)])
 
+/*
+ * CMIS (QSFP-DD, OSFP) Upper Page 11h lane flags and monitors.  Offsets
+ * are within the 256-byte view of the page, i.e. the upper page starts
+ * at 0x80.  Each flag byte holds one bit per lane, lane 1 in bit 0.
+ */
+#define CMIS_TX_FAULT_OFFSET			0x87
+#define CMIS_TX_LOS_OFFSET				0x88
+#define CMIS_TX_LOL_OFFSET				0x89
+#define CMIS_TX_PWR_HALRM_OFFSET		0x8B
+#define CMIS_TX_PWR_LALRM_OFFSET		0x8C
+#define CMIS_TX_PWR_HWARN_OFFSET		0x8D
+#define CMIS_TX_PWR_LWARN_OFFSET		0x8E
+#define CMIS_TX_BIAS_HALRM_OFFSET		0x8F
+#define CMIS_TX_BIAS_LALRM_OFFSET		0x90
+#define CMIS_TX_BIAS_HWARN_OFFSET		0x91
+#define CMIS_TX_BIAS_LWARN_OFFSET		0x92
+#define CMIS_RX_LOS_OFFSET				0x93
+#define CMIS_RX_LOL_OFFSET				0x94
+#define CMIS_RX_PWR_HALRM_OFFSET		0x95
+#define CMIS_RX_PWR_LALRM_OFFSET		0x96
+#define CMIS_RX_PWR_HWARN_OFFSET		0x97
+#define CMIS_RX_PWR_LWARN_OFFSET		0x98
+#define CMIS_TX_PWR_OFFSET				0x9A
+#define CMIS_TX_BIAS_OFFSET				0xAA
+#define CMIS_RX_PWR_OFFSET				0xBA
+#define CMIS_LANE_NUM					8
+
 /* Channel Monitoring Fields */
 struct sff_channel_diags {
 	__u16 bias_cur;      /* Measured bias current in 2uA units */
@@ -139,16 +168,73 @@ struct sff_channel_diags {
 	__u16 tx_power;      /* Measured TX Power */
 };
 
-/* Module Monitoring Fields */
-struct sff_diags {
-
-#define MAX_CHANNEL_NUM 4
+#define MAX_CHANNEL_NUM 8
 #define LWARN 0
 #define HWARN 1
 #define LALRM 2
 #define HALRM 3
 #define MCURR 4
 
+/* Lane status and alarm/warning flags; bit n is set for lane n + 1 */
+struct sff_lane_flags {
+	__u32 rx_los;
+	__u32 tx_los;
+	__u32 tx_fault;
+	__u32 rx_lol;
+	__u32 tx_lol;
+	/* Indexed by LWARN, HWARN, LALRM and HALRM */
+	__u32 bias_cur_aw[4];
+	__u32 tx_power_aw[4];
+	__u32 rx_power_aw[4];
+};
+
+/* Location of a single status flag for lane 1 */
+struct sff_lane_bit {
+	unsigned int offset;
+	unsigned int shift;
+};
+
+enum sff_lane_aw_format {
+	/* SFF-8636: one nibble per lane (HALRM, LALRM, HWARN, LWARN from
+	 * MSB), two lanes per byte starting with lane 1 in the high nibble
+	 */
+	SFF_LANE_AW_NIBBLE,
+	/* CMIS: one byte per flag, one bit per lane */
+	SFF_LANE_AW_BITMAP,
+};
+
+/* Layout of the per-lane monitors and flags in a module memory map */
+struct sff_lane_layout {
+	unsigned int n_lanes;
+	/* Offsets of the lane 1 monitors; lane n is at offset + n * stride */
+	unsigned int stride;
+	unsigned int bias_cur_offset;
+	unsigned int tx_power_offset;
+	unsigned int rx_power_offset;
+	/* Offsets of alarm/warning flags, indexed like sff_lane_flags.
+	 * With SFF_LANE_AW_NIBBLE all four entries are the same byte.
+	 */
+	enum sff_lane_aw_format aw_format;
+	unsigned int bias_cur_aw[4];
+	unsigned int tx_power_aw[4];
+	unsigned int rx_power_aw[4];
+	/* Status flags are one bit per lane, starting at shift */
+	struct sff_lane_bit rx_los;
+	struct sff_lane_bit tx_los;
+	struct sff_lane_bit tx_fault;
+	struct sff_lane_bit rx_lol;
+	struct sff_lane_bit tx_lol;
+};
+
+/* Not used by -m yet: ETHTOOL_GMODULEEEPROM returns a flat image
+ * without CMIS banked pages, so page 11h cannot be read.  This is for a
+ * decoder that reads pages individually.
+ */
+extern const struct sff_lane_layout cmis_lane_layout;
+
+/* Module Monitoring Fields */
+struct sff_diags {
+
 	/* Supports DOM */
 	__u8 supports_dom;
 	/* Supports alarm/warning thold */
@@ -170,16 +256,49 @@ struct sff_diags {
 	__u16 tx_power[5];
 	/* Measured RX Power */
 	__u16 rx_power[5];
+	/* Number of valid entries in scd[] */
+	__u8 n_lanes;
 	struct sff_channel_diags scd[MAX_CHANNEL_NUM];
+	struct sff_lane_flags lane_flags;
+};
+
+/* SFF-8472 external calibration constants (A2h bytes 56-91) */
+struct sff8472_cal {
+	/* Slopes in unsigned 8.8 fixed point, offsets in raw units */
+	__u16 bias_slp, tx_pwr_slp, vcc_slp, temp_slp;
+	__s16 bias_off, tx_pwr_off, vcc_off, temp_off;
+	/* Rx power polynomial coefficients RX_PWR(0)..RX_PWR(4) */
+	float rx_pwr[5];
+};
+
+enum sff8472_cal_field {
+	SFF8472_CAL_BIAS,
+	SFF8472_CAL_TX_PWR,
+	SFF8472_CAL_VCC,
+	SFF8472_CAL_RX_PWR,
 };
 
 double convert_mw_to_dbm(double mw);
+void sff_dbm_table_init(void);
+double sff_raw_pwr_to_dbm(__u16 raw);
 void sff_show_value_with_unit(const __u8 *id, unsigned int reg,
 			      const char *name, unsigned int mult,
 			      const char *unit);
 void sff_show_ascii(const __u8 *id, unsigned int first_reg,
 		    unsigned int last_reg, const char *name);
 void sff_show_thresholds(struct sff_diags sd);
+void sff_lanes_parse(const __u8 *id, const struct sff_lane_layout *layout,
+		     struct sff_diags *sd);
+void sff_show_lane_status(const char *name, unsigned int n_lanes,
+			  __u32 value);
+void sff_show_lane_flags(const struct sff_diags *sd);
+
+void sff8472_cal_load(const __u8 *id, struct sff8472_cal *cal);
+void sff8472_cal_apply(const struct sff8472_cal *cal,
+		       enum sff8472_cal_field field,
+		       __u16 *samples, unsigned int n);
+void sff8472_cal_apply_temp(const struct sff8472_cal *cal,
+			    __s16 *samples, unsigned int n);
 
 void sff8024_show_oui(const __u8 *id, int id_offset);
 void sff8024_show_identifier(const __u8 *id, int id_offset);
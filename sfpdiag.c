@@ -124,9 +124,11 @@ static struct sff8472_aw_flags {
 #define A2_OFFSET_TO_U16(offset) \
 	(id[SFF_A2_BASE + (offset)] << 8 | id[SFF_A2_BASE + (offset) + 1])
 
-/* Calibration slope is a number between 0.0 included and 256.0 excluded. */
-#define A2_OFFSET_TO_SLP(offset) \
-	(id[SFF_A2_BASE + (offset)] + id[SFF_A2_BASE + (offset) + 1] / 256.)
+/*
+ * Calibration slope is a number between 0.0 included and 256.0 excluded,
+ * i.e. unsigned 8.8 fixed point.
+ */
+#define A2_OFFSET_TO_SLP(offset) A2_OFFSET_TO_U16(offset)
 
 /* Calibration offset is an integer from -32768 to 32767 */
 #define A2_OFFSET_TO_OFF(offset) \
@@ -188,40 +190,104 @@ static float befloattoh(const __u32 *source)
 	return converter.dst;
 }
 
-static void sff8472_calibration(const __u8 *id, struct sff_diags *sd)
+void sff8472_cal_load(const __u8 *id, struct sff8472_cal *cal)
 {
-	int i;
-	__u16 rx_reading;
+	cal->bias_slp = A2_OFFSET_TO_SLP(SFF_A2_CAL_TXI_SLP);
+	cal->tx_pwr_slp = A2_OFFSET_TO_SLP(SFF_A2_CAL_TXPWR_SLP);
+	cal->vcc_slp = A2_OFFSET_TO_SLP(SFF_A2_CAL_V_SLP);
+	cal->temp_slp = A2_OFFSET_TO_SLP(SFF_A2_CAL_T_SLP);
+
+	cal->bias_off = A2_OFFSET_TO_OFF(SFF_A2_CAL_TXI_OFF);
+	cal->tx_pwr_off = A2_OFFSET_TO_OFF(SFF_A2_CAL_TXPWR_OFF);
+	cal->vcc_off = A2_OFFSET_TO_OFF(SFF_A2_CAL_V_OFF);
+	cal->temp_off = A2_OFFSET_TO_OFF(SFF_A2_CAL_T_OFF);
+
+	cal->rx_pwr[0] = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR0);
+	cal->rx_pwr[1] = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR1);
+	cal->rx_pwr[2] = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR2);
+	cal->rx_pwr[3] = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR3);
+	cal->rx_pwr[4] = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR4);
+}
 
-	/* Calibration should occur for all values (threshold and current) */
-	for (i = 0; i < ARRAY_SIZE(sd->bias_cur); ++i) {
-		/*
-		 * Apply calibration formula 1 (Temp., Voltage, Bias, Tx Power)
-		 */
-		sd->bias_cur[i]    *= A2_OFFSET_TO_SLP(SFF_A2_CAL_TXI_SLP);
-		sd->tx_power[i]    *= A2_OFFSET_TO_SLP(SFF_A2_CAL_TXPWR_SLP);
-		sd->sfp_voltage[i] *= A2_OFFSET_TO_SLP(SFF_A2_CAL_V_SLP);
-		sd->sfp_temp[i]    *= A2_OFFSET_TO_SLP(SFF_A2_CAL_T_SLP);
+/*
+ * Apply calibration formula 1 (reading * slope + offset).  The slope
+ * has only 16 significant bits, so the product is exact in integer
+ * arithmetic and truncates exactly as the floating-point version did.
+ */
+static void sff8472_cal_apply_slope(__u16 *samples, unsigned int n,
+				    __u16 slp, __s16 off)
+{
+	unsigned int i;
 
-		sd->bias_cur[i]    += A2_OFFSET_TO_OFF(SFF_A2_CAL_TXI_OFF);
-		sd->tx_power[i]    += A2_OFFSET_TO_OFF(SFF_A2_CAL_TXPWR_OFF);
-		sd->sfp_voltage[i] += A2_OFFSET_TO_OFF(SFF_A2_CAL_V_OFF);
-		sd->sfp_temp[i]    += A2_OFFSET_TO_OFF(SFF_A2_CAL_T_OFF);
+	for (i = 0; i < n; i++)
+		samples[i] = (__u16)(((__u32)samples[i] * slp) >> 8) + off;
+}
 
+void sff8472_cal_apply(const struct sff8472_cal *cal,
+		       enum sff8472_cal_field field,
+		       __u16 *samples, unsigned int n)
+{
+	unsigned int i;
+	__u16 rx_reading;
+
+	switch (field) {
+	case SFF8472_CAL_BIAS:
+		sff8472_cal_apply_slope(samples, n,
+					cal->bias_slp, cal->bias_off);
+		break;
+	case SFF8472_CAL_TX_PWR:
+		sff8472_cal_apply_slope(samples, n,
+					cal->tx_pwr_slp, cal->tx_pwr_off);
+		break;
+	case SFF8472_CAL_VCC:
+		sff8472_cal_apply_slope(samples, n,
+					cal->vcc_slp, cal->vcc_off);
+		break;
+	case SFF8472_CAL_RX_PWR:
 		/*
-		 * Apply calibration formula 2 (Rx Power only)
+		 * Apply calibration formula 2 (Rx Power only).  This is
+		 * kept in single precision, in the same order of
+		 * operations as before, so that results are unchanged.
 		 */
-		rx_reading = sd->rx_power[i];
-		sd->rx_power[i]    = A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR0);
-		sd->rx_power[i]    += rx_reading *
-			A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR1);
-		sd->rx_power[i]    += rx_reading *
-			A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR2);
-		sd->rx_power[i]    += rx_reading *
-			A2_OFFSET_TO_RXPWRx(SFF_A2_CAL_RXPWR3);
+		for (i = 0; i < n; i++) {
+			rx_reading = samples[i];
+			samples[i] = cal->rx_pwr[0];
+			samples[i] += rx_reading * cal->rx_pwr[1];
+			samples[i] += rx_reading * cal->rx_pwr[2];
+			samples[i] += rx_reading * cal->rx_pwr[3];
+		}
+		break;
 	}
 }
 
+void sff8472_cal_apply_temp(const struct sff8472_cal *cal,
+			    __s16 *samples, unsigned int n)
+{
+	unsigned int i;
+
+	/* Signed division truncates toward zero, like the float cast */
+	for (i = 0; i < n; i++)
+		samples[i] = (__s16)((__s32)samples[i] * cal->temp_slp / 256) +
+			cal->temp_off;
+}
+
+static void sff8472_calibration(const __u8 *id, struct sff_diags *sd)
+{
+	struct sff8472_cal cal;
+
+	/* Calibration should occur for all values (threshold and current) */
+	sff8472_cal_load(id, &cal);
+	sff8472_cal_apply(&cal, SFF8472_CAL_BIAS,
+			  sd->bias_cur, ARRAY_SIZE(sd->bias_cur));
+	sff8472_cal_apply(&cal, SFF8472_CAL_TX_PWR,
+			  sd->tx_power, ARRAY_SIZE(sd->tx_power));
+	sff8472_cal_apply(&cal, SFF8472_CAL_VCC,
+			  sd->sfp_voltage, ARRAY_SIZE(sd->sfp_voltage));
+	sff8472_cal_apply_temp(&cal, sd->sfp_temp, ARRAY_SIZE(sd->sfp_temp));
+	sff8472_cal_apply(&cal, SFF8472_CAL_RX_PWR,
+			  sd->rx_power, ARRAY_SIZE(sd->rx_power));
+}
+
 static void sff8472_parse_eeprom(const __u8 *id, struct sff_diags *sd)
 {
 	sd->supports_dom = id[SFF_A0_DOM] & SFF_A0_DOM_IMPL;
@@ -111,17 +111,92 @@ static struct test_case {
 	{ 1, "-d devname raw foo" },
 	{ 1, "--register-dump devname file" },
 	{ 1, "-d devname foo" },
+	{ 0, "-d devname diff foo" },
+	{ 0, "--register-dump devname hex on diff foo" },
+	{ 1, "-d devname raw on diff foo" },
+	{ 1, "-d devname diff" },
+	{ 0, "-d devname watch 1" },
+	{ 0, "-d devname watch 0.01 regs 0x3c00,0x100-0x11c count 10" },
+	{ 0, "--register-dump devname watch 2 regs 4" },
+	{ 1, "-d devname watch 0" },
+	{ 1, "-d devname watch -1" },
+	{ 1, "-d devname watch foo" },
+	{ 1, "-d devname watch 1 regs 0x20-0x10" },
+	{ 1, "-d devname watch 1 regs 0x10,,0x20" },
+	{ 1, "-d devname watch 1 regs foo" },
+	{ 1, "-d devname watch 1 raw on" },
+	{ 1, "-d devname watch 1 diff foo" },
+	{ 0, "-d devname json on" },
+	{ 0, "-d devname select CTRL,STATUS.Link*" },
+	{ 0, "-d devname json on select RDT* diff foo" },
+	{ 1, "-d devname json on raw on" },
+	{ 1, "-d devname select CTRL watch 1" },
+	{ 1, "-d devname select CTRL hex on" },
+	{ 1, "-d devname select CTRL,,STATUS" },
+	{ 1, "-d devname select .Link" },
+	{ 1, "-d devname json" },
+	{ 0, "-d devname hex on ascii on squeeze off" },
+	{ 1, "-d devname ascii" },
+	{ 0, "-d devname split foo" },
+	{ 1, "-d devname split foo raw on" },
+	{ 1, "-d devname split foo diff bar" },
+	{ 1, "-d devname split" },
+	{ 0, "-d devname table RX_FILTER_TBL0 rows 0-255" },
+	{ 0, "-d devname table *FILTER*.RSS_EN" },
+	{ 0, "-d devname rows 16" },
+	{ 0, "-d devname table BUF_FULL_TBL split foo" },
+	{ 1, "-d devname table RX_FILTER_TBL0 hex on" },
+	{ 1, "-d devname table RX_FILTER_TBL0 json on" },
+	{ 1, "-d devname rows 0-15 diff foo" },
+	{ 1, "-d devname table .RSS_EN" },
+	{ 1, "-d devname table RX_FILTER_TBL0." },
+	{ 1, "-d devname rows 10-5" },
+	{ 1, "-d devname rows 1-2-3" },
+	{ 1, "-d devname rows foo" },
+	{ 0, "-d devname ports lan1,lan2,lan3" },
+	{ 0, "-d devname ports all" },
+	{ 1, "-d devname ports lan1,,lan2" },
+	{ 1, "-d devname ports lan1 hex on" },
+	{ 1, "-d devname ports all diff foo" },
+	{ 1, "-d devname ports" },
+	{ 1, "-d devname regs 0x10" },
+	{ 1, "-d devname count 10" },
 	{ 1, "-d" },
+	{ 75, "--diff /nonexistent/foo /nonexistent/bar" },
+	{ 75, "--diff /nonexistent/foo /nonexistent/bar driver ixgbe version 1" },
+	{ 75, "--diff /nonexistent/foo /nonexistent/bar json on" },
+	{ 75, "--diff /nonexistent/foo /nonexistent/bar driver igb "
+	  "version 1 select CTRL json on" },
+	{ 1, "--diff foo bar select CTRL" },
+	{ 1, "--diff foo bar driver igb hex on select CTRL" },
+	{ 1, "--diff foo bar version foo" },
+	{ 1, "--diff foo bar baz" },
+	{ 1, "--diff foo" },
+	{ 1, "--diff" },
+	{ 1, "--monitor devname 0123456789abcdefghij" },
 	{ 0, "-e devname" },
 	{ 0, "--eeprom-dump devname raw on offset 1 length 2" },
 	{ 1, "-e devname raw foo" },
 	{ 1, "--eeprom-dump devname offset foo" },
 	{ 1, "-e devname length" },
 	{ 1, "--eeprom-dump devname foo" },
+	{ 0, "-e devname file foo offset 16" },
+	{ 1, "-e devname file" },
+	{ 0, "-e devname ascii on squeeze on" },
+	{ 1, "-e devname squeeze foo" },
+	{ 0, "-e devname raw on chunk 4096 progress on" },
+	{ 0, "-e devname output foo resume on" },
+	{ 1, "-e devname chunk 0" },
+	{ 1, "-e devname resume on" },
+	{ 1, "-e devname file foo output bar" },
 	{ 1, "-e" },
 	{ 0, "-E devname" },
 	{ 0, "--change-eeprom devname magic 0x87654321 offset 0 value 1" },
 	{ 0, "-E devname magic 0x87654321 offset 0 length 2" },
+	{ 0, "-E devname magic 0x87654321 file foo verify on" },
+	{ 0, "-E devname file foo offset 16 length 8" },
+	{ 1, "-E devname file foo value 1" },
+	{ 1, "-E devname verify" },
 	{ 1, "-E" },
 	{ 0, "-r devname" },
 	{ 0, "--negotiate devname" },
@@ -224,6 +299,18 @@ static struct test_case {
 	{ 0, "--get-dump devname data filename" },
 	{ 0, "-w devname data filename" },
 	{ 1, "--get-dump devname data" },
+	{ 0, "-w devname data -" },
+	{ 0, "-w devname data filename mmap on" },
+	{ 0, "-w devname data filename mmap off compress off" },
+	{ 1, "-w devname data - mmap on" },
+	{ 1, "-w devname data filename mmap on compress on" },
+#ifdef HAVE_ZLIB
+	{ 0, "-w devname data - compress on" },
+#else
+	{ 1, "-w devname data - compress on" },
+#endif
+	{ 1, "-w devname data filename foo" },
+	{ 1, "-w devname data filename mmap" },
 	{ 1, "-w devname foo" },
 	{ 1, "-w" },
 	{ 0, "-W devname 1" },
@@ -255,6 +342,15 @@ static struct test_case {
 	{ 0, "-m devname hex off" },
 	{ 1, "-m devname hex on raw on" },
 	{ 0, "-m devname offset 4 length 6" },
+	{ 0, "-m devname cache on" },
+	{ 0, "--module-info devname cache off hex on" },
+	{ 1, "-m devname cache" },
+	{ 1, "-m devname cache foo" },
+	{ 1, "-m devname file /nonexistent/foo" },
+	{ 1, "-m devname file /dev/null" },
+	{ 1, "-m devname cache on file foo" },
+	{ 1, "-m devname file" },
+	{ 0, "-m devname hex on ascii on squeeze on" },
 	{ 1, "--show-eee" },
 	{ 0, "--show-eee devname" },
 	{ 1, "--show-eee devname foo" },
@@ -280,6 +376,19 @@ static struct test_case {
 	{ 1, "--set-fec devname encoding none" },
 	{ 1, "--set-fec devname auto" },
 	/* can't test --set-priv-flags yet */
+	{ 1, "--save devname" },
+	{ 1, "--save devname file1 file2" },
+	{ 1, "--restore devname" },
+	{ 1, "--restore devname /nonexistent" },
+	{ 1, "--batch" },
+	{ 1, "--batch file1 file2" },
+	{ 0, "--batch -" },
+	{ 0, "--trace --help" },
+	{ 0, "--trace --trace-file /dev/null --help" },
+	{ 1, "--trace" },
+	{ 1, "--trace-file" },
+	{ 1, "--trace-file /dev/null --trace-file /dev/null --help" },
+	{ 1, "--tracefoo --help" },
 	{ 0, "-h" },
 	{ 0, "--help" },
 	{ 0, "--version" },
@@ -288,7 +397,7 @@ static struct test_case {
 	{ 1, "-0" },
 };
 
-int send_ioctl(struct cmd_context *ctx, void *cmd)
+int ioctl_send(struct cmd_context *ctx, void *cmd)
 {
 	/* If we get this far then parsing succeeded */
 	test_exit(0);
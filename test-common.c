@@ -16,7 +16,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/fcntl.h>
+#include <sys/socket.h>
 #include <unistd.h>
+#include <linux/netlink.h>
 #define TEST_NO_WRAPPERS
 #include "internal.h"
 
@@ -54,17 +56,39 @@ static void list_del(struct list_head *entry)
 	for (pos = (head)->next, n = pos->next; pos != (head); \
 		pos = n, n = pos->next)
 
-/* Free memory at end of test */
+/* Free memory at end of test, counting allocations on the way */
+
+struct test_block {
+	struct list_head link;
+	size_t size;
+} __attribute__((aligned(16)));
 
 static struct list_head malloc_list = LIST_HEAD_INIT(malloc_list);
+struct test_alloc_stats test_alloc_stats;
+
+static void test_alloc_add(struct test_block *block, size_t size)
+{
+	block->size = size;
+	list_add(&block->link, &malloc_list);
+	test_alloc_stats.count++;
+	test_alloc_stats.bytes += size;
+	if (test_alloc_stats.bytes > test_alloc_stats.peak)
+		test_alloc_stats.peak = test_alloc_stats.bytes;
+}
+
+static void test_alloc_del(struct test_block *block)
+{
+	list_del(&block->link);
+	test_alloc_stats.bytes -= block->size;
+}
 
 void *test_malloc(size_t size)
 {
-	struct list_head *block = malloc(sizeof(*block) + size);
+	struct test_block *block = malloc(sizeof(*block) + size);
 
 	if (!block)
 		return NULL;
-	list_add(block, &malloc_list);
+	test_alloc_add(block, size);
 	return block + 1;
 }
 
@@ -89,28 +113,32 @@ char *test_strdup(const char *s)
 
 void test_free(void *ptr)
 {
-	struct list_head *block;
+	struct test_block *block;
 
 	if (!ptr)
 		return;
-	block = (struct list_head *)ptr - 1;
-	list_del(block);
+	block = (struct test_block *)ptr - 1;
+	test_alloc_del(block);
 	free(block);
 }
 
 void *test_realloc(void *ptr, size_t size)
 {
-	struct list_head *block = NULL;
+	struct test_block *block = NULL, *new;
 
 	if (ptr) {
-		block = (struct list_head *)ptr - 1;
-		list_del(block);
+		block = (struct test_block *)ptr - 1;
+		test_alloc_del(block);
 	}
-	block = realloc(block, sizeof(*block) + size);
-	if (!block)
+	new = realloc(block, sizeof(*block) + size);
+	if (!new) {
+		/* The old block is still allocated */
+		if (block)
+			test_alloc_add(block, block->size);
 		return NULL;
-	list_add(block, &malloc_list);
-	return block + 1;
+	}
+	test_alloc_add(new, size);
+	return new + 1;
 }
 
 static void test_free_all(void)
@@ -120,6 +148,7 @@ static void test_free_all(void)
 	list_for_each_safe(block, next, &malloc_list)
 		free(block);
 	init_list_head(&malloc_list);
+	test_alloc_stats.bytes = 0;
 }
 
 /* Close files at end of test */
@@ -161,29 +190,156 @@ int test_open(const char *pathname, int flag, ...)
 	return node->fd;
 }
 
-int test_socket(int domain, int type, int protocol)
+static int test_track_fd(int fd)
 {
 	struct file_node *node;
 
 	node = malloc(sizeof(*node));
-	if (!node)
-		return -1;
-
-	node->fd = socket(domain, type, protocol);
-	if (node->fd < 0) {
-		free(node);
+	if (!node) {
+		close(fd);
 		return -1;
 	}
 
+	node->fd = fd;
 	node->fh = NULL;
 	list_add(&node->link, &file_list);
-	return node->fd;
+	return fd;
+}
+
+/* Mock netlink sockets, each backed by a socket pair */
+
+#define TEST_NETLINK_MAX	4
+
+void (*test_netlink)(int reply_fd, const void *msg, size_t len);
+unsigned long test_syscalls;
+static struct test_netlink_sock {
+	int fd, peer_fd;
+	int protocol;
+	bool listening;		/* bound to or joined a multicast group */
+} test_netlink_socks[TEST_NETLINK_MAX];
+static unsigned int test_netlink_n;
+
+static struct test_netlink_sock *test_netlink_find(int fd)
+{
+	unsigned int i;
+
+	for (i = 0; fd >= 0 && i < test_netlink_n; i++)
+		if (test_netlink_socks[i].fd == fd)
+			return &test_netlink_socks[i];
+	return NULL;
+}
+
+static int test_netlink_socket(int protocol)
+{
+	struct test_netlink_sock *sock;
+	int fds[2];
+
+	if (!test_netlink) {
+		errno = EAFNOSUPPORT;
+		return -1;
+	}
+	if (test_netlink_n == TEST_NETLINK_MAX) {
+		errno = EMFILE;
+		return -1;
+	}
+	/* Sequenced, so that shutting down the peer ends the messages */
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds))
+		return -1;
+	if (test_track_fd(fds[1]) < 0) {
+		close(fds[0]);
+		return -1;
+	}
+	sock = &test_netlink_socks[test_netlink_n++];
+	sock->peer_fd = fds[1];
+	sock->protocol = protocol;
+	sock->listening = false;
+	sock->fd = test_track_fd(fds[0]);
+	return sock->fd;
+}
+
+int test_socket(int domain, int type, int protocol)
+{
+	int fd;
+
+	test_syscalls++;
+	if (domain == AF_NETLINK)
+		return test_netlink_socket(protocol);
+
+	fd = socket(domain, type, protocol);
+	if (fd < 0)
+		return -1;
+	return test_track_fd(fd);
+}
+
+int test_bind(int fd, const struct sockaddr *addr, socklen_t len)
+{
+	struct test_netlink_sock *sock = test_netlink_find(fd);
+
+	if (sock) {
+		sock->listening = ((const struct sockaddr_nl *)addr)->nl_groups;
+		return 0;
+	}
+	return bind(fd, addr, len);
+}
+
+int test_setsockopt(int fd, int level, int name, const void *val,
+		    socklen_t len)
+{
+	struct test_netlink_sock *sock = test_netlink_find(fd);
+
+	if (sock) {
+		if (level != SOL_NETLINK || name != NETLINK_ADD_MEMBERSHIP) {
+			errno = ENOPROTOOPT;
+			return -1;
+		}
+		sock->listening = true;
+		return 0;
+	}
+	return setsockopt(fd, level, name, val, len);
+}
+
+ssize_t test_send(int fd, const void *buf, size_t len, int flags)
+{
+	struct test_netlink_sock *sock = test_netlink_find(fd);
+
+	test_syscalls++;
+	if (sock) {
+		test_netlink(sock->peer_fd, buf, len);
+		return len;
+	}
+	return send(fd, buf, len, flags);
+}
+
+ssize_t test_recv(int fd, void *buf, size_t len, int flags)
+{
+	test_syscalls++;
+	return recv(fd, buf, len, flags);
+}
+
+void test_netlink_event(int protocol, const void *msg, size_t len)
+{
+	struct test_netlink_sock *sock;
+
+	for (sock = test_netlink_socks;
+	     sock < test_netlink_socks + test_netlink_n; sock++) {
+		if (sock->fd < 0 || sock->protocol != protocol ||
+		    !sock->listening)
+			continue;
+		if (msg)
+			send(sock->peer_fd, msg, len, 0);
+		else
+			shutdown(sock->peer_fd, SHUT_WR);
+	}
 }
 
 int test_close(int fd)
 {
 	struct list_head *head, *next;
 
+	struct test_netlink_sock *sock = test_netlink_find(fd);
+
+	if (sock)
+		sock->fd = -1;
 	if (fd >= 0) {
 		list_for_each_safe(head, next, &file_list) {
 			if (((struct file_node *)head)->fd == fd) {
@@ -238,6 +394,8 @@ static void test_close_all(void)
 	struct list_head *head, *next;
 	struct file_node *node;
 
+	test_netlink_n = 0;
+
 	list_for_each_safe(head, next, &file_list) {
 		node = (struct file_node *)head;
 		if (node->fh)
@@ -291,7 +449,10 @@ int test_ioctl(const struct cmd_expect *expect, void *cmd)
 	}
 }
 
-int test_cmdline(const char *args)
+/* Run ethtool with @args, writing its standard output to @output or,
+ * if NULL, discarding it
+ */
+int test_cmdline_output(const char *args, FILE *output)
 {
 	int argc, i;
 	char **argv;
@@ -332,16 +493,18 @@ int test_cmdline(const char *args)
 
 	fflush(NULL);
 	dup2(dev_null, STDIN_FILENO);
-	if (getenv("TEST_TEST_VERBOSE")) {
-		orig_stderr = stderr;
-	} else {
+	if (output || !getenv("TEST_TEST_VERBOSE")) {
 		orig_stdout_fd = dup(STDOUT_FILENO);
 		if (orig_stdout_fd < 0) {
 			perror("dup stdout");
 			rc = -1;
 			goto out;
 		}
-		dup2(dev_null, STDOUT_FILENO);
+		dup2(output ? fileno(output) : dev_null, STDOUT_FILENO);
+	}
+	if (getenv("TEST_TEST_VERBOSE")) {
+		orig_stderr = stderr;
+	} else {
 		orig_stderr_fd = dup(STDERR_FILENO);
 		if (orig_stderr_fd < 0) {
 			perror("dup stderr");
@@ -381,3 +544,8 @@ out:
 	test_close_all();
 	return rc;
 }
+
+int test_cmdline(const char *args)
+{
+	return test_cmdline_output(args, NULL);
+}
@@ -0,0 +1,280 @@
+/****************************************************************************
+ * Test cases for the ethtool query daemon
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#define TEST_NO_WRAPPERS
+#include "internal.h"
+#include "libethtool.h"
+#include "ethtoold.h"
+
+#define LINK_NWORDS	2	/* the simulated device's */
+
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	return fakenic_ioctl(ctx, cmd);
+}
+
+/* The simulated device in test-fakenic.c; "gone" does not exist */
+static int fake_send(struct ethtool_dev *dev, void *cmd)
+{
+	if (!strcmp(dev->ifr.ifr_name, "gone"))
+		return -ENODEV;
+	return fakenic_send(dev, cmd);
+}
+
+static int fake_nic_create(unsigned int n_stats)
+{
+	struct fakenic_config config = {
+		.n_stats = n_stats,
+		.n_queues = 8,
+		.n_rules = 16,
+		.indir_size = 128,
+	};
+
+	return fakenic_create(&config);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int client_connect(const struct sockaddr_un *addr)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd < 0 || connect(fd, (const struct sockaddr *)addr,
+			      sizeof(*addr))) {
+		perror("connect");
+		exit(1);
+	}
+	return fd;
+}
+
+static void send_request(int fd, unsigned int version, unsigned int op,
+			 __u32 arg, const char *devname)
+{
+	struct ethtoold_request req;
+
+	memset(&req, 0, sizeof(req));
+	req.version = version;
+	req.op = op;
+	req.arg = arg;
+	strcpy(req.devname, devname);
+	if (send(fd, &req, sizeof(req), 0) != sizeof(req)) {
+		perror("send");
+		exit(1);
+	}
+}
+
+/* Read a reply and return its status, or 1 if it is malformed */
+static int recv_reply(int fd, struct ethtoold_reply *reply, void *payload,
+		      size_t size)
+{
+	if (recv(fd, reply, sizeof(*reply), MSG_WAITALL) != sizeof(*reply) ||
+	    reply->version != ETHTOOLD_VERSION || reply->len > size ||
+	    (reply->len && recv(fd, payload, reply->len, MSG_WAITALL) !=
+	     reply->len))
+		return 1;
+	return reply->status;
+}
+
+int main(void)
+{
+	char names[8][ETH_GSTRING_LEN];
+	struct ethtoold_config cfg = { .refresh_s = 60, .send = fake_send };
+	struct ethtool_drvinfo drvinfo;
+	struct ethtoold_server *srv;
+	struct ethtoold_reply reply;
+	struct sockaddr_un addr;
+	struct rlimit limit, low;
+	struct {
+		struct ethtool_link_settings req;
+		__u32 masks[3 * LINK_NWORDS];
+	} link;
+	unsigned long requests;
+	__u32 generation;
+	__u64 stats[8];
+	int listen_fd, a, b, c;
+	double start;
+	int rc = 0;
+
+	if (fake_nic_create(3)) {
+		fprintf(stderr, "E: cannot create the device\n");
+		return 1;
+	}
+
+	/* An abstract socket, so nothing is left behind */
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1,
+		 "ethtoold-test-%d", (int)getpid());
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (listen_fd < 0 ||
+	    bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(listen_fd, 4)) {
+		perror("listen");
+		return 1;
+	}
+	srv = ethtoold_server_new(listen_fd, -1, &cfg);
+	a = client_connect(&addr);
+	b = client_connect(&addr);
+	ethtoold_server_poll(srv, 1000);
+
+	/* Requests that arrive together share one GSTATS; each read of
+	 * the device gives new values
+	 */
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STATS, 0, "eth0");
+	send_request(b, ETHTOOLD_VERSION, ETHTOOLD_STATS, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(a, &reply, stats, sizeof(stats)) ||
+	    reply.len != 3 * sizeof(__u64) || stats[2] != 3 ||
+	    recv_reply(b, &reply, stats, sizeof(stats)) ||
+	    reply.len != 3 * sizeof(__u64) || stats[2] != 3) {
+		fprintf(stderr, "E: statistics not shared\n");
+		rc = 1;
+	}
+	generation = reply.generation;
+
+	/* Names are read once and kept */
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STRINGS, ETH_SS_STATS,
+		     "eth0");
+	ethtoold_server_poll(srv, 1000);
+	requests = fakenic_io.requests;
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STRINGS, ETH_SS_STATS,
+		     "eth0");
+	ethtoold_server_poll(srv, 1000);
+	recv_reply(a, &reply, names, sizeof(names));
+	if (recv_reply(a, &reply, names, sizeof(names)) ||
+	    reply.len != 3 * ETH_GSTRING_LEN ||
+	    strcmp(names[1], "rx_queue_0_bytes") ||
+	    reply.generation != generation ||
+	    fakenic_io.requests != requests) {
+		fprintf(stderr, "E: wrong statistic names\n");
+		rc = 1;
+	}
+
+	/* A later round fetches again, and notices the new count */
+	fake_nic_create(5);
+	send_request(b, ETHTOOLD_VERSION, ETHTOOLD_STATS, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(b, &reply, stats, sizeof(stats)) ||
+	    reply.len != 5 * sizeof(__u64) || stats[4] != 5 ||
+	    reply.generation == generation) {
+		fprintf(stderr, "E: changed statistics not noticed\n");
+		rc = 1;
+	}
+
+	/* The link mode handshake is done only once */
+	requests = fakenic_io.requests;
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_LINK, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_LINK, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	recv_reply(a, &reply, &link, sizeof(link));
+	if (recv_reply(a, &reply, &link, sizeof(link)) ||
+	    reply.len != sizeof(link) || link.req.speed != SPEED_10000 ||
+	    link.masks[LINK_NWORDS] !=
+	    1U << ETHTOOL_LINK_MODE_10000baseSR_Full_BIT ||
+	    fakenic_io.requests - requests != 3) {
+		fprintf(stderr, "E: wrong link settings (%lu requests)\n",
+			fakenic_io.requests - requests);
+		rc = 1;
+	}
+
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_DRVINFO, 0, "gone");
+	send_request(b, ETHTOOLD_VERSION + 1, ETHTOOLD_DRVINFO, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(a, &reply, NULL, 0) != -ENODEV ||
+	    recv_reply(b, &reply, NULL, 0) != -EPROTO) {
+		fprintf(stderr, "E: bad requests not refused\n");
+		rc = 1;
+	}
+
+	/* Out of descriptors, a waiting connection is left alone until a
+	 * client goes away, instead of being retried in a busy loop
+	 */
+	c = socket(AF_UNIX, SOCK_STREAM, 0);
+	getrlimit(RLIMIT_NOFILE, &limit);
+	low = limit;
+	low.rlim_cur = dup(c);
+	close(low.rlim_cur);
+	if (c < 0 || setrlimit(RLIMIT_NOFILE, &low) ||
+	    connect(c, (const struct sockaddr *)&addr, sizeof(addr))) {
+		perror("connect");
+		return 1;
+	}
+	ethtoold_server_poll(srv, 1000);
+	start = now();
+	ethtoold_server_poll(srv, 200);
+	if (now() - start < 0.15) {
+		fprintf(stderr, "E: connection retried without a descriptor\n");
+		rc = 1;
+	}
+	close(a);
+	ethtoold_server_poll(srv, 1000);
+	ethtoold_server_poll(srv, 1000);
+	setrlimit(RLIMIT_NOFILE, &limit);
+	send_request(c, ETHTOOLD_VERSION, ETHTOOLD_DRVINFO, 0, "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(c, &reply, &drvinfo, sizeof(drvinfo)) ||
+	    strcmp(drvinfo.driver, "fakenic")) {
+		fprintf(stderr, "E: connection not accepted later\n");
+		rc = 1;
+	}
+
+	close(b);
+	close(c);
+	ethtoold_server_poll(srv, 1000);
+	ethtoold_server_free(srv);
+
+	/* Reloading a device that did not change keeps its generation */
+	cfg.refresh_s = 0;
+	srv = ethtoold_server_new(listen_fd, -1, &cfg);
+	a = client_connect(&addr);
+	ethtoold_server_poll(srv, 1000);
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STRINGS, ETH_SS_STATS,
+		     "eth0");
+	ethtoold_server_poll(srv, 1000);
+	recv_reply(a, &reply, names, sizeof(names));
+	generation = reply.generation;
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STRINGS, ETH_SS_STATS,
+		     "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(a, &reply, names, sizeof(names)) ||
+	    reply.generation != generation) {
+		fprintf(stderr, "E: generation changed on an idle reload\n");
+		rc = 1;
+	}
+	fake_nic_create(4);
+	send_request(a, ETHTOOLD_VERSION, ETHTOOLD_STRINGS, ETH_SS_STATS,
+		     "eth0");
+	ethtoold_server_poll(srv, 1000);
+	if (recv_reply(a, &reply, names, sizeof(names)) ||
+	    reply.len != 4 * ETH_GSTRING_LEN ||
+	    reply.generation == generation) {
+		fprintf(stderr, "E: changed device not reloaded\n");
+		rc = 1;
+	}
+	close(a);
+	ethtoold_server_poll(srv, 1000);
+	ethtoold_server_free(srv);
+	close(listen_fd);
+	fakenic_destroy();
+	return rc;
+}
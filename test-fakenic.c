@@ -0,0 +1,760 @@
+/****************************************************************************
+ * Simulated network device for the test harness
+ *
+ * Tests that run sequences of commands, and benchmarks, need a device
+ * whose state changes as commands are applied rather than a script of
+ * expected ioctls.  fakenic_ioctl() answers requests the way the kernel
+ * and a typical driver would, from state that lasts until the device is
+ * destroyed: string sets and statistics, features, link settings, rings,
+ * channels, device and per-queue coalescing, RX flow hashing and
+ * classification rules, the RSS indirection table and key, registers
+ * and a plug-in module EEPROM.  Anything else fails with EOPNOTSUPP.
+ *
+ * The state is allocated outside the test wrappers, so it is not freed
+ * when each command line finishes.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define TEST_NO_WRAPPERS
+#include "internal.h"
+#include "sff-common.h"
+
+#define FAKENIC_MAX_RING	4096
+#define FAKENIC_KEY_SIZE	40
+#define FAKENIC_FLOW_TYPES	32
+#define FAKENIC_LINK_NWORDS	2
+
+static const struct fakenic_config fakenic_defaults = {
+	.n_stats = 64,
+	.n_queues = 8,
+	.n_rules = 1024,
+	.indir_size = 128,
+	.regs_len = 256,
+	.module_type = ETH_MODULE_SFF_8472,
+};
+
+/* Named so that each legacy offload flag matches a feature */
+static const char *const fakenic_features[] = {
+	"tx-scatter-gather",
+	"tx-checksum-ipv4",
+	"tx-checksum-ip-generic",
+	"tx-checksum-ipv6",
+	"highdma",
+	"tx-scatter-gather-fraglist",
+	"tx-vlan-hw-insert",
+	"rx-vlan-hw-parse",
+	"rx-vlan-filter",
+	"vlan-challenged",
+	"tx-generic-segmentation",
+	"rx-gro",
+	"rx-lro",
+	"tx-tcp-segmentation",
+	"tx-tcp-ecn-segmentation",
+	"tx-tcp6-segmentation",
+	"tx-udp-fragmentation",
+	"rx-ntuple-filter",
+	"rx-hashing",
+	"rx-checksum",
+	"tx-nocache-copy",
+	"loopback",
+	"rx-fcs",
+	"rx-all",
+};
+
+#define FAKENIC_N_FEATURES	ARRAY_SIZE(fakenic_features)
+#define FAKENIC_FEATURE_WORDS	((FAKENIC_N_FEATURES + 31) / 32)
+
+/* highdma is always on and vlan-challenged always off */
+#define FAKENIC_FIXED_ON	(1U << 4)
+#define FAKENIC_FIXED		(FAKENIC_FIXED_ON | 1U << 9)
+#define FAKENIC_HW_FEATURES						\
+	(((1U << FAKENIC_N_FEATURES) - 1) & ~FAKENIC_FIXED)
+/* Everything but LRO, loopback and the receive debugging features */
+#define FAKENIC_DEFAULT_FEATURES					\
+	(FAKENIC_HW_FEATURES & ~(1U << 12 | 1U << 21 | 1U << 22 | 1U << 23))
+
+static const char *const fakenic_hfuncs[] = { "toeplitz", "xor", "crc32" };
+
+static const char *const fakenic_stat_kinds[] = {
+	"packets", "bytes", "drops", "csum_err",
+};
+
+struct fakenic {
+	struct fakenic_config config;
+	char *stat_names;
+	u64 stats_reads;
+	u32 features_wanted;
+	struct ethtool_link_settings link;
+	struct ethtool_ringparam ring;
+	struct ethtool_channels channels;
+	struct ethtool_coalesce *coalesce;	/* per queue */
+	u64 rxfh[FAKENIC_FLOW_TYPES];
+	struct ethtool_rx_flow_spec *rules;
+	u8 *rule_used;
+	u32 rule_cnt;
+	u32 *indir;
+	u8 key[FAKENIC_KEY_SIZE];
+	u8 hfunc;
+	u32 regs_reads;
+	u8 *module;
+};
+
+static struct fakenic *nic;
+
+static int fakenic_error(int err)
+{
+	errno = err;
+	return -1;
+}
+
+static void fakenic_default_indir(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < nic->config.indir_size; i++)
+		nic->indir[i] = i % nic->channels.combined_count;
+}
+
+/* A plausible image with identifiers, vendor strings and diagnostics */
+static void fakenic_fill_module(u8 *image, u32 type, unsigned int len)
+{
+	const char *vendor = "FAKENIC         ";
+	unsigned int base = 0;
+
+	memset(image, 0, len);
+	switch (type) {
+	case ETH_MODULE_SFF_8079:
+	case ETH_MODULE_SFF_8472:
+		image[0] = SFF8024_ID_SFP;
+		image[1] = 0x04;
+		image[2] = SFF8024_CTOR_LC;
+		if (len > 92)
+			image[92] = 0x68;	/* diagnostics, internal cal */
+		break;
+	default:
+		/* The serial ID fields are in upper page 00h */
+		image[0] = SFF8024_ID_QSFP28;
+		image[2] = 0x04;		/* flat memory */
+		base = 128;
+		if (len > base + 2) {
+			image[base] = SFF8024_ID_QSFP28;
+			image[base + 2] = SFF8024_CTOR_LC;
+		}
+		break;
+	}
+	if (len >= base + 36)
+		memcpy(image + base + 20, vendor, 16);
+	if (len >= base + 56)
+		memcpy(image + base + 40, "FN-10G-SR       ", 16);
+	if (len >= base + 84)
+		memcpy(image + base + 68, "FN000001        ", 16);
+}
+
+static unsigned int fakenic_module_len(u32 type)
+{
+	switch (type) {
+	case ETH_MODULE_SFF_8079:
+		return ETH_MODULE_SFF_8079_LEN;
+	case ETH_MODULE_SFF_8472:
+		return ETH_MODULE_SFF_8472_LEN;
+	case ETH_MODULE_SFF_8436:
+		return ETH_MODULE_SFF_8436_LEN;
+	default:
+		return ETH_MODULE_SFF_8636_LEN;
+	}
+}
+
+/* Create the device, or replace it; @config may be NULL for defaults */
+int fakenic_create(const struct fakenic_config *config)
+{
+	unsigned int i, module_len;
+
+	fakenic_destroy();
+	nic = calloc(1, sizeof(*nic));
+	if (!nic)
+		return -ENOMEM;
+	nic->config = config ? *config : fakenic_defaults;
+	config = &nic->config;
+	if (!config->n_queues || config->n_queues > MAX_NUM_QUEUE) {
+		fakenic_destroy();
+		return -EINVAL;
+	}
+	module_len = config->module_len ? config->module_len :
+		fakenic_module_len(config->module_type);
+
+	nic->stat_names = calloc(config->n_stats + 1, ETH_GSTRING_LEN);
+	nic->coalesce = calloc(config->n_queues, sizeof(nic->coalesce[0]));
+	nic->rules = calloc(config->n_rules + 1, sizeof(nic->rules[0]));
+	nic->rule_used = calloc(config->n_rules + 1, 1);
+	nic->indir = calloc(config->indir_size + 1, sizeof(nic->indir[0]));
+	nic->module = calloc(module_len + 1, 1);
+	if (!nic->stat_names || !nic->coalesce || !nic->rules ||
+	    !nic->rule_used || !nic->indir || !nic->module) {
+		fakenic_destroy();
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < config->n_stats; i++)
+		snprintf(nic->stat_names + i * ETH_GSTRING_LEN,
+			 ETH_GSTRING_LEN, "rx_queue_%u_%s",
+			 i / ARRAY_SIZE(fakenic_stat_kinds),
+			 fakenic_stat_kinds[i % ARRAY_SIZE(fakenic_stat_kinds)]);
+
+	nic->features_wanted = FAKENIC_DEFAULT_FEATURES;
+
+	nic->link.speed = SPEED_10000;
+	nic->link.duplex = DUPLEX_FULL;
+	nic->link.port = PORT_FIBRE;
+	nic->link.autoneg = AUTONEG_DISABLE;
+
+	nic->ring.rx_max_pending = FAKENIC_MAX_RING;
+	nic->ring.tx_max_pending = FAKENIC_MAX_RING;
+	nic->ring.rx_pending = 512;
+	nic->ring.tx_pending = 512;
+
+	nic->channels.max_combined = config->n_queues;
+	nic->channels.combined_count = config->n_queues;
+
+	for (i = 0; i < config->n_queues; i++) {
+		nic->coalesce[i].cmd = ETHTOOL_GCOALESCE;
+		nic->coalesce[i].rx_coalesce_usecs = 20;
+		nic->coalesce[i].rx_max_coalesced_frames = 32;
+		nic->coalesce[i].tx_coalesce_usecs = 40;
+		nic->coalesce[i].tx_max_coalesced_frames = 64;
+	}
+
+	for (i = 0; i < FAKENIC_FLOW_TYPES; i++)
+		nic->rxfh[i] = RXH_IP_SRC | RXH_IP_DST;
+	nic->rxfh[TCP_V4_FLOW] |= RXH_L4_B_0_1 | RXH_L4_B_2_3;
+	nic->rxfh[TCP_V6_FLOW] |= RXH_L4_B_0_1 | RXH_L4_B_2_3;
+
+	fakenic_default_indir();
+	for (i = 0; i < FAKENIC_KEY_SIZE; i++)
+		nic->key[i] = 0x6d + i * 0x5a;
+	nic->hfunc = 1 << 0;
+
+	if (config->module_type) {
+		nic->config.module_len = module_len;
+		if (config->module_image)
+			memcpy(nic->module, config->module_image, module_len);
+		else
+			fakenic_fill_module(nic->module, config->module_type,
+					    module_len);
+	}
+	/* The image belongs to the caller */
+	nic->config.module_image = NULL;
+	return 0;
+}
+
+void fakenic_destroy(void)
+{
+	if (!nic)
+		return;
+	free(nic->stat_names);
+	free(nic->coalesce);
+	free(nic->rules);
+	free(nic->rule_used);
+	free(nic->indir);
+	free(nic->module);
+	free(nic);
+	nic = NULL;
+}
+
+/* String sets */
+
+static u32 fakenic_sset_count(u32 set)
+{
+	switch (set) {
+	case ETH_SS_STATS:
+		return nic->config.n_stats;
+	case ETH_SS_FEATURES:
+		return FAKENIC_N_FEATURES;
+	case ETH_SS_RSS_HASH_FUNCS:
+		return ARRAY_SIZE(fakenic_hfuncs);
+	default:
+		return 0;
+	}
+}
+
+static int fakenic_gsset_info(struct ethtool_sset_info *info)
+{
+	u64 mask = 0;
+	unsigned int i, n = 0;
+
+	for (i = 0; i < 64; i++) {
+		if (!(info->sset_mask & (1ULL << i)) || !fakenic_sset_count(i))
+			continue;
+		mask |= 1ULL << i;
+		info->data[n++] = fakenic_sset_count(i);
+	}
+	info->sset_mask = mask;
+	return 0;
+}
+
+/* Like the kernel, write as many strings as the set has */
+static int fakenic_gstrings(struct ethtool_gstrings *strings)
+{
+	u32 i, count = fakenic_sset_count(strings->string_set);
+	char *name;
+
+	if (!count)
+		return fakenic_error(EOPNOTSUPP);
+	strings->len = count;
+	if (strings->string_set == ETH_SS_STATS) {
+		memcpy(strings->data, nic->stat_names, count * ETH_GSTRING_LEN);
+		return 0;
+	}
+	for (i = 0; i < count; i++) {
+		name = (char *)strings->data + i * ETH_GSTRING_LEN;
+		memset(name, 0, ETH_GSTRING_LEN);
+		strncpy(name, strings->string_set == ETH_SS_FEATURES ?
+			fakenic_features[i] : fakenic_hfuncs[i],
+			ETH_GSTRING_LEN - 1);
+	}
+	return 0;
+}
+
+/* Counters that advance with every read */
+static int fakenic_gstats(struct ethtool_stats *stats)
+{
+	u32 i;
+
+	nic->stats_reads++;
+	stats->n_stats = nic->config.n_stats;
+	for (i = 0; i < stats->n_stats; i++)
+		stats->data[i] = nic->stats_reads * (i + 1);
+	return 0;
+}
+
+/* Features */
+
+static u32 fakenic_active_features(void)
+{
+	return (nic->features_wanted & FAKENIC_HW_FEATURES) | FAKENIC_FIXED_ON;
+}
+
+static int fakenic_gfeatures(struct ethtool_gfeatures *features)
+{
+	u32 i, words = features->size;
+
+	if (words > FAKENIC_FEATURE_WORDS)
+		words = FAKENIC_FEATURE_WORDS;
+	features->size = FAKENIC_FEATURE_WORDS;
+	for (i = 0; i < words; i++) {
+		memset(&features->features[i], 0,
+		       sizeof(features->features[i]));
+		if (i)
+			continue;
+		features->features[0].available = FAKENIC_HW_FEATURES;
+		features->features[0].requested = nic->features_wanted;
+		features->features[0].active = fakenic_active_features();
+		features->features[0].never_changed = FAKENIC_FIXED;
+	}
+	return 0;
+}
+
+static int fakenic_sfeatures(struct ethtool_sfeatures *features)
+{
+	u32 valid, requested;
+	int ret = 0;
+
+	if (features->size != FAKENIC_FEATURE_WORDS)
+		return fakenic_error(EINVAL);
+	valid = features->features[0].valid;
+	requested = features->features[0].requested;
+	if (valid & ~((1U << FAKENIC_N_FEATURES) - 1))
+		return fakenic_error(EINVAL);
+	if (valid & ~FAKENIC_HW_FEATURES) {
+		valid &= FAKENIC_HW_FEATURES;
+		ret |= ETHTOOL_F_UNSUPPORTED;
+	}
+	nic->features_wanted = (nic->features_wanted & ~valid) |
+		(requested & valid);
+	return ret;
+}
+
+/* Link settings, with the kernel's handshake on the bitmap size */
+static int fakenic_glinksettings(struct ethtool_link_settings *link)
+{
+	u32 *masks = (u32 *)(link + 1);
+	int i;
+
+	if (link->link_mode_masks_nwords != FAKENIC_LINK_NWORDS) {
+		memset(link, 0, sizeof(*link));
+		link->cmd = ETHTOOL_GLINKSETTINGS;
+		link->link_mode_masks_nwords = -FAKENIC_LINK_NWORDS;
+		return 0;
+	}
+	*link = nic->link;
+	link->cmd = ETHTOOL_GLINKSETTINGS;
+	link->link_mode_masks_nwords = FAKENIC_LINK_NWORDS;
+	memset(masks, 0, 3 * FAKENIC_LINK_NWORDS * sizeof(u32));
+	/* supported and advertising */
+	for (i = 0; i < 2; i++)
+		masks[i * FAKENIC_LINK_NWORDS +
+		      ETHTOOL_LINK_MODE_10000baseSR_Full_BIT / 32] =
+			1U << ETHTOOL_LINK_MODE_10000baseSR_Full_BIT % 32;
+	return 0;
+}
+
+static int fakenic_slinksettings(const struct ethtool_link_settings *link)
+{
+	if (link->link_mode_masks_nwords != FAKENIC_LINK_NWORDS)
+		return fakenic_error(EINVAL);
+	if (link->speed != SPEED_10000 || link->duplex != DUPLEX_FULL)
+		return fakenic_error(EINVAL);
+	nic->link.autoneg = link->autoneg;
+	return 0;
+}
+
+/* Rings, channels and coalescing */
+
+static int fakenic_sringparam(const struct ethtool_ringparam *ring)
+{
+	if (ring->rx_pending > nic->ring.rx_max_pending ||
+	    ring->tx_pending > nic->ring.tx_max_pending ||
+	    ring->rx_mini_pending || ring->rx_jumbo_pending)
+		return fakenic_error(EINVAL);
+	nic->ring.rx_pending = ring->rx_pending;
+	nic->ring.tx_pending = ring->tx_pending;
+	return 0;
+}
+
+static int fakenic_schannels(const struct ethtool_channels *channels)
+{
+	if (channels->rx_count || channels->tx_count ||
+	    channels->other_count || !channels->combined_count ||
+	    channels->combined_count > nic->channels.max_combined)
+		return fakenic_error(EINVAL);
+	nic->channels.combined_count = channels->combined_count;
+	fakenic_default_indir();
+	return 0;
+}
+
+static void fakenic_set_coalesce(unsigned int queue,
+				 const struct ethtool_coalesce *coalesce)
+{
+	nic->coalesce[queue] = *coalesce;
+	nic->coalesce[queue].cmd = ETHTOOL_GCOALESCE;
+}
+
+static int fakenic_scoalesce(const struct ethtool_coalesce *coalesce)
+{
+	unsigned int i;
+
+	for (i = 0; i < nic->config.n_queues; i++)
+		fakenic_set_coalesce(i, coalesce);
+	return 0;
+}
+
+static int fakenic_perqueue(struct ethtool_per_queue_op *op)
+{
+	struct ethtool_coalesce *data = (struct ethtool_coalesce *)op->data;
+	unsigned int i;
+
+	if (op->sub_command != ETHTOOL_GCOALESCE &&
+	    op->sub_command != ETHTOOL_SCOALESCE)
+		return fakenic_error(EOPNOTSUPP);
+
+	for (i = 0; i < MAX_NUM_QUEUE; i++) {
+		if (!(op->queue_mask[i / 32] & (1U << i % 32)))
+			continue;
+		if (i >= nic->channels.combined_count)
+			return fakenic_error(EINVAL);
+		if (op->sub_command == ETHTOOL_GCOALESCE)
+			*data++ = nic->coalesce[i];
+		else
+			fakenic_set_coalesce(i, data++);
+	}
+	return 0;
+}
+
+/* RX flow hashing and classification */
+
+static int fakenic_rxnfc(struct ethtool_rxnfc *nfc)
+{
+	u32 flow_type = nfc->flow_type & ~FLOW_RSS;
+	u32 loc, i, n;
+
+	switch (nfc->cmd) {
+	case ETHTOOL_GRXRINGS:
+		nfc->data = nic->channels.combined_count;
+		return 0;
+	case ETHTOOL_GRXFH:
+	case ETHTOOL_SRXFH:
+		if (flow_type >= FAKENIC_FLOW_TYPES)
+			return fakenic_error(EINVAL);
+		if (nfc->cmd == ETHTOOL_GRXFH)
+			nfc->data = nic->rxfh[flow_type];
+		else
+			nic->rxfh[flow_type] = nfc->data;
+		return 0;
+	case ETHTOOL_GRXCLSRLCNT:
+		nfc->rule_cnt = nic->rule_cnt;
+		nfc->data = nic->config.n_rules;
+		if (nic->config.driver_select)
+			nfc->data |= RX_CLS_LOC_SPECIAL;
+		return 0;
+	case ETHTOOL_GRXCLSRLALL:
+		if (nfc->rule_cnt < nic->rule_cnt)
+			return fakenic_error(EMSGSIZE);
+		for (loc = 0, n = 0; loc < nic->config.n_rules; loc++)
+			if (nic->rule_used[loc])
+				nfc->rule_locs[n++] = loc;
+		nfc->rule_cnt = n;
+		nfc->data = nic->config.n_rules;
+		return 0;
+	case ETHTOOL_GRXCLSRULE:
+		loc = nfc->fs.location;
+		if (loc >= nic->config.n_rules || !nic->rule_used[loc])
+			return fakenic_error(ENOENT);
+		nfc->fs = nic->rules[loc];
+		return 0;
+	case ETHTOOL_SRXCLSRLINS:
+		loc = nfc->fs.location;
+		if (loc & RX_CLS_LOC_SPECIAL) {
+			if (!nic->config.driver_select ||
+			    (loc != RX_CLS_LOC_ANY && loc != RX_CLS_LOC_FIRST &&
+			     loc != RX_CLS_LOC_LAST))
+				return fakenic_error(EINVAL);
+			for (i = 0; i < nic->config.n_rules; i++) {
+				n = loc == RX_CLS_LOC_LAST ?
+					nic->config.n_rules - 1 - i : i;
+				if (!nic->rule_used[n])
+					break;
+			}
+			if (i == nic->config.n_rules)
+				return fakenic_error(ENOSPC);
+			loc = n;
+		} else if (loc >= nic->config.n_rules) {
+			return fakenic_error(EINVAL);
+		}
+		if (nfc->fs.ring_cookie != RX_CLS_FLOW_DISC &&
+		    ethtool_get_flow_spec_ring(nfc->fs.ring_cookie) >=
+		    nic->channels.combined_count)
+			return fakenic_error(EINVAL);
+		nfc->fs.location = loc;
+		if (!nic->rule_used[loc])
+			nic->rule_cnt++;
+		nic->rule_used[loc] = 1;
+		nic->rules[loc] = nfc->fs;
+		return 0;
+	case ETHTOOL_SRXCLSRLDEL:
+		loc = nfc->fs.location;
+		if (loc >= nic->config.n_rules || !nic->rule_used[loc])
+			return fakenic_error(ENOENT);
+		nic->rule_used[loc] = 0;
+		nic->rule_cnt--;
+		return 0;
+	default:
+		return fakenic_error(EOPNOTSUPP);
+	}
+}
+
+/* RSS indirection table and key */
+
+static int fakenic_grssh(struct ethtool_rxfh *rxfh)
+{
+	u32 indir_size = rxfh->indir_size, key_size = rxfh->key_size;
+
+	if (rxfh->rss_context)
+		return fakenic_error(EOPNOTSUPP);
+	if ((indir_size && indir_size != nic->config.indir_size) ||
+	    (key_size && key_size != FAKENIC_KEY_SIZE))
+		return fakenic_error(EINVAL);
+	rxfh->indir_size = nic->config.indir_size;
+	rxfh->key_size = FAKENIC_KEY_SIZE;
+	rxfh->hfunc = nic->hfunc;
+	if (indir_size)
+		memcpy(rxfh->rss_config, nic->indir,
+		       indir_size * sizeof(u32));
+	if (key_size)
+		memcpy(rxfh->rss_config + indir_size, nic->key, key_size);
+	return 0;
+}
+
+static int fakenic_srssh(const struct ethtool_rxfh *rxfh)
+{
+	u32 indir_size = rxfh->indir_size, key_size = rxfh->key_size;
+	u32 indir_words, i;
+
+	if (rxfh->rss_context)
+		return fakenic_error(EOPNOTSUPP);
+	if ((indir_size && indir_size != ETH_RXFH_INDIR_NO_CHANGE &&
+	     indir_size != nic->config.indir_size) ||
+	    (key_size && key_size != FAKENIC_KEY_SIZE))
+		return fakenic_error(EINVAL);
+	if (rxfh->hfunc & ~((1U << ARRAY_SIZE(fakenic_hfuncs)) - 1))
+		return fakenic_error(EOPNOTSUPP);
+
+	indir_words = indir_size == ETH_RXFH_INDIR_NO_CHANGE ? 0 : indir_size;
+	for (i = 0; i < indir_words; i++)
+		if (rxfh->rss_config[i] >= nic->channels.combined_count)
+			return fakenic_error(EINVAL);
+
+	if (indir_size == 0)
+		fakenic_default_indir();
+	else if (indir_words)
+		memcpy(nic->indir, rxfh->rss_config, indir_words * sizeof(u32));
+	if (key_size)
+		memcpy(nic->key, rxfh->rss_config + indir_words, key_size);
+	if (rxfh->hfunc)
+		nic->hfunc = rxfh->hfunc;
+	return 0;
+}
+
+/* Registers, one of which counts reads so that watchers see changes */
+static int fakenic_gregs(struct ethtool_regs *regs)
+{
+	u32 i, word;
+
+	if (regs->len > nic->config.regs_len)
+		regs->len = nic->config.regs_len;
+	regs->version = 1;
+	nic->regs_reads++;
+	for (i = 0; i < regs->len; i++) {
+		word = i / 4 ? (i / 4) * 0x01010101 : nic->regs_reads;
+		regs->data[i] = word >> (i % 4 * 8);
+	}
+	return 0;
+}
+
+static int fakenic_module_eeprom(struct ethtool_eeprom *eeprom)
+{
+	if (!nic->config.module_type)
+		return fakenic_error(EOPNOTSUPP);
+	if (eeprom->len == 0 || eeprom->offset > nic->config.module_len ||
+	    eeprom->len > nic->config.module_len - eeprom->offset)
+		return fakenic_error(EINVAL);
+	memcpy(eeprom->data, nic->module + eeprom->offset, eeprom->len);
+	return 0;
+}
+
+static void fakenic_delay(void)
+{
+	struct timespec ts;
+
+	if (!nic->config.latency_us)
+		return;
+	ts.tv_sec = nic->config.latency_us / 1000000;
+	ts.tv_nsec = nic->config.latency_us % 1000000 * 1000;
+	while (nanosleep(&ts, &ts) && errno == EINTR)
+		;
+}
+
+static int fakenic_request(void *cmd)
+{
+	struct ethtool_drvinfo *drvinfo;
+	struct ethtool_modinfo *modinfo;
+
+	switch (*(u32 *)cmd) {
+	case ETHTOOL_GDRVINFO:
+		drvinfo = cmd;
+		memset(drvinfo, 0, sizeof(*drvinfo));
+		drvinfo->cmd = ETHTOOL_GDRVINFO;
+		strcpy(drvinfo->driver, "fakenic");
+		strcpy(drvinfo->version, "1.0");
+		strcpy(drvinfo->fw_version, "1.0.0");
+		strcpy(drvinfo->bus_info, "fake:00");
+		drvinfo->n_stats = nic->config.n_stats;
+		drvinfo->regdump_len = nic->config.regs_len;
+		return 0;
+	case ETHTOOL_GSSET_INFO:
+		return fakenic_gsset_info(cmd);
+	case ETHTOOL_GSTRINGS:
+		return fakenic_gstrings(cmd);
+	case ETHTOOL_GSTATS:
+		return fakenic_gstats(cmd);
+	case ETHTOOL_GFEATURES:
+		return fakenic_gfeatures(cmd);
+	case ETHTOOL_SFEATURES:
+		return fakenic_sfeatures(cmd);
+	case ETHTOOL_GLINK:
+		((struct ethtool_value *)cmd)->data = 1;
+		return 0;
+	case ETHTOOL_GLINKSETTINGS:
+		return fakenic_glinksettings(cmd);
+	case ETHTOOL_SLINKSETTINGS:
+		return fakenic_slinksettings(cmd);
+	case ETHTOOL_GRINGPARAM:
+		*(struct ethtool_ringparam *)cmd = nic->ring;
+		((struct ethtool_ringparam *)cmd)->cmd = ETHTOOL_GRINGPARAM;
+		return 0;
+	case ETHTOOL_SRINGPARAM:
+		return fakenic_sringparam(cmd);
+	case ETHTOOL_GCHANNELS:
+		*(struct ethtool_channels *)cmd = nic->channels;
+		((struct ethtool_channels *)cmd)->cmd = ETHTOOL_GCHANNELS;
+		return 0;
+	case ETHTOOL_SCHANNELS:
+		return fakenic_schannels(cmd);
+	case ETHTOOL_GCOALESCE:
+		*(struct ethtool_coalesce *)cmd = nic->coalesce[0];
+		return 0;
+	case ETHTOOL_SCOALESCE:
+		return fakenic_scoalesce(cmd);
+	case ETHTOOL_PERQUEUE:
+		return fakenic_perqueue(cmd);
+	case ETHTOOL_GRXRINGS:
+	case ETHTOOL_GRXFH:
+	case ETHTOOL_SRXFH:
+	case ETHTOOL_GRXCLSRLCNT:
+	case ETHTOOL_GRXCLSRLALL:
+	case ETHTOOL_GRXCLSRULE:
+	case ETHTOOL_SRXCLSRLINS:
+	case ETHTOOL_SRXCLSRLDEL:
+		return fakenic_rxnfc(cmd);
+	case ETHTOOL_GRSSH:
+		return fakenic_grssh(cmd);
+	case ETHTOOL_SRSSH:
+		return fakenic_srssh(cmd);
+	case ETHTOOL_GREGS:
+		return fakenic_gregs(cmd);
+	case ETHTOOL_GMODULEINFO:
+		if (!nic->config.module_type)
+			return fakenic_error(EOPNOTSUPP);
+		modinfo = cmd;
+		modinfo->type = nic->config.module_type;
+		modinfo->eeprom_len = nic->config.module_len;
+		return 0;
+	case ETHTOOL_GMODULEEEPROM:
+		return fakenic_module_eeprom(cmd);
+	default:
+		return fakenic_error(EOPNOTSUPP);
+	}
+}
+
+struct fakenic_io fakenic_io;
+
+/*
+ * Handle a request as ioctl() would, returning 0 or a positive value on
+ * success and -1 with errno set on failure.  Tests may call this
+ * directly to inspect the device.
+ */
+int fakenic_ioctl(struct cmd_context *ctx maybe_unused, void *cmd)
+{
+	int rc;
+
+	if (!nic)
+		return fakenic_error(ENODEV);
+	fakenic_delay();
+
+	rc = fakenic_request(cmd);
+	fakenic_io.requests++;
+	fakenic_io.bytes += request_size(cmd, rc < 0);
+	return rc;
+}
+
+/* Requests from the library, which returns a negative errno instead */
+int fakenic_send(struct ethtool_dev *dev maybe_unused, void *cmd)
+{
+	return fakenic_ioctl(NULL, cmd) < 0 ? -errno : 0;
+}
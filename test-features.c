@@ -286,14 +286,6 @@ static const struct cmd_expect cmd_expect_get_features_min_off[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ 0, 0, 0, 0, 0 }
@@ -304,24 +296,18 @@ static const struct cmd_expect cmd_expect_get_features_max_on[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_on, 4, 0, &cmd_grxcsum_on, sizeof(cmd_grxcsum_on) },
-	{ &cmd_gtxcsum_on, 4, 0, &cmd_gtxcsum_on, sizeof(cmd_gtxcsum_on) },
-	{ &cmd_gsg_on, 4, 0, &cmd_gsg_on, sizeof(cmd_gsg_on) },
-	{ &cmd_gtso_on, 4, 0, &cmd_gtso_on, sizeof(cmd_gtso_on) },
-	{ &cmd_gufo_on, 4, 0, &cmd_gufo_on, sizeof(cmd_gufo_on) },
-	{ &cmd_ggso_on, 4, 0, &cmd_ggso_on, sizeof(cmd_ggso_on) },
-	{ &cmd_ggro_on, 4,0, &cmd_ggro_on, sizeof(cmd_ggro_on) },
-	{ &cmd_gflags_on, 4, 0, &cmd_gflags_on, sizeof(cmd_sflags_on) },
 	{ &cmd_gfeatures_max_on, sizeof(cmd_gfeatures_max_on.cmd),
 	  0, &cmd_gfeatures_max_on, sizeof(cmd_gfeatures_max_on) },
 	{ 0, 0, 0, 0, 0 }
 };
 
-static const struct cmd_expect cmd_expect_set_features_min_off_min_on[] = {
+/* Fall back to the legacy offload flags if GFEATURES fails */
+static const struct cmd_expect cmd_expect_get_features_no_gfeatures[] = {
 	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd), -EIO },
 	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
 	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
 	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
@@ -330,18 +316,18 @@ static const struct cmd_expect cmd_expect_set_features_min_off_min_on[] = {
 	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
 	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
 	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_set_features_min_off_min_on[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ &cmd_sfeatures_min_on, sizeof(cmd_sfeatures_min_on),
 	  ETHTOOL_F_WISH, 0, 0 },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_on, 4,0, &cmd_ggro_on, sizeof(cmd_ggro_on) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on.cmd),
 	  0, &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on) },
 	{ 0, 0, 0, 0, 0 }
@@ -352,25 +338,9 @@ static const struct cmd_expect cmd_expect_set_features_min_off_min_off[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ &cmd_sfeatures_min_off, sizeof(cmd_sfeatures_min_off), 0, 0, 0 },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ 0, 0, 0, 0, 0 }
@@ -381,25 +351,9 @@ static const struct cmd_expect cmd_expect_set_features_min_on_min_off[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_on, 4,0, &cmd_ggro_on, sizeof(cmd_ggro_on) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on.cmd),
 	  0, &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on) },
 	{ &cmd_sfeatures_min_off, sizeof(cmd_sfeatures_min_off), 0, 0, 0 },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ 0, 0, 0, 0, 0 }
@@ -410,25 +364,9 @@ static const struct cmd_expect cmd_expect_set_features_min_off_unsup_on[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ &cmd_sfeatures_noop, sizeof(cmd_sfeatures_noop), 0, 0, 0 },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
 	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
 	{ 0, 0, 0, 0, 0 }
@@ -439,30 +377,103 @@ static const struct cmd_expect cmd_expect_set_features_ipv4_off_many_on[] = {
 	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
 	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
 	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
-	{ &cmd_grxcsum_off, 4, 0, &cmd_grxcsum_off, sizeof(cmd_grxcsum_off) },
-	{ &cmd_gtxcsum_off, 4, 0, &cmd_gtxcsum_off, sizeof(cmd_gtxcsum_off) },
-	{ &cmd_gsg_off, 4, 0, &cmd_gsg_off, sizeof(cmd_gsg_off) },
-	{ &cmd_gtso_off, 4, 0, &cmd_gtso_off, sizeof(cmd_gtso_off) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_off, 4, 0, &cmd_ggso_off, sizeof(cmd_ggso_off) },
-	{ &cmd_ggro_off, 4,0, &cmd_ggro_off, sizeof(cmd_ggro_off) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_ipv4_off, sizeof(cmd_gfeatures_ipv4_off.cmd),
 	  0, &cmd_gfeatures_ipv4_off, sizeof(cmd_gfeatures_ipv4_off) },
 	{ &cmd_sfeatures_ipv4_on, sizeof(cmd_sfeatures_ipv4_on), 0, 0, 0 },
-	{ &cmd_grxcsum_on, 4, 0, &cmd_grxcsum_on, sizeof(cmd_grxcsum_on) },
-	{ &cmd_gtxcsum_on, 4, 0, &cmd_gtxcsum_on, sizeof(cmd_gtxcsum_on) },
-	{ &cmd_gsg_on, 4, 0, &cmd_gsg_on, sizeof(cmd_gsg_on) },
-	{ &cmd_gtso_on, 4, 0, &cmd_gtso_on, sizeof(cmd_gtso_on) },
-	{ &cmd_gufo_off, 4, 0, &cmd_gufo_off, sizeof(cmd_gufo_off) },
-	{ &cmd_ggso_on, 4, 0, &cmd_ggso_on, sizeof(cmd_ggso_on) },
-	{ &cmd_ggro_on, 4,0, &cmd_ggro_on, sizeof(cmd_ggro_on) },
-	{ &cmd_gflags_off, 4, 0, &cmd_gflags_off, sizeof(cmd_gflags_off) },
 	{ &cmd_gfeatures_ipv4_on, sizeof(cmd_gfeatures_ipv4_on.cmd),
 	  0, &cmd_gfeatures_ipv4_on, sizeof(cmd_gfeatures_ipv4_on) },
 	{ 0, 0, 0, 0, 0 }
 };
 
+/* A batch fetches the feature names only for its first device */
+#define BATCH_FILE "test-features.batch"
+static const char batch_commands[] =
+	"# legacy names, then kernel names\n"
+	"-K dev1 gso on gro on\n"
+	"\n"
+	"-K dev2 tx-generic-segmentation off rx-gro off\n";
+
+static const struct cmd_expect cmd_expect_set_features_batch[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ &cmd_sfeatures_min_on, sizeof(cmd_sfeatures_min_on),
+	  ETHTOOL_F_WISH, 0, 0 },
+	{ &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on.cmd),
+	  0, &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on) },
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on.cmd),
+	  0, &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on) },
+	{ &cmd_sfeatures_min_off, sizeof(cmd_sfeatures_min_off), 0, 0, 0 },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ 0, 0, 0, 0, 0 }
+};
+
+/* Restoring changes only the features that differ */
+#define RESTORE_FILE "test-features.restore"
+static const char restore_settings[] =
+	"features rx-gro on tx-generic-segmentation on tx-lockless off\n";
+#define RESTORE_BAD_FILE "test-features-bad.restore"
+static const char restore_bad_settings[] =
+	"features rx-gro maybe\n";
+
+static const struct cmd_expect cmd_expect_restore_features[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ &cmd_sfeatures_min_on, sizeof(cmd_sfeatures_min_on), 0, 0, 0 },
+	{ 0, 0, 0, 0, 0 }
+};
+
+/* GSO does not change, so GRO is put back */
+static const struct cmd_expect cmd_expect_restore_features_part[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ &cmd_sfeatures_min_on, sizeof(cmd_sfeatures_min_on),
+	  ETHTOOL_F_WISH, 0, 0 },
+	{ &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on.cmd),
+	  0, &cmd_gfeatures_min_on, sizeof(cmd_gfeatures_min_on) },
+	{ &cmd_sfeatures_min_off, sizeof(cmd_sfeatures_min_off), 0, 0, 0 },
+	{ 0, 0, 0, 0, 0 }
+};
+
+/* Nothing changes, so there is nothing to put back */
+static const struct cmd_expect cmd_expect_restore_features_none[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ &cmd_sfeatures_min_on, sizeof(cmd_sfeatures_min_on),
+	  ETHTOOL_F_WISH, 0, 0 },
+	{ &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off.cmd),
+	  0, &cmd_gfeatures_min_off, sizeof(cmd_gfeatures_min_off) },
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_restore_features_same[] = {
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd),
+	  0, &cmd_gssetinfo, sizeof(cmd_gssetinfo) },
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd),
+	  0, &cmd_gstrings, sizeof(cmd_gstrings) },
+	{ &cmd_gfeatures_max_on, sizeof(cmd_gfeatures_max_on.cmd),
+	  0, &cmd_gfeatures_max_on, sizeof(cmd_gfeatures_max_on) },
+	{ 0, 0, 0, 0, 0 }
+};
+
 static struct test_case {
 	int rc;
 	const char *args;
@@ -478,6 +489,7 @@ static struct test_case {
 	{ 1, "-K devname tx on sg on", cmd_expect_set_features_unsup_on_old },
 	{ 0, "--show-offload devname", cmd_expect_get_features_min_off },
 	{ 0, "--show-features devname", cmd_expect_get_features_max_on },
+	{ 0, "-k devname", cmd_expect_get_features_no_gfeatures },
 	{ 0, "-K devname rx on tx on sg on tso on ufo on gso on gro on",
 	  cmd_expect_set_features_min_off_min_on },
 	{ 0, "-K devname rx off tx off sg off tso off ufo off gso off gro off",
@@ -494,12 +506,21 @@ static struct test_case {
 	{ 1, "--features devname rx", cmd_expect_get_strings },
 	{ 1, "--features devname foo on", cmd_expect_get_strings_old },
 	{ 1, "--offload devname foo on", cmd_expect_get_strings },
+	{ 0, "--batch " BATCH_FILE, cmd_expect_set_features_batch },
+	{ 0, "--restore devname " RESTORE_FILE, cmd_expect_restore_features },
+	{ 1, "--restore devname " RESTORE_FILE,
+	  cmd_expect_restore_features_part },
+	{ 1, "--restore devname " RESTORE_FILE,
+	  cmd_expect_restore_features_none },
+	{ 1, "--restore devname " RESTORE_BAD_FILE, cmd_expect_get_strings },
+	{ 0, "--restore devname " RESTORE_FILE,
+	  cmd_expect_restore_features_same },
 };
 
 static int expect_matched;
 static const struct cmd_expect *expect_next;
 
-int send_ioctl(struct cmd_context *ctx, void *cmd)
+int ioctl_send(struct cmd_context *ctx, void *cmd)
 {
 	int rc = test_ioctl(expect_next, cmd);
 
@@ -511,12 +532,28 @@ int send_ioctl(struct cmd_context *ctx, void *cmd)
 	return rc;
 }
 
+static int write_file(const char *name, const char *contents)
+{
+	FILE *file = fopen(name, "w");
+
+	if (!file || fputs(contents, file) < 0 || fclose(file)) {
+		perror(name);
+		return 1;
+	}
+	return 0;
+}
+
 int main(void)
 {
 	const struct test_case *tc;
 	int test_rc;
 	int rc = 0;
 
+	if (write_file(BATCH_FILE, batch_commands) ||
+	    write_file(RESTORE_FILE, restore_settings) ||
+	    write_file(RESTORE_BAD_FILE, restore_bad_settings))
+		return 1;
+
 	for (tc = test_cases; tc < test_cases + ARRAY_SIZE(test_cases); tc++) {
 		if (getenv("ETHTOOL_TEST_VERBOSE"))
 			printf("I: Test command line: ethtool %s\n", tc->args);
@@ -540,5 +577,8 @@ int main(void)
 		}
 	}
 
+	remove(BATCH_FILE);
+	remove(RESTORE_FILE);
+	remove(RESTORE_BAD_FILE);
 	return rc;
 }
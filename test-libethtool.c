@@ -0,0 +1,182 @@
+/****************************************************************************
+ * Test cases for libethtool
+ *
+ * The test is linked with the library alone and uses only its public
+ * header, as a program built against the installed library would.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libethtool.h"
+
+#define N_STATS		3
+#define LINK_NWORDS	3
+#define INDIR_SIZE	4
+#define KEY_SIZE	5
+#define RULE_LOC	5
+
+static unsigned int requests;
+
+/* Answers requests as a device with a few statistics, RSS and one rule */
+static int fake_send(struct ethtool_dev *dev, void *cmd)
+{
+	struct ethtool_link_settings *link = cmd;
+	struct ethtool_sset_info *sset_info = cmd;
+	struct ethtool_gstrings *strings = cmd;
+	struct ethtool_stats *stats = cmd;
+	struct ethtool_rxfh *rss = cmd;
+	struct ethtool_rxnfc *nfc = cmd;
+	unsigned int i;
+
+	requests++;
+
+	switch (*(__u32 *)cmd) {
+	case ETHTOOL_GSSET_INFO:
+		if (sset_info->sset_mask != 1ULL << ETH_SS_STATS)
+			return -EOPNOTSUPP;
+		sset_info->data[0] = N_STATS;
+		return 0;
+	case ETHTOOL_GSTRINGS:
+		if (strings->len != N_STATS)
+			return -EINVAL;
+		for (i = 0; i < N_STATS; i++)
+			snprintf((char *)strings->data + i * ETH_GSTRING_LEN,
+				 ETH_GSTRING_LEN, "stat_%u", i);
+		return 0;
+	case ETHTOOL_GSTATS:
+		for (i = 0; i < stats->n_stats; i++)
+			stats->data[i] = 100 + i;
+		return 0;
+	case ETHTOOL_GLINKSETTINGS:
+		if (link->link_mode_masks_nwords != LINK_NWORDS) {
+			link->link_mode_masks_nwords = -LINK_NWORDS;
+			return 0;
+		}
+		link->speed = 25000;
+		for (i = 0; i < 3 * LINK_NWORDS; i++)
+			link->link_mode_masks[i] = i + 1;
+		return 0;
+	case ETHTOOL_GRSSH:
+		if (!rss->indir_size && !rss->key_size) {
+			rss->indir_size = INDIR_SIZE;
+			rss->key_size = KEY_SIZE;
+			return 0;
+		}
+		for (i = 0; i < INDIR_SIZE; i++)
+			rss->rss_config[i] = i % 2;
+		memset(rss->rss_config + INDIR_SIZE, 0x6d, KEY_SIZE);
+		return 0;
+	case ETHTOOL_GRXCLSRLCNT:
+		nfc->rule_cnt = 1;
+		nfc->data = 16;
+		return 0;
+	case ETHTOOL_GRXCLSRLALL:
+		if (nfc->rule_cnt < 1)
+			return -EMSGSIZE;
+		nfc->rule_cnt = 1;
+		nfc->rule_locs[0] = RULE_LOC;
+		return 0;
+	case ETHTOOL_GRXCLSRULE:
+		if (nfc->fs.location != RULE_LOC)
+			return -ENOENT;
+		nfc->fs.flow_type = TCP_V4_FLOW;
+		nfc->fs.ring_cookie = 1;
+		return 0;
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+int main(void)
+{
+	char names[N_STATS][ETH_GSTRING_LEN];
+	__u32 indir[INDIR_SIZE], count, indir_size, key_size, locs[2];
+	struct ethtool_rx_flow_spec fs;
+	struct ethtool_link_info link;
+	struct ethtool_dev dev;
+	__u64 values[N_STATS];
+	__u8 key[KEY_SIZE];
+	int rc = 0;
+
+	if (libethtool_version() >> 16 != LIBETHTOOL_VERSION_MAJOR) {
+		fprintf(stderr, "E: library version %#x\n",
+			libethtool_version());
+		rc = 1;
+	}
+
+	if (ethtool_dev_init(&dev, -1, "16_char_devname!") != -EINVAL) {
+		fprintf(stderr, "E: accepted a long device name\n");
+		rc = 1;
+	}
+	ethtool_dev_init(&dev, -1, "devname");
+	dev.send = fake_send;
+
+	/* A short buffer is refused, with the size it needs */
+	count = 1;
+	if (ethtool_get_strings(&dev, ETH_SS_STATS, names, &count) !=
+	    -ENOSPC || count != N_STATS || requests != 1) {
+		fprintf(stderr, "E: short string buffer not refused\n");
+		rc = 1;
+	}
+	if (ethtool_get_strings(&dev, ETH_SS_STATS, names, &count) ||
+	    count != N_STATS || strcmp(names[2], "stat_2")) {
+		fprintf(stderr, "E: wrong statistic names\n");
+		rc = 1;
+	}
+	if (ethtool_get_stats(&dev, values, &count) || count != N_STATS ||
+	    values[0] != 100 || values[2] != 102) {
+		fprintf(stderr, "E: wrong statistics\n");
+		rc = 1;
+	}
+	count = 0;
+	if (ethtool_get_strings(&dev, ETH_SS_FEATURES, NULL, &count) !=
+	    -EOPNOTSUPP) {
+		fprintf(stderr, "E: unsupported string set not reported\n");
+		rc = 1;
+	}
+
+	if (ethtool_get_link_info(&dev, &link) ||
+	    link.base.speed != 25000 ||
+	    link.base.link_mode_masks_nwords != LINK_NWORDS ||
+	    link.supported[0] != 1 || link.advertising[0] != 4 ||
+	    link.lp_advertising[2] != 9 || link.lp_advertising[3] != 0) {
+		fprintf(stderr, "E: wrong link settings\n");
+		rc = 1;
+	}
+
+	indir_size = INDIR_SIZE;
+	key_size = 0;
+	if (ethtool_get_rxfh(&dev, indir, &indir_size, key, &key_size) !=
+	    -ENOSPC || key_size != KEY_SIZE) {
+		fprintf(stderr, "E: short RSS key buffer not refused\n");
+		rc = 1;
+	}
+	if (ethtool_get_rxfh(&dev, indir, &indir_size, key, &key_size) ||
+	    indir_size != INDIR_SIZE || indir[3] != 1 || key[4] != 0x6d) {
+		fprintf(stderr, "E: wrong RSS configuration\n");
+		rc = 1;
+	}
+
+	count = 0;
+	if (ethtool_get_rx_rule_locs(&dev, locs, &count) != -ENOSPC ||
+	    count != 1) {
+		fprintf(stderr, "E: short rule buffer not refused\n");
+		rc = 1;
+	}
+	count = 2;
+	if (ethtool_get_rx_rule_locs(&dev, locs, &count) || count != 1 ||
+	    locs[0] != RULE_LOC ||
+	    ethtool_get_rx_rule(&dev, RULE_LOC, &fs) ||
+	    fs.flow_type != TCP_V4_FLOW || fs.ring_cookie != 1) {
+		fprintf(stderr, "E: wrong classification rules\n");
+		rc = 1;
+	}
+
+	return rc;
+}
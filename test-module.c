@@ -0,0 +1,179 @@
+/****************************************************************************
+ * Fuzz test for the module EEPROM decoders behind ethtool -m
+ *
+ * Feeds randomised and truncated EEPROM images through the normal
+ * command line path.  The image is returned by a fake driver that may
+ * report any module type and length, so the decoders must not read
+ * beyond what was actually fetched.  Build with AddressSanitizer and
+ * UBSan (configure does this by default) to catch overruns.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define TEST_NO_WRAPPERS
+#include "internal.h"
+#include "sff-common.h"
+
+#define DEFAULT_ITERATIONS	20000
+#define MAX_IMAGE_LEN		(ETH_MODULE_SFF_8636_MAX_LEN + 64)
+
+static const struct {
+	__u32 type;
+	__u32 len;		/* canonical image length */
+	__u32 max_len;		/* optional paged image length */
+	__u8 ids[3];		/* identifiers that reach the full decoder */
+} module_types[] = {
+	{ ETH_MODULE_SFF_8079, ETH_MODULE_SFF_8079_LEN, 0,
+	  { SFF8024_ID_SOLDERED_MODULE, SFF8024_ID_SFP, SFF8024_ID_SFP } },
+	{ ETH_MODULE_SFF_8472, ETH_MODULE_SFF_8472_LEN, 0,
+	  { SFF8024_ID_SOLDERED_MODULE, SFF8024_ID_SFP, SFF8024_ID_SFP } },
+	{ ETH_MODULE_SFF_8436, ETH_MODULE_SFF_8436_LEN,
+	  ETH_MODULE_SFF_8436_MAX_LEN,
+	  { SFF8024_ID_QSFP, SFF8024_ID_QSFP_PLUS, SFF8024_ID_QSFP28 } },
+	{ ETH_MODULE_SFF_8636, ETH_MODULE_SFF_8636_LEN,
+	  ETH_MODULE_SFF_8636_MAX_LEN,
+	  { SFF8024_ID_QSFP, SFF8024_ID_QSFP_PLUS, SFF8024_ID_QSFP28 } },
+	/* Unknown to ethtool; must fall back to a hex dump */
+	{ 0x7f, 256, 0, { 0, 0, 0 } },
+};
+
+static struct ethtool_modinfo fake_modinfo;
+static __u8 fake_image[MAX_IMAGE_LEN];
+
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	struct ethtool_modinfo *modinfo;
+	struct ethtool_eeprom *eeprom;
+
+	switch (*(__u32 *)cmd) {
+	case ETHTOOL_GMODULEINFO:
+		modinfo = cmd;
+		modinfo->type = fake_modinfo.type;
+		modinfo->eeprom_len = fake_modinfo.eeprom_len;
+		return 0;
+	case ETHTOOL_GMODULEEEPROM:
+		eeprom = cmd;
+		if (eeprom->offset > fake_modinfo.eeprom_len ||
+		    eeprom->len > fake_modinfo.eeprom_len - eeprom->offset) {
+			errno = EINVAL;
+			return -1;
+		}
+		memcpy(eeprom->data, fake_image + eeprom->offset, eeprom->len);
+		return 0;
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static __u32 pick_length(unsigned int t)
+{
+	__u32 len = module_types[t].len;
+
+	switch (random() % 8) {
+	case 0:
+		/* Truncated anywhere, including empty */
+		return random() % (len + 1);
+	case 1:
+		/* Slightly longer than the decoder expects */
+		return len + random() % 64;
+	case 2:
+	case 3:
+		if (module_types[t].max_len)
+			return module_types[t].max_len;
+		/* fall through */
+	default:
+		return len;
+	}
+}
+
+static void fill_image(unsigned int t, __u32 len)
+{
+	unsigned int i;
+
+	for (i = 0; i < len; i++)
+		fake_image[i] = random();
+
+	/* Mostly use a valid identifier and advertise diagnostics, so
+	 * that the deeper decoding paths are reached.
+	 */
+	if (len > 1 && random() % 4) {
+		fake_image[0] = module_types[t].ids[random() % 3];
+		if (module_types[t].type == ETH_MODULE_SFF_8079 ||
+		    module_types[t].type == ETH_MODULE_SFF_8472)
+			fake_image[1] = 0x04;
+	}
+	if (module_types[t].type == ETH_MODULE_SFF_8472 && len > 92 &&
+	    random() % 4)
+		fake_image[92] |= 1 << 6;
+}
+
+static void make_args(char *args, size_t size, __u32 len)
+{
+	__u32 offset;
+
+	switch (random() % 8) {
+	case 0:
+		snprintf(args, size, "-m devname hex on");
+		break;
+	case 1:
+		snprintf(args, size, "-m devname raw on");
+		break;
+	case 2:
+		offset = len ? random() % len : 0;
+		snprintf(args, size, "-m devname offset %u length %lu",
+			 offset, random() % (len - offset + 1));
+		break;
+	default:
+		snprintf(args, size, "-m devname");
+		break;
+	}
+}
+
+int main(void)
+{
+	unsigned long iterations = DEFAULT_ITERATIONS;
+	unsigned long seed = 8636;
+	unsigned long i;
+	unsigned int t;
+	char args[64];
+	int test_rc;
+	int rc = 0;
+
+	if (getenv("ETHTOOL_TEST_FUZZ_ITERATIONS"))
+		iterations = strtoul(getenv("ETHTOOL_TEST_FUZZ_ITERATIONS"),
+				     NULL, 0);
+	if (getenv("ETHTOOL_TEST_FUZZ_SEED"))
+		seed = strtoul(getenv("ETHTOOL_TEST_FUZZ_SEED"), NULL, 0);
+
+	for (i = 0; i < iterations; i++) {
+		/* Reseed per iteration so a failure can be replayed alone */
+		srandom(seed + i);
+		t = random() % ARRAY_SIZE(module_types);
+		fake_modinfo.type = module_types[t].type;
+		fake_modinfo.eeprom_len = pick_length(t);
+		fill_image(t, fake_modinfo.eeprom_len);
+		make_args(args, sizeof(args), fake_modinfo.eeprom_len);
+
+		if (getenv("ETHTOOL_TEST_VERBOSE"))
+			printf("I: seed %lu: type %#x len %u: ethtool %s\n",
+			       seed + i, fake_modinfo.type,
+			       fake_modinfo.eeprom_len, args);
+		test_rc = test_cmdline(args);
+		if (test_rc != 0) {
+			fprintf(stderr,
+				"E: seed %lu: type %#x len %u: ethtool %s returns %d\n",
+				seed + i, fake_modinfo.type,
+				fake_modinfo.eeprom_len, args, test_rc);
+			rc = 1;
+		}
+	}
+
+	return rc;
+}
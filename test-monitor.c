@@ -0,0 +1,279 @@
+/****************************************************************************
+ * Test cases for --monitor
+ *
+ * The mock kernel answers the link dump with one device and then queues
+ * link messages and ethtool notifications, as the kernel would after
+ * changes to the simulated device in test-fakenic.c.  Each case checks
+ * what the monitor reports and how often it reads the features.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <linux/rtnetlink.h>
+#define TEST_NO_WRAPPERS
+#include "netlink.h"
+
+#define MOCK_FAMILY	0x1d
+#define MOCK_GROUP	5
+#define MOCK_IFINDEX	2
+#define MOCK_FLAGS	(IFF_UP | IFF_RUNNING | 0x10000 /* IFF_LOWER_UP */)
+#define MOCK_OPER_UP	6
+#define MOCK_OPER_DOWN	2
+#define MOCK_GRO_BIT	11	/* rx-gro on the simulated device */
+
+/* RTM_NEWLINK or RTM_DELLINK for "devname" */
+struct mock_link_msg {
+	struct nlmsghdr nlh;
+	struct ifinfomsg ifi;
+	struct nlattr name_attr;
+	char name[8];
+	struct nlattr oper_attr;
+	u8 operstate;
+	u8 pad[3];
+};
+
+struct test_case {
+	const char *name;
+	int has_family;			/* ethtool notifications */
+	void (*events)(void);		/* queued after the start */
+	const char *const *records;	/* what is reported, in order */
+	unsigned int n_records;
+	unsigned int gfeatures;		/* feature reads, including the start */
+};
+
+static const struct test_case *test;
+static int started;
+static unsigned int gfeatures;
+
+static void mock_link(u16 type, u8 family, u32 seq, u32 flags, u8 operstate)
+{
+	struct mock_link_msg msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.nlh.nlmsg_len = sizeof(msg);
+	msg.nlh.nlmsg_type = type;
+	msg.nlh.nlmsg_seq = seq;
+	msg.ifi.ifi_family = family;
+	msg.ifi.ifi_index = MOCK_IFINDEX;
+	msg.ifi.ifi_flags = flags;
+	msg.name_attr.nla_len = NLA_HDRLEN + sizeof(msg.name);
+	msg.name_attr.nla_type = IFLA_IFNAME;
+	strcpy(msg.name, "devname");
+	msg.oper_attr.nla_len = NLA_HDRLEN + 1;
+	msg.oper_attr.nla_type = IFLA_OPERSTATE;
+	msg.operstate = operstate;
+	test_netlink_event(NETLINK_ROUTE, &msg, sizeof(msg));
+}
+
+static void mock_feature_ntf(void)
+{
+	struct nl_msg msg = {};
+	size_t nest;
+
+	nl_msg_genl(&msg, MOCK_FAMILY, 0, ETHTOOL_MSG_FEATURES_NTF,
+		    ETHTOOL_GENL_VERSION);
+	/* Every message's header is attribute 1 */
+	nest = nl_nest_start(&msg, 1);
+	nl_put_u32(&msg, ETHTOOL_A_HEADER_DEV_INDEX, MOCK_IFINDEX);
+	nl_nest_end(&msg, nest);
+	if (!msg.oom)
+		test_netlink_event(NETLINK_GENERIC, msg.buf, msg.len);
+	nl_msg_free(&msg);
+}
+
+static void mock_gro_off(void)
+{
+	struct {
+		struct ethtool_sfeatures hdr;
+		struct ethtool_set_features_block blocks[1];
+	} sfeatures = { { ETHTOOL_SFEATURES, 1 },
+			{ { 1U << MOCK_GRO_BIT, 0 } } };
+
+	fakenic_ioctl(NULL, &sfeatures);
+}
+
+static void mock_error(int fd, const struct nlmsghdr *req, int error)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct nlmsgerr err;
+	} reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.nlh.nlmsg_len = sizeof(reply);
+	reply.nlh.nlmsg_type = NLMSG_ERROR;
+	reply.nlh.nlmsg_seq = req->nlmsg_seq;
+	reply.err.error = error;
+	reply.err.msg = *req;
+	send(fd, &reply, sizeof(reply), 0);
+}
+
+/* The link dump, the ethtool family and no ethtool requests */
+static void mock_kernel(int fd, const void *buf, size_t len)
+{
+	const struct nlmsghdr *req = buf;
+	struct nl_msg msg = {};
+	struct nlmsghdr done;
+	size_t groups, group;
+
+	if (req->nlmsg_type == RTM_GETLINK) {
+		mock_link(RTM_NEWLINK, AF_UNSPEC, req->nlmsg_seq, MOCK_FLAGS,
+			  MOCK_OPER_UP);
+		memset(&done, 0, sizeof(done));
+		done.nlmsg_len = sizeof(done);
+		done.nlmsg_type = NLMSG_DONE;
+		done.nlmsg_seq = req->nlmsg_seq;
+		send(fd, &done, sizeof(done), 0);
+		return;
+	}
+	if (req->nlmsg_type != GENL_ID_CTRL || !test->has_family) {
+		mock_error(fd, req, req->nlmsg_type == GENL_ID_CTRL ?
+			   -ENOENT : -EOPNOTSUPP);
+		return;
+	}
+
+	nl_msg_genl(&msg, GENL_ID_CTRL, 0, CTRL_CMD_NEWFAMILY, 2);
+	nl_put_str(&msg, CTRL_ATTR_FAMILY_NAME, ETHTOOL_GENL_NAME);
+	nl_put_u16(&msg, CTRL_ATTR_FAMILY_ID, MOCK_FAMILY);
+	groups = nl_nest_start(&msg, CTRL_ATTR_MCAST_GROUPS);
+	group = nl_nest_start(&msg, 1);
+	nl_put_str(&msg, CTRL_ATTR_MCAST_GRP_NAME, ETHTOOL_MCGRP_MONITOR_NAME);
+	nl_put_u32(&msg, CTRL_ATTR_MCAST_GRP_ID, MOCK_GROUP);
+	nl_nest_end(&msg, group);
+	nl_nest_end(&msg, groups);
+	if (!msg.oom) {
+		((struct nlmsghdr *)msg.buf)->nlmsg_seq = req->nlmsg_seq;
+		send(fd, msg.buf, msg.len, 0);
+	}
+	nl_msg_free(&msg);
+}
+
+/* The events start once the monitor has read the features at start */
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	int rc = fakenic_ioctl(ctx, cmd);
+
+	if (*(u32 *)cmd == ETHTOOL_GFEATURES) {
+		gfeatures++;
+		if (!started) {
+			started = 1;
+			test->events();
+		}
+	}
+	return rc;
+}
+
+/* Only a change of state makes the monitor read the features */
+static void events_link(void)
+{
+	mock_gro_off();
+	mock_link(RTM_NEWLINK, AF_UNSPEC, 0, MOCK_FLAGS, MOCK_OPER_UP);
+	mock_link(RTM_DELLINK, AF_BRIDGE, 0, MOCK_FLAGS, MOCK_OPER_UP);
+	mock_link(RTM_NEWLINK, AF_UNSPEC, 0, MOCK_FLAGS | IFF_PROMISC,
+		  MOCK_OPER_UP);
+	mock_link(RTM_NEWLINK, AF_UNSPEC, 0, IFF_UP, MOCK_OPER_DOWN);
+	mock_link(RTM_DELLINK, AF_UNSPEC, 0, IFF_UP, MOCK_OPER_DOWN);
+	test_netlink_event(NETLINK_ROUTE, NULL, 0);
+}
+
+static const char *const records_link[] = {
+	"link up", "features changed", "link down", "removed",
+};
+
+/* With notifications, only they make the monitor read the features */
+static void events_ntf(void)
+{
+	mock_gro_off();
+	mock_link(RTM_NEWLINK, AF_UNSPEC, 0, MOCK_FLAGS | IFF_PROMISC,
+		  MOCK_OPER_UP);
+	mock_link(RTM_DELLINK, AF_BRIDGE, 0, MOCK_FLAGS, MOCK_OPER_UP);
+	mock_feature_ntf();
+	test_netlink_event(NETLINK_GENERIC, NULL, 0);
+}
+
+static const char *const records_ntf[] = {
+	"link up", "features changed",
+};
+
+static const struct test_case test_cases[] = {
+	{ "link messages", 0, events_link,
+	  records_link, ARRAY_SIZE(records_link), 2 },
+	{ "notifications", 1, events_ntf,
+	  records_ntf, ARRAY_SIZE(records_ntf), 2 },
+};
+
+/* Compare the records in @output, ignoring the lines of features */
+static int check_records(FILE *output)
+{
+	static const char prefix[] = " devname: ";
+	unsigned int n = 0;
+	char line[256];
+	const char *p;
+
+	rewind(output);
+	while (fgets(line, sizeof(line), output)) {
+		p = strstr(line, prefix);
+		if (!p)
+			continue;
+		p += strlen(prefix);
+		if (n == test->n_records ||
+		    strncmp(p, test->records[n], strlen(test->records[n]))) {
+			fprintf(stderr, "E: %s: unexpected record %s",
+				test->name, line);
+			return 1;
+		}
+		n++;
+	}
+	if (n != test->n_records) {
+		fprintf(stderr, "E: %s: %u records, expected %u\n",
+			test->name, n, test->n_records);
+		return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	FILE *output;
+	int test_rc;
+	int rc = 0;
+
+	test_netlink = mock_kernel;
+
+	for (test = test_cases; test < test_cases + ARRAY_SIZE(test_cases);
+	     test++) {
+		if (getenv("ETHTOOL_TEST_VERBOSE"))
+			printf("I: Test: %s\n", test->name);
+		output = tmpfile();
+		if (!output || fakenic_create(NULL)) {
+			fprintf(stderr, "E: cannot set up %s\n", test->name);
+			return 1;
+		}
+		started = 0;
+		gfeatures = 0;
+		test_rc = test_cmdline_output("--monitor", output);
+		if (test_rc) {
+			fprintf(stderr, "E: %s: ethtool --monitor returns %d\n",
+				test->name, test_rc);
+			rc = 1;
+		} else if (check_records(output)) {
+			rc = 1;
+		} else if (gfeatures != test->gfeatures) {
+			fprintf(stderr,
+				"E: %s: features read %u times, expected %u\n",
+				test->name, gfeatures, test->gfeatures);
+			rc = 1;
+		}
+		fclose(output);
+	}
+
+	fakenic_destroy();
+	return rc;
+}
@@ -0,0 +1,393 @@
+/****************************************************************************
+ * Test cases for the ethtool netlink transport
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#define TEST_NO_WRAPPERS
+#include "netlink.h"
+
+/* The mock kernel.  It knows four devices, "devname" and "dev1" to
+ * "dev3", and any number of others only there to make dumps bigger.
+ */
+
+#define MOCK_FAMILY	0x1d
+
+static const char *const mock_devs[] = { "devname", "dev1", "dev2", "dev3" };
+
+static const char *const mock_stat_names[] = {
+	"rx_packets", "tx_packets", "rx_missed_errors",
+};
+
+static int mock_has_family;	/* ethtool family registered */
+static unsigned int mock_pad_devs;
+static unsigned int mock_requests;
+
+static void mock_error(int fd, const struct nlmsghdr *req, int error)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct nlmsgerr err;
+	} reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.nlh.nlmsg_len = sizeof(reply);
+	reply.nlh.nlmsg_type = NLMSG_ERROR;
+	reply.nlh.nlmsg_seq = req->nlmsg_seq;
+	reply.err.error = error;
+	reply.err.msg = *req;
+	send(fd, &reply, sizeof(reply), 0);
+}
+
+static void mock_reply(int fd, const struct nlmsghdr *req, struct nl_msg *msg)
+{
+	if (!msg->oom) {
+		((struct nlmsghdr *)msg->buf)->nlmsg_seq = req->nlmsg_seq;
+		send(fd, msg->buf, msg->len, 0);
+	}
+	nl_msg_free(msg);
+}
+
+/* Reply with each requested string set; only ETH_SS_STATS is non-empty */
+static void mock_strset(struct nl_msg *msg, const struct nlattr *sets)
+{
+	const struct nlattr *tb[ETHTOOL_A_STRINGSET_MAX + 1];
+	const struct nlattr *nla;
+	size_t reply_sets, set, strings, string;
+	u32 id, i, count;
+	int rem;
+
+	reply_sets = nl_nest_start(msg, ETHTOOL_A_STRSET_STRINGSETS);
+	nl_for_each_attr(nla, nl_attr_data(sets), nl_attr_len(sets), rem) {
+		nl_parse_nested(nla, tb, ETHTOOL_A_STRINGSET_MAX);
+		if (!tb[ETHTOOL_A_STRINGSET_ID])
+			continue;
+		id = nl_get_u32(tb[ETHTOOL_A_STRINGSET_ID]);
+		count = id == ETH_SS_STATS ? ARRAY_SIZE(mock_stat_names) : 0;
+
+		set = nl_nest_start(msg, ETHTOOL_A_STRINGSETS_STRINGSET);
+		nl_put_u32(msg, ETHTOOL_A_STRINGSET_ID, id);
+		nl_put_u32(msg, ETHTOOL_A_STRINGSET_COUNT, count);
+		strings = nl_nest_start(msg, ETHTOOL_A_STRINGSET_STRINGS);
+		for (i = 0; i < count; i++) {
+			string = nl_nest_start(msg, ETHTOOL_A_STRINGS_STRING);
+			nl_put_u32(msg, ETHTOOL_A_STRING_INDEX, i);
+			nl_put_str(msg, ETHTOOL_A_STRING_VALUE,
+				   mock_stat_names[i]);
+			nl_nest_end(msg, string);
+		}
+		nl_nest_end(msg, strings);
+		nl_nest_end(msg, set);
+	}
+	nl_nest_end(msg, reply_sets);
+}
+
+/* Append the message for one device of a dump to @buf */
+static int mock_dump_dev(char **buf, size_t *len, const struct nlmsghdr *req,
+			 const char *devname, const struct nlattr *sets)
+{
+	struct nl_msg msg = {};
+	size_t hdr;
+	char *p;
+
+	nl_msg_genl(&msg, MOCK_FAMILY, NLM_F_MULTI,
+		    ETHTOOL_MSG_STRSET_GET_REPLY, ETHTOOL_GENL_VERSION);
+	hdr = nl_nest_start(&msg, ETHTOOL_A_STRSET_HEADER);
+	nl_put_str(&msg, ETHTOOL_A_HEADER_DEV_NAME, devname);
+	nl_nest_end(&msg, hdr);
+	if (sets)
+		mock_strset(&msg, sets);
+	p = msg.oom ? NULL : realloc(*buf, *len + msg.len);
+	if (!p) {
+		nl_msg_free(&msg);
+		return -1;
+	}
+	((struct nlmsghdr *)msg.buf)->nlmsg_seq = req->nlmsg_seq;
+	memcpy(p + *len, msg.buf, msg.len);
+	*buf = p;
+	*len += msg.len;
+	nl_msg_free(&msg);
+	return 0;
+}
+
+/* Reply to a string set dump with every device in one datagram, as the
+ * kernel does when they fit, followed by NLMSG_DONE
+ */
+static void mock_strset_dump(int fd, const struct nlmsghdr *req,
+			     const struct nlattr *sets)
+{
+	struct nlmsghdr *done;
+	char name[IFNAMSIZ];
+	char *buf = NULL;
+	size_t len = 0;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(mock_devs) + mock_pad_devs; i++) {
+		if (i < ARRAY_SIZE(mock_devs))
+			strcpy(name, mock_devs[i]);
+		else
+			snprintf(name, sizeof(name), "pad%u", i);
+		if (mock_dump_dev(&buf, &len, req, name, sets))
+			goto out;
+	}
+	done = realloc(buf, len + NLMSG_LENGTH(sizeof(int)));
+	if (!done)
+		goto out;
+	buf = (char *)done;
+	done = (struct nlmsghdr *)(buf + len);
+	memset(done, 0, NLMSG_LENGTH(sizeof(int)));
+	done->nlmsg_len = NLMSG_LENGTH(sizeof(int));
+	done->nlmsg_type = NLMSG_DONE;
+	done->nlmsg_flags = NLM_F_MULTI;
+	done->nlmsg_seq = req->nlmsg_seq;
+	send(fd, buf, len + done->nlmsg_len, 0);
+out:
+	free(buf);
+}
+
+static void mock_kernel(int fd, const void *buf, size_t len)
+{
+	const struct nlattr *tb[ETHTOOL_A_STRSET_MAX + 1];
+	const struct nlmsghdr *req = buf;
+	const struct genlmsghdr *genl = NLMSG_DATA(req);
+	struct nl_msg msg = {};
+
+	mock_requests++;
+	if (len < NLMSG_LENGTH(GENL_HDRLEN) || req->nlmsg_len != len) {
+		mock_error(fd, req, -EINVAL);
+		return;
+	}
+
+	if (req->nlmsg_type == GENL_ID_CTRL) {
+		if (!mock_has_family) {
+			mock_error(fd, req, -ENOENT);
+			return;
+		}
+		nl_msg_genl(&msg, GENL_ID_CTRL, 0, CTRL_CMD_NEWFAMILY, 2);
+		nl_put_str(&msg, CTRL_ATTR_FAMILY_NAME, ETHTOOL_GENL_NAME);
+		nl_put_u16(&msg, CTRL_ATTR_FAMILY_ID, MOCK_FAMILY);
+		mock_reply(fd, req, &msg);
+		return;
+	}
+	if (req->nlmsg_type != MOCK_FAMILY) {
+		mock_error(fd, req, -ENOENT);
+		return;
+	}
+
+	/* Only whole-system string set dumps save system calls */
+	nl_parse((const char *)genl + GENL_HDRLEN,
+		 len - NLMSG_LENGTH(GENL_HDRLEN), tb, ETHTOOL_A_STRSET_MAX);
+	if (genl->cmd != ETHTOOL_MSG_STRSET_GET ||
+	    !(req->nlmsg_flags & NLM_F_DUMP) || tb[ETHTOOL_A_STRSET_HEADER]) {
+		mock_error(fd, req, -EOPNOTSUPP);
+		return;
+	}
+	mock_strset_dump(fd, req, tb[ETHTOOL_A_STRSET_STRINGSETS]);
+}
+
+/* The ioctls expected once netlink has had its turn */
+
+static const struct {
+	struct ethtool_sset_info cmd;
+	u32 data[1];
+}
+cmd_gssetinfo = { { ETHTOOL_GSSET_INFO, 0, 1ULL << ETH_SS_STATS }, { 3 } };
+
+static const struct {
+	struct ethtool_gstrings cmd;
+	u8 data[3][ETH_GSTRING_LEN];
+}
+cmd_gstrings = { { ETHTOOL_GSTRINGS, ETH_SS_STATS, 3 },
+		 { "rx_packets", "tx_packets", "rx_missed_errors" } };
+
+static const struct {
+	struct ethtool_stats cmd;
+	u64 data[3];
+}
+cmd_gstats = { { ETHTOOL_GSTATS, 3 }, { 100, 200, 3 } };
+
+static const struct ethtool_ringparam
+cmd_gring = { ETHTOOL_GRINGPARAM, 4096, 0, 0, 4096, 512, 0, 0, 256 },
+cmd_sring = { ETHTOOL_SRINGPARAM, 4096, 0, 0, 4096, 1024, 0, 0, 256 };
+
+#define EXPECT_GSSETINFO \
+	{ &cmd_gssetinfo, sizeof(cmd_gssetinfo.cmd), 0, \
+	  &cmd_gssetinfo, sizeof(cmd_gssetinfo) }
+#define EXPECT_GSTRINGS \
+	{ &cmd_gstrings, sizeof(cmd_gstrings.cmd), 0, \
+	  &cmd_gstrings, sizeof(cmd_gstrings) }
+#define EXPECT_GSTATS \
+	{ &cmd_gstats, sizeof(cmd_gstats.cmd), 0, \
+	  &cmd_gstats, sizeof(cmd_gstats) }
+#define EXPECT_GRING \
+	{ &cmd_gring, 4, 0, &cmd_gring, sizeof(cmd_gring) }
+#define EXPECT_SRING \
+	{ &cmd_sring, sizeof(cmd_sring), 0, 0, 0 }
+
+static const struct cmd_expect cmd_expect_gstats[] = {
+	EXPECT_GSSETINFO, EXPECT_GSTRINGS, EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gring[] = {
+	EXPECT_GRING,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_sring[] = {
+	EXPECT_GRING, EXPECT_SRING,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gstats_1[] = {
+	EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gstats_4[] = {
+	EXPECT_GSTATS, EXPECT_GSTATS, EXPECT_GSTATS, EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gstats_2_ioctl[] = {
+	EXPECT_GSSETINFO, EXPECT_GSTRINGS, EXPECT_GSTATS,
+	EXPECT_GSSETINFO, EXPECT_GSTRINGS, EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gstats_newdev[] = {
+	EXPECT_GSTATS,
+	EXPECT_GSSETINFO, EXPECT_GSTRINGS, EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+static const struct cmd_expect cmd_expect_gstats_sring[] = {
+	EXPECT_GSTATS, EXPECT_GRING, EXPECT_SRING, EXPECT_GSTATS,
+	{ 0, 0, 0, 0, 0 }
+};
+
+#define BATCH_FILE "test-netlink.batch"
+
+/*
+ * System calls counted are sockets, netlink messages sent and received,
+ * and ioctls.  By ioctl alone, each -S costs 3 and a batch opens one
+ * control socket.
+ */
+static struct test_case {
+	int rc;
+	const char *batch;	/* commands run with --batch, or NULL */
+	const char *args;	/* command line without a batch */
+	int has_family;
+	unsigned int pad_devs;
+	unsigned int requests;	/* netlink messages, including the lookup */
+	unsigned int syscalls;
+	const struct cmd_expect *expect;
+} const test_cases[] = {
+	/* A single command does not use netlink at all */
+	{ 0, NULL, "-S devname", 1, 0, 0, 4, cmd_expect_gstats },
+	{ 0, NULL, "-g devname", 1, 0, 0, 2, cmd_expect_gring },
+	{ 0, NULL, "-G devname rx 1024", 1, 0, 0, 3, cmd_expect_sring },
+	/* One dump for four devices: 10 system calls instead of 13 */
+	{ 0, "-S dev1\n-S dev2\n-S dev3\n-S devname\n", NULL, 1, 0, 2, 10,
+	  cmd_expect_gstats_4 },
+	/* A dump too big for the buffer is read again, once */
+	{ 0, "-S dev1\n", NULL, 1, 400, 3, 10, cmd_expect_gstats_1 },
+	/* A device that came after the dump goes by ioctl */
+	{ 0, "-S dev1\n-S newdev\n", NULL, 1, 0, 2, 10,
+	  cmd_expect_gstats_newdev },
+	/* A change drops the dump */
+	{ 0, "-S devname\n-G devname rx 1024\n-S devname\n", NULL, 1, 0, 3,
+	  12, cmd_expect_gstats_sring },
+	/* Older kernel: everything by ioctl after a failed lookup */
+	{ 0, "-S dev1\n-S dev2\n", NULL, 0, 0, 1, 10,
+	  cmd_expect_gstats_2_ioctl },
+};
+
+static int expect_matched;
+static const struct cmd_expect *expect_next;
+
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	int rc = test_ioctl(expect_next, cmd);
+
+	if (rc == TEST_IOCTL_MISMATCH) {
+		expect_matched = 0;
+		test_exit(0);
+	}
+	expect_next++;
+	test_syscalls++;
+	return rc;
+}
+
+static int write_file(const char *name, const char *contents)
+{
+	FILE *file = fopen(name, "w");
+
+	if (!file || fputs(contents, file) < 0 || fclose(file)) {
+		perror(name);
+		return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	const struct test_case *tc;
+	const char *args;
+	int test_rc;
+	int rc = 0;
+
+	test_netlink = mock_kernel;
+
+	for (tc = test_cases; tc < test_cases + ARRAY_SIZE(test_cases); tc++) {
+		args = tc->args;
+		if (tc->batch) {
+			if (write_file(BATCH_FILE, tc->batch))
+				return 1;
+			args = "--batch " BATCH_FILE;
+		}
+		if (getenv("ETHTOOL_TEST_VERBOSE"))
+			printf("I: Test command line: ethtool %s\n", args);
+		mock_has_family = tc->has_family;
+		mock_pad_devs = tc->pad_devs;
+		mock_requests = 0;
+		test_syscalls = 0;
+		expect_matched = 1;
+		expect_next = tc->expect;
+		test_rc = test_cmdline(args);
+
+		if (!expect_matched || expect_next->cmd) {
+			fprintf(stderr,
+				"E: ethtool %s deviated from the expected "
+				"ioctl sequence after %zu calls\n",
+				args, expect_next - tc->expect);
+			rc = 1;
+		} else if (mock_requests != tc->requests) {
+			fprintf(stderr,
+				"E: ethtool %s sent %u netlink messages, "
+				"expected %u\n",
+				args, mock_requests, tc->requests);
+			rc = 1;
+		} else if (test_syscalls != tc->syscalls) {
+			fprintf(stderr,
+				"E: ethtool %s made %lu system calls, "
+				"expected %u\n",
+				args, test_syscalls, tc->syscalls);
+			rc = 1;
+		} else if (test_rc != tc->rc) {
+			fprintf(stderr, "E: ethtool %s returns %d\n",
+				args, test_rc);
+			rc = 1;
+		}
+	}
+
+	remove(BATCH_FILE);
+	return rc;
+}
@@ -0,0 +1,327 @@
+/****************************************************************************
+ * Test cases for SFF module EEPROM decoding helpers
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "internal.h"
+#include "sff-common.h"
+
+#define SFF_A2_BASE		0x100
+#define SFF_A2_CAL_RXPWR4	56
+#define SFF_A2_CAL_TXI_SLP	76
+
+/* Reference implementation of the original floating-point calibration */
+
+static float ref_befloattoh(const __u8 *p)
+{
+	union {
+		__u32 src;
+		float dst;
+	} converter;
+
+	memcpy(&converter.src, p, sizeof(converter.src));
+	converter.src = ntohl(converter.src);
+	return converter.dst;
+}
+
+static double ref_slp(const __u8 *p)
+{
+	return p[0] + p[1] / 256.;
+}
+
+static __s16 ref_off(const __u8 *p)
+{
+	return (__s16)(p[0] << 8 | p[1]);
+}
+
+static void ref_calibration(const __u8 *id, __u16 *bias, __u16 *tx_pwr,
+			    __u16 *vcc, __s16 *temp, __u16 *rx_pwr,
+			    unsigned int n)
+{
+	const __u8 *cal = id + SFF_A2_BASE + SFF_A2_CAL_TXI_SLP;
+	const __u8 *rx = id + SFF_A2_BASE + SFF_A2_CAL_RXPWR4;
+	__u16 rx_reading;
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		bias[i] *= ref_slp(cal + 0);
+		tx_pwr[i] *= ref_slp(cal + 4);
+		vcc[i] *= ref_slp(cal + 12);
+		temp[i] *= ref_slp(cal + 8);
+
+		bias[i] += ref_off(cal + 2);
+		tx_pwr[i] += ref_off(cal + 6);
+		vcc[i] += ref_off(cal + 14);
+		temp[i] += ref_off(cal + 10);
+
+		/* RX_PWR(0) is last in the EEPROM, RX_PWR(4) first */
+		rx_reading = rx_pwr[i];
+		rx_pwr[i] = ref_befloattoh(rx + 16);
+		rx_pwr[i] += rx_reading * ref_befloattoh(rx + 12);
+		rx_pwr[i] += rx_reading * ref_befloattoh(rx + 8);
+		rx_pwr[i] += rx_reading * ref_befloattoh(rx + 4);
+	}
+}
+
+static void put_float(__u8 *p, float f)
+{
+	union {
+		__u32 src;
+		float dst;
+	} converter;
+
+	converter.dst = f;
+	converter.src = htonl(converter.src);
+	memcpy(p, &converter.src, sizeof(converter.src));
+}
+
+/* Raw readings are in units of 0.1 uW */
+static const struct {
+	__u16 raw;
+	double dbm;
+} dbm_known[] = {
+	{ 1, -40.0 },		/* 0.0001 mW */
+	{ 10, -30.0 },
+	{ 1000, -10.0 },
+	{ 5000, -3.0103 },
+	{ 10000, 0.0 },		/* 1 mW */
+	{ 20000, 3.0103 },
+	{ 31623, 5.0000 },
+	{ 65535, 8.1648 },
+};
+
+static int check_dbm_known(const char *when)
+{
+	unsigned int i;
+	double dbm;
+
+	for (i = 0; i < ARRAY_SIZE(dbm_known); i++) {
+		dbm = sff_raw_pwr_to_dbm(dbm_known[i].raw);
+		if (fabs(dbm - dbm_known[i].dbm) > 0.0001) {
+			fprintf(stderr, "E: %u is %.4f dBm %s, expected %.4f\n",
+				dbm_known[i].raw, dbm, when, dbm_known[i].dbm);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int test_dbm_table(void)
+{
+	int rc;
+
+	/* Filled on demand, then all at once */
+	rc = check_dbm_known("on first use");
+	rc |= check_dbm_known("from the table");
+	sff_dbm_table_init();
+	rc |= check_dbm_known("after sff_dbm_table_init()");
+	if (!isinf(sff_raw_pwr_to_dbm(0)) || sff_raw_pwr_to_dbm(0) > 0) {
+		fprintf(stderr, "E: 0 is not -inf dBm\n");
+		rc = 1;
+	}
+	return rc;
+}
+
+#define N_CAL_SAMPLES	64
+#define N_CAL_ROUNDS	2000
+
+static int test_calibration(void)
+{
+	__u16 bias[2][N_CAL_SAMPLES], tx_pwr[2][N_CAL_SAMPLES];
+	__u16 vcc[2][N_CAL_SAMPLES], rx_pwr[2][N_CAL_SAMPLES];
+	__s16 temp[2][N_CAL_SAMPLES];
+	struct sff8472_cal cal;
+	__u8 id[512];
+	unsigned int round, i;
+
+	srandom(8472);
+	for (round = 0; round < N_CAL_ROUNDS; round++) {
+		for (i = 0; i < sizeof(id); i++)
+			id[i] = random();
+		/* Keep slopes below 4.0 and the rx power coefficients
+		 * small, so that no result overflows its 16-bit field
+		 */
+		for (i = 0; i < 16; i += 4)
+			id[SFF_A2_BASE + SFF_A2_CAL_TXI_SLP + i] &= 3;
+		for (i = 0; i < 5; i++)
+			put_float(id + SFF_A2_BASE + SFF_A2_CAL_RXPWR4 + 4 * i,
+				  (random() % 2000) / 1000.f);
+		for (i = 0; i < N_CAL_SAMPLES; i++) {
+			bias[0][i] = bias[1][i] = random() % 0x4000;
+			tx_pwr[0][i] = tx_pwr[1][i] = random() % 0x4000;
+			vcc[0][i] = vcc[1][i] = random() % 0x4000;
+			temp[0][i] = temp[1][i] =
+				(__s16)(random() % 0x4000) - 0x2000;
+			rx_pwr[0][i] = rx_pwr[1][i] = random() % 0x1000;
+		}
+
+		ref_calibration(id, bias[0], tx_pwr[0], vcc[0], temp[0],
+				rx_pwr[0], N_CAL_SAMPLES);
+
+		sff8472_cal_load(id, &cal);
+		sff8472_cal_apply(&cal, SFF8472_CAL_BIAS,
+				  bias[1], N_CAL_SAMPLES);
+		sff8472_cal_apply(&cal, SFF8472_CAL_TX_PWR,
+				  tx_pwr[1], N_CAL_SAMPLES);
+		sff8472_cal_apply(&cal, SFF8472_CAL_VCC,
+				  vcc[1], N_CAL_SAMPLES);
+		sff8472_cal_apply_temp(&cal, temp[1], N_CAL_SAMPLES);
+		sff8472_cal_apply(&cal, SFF8472_CAL_RX_PWR,
+				  rx_pwr[1], N_CAL_SAMPLES);
+
+		if (memcmp(bias[0], bias[1], sizeof(bias[0])) ||
+		    memcmp(tx_pwr[0], tx_pwr[1], sizeof(tx_pwr[0])) ||
+		    memcmp(vcc[0], vcc[1], sizeof(vcc[0])) ||
+		    memcmp(temp[0], temp[1], sizeof(temp[0])) ||
+		    memcmp(rx_pwr[0], rx_pwr[1], sizeof(rx_pwr[0]))) {
+			fprintf(stderr,
+				"E: calibration mismatch in round %u\n", round);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int check_lanes(const char *name, const struct sff_diags *sd,
+		       const struct sff_lane_flags *expect,
+		       unsigned int n_lanes, unsigned int base)
+{
+	unsigned int lane;
+
+	if (sd->n_lanes != n_lanes) {
+		fprintf(stderr, "E: %s: parsed %u lanes, expected %u\n",
+			name, sd->n_lanes, n_lanes);
+		return 1;
+	}
+	for (lane = 0; lane < n_lanes; lane++) {
+		if (sd->scd[lane].bias_cur != base + 0x100 + lane ||
+		    sd->scd[lane].tx_power != base + 0x200 + lane ||
+		    sd->scd[lane].rx_power != base + 0x300 + lane) {
+			fprintf(stderr, "E: %s: wrong monitors for lane %u\n",
+				name, lane + 1);
+			return 1;
+		}
+	}
+	if (memcmp(&sd->lane_flags, expect, sizeof(*expect))) {
+		fprintf(stderr, "E: %s: wrong lane flags\n", name);
+		return 1;
+	}
+	return 0;
+}
+
+static void put_u16(__u8 *p, __u16 val)
+{
+	p[0] = val >> 8;
+	p[1] = val;
+}
+
+static int test_lanes_cmis(void)
+{
+	const struct sff_lane_layout *layout = &cmis_lane_layout;
+	struct sff_lane_flags expect = {
+		.rx_los = 0x81,
+		.tx_los = 0x02,
+		.tx_fault = 0x40,
+		.rx_lol = 0x18,
+		.tx_lol = 0x00,
+		.bias_cur_aw = { 0x01, 0x02, 0x04, 0x08 },
+		.tx_power_aw = { 0x10, 0x20, 0x40, 0x80 },
+		.rx_power_aw = { 0xff, 0x00, 0x0f, 0xf0 },
+	};
+	struct sff_diags sd = {0};
+	unsigned int lane, type;
+	__u8 page[256] = {0};
+
+	for (lane = 0; lane < CMIS_LANE_NUM; lane++) {
+		put_u16(page + layout->bias_cur_offset + 2 * lane,
+			0x1100 + lane);
+		put_u16(page + layout->tx_power_offset + 2 * lane,
+			0x1200 + lane);
+		put_u16(page + layout->rx_power_offset + 2 * lane,
+			0x1300 + lane);
+	}
+	page[CMIS_RX_LOS_OFFSET] = expect.rx_los;
+	page[CMIS_TX_LOS_OFFSET] = expect.tx_los;
+	page[CMIS_TX_FAULT_OFFSET] = expect.tx_fault;
+	page[CMIS_RX_LOL_OFFSET] = expect.rx_lol;
+	page[CMIS_TX_LOL_OFFSET] = expect.tx_lol;
+	for (type = LWARN; type <= HALRM; type++) {
+		page[layout->bias_cur_aw[type]] = expect.bias_cur_aw[type];
+		page[layout->tx_power_aw[type]] = expect.tx_power_aw[type];
+		page[layout->rx_power_aw[type]] = expect.rx_power_aw[type];
+	}
+
+	sff_lanes_parse(page, layout, &sd);
+	return check_lanes("CMIS", &sd, &expect, CMIS_LANE_NUM, 0x1000);
+}
+
+static int test_lanes_nibble(void)
+{
+	/* SFF-8636 lower page 00h layout */
+	static const struct sff_lane_layout layout = {
+		.n_lanes = 4,
+		.stride = 2,
+		.bias_cur_offset = 0x2A,
+		.tx_power_offset = 0x32,
+		.rx_power_offset = 0x22,
+		.aw_format = SFF_LANE_AW_NIBBLE,
+		.bias_cur_aw = { 0x0B, 0x0B, 0x0B, 0x0B },
+		.tx_power_aw = { 0x0D, 0x0D, 0x0D, 0x0D },
+		.rx_power_aw = { 0x09, 0x09, 0x09, 0x09 },
+		.rx_los = { 0x03, 0 },
+		.tx_los = { 0x03, 4 },
+		.tx_fault = { 0x04, 0 },
+		.rx_lol = { 0x05, 0 },
+		.tx_lol = { 0x05, 4 },
+	};
+	struct sff_lane_flags expect = {
+		.rx_los = 0x5,
+		.tx_los = 0xa,
+		.tx_fault = 0x8,
+		.rx_lol = 0x1,
+		.tx_lol = 0x2,
+		/* lane 1 high alarm, lane 2 low warning, lane 4 high warn */
+		.bias_cur_aw = { 0x2, 0x8, 0x0, 0x1 },
+		/* every flag on lane 3 */
+		.tx_power_aw = { 0x4, 0x4, 0x4, 0x4 },
+		.rx_power_aw = { 0x0, 0x0, 0x0, 0x0 },
+	};
+	struct sff_diags sd = {0};
+	unsigned int lane;
+	__u8 id[256] = {0};
+
+	for (lane = 0; lane < 4; lane++) {
+		put_u16(id + 0x2A + 2 * lane, 0x2100 + lane);
+		put_u16(id + 0x32 + 2 * lane, 0x2200 + lane);
+		put_u16(id + 0x22 + 2 * lane, 0x2300 + lane);
+	}
+	id[0x03] = 0xa5;
+	id[0x04] = 0x08;
+	id[0x05] = 0x21;
+	id[0x0B] = 0x81;
+	id[0x0C] = 0x02;
+	id[0x0E] = 0xf0;
+
+	sff_lanes_parse(id, &layout, &sd);
+	return check_lanes("SFF-8636", &sd, &expect, 4, 0x2000);
+}
+
+int main(void)
+{
+	int rc = 0;
+
+	rc |= test_dbm_table();
+	rc |= test_calibration();
+	rc |= test_lanes_cmis();
+	rc |= test_lanes_nibble();
+
+	return rc;
+}
@@ -0,0 +1,398 @@
+/****************************************************************************
+ * Test cases for command sequences run against a simulated device
+ *
+ * Each command changes the state of the device in test-fakenic.c, and
+ * the following check asks the device whether the change took effect.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation, incorporated herein by reference.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#define TEST_NO_WRAPPERS
+#include "internal.h"
+
+static const struct fakenic_config config_large = {
+	.n_stats = 2000,
+	.n_queues = 8,
+	.n_rules = 1024,
+	.indir_size = 128,
+	.regs_len = 1024,
+	.module_type = ETH_MODULE_SFF_8636,
+};
+
+static const struct fakenic_config config_driver_select = {
+	.n_stats = 16,
+	.n_queues = 4,
+	.n_rules = 16,
+	.driver_select = 1,
+	.indir_size = 64,
+};
+
+int ioctl_send(struct cmd_context *ctx, void *cmd)
+{
+	return fakenic_ioctl(ctx, cmd);
+}
+
+static u32 rule_count(void)
+{
+	struct ethtool_rxnfc nfc = { .cmd = ETHTOOL_GRXCLSRLCNT };
+
+	return fakenic_ioctl(NULL, &nfc) ? ~0U : nfc.rule_cnt;
+}
+
+static int get_rule(u32 loc, struct ethtool_rx_flow_spec *fs)
+{
+	struct ethtool_rxnfc nfc = { .cmd = ETHTOOL_GRXCLSRULE };
+
+	nfc.fs.location = loc;
+	if (fakenic_ioctl(NULL, &nfc))
+		return -errno;
+	*fs = nfc.fs;
+	return 0;
+}
+
+static int check_rules_added(void)
+{
+	struct ethtool_rx_flow_spec fs;
+
+	/* The rule manager fills the table from the end */
+	return rule_count() == 3 && !get_rule(1023, &fs) &&
+		fs.flow_type == TCP_V4_FLOW &&
+		fs.h_u.tcp_ip4_spec.pdst == htons(80) &&
+		fs.ring_cookie == 1 && !get_rule(1021, &fs) &&
+		fs.h_u.tcp_ip4_spec.pdst == htons(443);
+}
+
+static int check_rule_deleted(void)
+{
+	struct ethtool_rx_flow_spec fs;
+
+	return rule_count() == 2 && get_rule(1022, &fs) == -ENOENT;
+}
+
+static int check_rules_unchanged(void)
+{
+	return rule_count() == 2;
+}
+
+static int check_rules_driver_select(void)
+{
+	struct ethtool_rx_flow_spec fs;
+
+	return rule_count() == 2 && !get_rule(0, &fs) &&
+		fs.flow_type == UDP_V4_FLOW && !get_rule(1, &fs) &&
+		fs.ring_cookie == RX_CLS_FLOW_DISC;
+}
+
+static int check_indir(u32 n_rings)
+{
+	struct ethtool_rxfh *rxfh;
+	int ok;
+	u32 i;
+
+	rxfh = calloc(1, sizeof(*rxfh) + 128 * sizeof(rxfh->rss_config[0]));
+	if (!rxfh)
+		return 0;
+	rxfh->cmd = ETHTOOL_GRSSH;
+	rxfh->indir_size = 128;
+	ok = !fakenic_ioctl(NULL, rxfh);
+	for (i = 0; ok && i < rxfh->indir_size; i++)
+		ok = rxfh->rss_config[i] == i % n_rings;
+	free(rxfh);
+	return ok;
+}
+
+static int check_indir_equal_2(void)
+{
+	return check_indir(2);
+}
+
+static int check_indir_default(void)
+{
+	return check_indir(8);
+}
+
+static int check_indir_channels_4(void)
+{
+	struct ethtool_channels channels = { .cmd = ETHTOOL_GCHANNELS };
+
+	return !fakenic_ioctl(NULL, &channels) &&
+		channels.combined_count == 4 && check_indir(4);
+}
+
+/* rx-usecs of queues 0 to 2 */
+static int check_queue_usecs(u32 usecs0, u32 usecs1, u32 usecs2)
+{
+	struct ethtool_per_queue_op *op;
+	struct ethtool_coalesce *coalesce;
+	int ok;
+
+	op = calloc(1, sizeof(*op) + 3 * sizeof(*coalesce));
+	if (!op)
+		return 0;
+	op->cmd = ETHTOOL_PERQUEUE;
+	op->sub_command = ETHTOOL_GCOALESCE;
+	op->queue_mask[0] = 0x7;
+	coalesce = (struct ethtool_coalesce *)op->data;
+	ok = !fakenic_ioctl(NULL, op) &&
+		coalesce[0].rx_coalesce_usecs == usecs0 &&
+		coalesce[1].rx_coalesce_usecs == usecs1 &&
+		coalesce[2].rx_coalesce_usecs == usecs2;
+	free(op);
+	return ok;
+}
+
+static int check_queue_coalesce(void)
+{
+	return check_queue_usecs(50, 50, 20);
+}
+
+static int check_coalesce(void)
+{
+	return check_queue_usecs(10, 10, 10);
+}
+
+static int feature_active(const char *name)
+{
+	struct {
+		struct ethtool_gstrings hdr;
+		u8 data[64 * ETH_GSTRING_LEN];
+	} strings = { { ETHTOOL_GSTRINGS, ETH_SS_FEATURES, 0 } };
+	struct {
+		struct ethtool_gfeatures hdr;
+		struct ethtool_get_features_block blocks[2];
+	} features = { { ETHTOOL_GFEATURES, 2 } };
+	u32 i;
+
+	if (fakenic_ioctl(NULL, &strings) || fakenic_ioctl(NULL, &features))
+		return -1;
+	for (i = 0; i < strings.hdr.len; i++)
+		if (!strcmp((char *)strings.data + i * ETH_GSTRING_LEN, name))
+			return !!(features.blocks[i / 32].active &
+				  (1U << i % 32));
+	return -1;
+}
+
+static int check_gro_off(void)
+{
+	return feature_active("rx-gro") == 0 &&
+		feature_active("tx-generic-segmentation") == 1;
+}
+
+static int check_ring(void)
+{
+	struct ethtool_ringparam ring = { .cmd = ETHTOOL_GRINGPARAM };
+
+	return !fakenic_ioctl(NULL, &ring) && ring.rx_pending == 1024 &&
+		ring.tx_pending == 512;
+}
+
+/* Settings files, in the order --save writes the groups */
+#define SAVE_FILE "test-stateful.save"
+#define ROLLBACK_FILE "test-stateful.rollback"
+
+static int check_saved(void)
+{
+	static const char *const groups[] = {
+		"channels ", "rxfh indir 0 1 2 3 0 1 2 3 ", "ring ",
+		"coalesce ", "features ",
+	};
+	char line[4096];
+	unsigned int n = 0;
+	int ok = 1;
+	FILE *file;
+
+	file = fopen(SAVE_FILE, "r");
+	if (!file)
+		return 0;
+	while (ok && fgets(line, sizeof(line), file)) {
+		if (line[0] == '#')
+			continue;
+		ok = n < ARRAY_SIZE(groups) &&
+			!strncmp(line, groups[n], strlen(groups[n]));
+		if (ok && n == 0)
+			ok = strstr(line, " combined 4\n") != NULL;
+		if (ok && n == 2)
+			ok = strstr(line, " rx 1024 ") != NULL;
+		if (ok && n == 4)
+			ok = strstr(line, " rx-gro off ") != NULL;
+		n++;
+	}
+	fclose(file);
+	return ok && n == ARRAY_SIZE(groups);
+}
+
+/* The ring fails after channels and rxfh were changed */
+static int write_rollback_file(void)
+{
+	FILE *file = fopen(ROLLBACK_FILE, "w");
+	unsigned int i;
+
+	if (!file)
+		return -1;
+	fputs("channels combined 8\nrxfh indir", file);
+	for (i = 0; i < 128; i++)
+		fprintf(file, " %u", 7 - i % 8);
+	fputs("\nring rx 8192\n", file);
+	return fclose(file);
+}
+
+static int check_rolled_back(void)
+{
+	return check_indir_channels_4() && check_ring();
+}
+
+/* Run -S twice with a trace file and check the line of each request */
+static int test_trace_file(void)
+{
+	static const char *const names[] = {
+		"GSSET_INFO", "GSTRINGS", "GSTATS",
+	};
+	const char *tmpdir = getenv("TMPDIR");
+	char path[PATH_MAX], args[PATH_MAX + 64], line[256];
+	char date[64], dev[IFNAMSIZ], name[32];
+	unsigned int n_args = 0, n_calls = 0;
+	unsigned long bytes;
+	double usecs;
+	FILE *file;
+	int fd, err;
+	int ok = 1;
+
+	snprintf(path, sizeof(path), "%s/test-stateful.XXXXXX",
+		 tmpdir ? tmpdir : "/tmp");
+	fd = mkstemp(path);
+	if (fd < 0) {
+		perror(path);
+		return 1;
+	}
+	close(fd);
+
+	snprintf(args, sizeof(args), "--trace --trace-file %s -S devname",
+		 path);
+	if (test_cmdline(args) || test_cmdline(args))
+		ok = 0;
+
+	file = fopen(path, "r");
+	while (ok && file && fgets(line, sizeof(line), file)) {
+		/* Each command line starts with its arguments */
+		if (line[0] == '#') {
+			ok = !strcmp(line, "# ethtool -S devname\n") &&
+				n_calls == n_args * ARRAY_SIZE(names);
+			n_args++;
+			continue;
+		}
+		ok = sscanf(line, "%63s %15s %31s %lu %lf %d", date, dev, name,
+			    &bytes, &usecs, &err) == 6 &&
+			!strcmp(dev, "devname") &&
+			!strcmp(name, names[n_calls % ARRAY_SIZE(names)]) &&
+			!err;
+		/* The statistics are all there */
+		if (ok && !strcmp(name, "GSTATS"))
+			ok = bytes == sizeof(struct ethtool_stats) +
+				config_large.n_stats * sizeof(u64);
+		n_calls++;
+	}
+	if (!file || n_args != 2 || n_calls != 2 * ARRAY_SIZE(names))
+		ok = 0;
+	if (file)
+		fclose(file);
+	remove(path);
+
+	if (!ok)
+		fprintf(stderr, "E: ethtool %s wrote the wrong trace\n", args);
+	return !ok;
+}
+
+static struct test_case {
+	const struct fakenic_config *create;	/* new device first */
+	int rc;
+	const char *args;
+	int (*check)(void);
+} const test_cases[] = {
+	{ &config_large, 0, "-i devname" },
+	{ NULL, 0, "-S devname" },
+	{ NULL, 0, "-N devname flow-type tcp4 dst-port 80 action 1" },
+	{ NULL, 0, "-N devname flow-type tcp4 dst-port 8080 action 2" },
+	{ NULL, 0, "-N devname flow-type tcp4 dst-port 443 action 3",
+	  check_rules_added },
+	{ NULL, 0, "-n devname" },
+	{ NULL, 0, "-N devname delete 1022", check_rule_deleted },
+	{ NULL, 1, "-N devname delete 1022", check_rule_deleted },
+	/* No such queue; the device refuses it */
+	{ NULL, 1, "-N devname flow-type tcp4 action 99",
+	  check_rules_unchanged },
+	{ NULL, 0, "-X devname equal 2", check_indir_equal_2 },
+	{ NULL, 0, "-x devname" },
+	{ NULL, 0, "-X devname default", check_indir_default },
+	{ NULL, 0, "-Q devname queue_mask 0x3 --coalesce rx-usecs 50",
+	  check_queue_coalesce },
+	{ NULL, 0, "-Q devname queue_mask 0x7 --show-coalesce" },
+	{ NULL, 0, "-C devname rx-usecs 10", check_coalesce },
+	{ NULL, 0, "-K devname gro off", check_gro_off },
+	{ NULL, 0, "-k devname" },
+	{ NULL, 0, "-G devname rx 1024", check_ring },
+	{ NULL, 81, "-G devname rx 8192", check_ring },
+	{ NULL, 0, "-L devname combined 4", check_indir_channels_4 },
+	{ NULL, 0, "--save devname " SAVE_FILE, check_saved },
+	/* Channels go first, or the saved table has queues out of range */
+	{ NULL, 0, "-L devname combined 2" },
+	{ NULL, 0, "--restore devname " SAVE_FILE, check_indir_channels_4 },
+	{ NULL, 0, "--restore devname " SAVE_FILE, check_indir_channels_4 },
+	{ NULL, 1, "--restore devname " ROLLBACK_FILE, check_rolled_back },
+	{ NULL, 0, "-m devname" },
+	{ NULL, 0, "-d devname" },
+	{ NULL, 0, "devname" },
+	{ NULL, 0, "--trace -S devname" },
+	{ NULL, 0, "--trace --trace-file /dev/null -n devname" },
+	/* The driver chooses locations from the start of the table */
+	{ &config_driver_select, 0, "-N devname flow-type udp4 action 0" },
+	{ NULL, 0, "-N devname flow-type tcp4 action -1",
+	  check_rules_driver_select },
+};
+
+int main(void)
+{
+	const struct test_case *tc;
+	int test_rc;
+	int rc = 0;
+
+	if (write_rollback_file()) {
+		perror(ROLLBACK_FILE);
+		return 1;
+	}
+
+	for (tc = test_cases; tc < test_cases + ARRAY_SIZE(test_cases); tc++) {
+		if (tc->create && fakenic_create(tc->create)) {
+			fprintf(stderr, "E: cannot create device\n");
+			return 1;
+		}
+		if (getenv("ETHTOOL_TEST_VERBOSE"))
+			printf("I: Test command line: ethtool %s\n", tc->args);
+		test_rc = test_cmdline(tc->args);
+		if (test_rc != tc->rc) {
+			fprintf(stderr, "E: ethtool %s returns %d\n",
+				tc->args, test_rc);
+			rc = 1;
+		} else if (tc->check && !tc->check()) {
+			fprintf(stderr,
+				"E: ethtool %s left the device in the wrong "
+				"state\n", tc->args);
+			rc = 1;
+		}
+	}
+
+	if (fakenic_create(&config_large) || test_trace_file())
+		rc = 1;
+
+	fakenic_destroy();
+	remove(SAVE_FILE);
+	remove(ROLLBACK_FILE);
+	return rc;
+}